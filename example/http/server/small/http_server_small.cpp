@@ -117,10 +117,10 @@ private:
             // we do not recognize the request method.
             response_.result(http::status::bad_request);
             response_.set(http::field::content_type, "text/plain");
-            beast::ostream(response_.body())
-                << "Invalid request-method '"
-                << std::string(request_.method_string())
-                << "'";
+            beast::format_to(response_.body(),
+                "Invalid request-method '",
+                request_.method_string(),
+                "'");
             break;
         }
 
@@ -134,36 +134,36 @@ private:
         if(request_.target() == "/count")
         {
             response_.set(http::field::content_type, "text/html");
-            beast::ostream(response_.body())
-                << "<html>\n"
-                <<  "<head><title>Request count</title></head>\n"
-                <<  "<body>\n"
-                <<  "<h1>Request count</h1>\n"
-                <<  "<p>There have been "
-                <<  my_program_state::request_count()
-                <<  " requests so far.</p>\n"
-                <<  "</body>\n"
-                <<  "</html>\n";
+            beast::format_to(response_.body(),
+                "<html>\n",
+                "<head><title>Request count</title></head>\n",
+                "<body>\n",
+                "<h1>Request count</h1>\n",
+                "<p>There have been ",
+                my_program_state::request_count(),
+                " requests so far.</p>\n",
+                "</body>\n",
+                "</html>\n");
         }
         else if(request_.target() == "/time")
         {
             response_.set(http::field::content_type, "text/html");
-            beast::ostream(response_.body())
-                <<  "<html>\n"
-                <<  "<head><title>Current time</title></head>\n"
-                <<  "<body>\n"
-                <<  "<h1>Current time</h1>\n"
-                <<  "<p>The current time is "
-                <<  my_program_state::now()
-                <<  " seconds since the epoch.</p>\n"
-                <<  "</body>\n"
-                <<  "</html>\n";
+            beast::format_to(response_.body(),
+                "<html>\n",
+                "<head><title>Current time</title></head>\n",
+                "<body>\n",
+                "<h1>Current time</h1>\n",
+                "<p>The current time is ",
+                my_program_state::now(),
+                " seconds since the epoch.</p>\n",
+                "</body>\n",
+                "</html>\n");
         }
         else
         {
             response_.result(http::status::not_found);
             response_.set(http::field::content_type, "text/plain");
-            beast::ostream(response_.body()) << "File not found\r\n";
+            beast::format_to(response_.body(), "File not found\r\n");
         }
     }
 
@@ -0,0 +1,289 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_CORE_DETAIL_KTLS_HPP
+#define BOOST_BEAST_CORE_DETAIL_KTLS_HPP
+
+#include <boost/beast/core/error.hpp>
+#include <boost/beast/core/detail/type_traits.hpp>
+#include <boost/asio/error.hpp>
+#include <boost/asio/ssl/error.hpp>
+#include <boost/asio/ssl/stream.hpp>
+#include <boost/core/ignore_unused.hpp>
+#include <openssl/kdf.h>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#if defined(__linux__) && defined(__has_include)
+# if __has_include(<linux/tls.h>)
+#  define BOOST_BEAST_HAS_KTLS 1
+# endif
+#endif
+
+#ifndef BOOST_BEAST_HAS_KTLS
+# define BOOST_BEAST_HAS_KTLS 0
+#endif
+
+#if BOOST_BEAST_HAS_KTLS
+# include <linux/tls.h>
+# include <netinet/in.h>
+# include <netinet/tcp.h>
+# include <sys/socket.h>
+# include <sys/uio.h>
+# include <cerrno>
+# ifndef TCP_ULP
+#  define TCP_ULP 31
+# endif
+# ifndef SOL_TLS
+#  define SOL_TLS 282
+# endif
+#endif
+
+namespace boost {
+namespace beast {
+namespace detail {
+
+// The state of one direction of a TLS 1.2
+// connection using AES-GCM, as the kernel needs it.
+struct ktls_crypto
+{
+    std::size_t key_size = 0;   // 16 or 32
+    unsigned char key[32];
+    unsigned char salt[4];      // implicit part of the nonce
+    unsigned char iv[8];        // explicit nonce of the next record
+    unsigned char rec_seq[8];   // sequence number of the next record
+};
+
+// Derive the write state of `ssl`, which must have completed a
+// TLS 1.2 handshake and not sent any application data since.
+// Only the Finished message was sent under the new keys, so
+// the next record has the sequence number one.
+inline
+void
+ktls_write_crypto(
+    SSL* ssl, ktls_crypto& c, error_code& ec)
+{
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+    if(SSL_version(ssl) != TLS1_2_VERSION)
+    {
+        ec = net::error::operation_not_supported;
+        return;
+    }
+    auto const cipher = SSL_get_current_cipher(ssl);
+    if(! cipher)
+    {
+        ec = net::error::operation_not_supported;
+        return;
+    }
+    switch(SSL_CIPHER_get_cipher_nid(cipher))
+    {
+    case NID_aes_128_gcm: c.key_size = 16; break;
+    case NID_aes_256_gcm: c.key_size = 32; break;
+    default:
+        ec = net::error::operation_not_supported;
+        return;
+    }
+
+    unsigned char master[SSL_MAX_MASTER_KEY_LENGTH];
+    auto const master_size = SSL_SESSION_get_master_key(
+        SSL_get_session(ssl), master, sizeof(master));
+
+    // key_block = PRF(master, "key expansion",
+    //     server_random + client_random)
+    unsigned char seed[13 + 2 * SSL3_RANDOM_SIZE];
+    std::memcpy(seed, "key expansion", 13);
+    SSL_get_server_random(ssl, seed + 13, SSL3_RANDOM_SIZE);
+    SSL_get_client_random(ssl,
+        seed + 13 + SSL3_RANDOM_SIZE, SSL3_RANDOM_SIZE);
+
+    // AEAD ciphers have no MAC keys
+    unsigned char block[2 * (32 + 4)];
+    std::size_t const block_size = 2 * (c.key_size + 4);
+    std::size_t n = block_size;
+    auto const pctx = EVP_PKEY_CTX_new_id(EVP_PKEY_TLS1_PRF, nullptr);
+    bool const ok = pctx &&
+        EVP_PKEY_derive_init(pctx) > 0 &&
+        EVP_PKEY_CTX_set_tls1_prf_md(pctx,
+            SSL_CIPHER_get_handshake_digest(cipher)) > 0 &&
+        EVP_PKEY_CTX_set1_tls1_prf_secret(pctx,
+            master, static_cast<int>(master_size)) > 0 &&
+        EVP_PKEY_CTX_add1_tls1_prf_seed(pctx,
+            seed, static_cast<int>(sizeof(seed))) > 0 &&
+        EVP_PKEY_derive(pctx, block, &n) > 0 &&
+        n == block_size;
+    EVP_PKEY_CTX_free(pctx);
+    OPENSSL_cleanse(master, sizeof(master));
+    if(! ok)
+    {
+        ec.assign(static_cast<int>(::ERR_get_error()),
+            net::error::get_ssl_category());
+        if(! ec)
+            ec = net::error::operation_not_supported;
+        OPENSSL_cleanse(block, sizeof(block));
+        return;
+    }
+
+    // client_key, server_key, client_iv, server_iv
+    bool const server = SSL_is_server(ssl) != 0;
+    std::memcpy(c.key,
+        block + (server ? c.key_size : 0), c.key_size);
+    std::memcpy(c.salt,
+        block + 2 * c.key_size + (server ? 4 : 0), 4);
+    OPENSSL_cleanse(block, sizeof(block));
+
+    // Like OpenSSL, use the sequence
+    // number as the explicit nonce.
+    std::memset(c.rec_seq, 0, sizeof(c.rec_seq));
+    c.rec_seq[7] = 1;
+    std::memcpy(c.iv, c.rec_seq, sizeof(c.iv));
+    ec = {};
+#else
+    boost::ignore_unused(ssl, c);
+    ec = net::error::operation_not_supported;
+#endif
+}
+
+// Give the write state to the kernel, which then encrypts
+// everything written to the socket.
+inline
+void
+ktls_enable_send(
+    int fd, ktls_crypto const& c, error_code& ec)
+{
+#if BOOST_BEAST_HAS_KTLS
+    if(::setsockopt(fd, SOL_TCP, TCP_ULP, "tls", sizeof("tls")) != 0)
+    {
+        // ENOENT means the tls module is not available
+        if(errno == ENOENT)
+            ec = net::error::operation_not_supported;
+        else
+            ec.assign(errno, net::error::get_system_category());
+        return;
+    }
+    int rv;
+    if(c.key_size == 16)
+    {
+        tls12_crypto_info_aes_gcm_128 info;
+        std::memset(&info, 0, sizeof(info));
+        info.info.version = TLS_1_2_VERSION;
+        info.info.cipher_type = TLS_CIPHER_AES_GCM_128;
+        std::memcpy(info.key, c.key, sizeof(info.key));
+        std::memcpy(info.salt, c.salt, sizeof(info.salt));
+        std::memcpy(info.iv, c.iv, sizeof(info.iv));
+        std::memcpy(info.rec_seq, c.rec_seq, sizeof(info.rec_seq));
+        rv = ::setsockopt(fd, SOL_TLS, TLS_TX, &info, sizeof(info));
+        OPENSSL_cleanse(&info, sizeof(info));
+    }
+    else
+    {
+        tls12_crypto_info_aes_gcm_256 info;
+        std::memset(&info, 0, sizeof(info));
+        info.info.version = TLS_1_2_VERSION;
+        info.info.cipher_type = TLS_CIPHER_AES_GCM_256;
+        std::memcpy(info.key, c.key, sizeof(info.key));
+        std::memcpy(info.salt, c.salt, sizeof(info.salt));
+        std::memcpy(info.iv, c.iv, sizeof(info.iv));
+        std::memcpy(info.rec_seq, c.rec_seq, sizeof(info.rec_seq));
+        rv = ::setsockopt(fd, SOL_TLS, TLS_TX, &info, sizeof(info));
+        OPENSSL_cleanse(&info, sizeof(info));
+    }
+    if(rv != 0)
+    {
+        ec.assign(errno, net::error::get_system_category());
+        return;
+    }
+    ec = {};
+#else
+    boost::ignore_unused(fd, c);
+    ec = net::error::operation_not_supported;
+#endif
+}
+
+// Send a close_notify alert through the kernel
+inline
+void
+ktls_send_close_notify(int fd, error_code& ec)
+{
+#if BOOST_BEAST_HAS_KTLS
+    unsigned char alert[2] = { 1, 0 }; // warning, close_notify
+    char control[CMSG_SPACE(sizeof(unsigned char))];
+    std::memset(control, 0, sizeof(control));
+    iovec iov;
+    iov.iov_base = alert;
+    iov.iov_len = sizeof(alert);
+    msghdr msg;
+    std::memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    auto const cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_TLS;
+    cmsg->cmsg_type = TLS_SET_RECORD_TYPE;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(unsigned char));
+    *CMSG_DATA(cmsg) = 21; // alert
+    if(::sendmsg(fd, &msg, MSG_NOSIGNAL) < 0)
+    {
+        ec.assign(errno, net::error::get_system_category());
+        return;
+    }
+    ec = {};
+#else
+    boost::ignore_unused(fd);
+    ec = net::error::operation_not_supported;
+#endif
+}
+
+//------------------------------------------------------------------------------
+
+// The native socket handle underneath a next layer
+
+template<class T, class = void>
+struct has_socket_member : std::false_type
+{
+};
+
+template<class T>
+struct has_socket_member<T, void_t<decltype(
+    std::declval<T&>().socket().native_handle())>>
+    : std::true_type
+{
+};
+
+template<class Stream>
+auto
+ktls_native_handle(Stream& s, std::true_type) ->
+    decltype(s.socket().native_handle())
+{
+    return s.socket().native_handle();
+}
+
+template<class Stream>
+auto
+ktls_native_handle(Stream& s, std::false_type) ->
+    decltype(s.native_handle())
+{
+    return s.native_handle();
+}
+
+template<class Stream>
+auto
+ktls_native_handle(Stream& s) ->
+    decltype(ktls_native_handle(s, has_socket_member<Stream>{}))
+{
+    return ktls_native_handle(s, has_socket_member<Stream>{});
+}
+
+} // detail
+} // beast
+} // boost
+
+#endif
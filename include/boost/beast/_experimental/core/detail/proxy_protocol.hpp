@@ -0,0 +1,370 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_CORE_DETAIL_PROXY_PROTOCOL_HPP
+#define BOOST_BEAST_CORE_DETAIL_PROXY_PROTOCOL_HPP
+
+#include <boost/beast/_experimental/core/proxy_protocol_error.hpp>
+#include <boost/beast/core/string.hpp>
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/optional.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace boost {
+namespace beast {
+namespace detail {
+
+// What a PROXY protocol header says about the connection
+struct proxy_header
+{
+    int version = 0;
+    bool local = true;
+    net::ip::tcp::endpoint source;
+    net::ip::tcp::endpoint destination;
+    std::string tlvs;
+};
+
+static std::size_t constexpr proxy_v1_max = 107;
+
+static std::size_t constexpr proxy_v2_min = 16;
+
+inline
+bool
+parse_proxy_port(string_view s, unsigned short& port)
+{
+    if(s.empty() || s.size() > 5)
+        return false;
+    unsigned long v = 0;
+    for(auto c : s)
+    {
+        if(c < '0' || c > '9')
+            return false;
+        v = 10 * v + static_cast<unsigned>(c - '0');
+    }
+    if(v > 65535)
+        return false;
+    port = static_cast<unsigned short>(v);
+    return true;
+}
+
+inline
+bool
+parse_proxy_address(
+    string_view s, bool v6, net::ip::address& addr)
+{
+    // make_address wants a null terminated string
+    char buf[64];
+    if(s.empty() || s.size() >= sizeof(buf))
+        return false;
+    std::memcpy(buf, s.data(), s.size());
+    buf[s.size()] = 0;
+    error_code ec;
+    addr = net::ip::make_address(buf, ec);
+    if(ec)
+        return false;
+    return v6 ? addr.is_v6() : addr.is_v4();
+}
+
+/*  Parse the version 1 header in the first `n` bytes of `p`,
+    which start with "PROXY ".
+
+        PROXY TCP4 192.168.0.1 192.168.0.11 56324 443\r\n
+        PROXY UNKNOWN ...\r\n
+*/
+inline
+std::size_t
+parse_proxy_v1(
+    char const* p, std::size_t n,
+    proxy_header& h, error_code& ec)
+{
+    auto const size = n < proxy_v1_max ? n : proxy_v1_max;
+    char const* eol = nullptr;
+    for(std::size_t i = 1; i < size; ++i)
+    {
+        if(p[i - 1] == '\r' && p[i] == '\n')
+        {
+            eol = p + i - 1;
+            break;
+        }
+    }
+    if(! eol)
+    {
+        if(n < proxy_v1_max)
+            return 0;
+        ec = proxy_protocol_error::bad_header;
+        return 0;
+    }
+    auto const used = static_cast<std::size_t>(eol - p) + 2;
+
+    // Split the fields on single spaces
+    string_view f[6];
+    std::size_t nf = 0;
+    auto first = p;
+    for(auto it = p;; ++it)
+    {
+        if(it != eol && *it != ' ')
+            continue;
+        if(nf == 6)
+        {
+            // too many fields
+            ++nf;
+            break;
+        }
+        f[nf++] = {first, static_cast<std::size_t>(it - first)};
+        if(it == eol)
+            break;
+        first = it + 1;
+    }
+
+    h = proxy_header{};
+    h.version = 1;
+    if(nf >= 2 && f[1] == "UNKNOWN")
+    {
+        // The rest of the line must be ignored
+        ec = {};
+        return used;
+    }
+    bool v6;
+    if(nf == 6 && f[1] == "TCP4")
+        v6 = false;
+    else if(nf == 6 && f[1] == "TCP6")
+        v6 = true;
+    else
+    {
+        ec = proxy_protocol_error::bad_header;
+        return 0;
+    }
+    net::ip::address src;
+    net::ip::address dst;
+    unsigned short src_port;
+    unsigned short dst_port;
+    if( ! parse_proxy_address(f[2], v6, src) ||
+        ! parse_proxy_address(f[3], v6, dst) ||
+        ! parse_proxy_port(f[4], src_port) ||
+        ! parse_proxy_port(f[5], dst_port))
+    {
+        ec = proxy_protocol_error::bad_header;
+        return 0;
+    }
+    h.local = false;
+    h.source = {src, src_port};
+    h.destination = {dst, dst_port};
+    ec = {};
+    return used;
+}
+
+inline
+unsigned short
+proxy_read_u16(unsigned char const* p)
+{
+    return static_cast<unsigned short>((p[0] << 8) | p[1]);
+}
+
+/*  Parse the version 2 header in the first `n` bytes of `p`,
+    which start with the 12 byte signature.
+
+        signature   12 bytes
+        ver_cmd     version in the high nibble, 0 LOCAL or 1 PROXY
+        fam         address family in the high nibble,
+                    0 UNSPEC, 1 INET, 2 INET6 or 3 UNIX
+        len         size of the rest of the header, big endian
+        addresses   source and destination address, then port
+        tlvs        type, big endian 16 bit length, value
+*/
+inline
+std::size_t
+parse_proxy_v2(
+    unsigned char const* p, std::size_t n,
+    proxy_header& h, error_code& ec)
+{
+    if(n < proxy_v2_min)
+        return 0;
+    if((p[12] >> 4) != 2 || (p[12] & 0xf) > 1)
+    {
+        ec = proxy_protocol_error::bad_header;
+        return 0;
+    }
+    auto const used = proxy_v2_min + proxy_read_u16(p + 14);
+    if(n < used)
+        return 0;
+
+    h = proxy_header{};
+    h.version = 2;
+    auto const cmd = p[12] & 0xf;
+    auto it = p + proxy_v2_min;
+    auto const end = p + used;
+
+    // AF_UNSPEC has no addresses, and those of
+    // AF_UNIX connections are not IP endpoints.
+    std::size_t addr_size;
+    switch(p[13] >> 4)
+    {
+    case 0: addr_size = 0; break;
+    case 1: addr_size = 12; break;
+    case 2: addr_size = 36; break;
+    case 3: addr_size = 216; break;
+    default:
+        ec = proxy_protocol_error::bad_header;
+        return 0;
+    }
+    if(static_cast<std::size_t>(end - it) < addr_size)
+    {
+        ec = proxy_protocol_error::bad_header;
+        return 0;
+    }
+
+    // The addresses of LOCAL connections are ignored
+    if(cmd == 1 && addr_size == 12)
+    {
+        net::ip::address_v4::bytes_type src;
+        net::ip::address_v4::bytes_type dst;
+        std::memcpy(src.data(), it, 4);
+        std::memcpy(dst.data(), it + 4, 4);
+        h.source = {net::ip::address_v4(src),
+            proxy_read_u16(it + 8)};
+        h.destination = {net::ip::address_v4(dst),
+            proxy_read_u16(it + 10)};
+        h.local = false;
+    }
+    else if(cmd == 1 && addr_size == 36)
+    {
+        net::ip::address_v6::bytes_type src;
+        net::ip::address_v6::bytes_type dst;
+        std::memcpy(src.data(), it, 16);
+        std::memcpy(dst.data(), it + 16, 16);
+        h.source = {net::ip::address_v6(src),
+            proxy_read_u16(it + 32)};
+        h.destination = {net::ip::address_v6(dst),
+            proxy_read_u16(it + 34)};
+        h.local = false;
+    }
+    it += addr_size;
+
+    // Check that the TLVs fill the rest of the header exactly
+    for(auto t = it; t != end;)
+    {
+        if(end - t < 3 || end - t - 3 < proxy_read_u16(t + 1))
+        {
+            ec = proxy_protocol_error::bad_header;
+            return 0;
+        }
+        t += 3 + proxy_read_u16(t + 1);
+    }
+    h.tlvs.assign(reinterpret_cast<char const*>(it), end - it);
+    ec = {};
+    return used;
+}
+
+/*  Parse the PROXY protocol header at the start of `p`.
+
+    Returns the size of the header, or zero if more bytes are needed.
+    Sets `ec` to proxy_protocol_error::bad_header if the bytes cannot start
+    a header.
+*/
+inline
+std::size_t
+parse_proxy_header(
+    unsigned char const* p, std::size_t n,
+    proxy_header& h, error_code& ec)
+{
+    static char const v1[] = "PROXY ";
+    static char const v2[] = "\r\n\r\n\0\r\nQUIT\n";
+    ec = {};
+    if(n == 0)
+        return 0;
+    if(p[0] == 'P')
+    {
+        auto const m = n < 6 ? n : 6;
+        if(std::memcmp(p, v1, m) != 0)
+        {
+            ec = proxy_protocol_error::bad_header;
+            return 0;
+        }
+        return parse_proxy_v1(
+            reinterpret_cast<char const*>(p), n, h, ec);
+    }
+    auto const m = n < 12 ? n : 12;
+    if(std::memcmp(p, v2, m) != 0)
+    {
+        ec = proxy_protocol_error::bad_header;
+        return 0;
+    }
+    return parse_proxy_v2(p, n, h, ec);
+}
+
+// Find the value of the first TLV of a type
+inline
+boost::optional<string_view>
+find_proxy_tlv(std::string const& tlvs, unsigned char type)
+{
+    auto it = reinterpret_cast<unsigned char const*>(tlvs.data());
+    auto const end = it + tlvs.size();
+    while(it != end)
+    {
+        auto const len = proxy_read_u16(it + 1);
+        if(it[0] == type)
+            return string_view(
+                reinterpret_cast<char const*>(it + 3), len);
+        it += 3 + len;
+    }
+    return boost::none;
+}
+
+// Move `in` to `out`, where both refer to the same memory
+// and `out` starts at or before `in`.
+template<
+    class MutableBufferSequence,
+    class ConstBufferSequence>
+std::size_t
+buffer_move_front(
+    MutableBufferSequence const& out,
+    ConstBufferSequence const& in)
+{
+    std::size_t total = 0;
+    auto out_it = net::buffer_sequence_begin(out);
+    auto const out_end = net::buffer_sequence_end(out);
+    auto in_it = net::buffer_sequence_begin(in);
+    auto const in_end = net::buffer_sequence_end(in);
+    net::mutable_buffer mb;
+    net::const_buffer cb;
+    for(;;)
+    {
+        if(mb.size() == 0)
+        {
+            if(out_it == out_end)
+                break;
+            mb = *out_it++;
+            continue;
+        }
+        if(cb.size() == 0)
+        {
+            if(in_it == in_end)
+                break;
+            cb = *in_it++;
+            continue;
+        }
+        auto const n = mb.size() < cb.size() ?
+            mb.size() : cb.size();
+        std::memmove(mb.data(), cb.data(), n);
+        mb += n;
+        cb += n;
+        total += n;
+    }
+    return total;
+}
+
+} // detail
+} // beast
+} // boost
+
+#endif
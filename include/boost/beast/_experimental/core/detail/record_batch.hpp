@@ -0,0 +1,342 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_CORE_DETAIL_RECORD_BATCH_HPP
+#define BOOST_BEAST_CORE_DETAIL_RECORD_BATCH_HPP
+
+#include <boost/beast/core/async_op_base.hpp>
+#include <boost/beast/core/bind_handler.hpp>
+#include <boost/beast/core/buffer_size.hpp>
+#include <boost/beast/core/error.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/core/stream_traits.hpp>
+#include <boost/asio/async_result.hpp>
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/throw_exception.hpp>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace boost {
+namespace beast {
+namespace detail {
+
+/*  The layer between net::ssl::stream and the socket.
+
+    Normally everything passes straight through. While a batch
+    is held, the records written by the SSL engine are appended
+    to one buffer and their writes complete at once. When told
+    to flush, the next write appends its record and then sends
+    the whole buffer with a single write to the next layer.
+
+    The flushing write happens inside the engine's own write
+    operation, so it is serialized with any records a concurrent
+    read operation has to send.
+*/
+template<class NextLayer>
+class record_batch
+{
+public:
+    enum class mode
+    {
+        pass,
+        hold,
+        flush
+    };
+
+private:
+    NextLayer next_layer_;
+    flat_buffer buffer_;
+    mode mode_ = mode::pass;
+
+    template<class ConstBufferSequence>
+    std::size_t
+    append(ConstBufferSequence const& buffers)
+    {
+        auto const n = buffer_size(buffers);
+        buffer_.commit(net::buffer_copy(
+            buffer_.prepare(n), buffers));
+        return n;
+    }
+
+    // net::write would split the batch
+    // into writes of at most 64KB.
+    void
+    flush(error_code& ec)
+    {
+        auto b = buffer_.data();
+        while(b.size() > 0)
+        {
+            auto const n = next_layer_.write_some(b, ec);
+            if(ec)
+                break;
+            b += n;
+        }
+        buffer_.clear();
+    }
+
+    template<class Handler>
+    class flush_op
+        : public async_op_base<Handler,
+            beast::executor_type<NextLayer>>
+    {
+        record_batch& b_;
+        std::size_t n_;
+
+    public:
+        template<class Handler_>
+        flush_op(
+            Handler_&& h,
+            record_batch& b,
+            std::size_t n)
+            : async_op_base<Handler,
+                beast::executor_type<NextLayer>>(
+                    std::forward<Handler_>(h),
+                    b.get_executor())
+            , b_(b)
+            , n_(n)
+        {
+            b_.next_layer_.async_write_some(
+                b_.buffer_.data(), std::move(*this));
+        }
+
+        void
+        operator()(error_code ec, std::size_t bytes_transferred)
+        {
+            if(! ec)
+            {
+                b_.buffer_.consume(bytes_transferred);
+                if(b_.buffer_.size() > 0)
+                    return b_.next_layer_.async_write_some(
+                        b_.buffer_.data(), std::move(*this));
+            }
+            b_.buffer_.clear();
+            this->invoke_now(ec, ec ? 0 : n_);
+        }
+    };
+
+    struct run_write_op
+    {
+        template<class WriteHandler>
+        void
+        operator()(
+            WriteHandler&& h,
+            record_batch* b,
+            std::size_t n)
+        {
+            if(b->mode_ == mode::flush)
+            {
+                b->mode_ = mode::pass;
+                flush_op<typename std::decay<
+                    WriteHandler>::type>(
+                        std::forward<WriteHandler>(h), *b, n);
+                return;
+            }
+            net::post(b->get_executor(),
+                beast::bind_front_handler(
+                    std::forward<WriteHandler>(h),
+                    error_code{}, n));
+        }
+    };
+
+public:
+    using next_layer_type =
+        typename std::remove_reference<NextLayer>::type;
+
+    using lowest_layer_type =
+        typename next_layer_type::lowest_layer_type;
+
+    using executor_type =
+        beast::executor_type<next_layer_type>;
+
+    template<class... Args>
+    explicit
+    record_batch(Args&&... args)
+        : next_layer_(std::forward<Args>(args)...)
+    {
+    }
+
+    executor_type
+    get_executor() noexcept
+    {
+        return next_layer_.get_executor();
+    }
+
+    next_layer_type&
+    next_layer() noexcept
+    {
+        return next_layer_;
+    }
+
+    next_layer_type const&
+    next_layer() const noexcept
+    {
+        return next_layer_;
+    }
+
+    lowest_layer_type&
+    lowest_layer() noexcept
+    {
+        return next_layer_.lowest_layer();
+    }
+
+    lowest_layer_type const&
+    lowest_layer() const noexcept
+    {
+        return next_layer_.lowest_layer();
+    }
+
+    // Set how the next writes are treated
+    void
+    set_mode(mode m) noexcept
+    {
+        mode_ = m;
+    }
+
+    // Return the number of bytes held
+    std::size_t
+    size() const noexcept
+    {
+        return buffer_.size();
+    }
+
+    // Return the bytes held
+    net::const_buffer
+    data() const noexcept
+    {
+        return buffer_.data();
+    }
+
+    // Drop the bytes held, and go back to passing writes through
+    void
+    reset() noexcept
+    {
+        buffer_.clear();
+        mode_ = mode::pass;
+    }
+
+    // Release the memory used to hold records
+    void
+    shrink_to_fit()
+    {
+        buffer_.shrink_to_fit();
+    }
+
+    template<class MutableBufferSequence>
+    std::size_t
+    read_some(MutableBufferSequence const& buffers)
+    {
+        return next_layer_.read_some(buffers);
+    }
+
+    template<class MutableBufferSequence>
+    std::size_t
+    read_some(
+        MutableBufferSequence const& buffers,
+        error_code& ec)
+    {
+        return next_layer_.read_some(buffers, ec);
+    }
+
+    template<
+        class MutableBufferSequence,
+        class ReadHandler>
+    BOOST_ASIO_INITFN_RESULT_TYPE(
+        ReadHandler, void(error_code, std::size_t))
+    async_read_some(
+        MutableBufferSequence const& buffers,
+        ReadHandler&& handler)
+    {
+        return next_layer_.async_read_some(
+            buffers, std::forward<ReadHandler>(handler));
+    }
+
+    template<class ConstBufferSequence>
+    std::size_t
+    write_some(ConstBufferSequence const& buffers)
+    {
+        error_code ec;
+        auto const n = write_some(buffers, ec);
+        if(ec)
+            BOOST_THROW_EXCEPTION(system_error{ec});
+        return n;
+    }
+
+    template<class ConstBufferSequence>
+    std::size_t
+    write_some(
+        ConstBufferSequence const& buffers,
+        error_code& ec)
+    {
+        if(mode_ == mode::pass)
+            return next_layer_.write_some(buffers, ec);
+        auto const n = append(buffers);
+        ec = {};
+        if(mode_ == mode::flush)
+        {
+            mode_ = mode::pass;
+            flush(ec);
+            if(ec)
+                return 0;
+        }
+        return n;
+    }
+
+    template<
+        class ConstBufferSequence,
+        class WriteHandler>
+    BOOST_ASIO_INITFN_RESULT_TYPE(
+        WriteHandler, void(error_code, std::size_t))
+    async_write_some(
+        ConstBufferSequence const& buffers,
+        WriteHandler&& handler)
+    {
+        if(mode_ == mode::pass)
+            return next_layer_.async_write_some(
+                buffers, std::forward<WriteHandler>(handler));
+        auto const n = append(buffers);
+        return net::async_initiate<
+            WriteHandler,
+            void(error_code, std::size_t)>(
+                run_write_op{},
+                handler,
+                this,
+                n);
+    }
+};
+
+// Return the stream below the batch layer, if there is one
+
+template<class Stream>
+Stream&
+unwrap_batch(Stream& s) noexcept
+{
+    return s;
+}
+
+template<class NextLayer>
+typename record_batch<NextLayer>::next_layer_type&
+unwrap_batch(record_batch<NextLayer>& b) noexcept
+{
+    return b.next_layer();
+}
+
+template<class NextLayer>
+typename record_batch<NextLayer>::next_layer_type const&
+unwrap_batch(record_batch<NextLayer> const& b) noexcept
+{
+    return b.next_layer();
+}
+
+} // detail
+} // beast
+} // boost
+
+#endif
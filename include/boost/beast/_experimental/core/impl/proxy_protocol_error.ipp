@@ -0,0 +1,63 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_CORE_IMPL_PROXY_PROTOCOL_ERROR_IPP
+#define BOOST_BEAST_CORE_IMPL_PROXY_PROTOCOL_ERROR_IPP
+
+#include <boost/beast/_experimental/core/proxy_protocol_error.hpp>
+
+namespace boost {
+namespace beast {
+
+namespace detail {
+
+class proxy_protocol_error_codes : public error_category
+{
+public:
+    BOOST_BEAST_DECL
+    const char*
+    name() const noexcept override
+    {
+        return "boost.beast.proxy_protocol";
+    }
+
+    BOOST_BEAST_DECL
+    std::string
+    message(int ev) const override
+    {
+        switch(static_cast<proxy_protocol_error>(ev))
+        {
+        default:
+        case proxy_protocol_error::bad_header: return
+            "The PROXY protocol header is invalid";
+        }
+    }
+
+    BOOST_BEAST_DECL
+    error_condition
+    default_error_condition(int ev) const noexcept override
+    {
+        return error_condition{ev, *this};
+    }
+};
+
+} // detail
+
+error_code
+make_error_code(proxy_protocol_error e) noexcept
+{
+    static detail::proxy_protocol_error_codes const cat{};
+    return error_code{static_cast<
+        std::underlying_type<proxy_protocol_error>::type>(e), cat};
+}
+
+} // beast
+} // boost
+
+#endif
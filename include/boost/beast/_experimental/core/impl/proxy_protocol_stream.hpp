@@ -0,0 +1,306 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_CORE_IMPL_PROXY_PROTOCOL_STREAM_HPP
+#define BOOST_BEAST_CORE_IMPL_PROXY_PROTOCOL_STREAM_HPP
+
+#include <boost/beast/core/async_op_base.hpp>
+#include <boost/beast/core/buffer_size.hpp>
+#include <boost/beast/core/buffers_prefix.hpp>
+#include <boost/beast/core/buffers_suffix.hpp>
+#include <boost/beast/core/read_size.hpp>
+#include <boost/beast/core/stream_traits.hpp>
+#include <boost/beast/core/detail/type_traits.hpp>
+#include <boost/asio/coroutine.hpp>
+#include <boost/throw_exception.hpp>
+#include <algorithm>
+#include <utility>
+
+namespace boost {
+namespace beast {
+
+template<class NextLayer>
+struct proxy_protocol_stream<NextLayer>::ops
+{
+
+template<class Buffers, class Handler>
+class read_op
+    : public async_op_base<Handler,
+        beast::executor_type<proxy_protocol_stream>>
+    , public net::coroutine
+{
+    proxy_protocol_stream& s_;
+    Buffers b_;
+
+public:
+    template<class Handler_>
+    read_op(
+        Handler_&& h,
+        proxy_protocol_stream& s,
+        Buffers const& b)
+        : async_op_base<Handler,
+            beast::executor_type<proxy_protocol_stream>>(
+                std::forward<Handler_>(h), s.get_executor())
+        , s_(s)
+        , b_(b)
+    {
+        (*this)({}, 0, false);
+    }
+
+    void
+    operator()(
+        error_code ec,
+        std::size_t bytes_transferred,
+        bool cont = true)
+    {
+        BOOST_ASIO_CORO_REENTER(*this)
+        {
+            if(buffer_size(b_) == 0)
+                goto upcall;
+            while(! s_.header_done_)
+            {
+                if(s_.buffer_.size() == 0)
+                {
+                    BOOST_ASIO_CORO_YIELD
+                    s_.stream_.async_read_some(b_, std::move(*this));
+                    if(ec)
+                    {
+                        bytes_transferred = 0;
+                        goto upcall;
+                    }
+                    bytes_transferred = s_.on_read(
+                        b_, bytes_transferred, ec);
+                    if(ec || bytes_transferred > 0)
+                        goto upcall;
+                    continue;
+                }
+                BOOST_ASIO_CORO_YIELD
+                s_.stream_.async_read_some(
+                    s_.buffer_.prepare(read_size(s_.buffer_, 1536)),
+                    std::move(*this));
+                s_.buffer_.commit(bytes_transferred);
+                bytes_transferred = 0;
+                if(ec)
+                    goto upcall;
+                s_.parse(ec);
+                if(ec)
+                    goto upcall;
+            }
+            if(s_.buffer_.size() > 0)
+            {
+                bytes_transferred = s_.drain(b_);
+                goto upcall;
+            }
+            BOOST_ASIO_CORO_YIELD
+            s_.stream_.async_read_some(b_, std::move(*this));
+        upcall:
+            this->invoke(cont, ec, bytes_transferred);
+        }
+    }
+};
+
+struct run_read_op
+{
+    template<class ReadHandler, class Buffers>
+    void
+    operator()(
+        ReadHandler&& h,
+        proxy_protocol_stream* s,
+        Buffers const& b)
+    {
+        // If you get an error on the following line it means
+        // that your handler does not meet the documented type
+        // requirements for the handler.
+
+        static_assert(
+            beast::detail::is_invocable<ReadHandler,
+            void(error_code, std::size_t)>::value,
+            "ReadHandler type requirements not met");
+
+        read_op<
+            Buffers,
+            typename std::decay<ReadHandler>::type>(
+                std::forward<ReadHandler>(h), *s, b);
+    }
+};
+
+};
+
+//------------------------------------------------------------------------------
+
+template<class NextLayer>
+template<class... Args>
+proxy_protocol_stream<NextLayer>::
+proxy_protocol_stream(Args&&... args)
+    : stream_(std::forward<Args>(args)...)
+{
+}
+
+// Called with the first bytes read into the caller's buffers
+template<class NextLayer>
+template<class MutableBufferSequence>
+std::size_t
+proxy_protocol_stream<NextLayer>::
+on_read(
+    MutableBufferSequence const& buffers,
+    std::size_t bytes_transferred,
+    error_code& ec)
+{
+    net::mutable_buffer const b =
+        *net::buffer_sequence_begin(buffers);
+    auto const used = detail::parse_proxy_header(
+        static_cast<unsigned char const*>(b.data()),
+        (std::min)(bytes_transferred, b.size()),
+        header_, ec);
+    if(ec)
+        return 0;
+    if(used == 0)
+    {
+        // The header is incomplete or spans
+        // buffers, gather it in our buffer.
+        buffer_.commit(net::buffer_copy(
+            buffer_.prepare(bytes_transferred),
+            buffers_prefix(bytes_transferred, buffers)));
+        parse(ec);
+        if(ec || ! header_done_)
+            return 0;
+        return drain(buffers);
+    }
+    header_done_ = true;
+    buffers_suffix<MutableBufferSequence> rest(buffers);
+    rest.consume(used);
+    return detail::buffer_move_front(buffers,
+        buffers_prefix(bytes_transferred - used, rest));
+}
+
+template<class NextLayer>
+void
+proxy_protocol_stream<NextLayer>::
+parse(error_code& ec)
+{
+    auto const b = buffer_.data();
+    auto const used = detail::parse_proxy_header(
+        static_cast<unsigned char const*>(b.data()),
+        b.size(), header_, ec);
+    if(ec || used == 0)
+        return;
+    buffer_.consume(used);
+    header_done_ = true;
+}
+
+// Return the bytes which followed the header
+template<class NextLayer>
+template<class MutableBufferSequence>
+std::size_t
+proxy_protocol_stream<NextLayer>::
+drain(MutableBufferSequence const& buffers)
+{
+    auto const n = net::buffer_copy(buffers, buffer_.data());
+    buffer_.consume(n);
+    if(buffer_.size() == 0)
+        buffer_.shrink_to_fit();
+    return n;
+}
+
+template<class NextLayer>
+template<class MutableBufferSequence>
+std::size_t
+proxy_protocol_stream<NextLayer>::
+read_some(MutableBufferSequence const& buffers)
+{
+    static_assert(is_sync_read_stream<next_layer_type>::value,
+        "SyncReadStream type requirements not met");
+    static_assert(net::is_mutable_buffer_sequence<
+        MutableBufferSequence>::value,
+            "MutableBufferSequence type requirements not met");
+    error_code ec;
+    auto n = read_some(buffers, ec);
+    if(ec)
+        BOOST_THROW_EXCEPTION(system_error{ec});
+    return n;
+}
+
+template<class NextLayer>
+template<class MutableBufferSequence>
+std::size_t
+proxy_protocol_stream<NextLayer>::
+read_some(MutableBufferSequence const& buffers, error_code& ec)
+{
+    static_assert(is_sync_read_stream<next_layer_type>::value,
+        "SyncReadStream type requirements not met");
+    static_assert(net::is_mutable_buffer_sequence<
+        MutableBufferSequence>::value,
+            "MutableBufferSequence type requirements not met");
+    if(header_done_ && buffer_.size() == 0)
+        return stream_.read_some(buffers, ec);
+    if(buffer_size(buffers) == 0)
+    {
+        ec = {};
+        return 0;
+    }
+    while(! header_done_)
+    {
+        if(buffer_.size() == 0)
+        {
+            auto const n = stream_.read_some(buffers, ec);
+            if(ec)
+                return 0;
+            auto const bytes_transferred = on_read(buffers, n, ec);
+            if(ec || bytes_transferred > 0)
+                return bytes_transferred;
+            continue;
+        }
+        buffer_.commit(stream_.read_some(
+            buffer_.prepare(read_size(buffer_, 1536)), ec));
+        if(ec)
+            return 0;
+        parse(ec);
+        if(ec)
+            return 0;
+    }
+    if(buffer_.size() > 0)
+    {
+        ec = {};
+        return drain(buffers);
+    }
+    return stream_.read_some(buffers, ec);
+}
+
+template<class NextLayer>
+template<
+    class MutableBufferSequence,
+    class ReadHandler>
+BOOST_ASIO_INITFN_RESULT_TYPE(
+    ReadHandler, void(error_code, std::size_t))
+proxy_protocol_stream<NextLayer>::
+async_read_some(
+    MutableBufferSequence const& buffers,
+    ReadHandler&& handler)
+{
+    static_assert(is_async_read_stream<next_layer_type>::value,
+        "AsyncReadStream type requirements not met");
+    static_assert(net::is_mutable_buffer_sequence<
+            MutableBufferSequence >::value,
+        "MutableBufferSequence type requirements not met");
+    if(header_done_ && buffer_.size() == 0)
+        return stream_.async_read_some(
+            buffers, std::forward<ReadHandler>(handler));
+    return net::async_initiate<
+        ReadHandler,
+        void(error_code, std::size_t)>(
+            typename ops::run_read_op{},
+            handler,
+            this,
+            buffers);
+}
+
+} // beast
+} // boost
+
+#endif
@@ -0,0 +1,35 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_CORE_PROXY_PROTOCOL_ERROR_HPP
+#define BOOST_BEAST_CORE_PROXY_PROTOCOL_ERROR_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/error.hpp>
+
+namespace boost {
+namespace beast {
+
+/// Error codes returned from @ref proxy_protocol_stream operations
+enum class proxy_protocol_error
+{
+    /** The PROXY protocol header is invalid
+
+        This error indicates that the bytes at the start of
+        a connection are not a valid PROXY protocol header.
+    */
+    bad_header = 1
+};
+
+} // beast
+} // boost
+
+#include <boost/beast/_experimental/core/impl/proxy_protocol_error.hpp>
+
+#endif
@@ -0,0 +1,429 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_CORE_PROXY_PROTOCOL_STREAM_HPP
+#define BOOST_BEAST_CORE_PROXY_PROTOCOL_STREAM_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/error.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/core/string.hpp>
+#include <boost/beast/_experimental/core/proxy_protocol_error.hpp>
+#include <boost/beast/_experimental/core/detail/proxy_protocol.hpp>
+#include <boost/asio/async_result.hpp>
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/optional.hpp>
+#include <type_traits>
+
+namespace boost {
+namespace beast {
+
+/** Stream wrapper to receive the PROXY protocol header
+
+    A proxy or load balancer which uses the PROXY protocol sends a
+    header at the start of each connection, carrying the addresses
+    of the client connection it is forwarding. This wrapper removes
+    the header from the data read on the connection, and makes the
+    addresses available to the application. Both the text format
+    (version 1) and the binary format (version 2) are supported,
+    including the type-length-value fields of version 2.
+
+    The header is parsed by the first read. That read goes directly
+    into the caller's buffers, and the header is parsed in place.
+    Whatever follows the header in the same read is moved to the
+    front of the caller's buffers and returned, without another call
+    to the next layer. Only when the header is split across reads,
+    or does not fit in the first of the caller's buffers, are its
+    bytes gathered in a buffer owned by the stream.
+
+    If the connection does not start with a valid header, the read
+    fails with @ref proxy_protocol_error::bad_header. Writes are passed
+    through to the next layer unchanged.
+
+    For asynchronous operations, the application must ensure
+    that they are are all performed within the same implicit
+    or explicit strand.
+
+    @par Thread Safety
+    @e Distinct @e objects: Safe.@n
+    @e Shared @e objects: Unsafe.
+    The application must also ensure that all asynchronous
+    operations are performed within the same implicit or explicit strand.
+
+    @par Example
+
+    To use the @ref proxy_protocol_stream template with an
+    `ip::tcp::socket`, you would write:
+
+    @code
+    proxy_protocol_stream<ip::tcp::socket> ps{io_context};
+    ...
+    http::read(ps, buffer, req);
+    if(! ps.is_local())
+        std::cout << "Client: " << ps.source() << "\n";
+    @endcode
+
+    @tparam NextLayer The type representing the next layer, to which
+    data will be read and written during operations. For synchronous
+    operations, the type must support the @b SyncStream concept.
+    For asynchronous operations, the type must support the
+    @b AsyncStream concept.
+
+    @note A stream object must not be moved or destroyed while there
+    are pending asynchronous operations associated with it.
+
+    @par Concepts
+        @b AsyncStream,
+        @b SyncStream
+
+    @see
+
+    <a href="https://www.haproxy.org/download/1.8/doc/proxy-protocol.txt">The PROXY protocol</a>
+*/
+template<class NextLayer>
+class proxy_protocol_stream
+{
+    struct ops;
+
+    NextLayer stream_;
+    flat_buffer buffer_;
+    detail::proxy_header header_;
+    bool header_done_ = false;
+
+    template<class MutableBufferSequence>
+    std::size_t
+    on_read(
+        MutableBufferSequence const& buffers,
+        std::size_t bytes_transferred,
+        error_code& ec);
+
+    void
+    parse(error_code& ec);
+
+    template<class MutableBufferSequence>
+    std::size_t
+    drain(MutableBufferSequence const& buffers);
+
+public:
+    /// The type of the next layer.
+    using next_layer_type =
+        typename std::remove_reference<NextLayer>::type;
+
+    /// The type of the executor associated with the object.
+    using executor_type = typename next_layer_type::executor_type;
+
+    proxy_protocol_stream(proxy_protocol_stream&&) = default;
+    proxy_protocol_stream& operator=(proxy_protocol_stream&&) = default;
+
+    /** Destructor
+
+        The treatment of pending operations will be the same as that
+        of the next layer.
+    */
+    ~proxy_protocol_stream() = default;
+
+    /** Constructor
+
+        Arguments, if any, are forwarded to the next layer's constructor.
+    */
+    template<class... Args>
+    explicit
+    proxy_protocol_stream(Args&&... args);
+
+    //--------------------------------------------------------------------------
+
+    /** Get the executor associated with the object.
+
+        This function may be used to obtain the executor object that the
+        stream uses to dispatch handlers for asynchronous operations.
+
+        @return A copy of the executor that stream will use to dispatch handlers.
+    */
+    executor_type
+    get_executor() noexcept
+    {
+        return stream_.get_executor();
+    }
+
+    /** Get a reference to the next layer
+
+        This function returns a reference to the next layer
+        in a stack of stream layers.
+
+        @return A reference to the next layer in the stack of
+        stream layers.
+    */
+    next_layer_type&
+    next_layer()
+    {
+        return stream_;
+    }
+
+    /** Get a reference to the next layer
+
+        This function returns a reference to the next layer in a
+        stack of stream layers.
+
+        @return A reference to the next layer in the stack of
+        stream layers.
+    */
+    next_layer_type const&
+    next_layer() const
+    {
+        return stream_;
+    }
+
+    //--------------------------------------------------------------------------
+
+    /// Returns `true` if the header has been received
+    bool
+    is_header_done() const noexcept
+    {
+        return header_done_;
+    }
+
+    /** Returns the version of the header received
+
+        @return `1` or `2`, or `0` if the header has not been received.
+    */
+    int
+    version() const noexcept
+    {
+        return header_.version;
+    }
+
+    /** Returns `true` if the header carries no client addresses
+
+        This happens when the proxy opened the connection on its
+        own behalf, for example for a health check, or when it does
+        not know the addresses or they are not IP addresses. In these
+        cases @ref source and @ref destination are unspecified, and
+        the endpoints of the connection itself should be used.
+    */
+    bool
+    is_local() const noexcept
+    {
+        return header_.local;
+    }
+
+    /// Returns the address of the client which connected to the proxy
+    net::ip::tcp::endpoint const&
+    source() const noexcept
+    {
+        return header_.source;
+    }
+
+    /// Returns the address on the proxy that the client connected to
+    net::ip::tcp::endpoint const&
+    destination() const noexcept
+    {
+        return header_.destination;
+    }
+
+    /** Returns the value of a type-length-value field
+
+        Version 2 headers may carry extra information about the
+        connection in fields identified by a one byte type, such
+        as the ALPN (0x01), the authority (0x02) or the unique ID
+        (0x05) of the connection.
+
+        @param type The type of the field.
+
+        @return The value of the first field of the given type,
+        or `boost::none` if there is no such field.
+    */
+    boost::optional<string_view>
+    tlv(unsigned char type) const
+    {
+        return detail::find_proxy_tlv(header_.tlvs, type);
+    }
+
+    //--------------------------------------------------------------------------
+
+    /** Read some data from the stream.
+
+        This function is used to read data from the stream. The function call will
+        block until one or more bytes of data has been read successfully, or until
+        an error occurs. The first read also receives the header.
+
+        @param buffers The buffers into which the data will be read.
+
+        @returns The number of bytes read.
+
+        @throws system_error Thrown on failure.
+
+        @note The `read_some` operation may not read all of the requested number of
+        bytes. Consider using the function `net::read` if you need to ensure
+        that the requested amount of data is read before the blocking operation
+        completes.
+    */
+    template<class MutableBufferSequence>
+    std::size_t
+    read_some(MutableBufferSequence const& buffers);
+
+    /** Read some data from the stream.
+
+        This function is used to read data from the stream. The function call will
+        block until one or more bytes of data has been read successfully, or until
+        an error occurs. The first read also receives the header.
+
+        @param buffers The buffers into which the data will be read.
+
+        @param ec Set to indicate what error occurred, if any.
+
+        @returns The number of bytes read.
+
+        @note The `read_some` operation may not read all of the requested number of
+        bytes. Consider using the function `net::read` if you need to ensure
+        that the requested amount of data is read before the blocking operation
+        completes.
+    */
+    template<class MutableBufferSequence>
+    std::size_t
+    read_some(
+        MutableBufferSequence const& buffers,
+        error_code& ec);
+
+    /** Start an asynchronous read.
+
+        This function is used to asynchronously read one or more bytes of data from
+        the stream. The function call always returns immediately. The first read
+        also receives the header.
+
+        @param buffers The buffers into which the data will be read. Although the
+        buffers object may be copied as necessary, ownership of the underlying
+        buffers is retained by the caller, which must guarantee that they remain
+        valid until the handler is called.
+
+        @param handler The completion handler to invoke when the operation
+        completes. The implementation takes ownership of the handler by
+        performing a decay-copy. The equivalent function signature of
+        the handler must be:
+
+        @code void handler(
+          const boost::system::error_code& error, // Result of operation.
+          std::size_t bytes_transferred           // Number of bytes read.
+        ); @endcode
+
+        Regardless of whether the asynchronous operation completes
+        immediately or not, the handler will not be invoked from within
+        this function. Invocation of the handler will be performed in a
+        manner equivalent to using `net::post`.
+
+        @note The `async_read_some` operation may not read all of the requested number of
+        bytes. Consider using the function `net::async_read` if you need
+        to ensure that the requested amount of data is read before the asynchronous
+        operation completes.
+    */
+    template<
+        class MutableBufferSequence,
+        class ReadHandler>
+    BOOST_ASIO_INITFN_RESULT_TYPE(
+        ReadHandler, void(error_code, std::size_t))
+    async_read_some(
+        MutableBufferSequence const& buffers,
+        ReadHandler&& handler);
+
+    /** Write some data to the stream.
+
+        This function is used to write data on the stream. The function call will
+        block until one or more bytes of data has been written successfully, or
+        until an error occurs.
+
+        @param buffers The data to be written.
+
+        @returns The number of bytes written.
+
+        @throws system_error Thrown on failure.
+
+        @note The `write_some` operation may not transmit all of the data to the
+        peer. Consider using the function `net::write` if you need to
+        ensure that all data is written before the blocking operation completes.
+    */
+    template<class ConstBufferSequence>
+    std::size_t
+    write_some(ConstBufferSequence const& buffers)
+    {
+        return stream_.write_some(buffers);
+    }
+
+    /** Write some data to the stream.
+
+        This function is used to write data on the stream. The function call will
+        block until one or more bytes of data has been written successfully, or
+        until an error occurs.
+
+        @param buffers The data to be written.
+
+        @param ec Set to indicate what error occurred, if any.
+
+        @returns The number of bytes written.
+
+        @note The `write_some` operation may not transmit all of the data to the
+        peer. Consider using the function `net::write` if you need to
+        ensure that all data is written before the blocking operation completes.
+    */
+    template<class ConstBufferSequence>
+    std::size_t
+    write_some(
+        ConstBufferSequence const& buffers,
+        error_code& ec)
+    {
+        return stream_.write_some(buffers, ec);
+    }
+
+    /** Start an asynchronous write.
+
+        This function is used to asynchronously write one or more bytes of data to
+        the stream. The function call always returns immediately.
+
+        @param buffers The data to be written to the stream. Although the buffers
+        object may be copied as necessary, ownership of the underlying buffers is
+        retained by the caller, which must guarantee that they remain valid until
+        the handler is called.
+
+        @param handler The completion handler to invoke when the operation
+        completes. The implementation takes ownership of the handler by
+        performing a decay-copy. The equivalent function signature of
+        the handler must be:
+
+        @code void handler(
+          const boost::system::error_code& error, // Result of operation.
+          std::size_t bytes_transferred           // Number of bytes written.
+        ); @endcode
+        Regardless of whether the asynchronous operation completes
+        immediately or not, the handler will not be invoked from within
+        this function. Invocation of the handler will be performed in a
+        manner equivalent to using `net::post`.
+
+        @note The `async_write_some` operation may not transmit all of the data to
+        the peer. Consider using the function `net::async_write` if you need
+        to ensure that all data is written before the asynchronous operation completes.
+    */
+    template<
+        class ConstBufferSequence,
+        class WriteHandler>
+    BOOST_ASIO_INITFN_RESULT_TYPE(
+        WriteHandler, void(error_code, std::size_t))
+    async_write_some(
+        ConstBufferSequence const& buffers,
+        WriteHandler&& handler)
+    {
+        return stream_.async_write_some(
+            buffers, std::forward<WriteHandler>(handler));
+    }
+};
+
+} // beast
+} // boost
+
+#include <boost/beast/_experimental/core/impl/proxy_protocol_stream.hpp>
+
+#endif
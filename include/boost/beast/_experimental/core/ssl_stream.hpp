@@ -15,8 +15,17 @@
 // This include is necessary to work with `ssl::stream` and `boost::beast::websocket::stream`
 #include <boost/beast/websocket/ssl.hpp>
 
+#include <boost/beast/_experimental/core/detail/ktls.hpp>
+#include <boost/beast/_experimental/core/detail/record_batch.hpp>
+#include <boost/beast/core/async_op_base.hpp>
+#include <boost/beast/core/buffer_size.hpp>
+#include <boost/beast/core/buffers_prefix.hpp>
+#include <boost/beast/core/buffers_suffix.hpp>
 #include <boost/beast/core/flat_stream.hpp>
+#include <boost/asio/coroutine.hpp>
 #include <boost/asio/ssl/stream.hpp>
+#include <boost/assert.hpp>
+#include <boost/throw_exception.hpp>
 #include <cstddef>
 #include <memory>
 #include <type_traits>
@@ -55,7 +64,26 @@ namespace beast {
 
     @li Uses @ref flat_stream internally, as a performance work-around for a
         limitation of `net::ssl::stream` when writing buffer sequences
-        having length greater than one.
+        having length greater than one. No more is flattened than fits
+        in one record, as limited by a negotiated maximum fragment length.
+
+    @li Can hand the encryption of outgoing data to the kernel, see
+        @ref enable_ktls_send.
+
+    @li Can send several records with each write on the next layer,
+        when `BatchWrites` is `true`, see @ref write_batch_bytes.
+
+    @tparam NextLayer The type representing the next layer, to which
+    data will be read and written during operations. For synchronous
+    operations, the type must support the <em>SyncStream</em> concept.
+    For asynchronous operations, the type must support the
+    <em>AsyncStream</em> concept. This type will usually be some
+    variation of `net::ip::tcp::socket`.
+
+    @tparam BatchWrites If `true`, a layer which can hold the records
+    produced by the SSL engine is inserted below `net::ssl::stream`,
+    and @ref write_batch_bytes may be used. The default is `false`,
+    and the SSL engine writes directly to the next layer.
 
     @par Concepts:
         @li AsyncReadStream
@@ -64,14 +92,181 @@ namespace beast {
         @li SyncReadStream
         @li SyncWriteStream
 */
-template<class NextLayer>
+template<class NextLayer, bool BatchWrites = false>
 class ssl_stream
     : public net::ssl::stream_base
 {
-    using ssl_stream_type = net::ssl::stream<NextLayer>;
+    // The layer below the SSL engine
+    using batch_type = typename std::conditional<BatchWrites,
+        detail::record_batch<NextLayer>, NextLayer>::type;
+    using ssl_stream_type = net::ssl::stream<batch_type>;
     using stream_type = boost::beast::flat_stream<ssl_stream_type>;
 
+    template<class Handler, class Buffers>
+    class batch_write_op;
+
+    struct run_batch_write_op
+    {
+        template<class WriteHandler, class Buffers>
+        void
+        operator()(
+            WriteHandler&& h,
+            ssl_stream* s,
+            Buffers const& b)
+        {
+            batch_write_op<
+                typename std::decay<WriteHandler>::type,
+                Buffers>(std::forward<WriteHandler>(h), *s, b);
+        }
+    };
+
     std::unique_ptr<stream_type> p_;
+    std::size_t batch_limit_ = 0;
+    bool ktls_send_ = false;
+
+    batch_type&
+    batch() noexcept
+    {
+        return p_->next_layer().next_layer();
+    }
+
+    // Send close_notify through the kernel, OpenSSL
+    // only waits for the one sent by the peer.
+    void
+    ktls_close_notify(boost::system::error_code& ec)
+    {
+        auto const ssl = native_handle();
+        auto const state = SSL_get_shutdown(ssl);
+        if(state & SSL_SENT_SHUTDOWN)
+            return;
+        detail::ktls_send_close_notify(static_cast<int>(
+            detail::ktls_native_handle(next_layer())), ec);
+        SSL_set_shutdown(ssl, state | SSL_SENT_SHUTDOWN);
+    }
+
+    // OpenSSL writes one record per call, flattening
+    // more than a record holds would only be copied again.
+    void
+    update_limit()
+    {
+        std::size_t limit = detail::flat_stream_base::max_size;
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+        if(auto const session = SSL_get_session(native_handle()))
+        {
+            auto const mode =
+                SSL_SESSION_get_max_fragment_length(session);
+            if( mode >= TLSEXT_max_fragment_length_512 &&
+                mode <= TLSEXT_max_fragment_length_4096)
+                limit = std::size_t{512} << (mode - 1);
+        }
+#endif
+        p_->flatten_limit(limit);
+    }
+
+    bool
+    can_batch() noexcept
+    {
+        return batch_limit_ > 0 &&
+            ! SSL_renegotiate_pending(native_handle());
+    }
+
+    // How to treat the record for the next write
+    // of the plaintext in `buffers`.
+    template<class ConstBufferSequence>
+    typename detail::record_batch<NextLayer>::mode
+    batch_mode(ConstBufferSequence const& buffers)
+    {
+        // room for the record header and trailer
+        std::size_t constexpr overhead = 1024;
+        auto const limit = p_->flatten_limit();
+        if( buffer_size(buffers) <= limit ||
+            batch().size() + limit + overhead >= batch_limit_)
+            return batch_type::mode::flush;
+        return batch_type::mode::hold;
+    }
+
+    template<class ConstBufferSequence>
+    std::size_t
+    batch_write_some(
+        ConstBufferSequence const& buffers,
+        boost::system::error_code& ec)
+    {
+        buffers_suffix<ConstBufferSequence> cb(buffers);
+        std::size_t total = 0;
+        do
+        {
+            // At most one record per call, so data is always
+            // left for the write which flushes the batch.
+            batch().set_mode(batch_mode(cb));
+            auto const n = p_->write_some(
+                beast::buffers_prefix(p_->flatten_limit(), cb), ec);
+            if(ec)
+            {
+                batch().reset();
+                return 0;
+            }
+            cb.consume(n);
+            total += n;
+        }
+        while(batch().size() > 0 && buffer_size(cb) > 0);
+        BOOST_ASSERT(batch().size() == 0);
+        batch().set_mode(batch_type::mode::pass);
+        return total;
+    }
+
+    template<class ConstBufferSequence>
+    std::size_t
+    write_records(
+        ConstBufferSequence const& buffers,
+        boost::system::error_code& ec,
+        std::true_type)
+    {
+        if(can_batch())
+            return batch_write_some(buffers, ec);
+        return p_->write_some(buffers, ec);
+    }
+
+    template<class ConstBufferSequence>
+    std::size_t
+    write_records(
+        ConstBufferSequence const& buffers,
+        boost::system::error_code& ec,
+        std::false_type)
+    {
+        return p_->write_some(buffers, ec);
+    }
+
+    template<class ConstBufferSequence, class WriteHandler>
+    BOOST_ASIO_INITFN_RESULT_TYPE(WriteHandler,
+        void(boost::system::error_code, std::size_t))
+    async_write_records(
+        ConstBufferSequence const& buffers,
+        WriteHandler&& handler,
+        std::true_type)
+    {
+        if(can_batch())
+            return net::async_initiate<
+                WriteHandler,
+                void(boost::system::error_code, std::size_t)>(
+                    run_batch_write_op{},
+                    handler,
+                    this,
+                    buffers);
+        return p_->async_write_some(buffers,
+            std::forward<WriteHandler>(handler));
+    }
+
+    template<class ConstBufferSequence, class WriteHandler>
+    BOOST_ASIO_INITFN_RESULT_TYPE(WriteHandler,
+        void(boost::system::error_code, std::size_t))
+    async_write_records(
+        ConstBufferSequence const& buffers,
+        WriteHandler&& handler,
+        std::false_type)
+    {
+        return p_->async_write_some(buffers,
+            std::forward<WriteHandler>(handler));
+    }
 
 public:
     /// The native handle type of the SSL stream.
@@ -82,7 +277,8 @@ public:
     using impl_struct = typename ssl_stream_type::impl_struct;
 
     /// The type of the next layer.
-    using next_layer_type = typename ssl_stream_type::next_layer_type;
+    using next_layer_type =
+        typename std::remove_reference<NextLayer>::type;
 
     /// The type of the executor associated with the object.
     using executor_type = typename stream_type::executor_type;
@@ -162,7 +358,8 @@ public:
     next_layer_type const&
     next_layer() const noexcept
     {
-        return p_->next_layer().next_layer();
+        return detail::unwrap_batch(
+            p_->next_layer().next_layer());
     }
 
     /** Get a reference to the next layer.
@@ -179,7 +376,8 @@ public:
     next_layer_type&
     next_layer() noexcept
     {
-        return p_->next_layer().next_layer();
+        return detail::unwrap_batch(
+            p_->next_layer().next_layer());
     }
 
     /** Set the peer verification mode.
@@ -446,7 +644,10 @@ public:
     void
     shutdown()
     {
-        p_->next_layer().shutdown();
+        boost::system::error_code ec;
+        shutdown(ec);
+        if(ec)
+            BOOST_THROW_EXCEPTION(boost::system::system_error{ec});
     }
 
     /** Shut down SSL on the stream.
@@ -459,6 +660,12 @@ public:
     void
     shutdown(boost::system::error_code& ec)
     {
+        if(ktls_send_)
+        {
+            ktls_close_notify(ec);
+            if(ec)
+                return;
+        }
         p_->next_layer().shutdown(ec);
     }
 
@@ -479,10 +686,104 @@ public:
         void(boost::system::error_code))
     async_shutdown(BOOST_ASIO_MOVE_ARG(ShutdownHandler) handler)
     {
+        if(ktls_send_)
+        {
+            // A failure shows up again when
+            // reading the peer's close_notify.
+            boost::system::error_code ec;
+            ktls_close_notify(ec);
+        }
         return p_->next_layer().async_shutdown(
             BOOST_ASIO_MOVE_CAST(ShutdownHandler)(handler));
     }
 
+    /** Offload the encryption of outgoing data to the kernel.
+
+        This function gives the keys negotiated by the handshake to
+        the operating system, using the kernel TLS module on Linux.
+        On success, data written to the stream is sent directly on
+        the next layer, and the kernel encrypts it. This removes a
+        copy and the encryption from the writing thread, and allows
+        the native socket handle to be used with `sendfile` for the
+        rest of the connection. Reading is not affected.
+
+        Currently this is supported for TLS 1.2 connections using
+        an AES-GCM cipher suite. When the offload is not possible,
+        the error is `net::error::operation_not_supported` and the
+        stream keeps working as before, so the call may be made
+        unconditionally.
+
+        @param ec Set to indicate what error occurred, if any.
+
+        @note This must be called after the handshake completes and
+        before any data is written. The peer must not request a
+        renegotiation afterwards.
+    */
+    void
+    enable_ktls_send(boost::system::error_code& ec)
+    {
+        auto const ssl = native_handle();
+        detail::ktls_crypto c;
+        detail::ktls_write_crypto(ssl, c, ec);
+        if(! ec)
+            detail::ktls_enable_send(static_cast<int>(
+                detail::ktls_native_handle(next_layer())), c, ec);
+        OPENSSL_cleanse(&c, sizeof(c));
+        if(ec)
+            return;
+    #ifdef SSL_OP_NO_RENEGOTIATION
+        // OpenSSL cannot write records anymore
+        SSL_set_options(ssl, SSL_OP_NO_RENEGOTIATION);
+    #endif
+        ktls_send_ = true;
+    }
+
+    /// Returns `true` if the kernel encrypts outgoing data
+    bool
+    is_ktls_send() const noexcept
+    {
+        return ktls_send_;
+    }
+
+    /** Set the number of bytes of records to batch in one write.
+
+        Without batching, each TLS record of at most 16KB of data
+        is sent on the next layer with its own write. When this is
+        set to a non-zero amount, a write of a large buffer sequence
+        encrypts records until about this many bytes are produced
+        or the data runs out, and then sends them all with a single
+        write on the next layer. This cuts the number of system calls
+        for bulk transfers, at the cost of copying the encrypted
+        records once and holding up to this many bytes per stream.
+
+        Nothing is held beyond the operation which produced it.
+        The write completes only after its records were written to
+        the next layer, so latency is bounded by the batch size.
+
+        @param amount The number of bytes to batch, or zero to send
+        every record on its own. The default is zero.
+
+        @note This is only available when `BatchWrites` is `true`.
+        Batching is not used while a renegotiation is pending, or
+        when @ref enable_ktls_send succeeded.
+    */
+    void
+    write_batch_bytes(std::size_t amount)
+    {
+        static_assert(BatchWrites,
+            "write_batch_bytes requires BatchWrites");
+        batch_limit_ = amount;
+        if(amount == 0)
+            batch().shrink_to_fit();
+    }
+
+    /// Returns the number of bytes of records batched in one write
+    std::size_t
+    write_batch_bytes() const noexcept
+    {
+        return batch_limit_;
+    }
+
     /** Write some data to the stream.
 
         This function is used to write data on the stream. The function call will
@@ -503,7 +804,11 @@ public:
     std::size_t
     write_some(ConstBufferSequence const& buffers)
     {
-        return p_->write_some(buffers);
+        boost::system::error_code ec;
+        auto const n = write_some(buffers, ec);
+        if(ec)
+            BOOST_THROW_EXCEPTION(boost::system::system_error{ec});
+        return n;
     }
 
     /** Write some data to the stream.
@@ -527,7 +832,11 @@ public:
     write_some(ConstBufferSequence const& buffers,
         boost::system::error_code& ec)
     {
-        return p_->write_some(buffers, ec);
+        if(ktls_send_)
+            return next_layer().write_some(buffers, ec);
+        update_limit();
+        return write_records(buffers, ec,
+            std::integral_constant<bool, BatchWrites>{});
     }
 
     /** Start an asynchronous write.
@@ -559,8 +868,13 @@ public:
     async_write_some(ConstBufferSequence const& buffers,
         BOOST_ASIO_MOVE_ARG(WriteHandler) handler)
     {
-        return p_->async_write_some(buffers,
-            BOOST_ASIO_MOVE_CAST(WriteHandler)(handler));
+        if(ktls_send_)
+            return next_layer().async_write_some(buffers,
+                BOOST_ASIO_MOVE_CAST(WriteHandler)(handler));
+        update_limit();
+        return async_write_records(buffers,
+            BOOST_ASIO_MOVE_CAST(WriteHandler)(handler),
+            std::integral_constant<bool, BatchWrites>{});
     }
 
     /** Read some data from the stream.
@@ -646,15 +960,70 @@ public:
     }
 };
 
+#if ! BOOST_BEAST_DOXYGEN
+template<class NextLayer, bool BatchWrites>
+template<class Handler, class Buffers>
+class ssl_stream<NextLayer, BatchWrites>::batch_write_op
+    : public async_op_base<Handler, executor_type>
+    , public net::coroutine
+{
+    ssl_stream& s_;
+    buffers_suffix<Buffers> cb_;
+    std::size_t total_ = 0;
+
+public:
+    template<class Handler_>
+    batch_write_op(
+        Handler_&& h,
+        ssl_stream& s,
+        Buffers const& b)
+        : async_op_base<Handler, executor_type>(
+            std::forward<Handler_>(h), s.get_executor())
+        , s_(s)
+        , cb_(b)
+    {
+        (*this)({}, 0);
+    }
+
+    void
+    operator()(
+        boost::system::error_code ec,
+        std::size_t bytes_transferred)
+    {
+        BOOST_ASIO_CORO_REENTER(*this)
+        {
+            do
+            {
+                s_.batch().set_mode(s_.batch_mode(cb_));
+                BOOST_ASIO_CORO_YIELD
+                s_.p_->async_write_some(beast::buffers_prefix(
+                    s_.p_->flatten_limit(), cb_), std::move(*this));
+                if(ec)
+                {
+                    s_.batch().reset();
+                    return this->invoke_now(ec, 0);
+                }
+                cb_.consume(bytes_transferred);
+                total_ += bytes_transferred;
+            }
+            while(s_.batch().size() > 0 && buffer_size(cb_) > 0);
+            BOOST_ASSERT(s_.batch().size() == 0);
+            s_.batch().set_mode(batch_type::mode::pass);
+            this->invoke_now(ec, total_);
+        }
+    }
+};
+#endif
+
 // These hooks are used to inform boost::beast::websocket::stream on
 // how to tear down the connection as part of the WebSocket
 // protocol specifications
 #if ! BOOST_BEAST_DOXYGEN
-template<class SyncStream>
+template<class SyncStream, bool BatchWrites>
 void
 teardown(
     boost::beast::websocket::role_type role,
-    ssl_stream<SyncStream>& stream,
+    ssl_stream<SyncStream, BatchWrites>& stream,
     boost::system::error_code& ec)
 {
     // Just forward it to the wrapped stream
@@ -662,11 +1031,11 @@ teardown(
     teardown(role, stream.next_layer(), ec);
 }
 
-template<class AsyncStream, class TeardownHandler>
+template<class AsyncStream, bool BatchWrites, class TeardownHandler>
 void
 async_teardown(
     boost::beast::websocket::role_type role,
-    ssl_stream<AsyncStream>& stream,
+    ssl_stream<AsyncStream, BatchWrites>& stream,
     TeardownHandler&& handler)
 {
     // Just forward it to the wrapped stream
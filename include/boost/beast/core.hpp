@@ -18,11 +18,13 @@
 #include <boost/beast/core/buffer_traits.hpp>
 #include <boost/beast/core/buffered_read_stream.hpp>
 #include <boost/beast/core/buffers_adaptor.hpp>
+#include <boost/beast/core/buffers_array.hpp>
 #include <boost/beast/core/buffers_cat.hpp>
 #include <boost/beast/core/buffers_prefix.hpp>
 #include <boost/beast/core/buffers_range.hpp>
 #include <boost/beast/core/buffers_suffix.hpp>
 #include <boost/beast/core/buffers_to_string.hpp>
+#include <boost/beast/core/detect_protocol.hpp>
 #include <boost/beast/core/detect_ssl.hpp>
 #include <boost/beast/core/dynamic_buffer_ref.hpp>
 #include <boost/beast/core/error.hpp>
@@ -34,19 +36,26 @@
 #include <boost/beast/core/flat_buffer.hpp>
 #include <boost/beast/core/flat_static_buffer.hpp>
 #include <boost/beast/core/flat_stream.hpp>
+#include <boost/beast/core/format.hpp>
+#include <boost/beast/core/growth_policy.hpp>
 #include <boost/beast/core/handler_ptr.hpp>
 #include <boost/beast/core/make_printable.hpp>
 #include <boost/beast/core/make_strand.hpp>
+#include <boost/beast/core/metrics_policy.hpp>
+#include <boost/beast/core/mirrored_ring_buffer.hpp>
 #include <boost/beast/core/multi_buffer.hpp>
 #include <boost/beast/core/ostream.hpp>
 #include <boost/beast/core/rate_policy.hpp>
 #include <boost/beast/core/read_size.hpp>
+#include <boost/beast/core/slab_allocator.hpp>
 #include <boost/beast/core/span.hpp>
+#include <boost/beast/core/spsc_buffer.hpp>
 #include <boost/beast/core/static_buffer.hpp>
 #include <boost/beast/core/static_string.hpp>
 #include <boost/beast/core/stream_traits.hpp>
 #include <boost/beast/core/string.hpp>
 #include <boost/beast/core/string_param.hpp>
 #include <boost/beast/core/tcp_stream.hpp>
+#include <boost/beast/core/timeout_wheel.hpp>
 
 #endif
@@ -13,8 +13,10 @@
 #include <boost/beast/core/detail/config.hpp>
 #include <boost/beast/core/detail/stream_base.hpp>
 #include <boost/beast/core/error.hpp>
+#include <boost/beast/core/metrics_policy.hpp>
 #include <boost/beast/core/rate_policy.hpp>
 #include <boost/beast/core/stream_traits.hpp>
+#include <boost/beast/core/timeout_wheel.hpp>
 #include <boost/beast/websocket/role.hpp> // VFALCO This is unfortunate
 #include <boost/asio/async_result.hpp>
 #include <boost/asio/basic_stream_socket.hpp>
@@ -25,6 +27,7 @@
 #include <boost/config/workaround.hpp>
 #include <boost/enable_shared_from_this.hpp>
 #include <boost/shared_ptr.hpp>
+#include <boost/throw_exception.hpp>
 #include <chrono>
 #include <limits>
 #include <memory>
@@ -173,6 +176,15 @@ namespace beast {
     `net::basic_stream_socket`. Timeouts are not available when performing
     blocking calls.
 
+    @par Metrics
+
+    The metrics policy is told about each read and write performed on
+    the socket, the time spent waiting for it and for the rate policy,
+    the time spent in completion handlers, and each timeout. The default
+    @ref null_metrics_policy records nothing and costs nothing, while
+    @ref simple_metrics_policy counts the I/O of the stream and can add
+    it to a @ref metrics_registry shared by many streams.
+
     @tparam Protocol A type meeting the requirements of <em>Protocol</em>
     representing the protocol the protocol to use for the basic stream socket.
     A common choice is `net::ip::tcp`.
@@ -182,6 +194,14 @@ namespace beast {
     associated executor. If this type is omitted, the default of `net::executor`
     will be used.
 
+    @tparam RatePolicy A type meeting the requirements of <em>RatePolicy</em>
+    used to limit the bandwidth of reads and writes. The default of
+    @ref unlimited_rate_policy places no limits.
+
+    @tparam MetricsPolicy A type meeting the requirements of
+    <em>MetricsPolicy</em> used to record the I/O performed by the stream.
+    The default of @ref null_metrics_policy records nothing.
+
     @par Thread Safety
     <em>Distinct objects</em>: Safe.@n
     <em>Shared objects</em>: Unsafe. The application must also ensure
@@ -195,7 +215,8 @@ namespace beast {
 template<
     class Protocol,
     class Executor = net::executor,
-    class RatePolicy = unlimited_rate_policy
+    class RatePolicy = unlimited_rate_policy,
+    class MetricsPolicy = null_metrics_policy
 >
 class basic_stream
 #if ! BOOST_BEAST_DOXYGEN
@@ -227,11 +248,15 @@ private:
     struct impl_type
         : boost::enable_shared_from_this<impl_type>
         , boost::empty_value<RatePolicy>
+        , boost::empty_value<MetricsPolicy, 1>
     {
         // must come first
         net::basic_stream_socket<
             Protocol, Executor> socket;
 
+        // must outlive the entries in read and write
+        boost::shared_ptr<detail::timeout_wheel_impl> wheel;
+
         op_state read;
         op_state write;
         net::steady_timer timer; // rate timer
@@ -268,9 +293,28 @@ private:
             return this->boost::empty_value<RatePolicy>::get();
         }
 
+        MetricsPolicy&
+        metrics() noexcept
+        {
+            return this->boost::empty_value<MetricsPolicy, 1>::get();
+        }
+
+        MetricsPolicy const&
+        metrics() const noexcept
+        {
+            return this->boost::empty_value<MetricsPolicy, 1>::get();
+        }
+
         template<class Executor2>
         void on_timer(Executor2 const& ex2);
 
+        void on_rate_wait(); // an operation waits for budget
+
+        template<class Executor2>
+        void start_timeout(op_state& state, Executor2 const& ex2);
+        std::size_t stop_timeout(op_state& state);
+        static void on_expire(detail::timeout_entry& e);
+
         void reset();       // set timeouts to never
         void close();       // cancel everything
     };
@@ -414,6 +458,20 @@ public:
         return impl_->policy();
     }
 
+    /// Returns the metrics policy associated with the object
+    MetricsPolicy&
+    metrics_policy() noexcept
+    {
+        return impl_->metrics();
+    }
+
+    /// Returns the metrics policy associated with the object
+    MetricsPolicy const&
+    metrics_policy() const noexcept
+    {
+        return impl_->metrics();
+    }
+
     /** Set the timeout for the next logical operation.
 
         This sets either the read timer, the write timer, or
@@ -463,6 +521,29 @@ public:
     void
     expires_never();
 
+    /** Enforce the timeouts of this stream with a shared timeout wheel.
+
+        By default, the stream waits on its own timers to enforce
+        timeouts. After this call, the deadlines of subsequent
+        operations are registered with `wheel` instead, which
+        avoids a reactor timer wait for each logical operation.
+        Timeouts may be reported up to one granularity of the
+        wheel after the expiry time.
+
+        @param wheel The wheel to use, or `nullptr` to go back to
+        the stream's own timers. The stream shares ownership of the
+        state of the wheel, which keeps enforcing the timeouts of the
+        stream if the wheel object is destroyed first. The wheel must
+        run in the same implicit or explicit strand as the stream.
+
+        @note No asynchronous operations may be outstanding
+        when this function is called.
+
+        @see timeout_wheel
+    */
+    void
+    use_timeout_wheel(timeout_wheel* wheel) noexcept;
+
     /** Cancel all asynchronous operations associated with the socket.
 
         This function causes all outstanding asynchronous connect,
@@ -1193,7 +1274,11 @@ public:
     std::size_t
     read_some(MutableBufferSequence const& buffers)
     {
-        return impl_->socket.read_some(buffers);
+        error_code ec;
+        auto const n = read_some(buffers, ec);
+        if(ec)
+            BOOST_THROW_EXCEPTION(system_error{ec});
+        return n;
     }
 
     /** Read some data.
@@ -1225,7 +1310,12 @@ public:
         MutableBufferSequence const& buffers,
         error_code& ec)
     {
-        return impl_->socket.read_some(buffers, ec);
+        auto& m = impl_->metrics();
+        auto const t0 = metrics_policy_access::now(m);
+        auto const n = impl_->socket.read_some(buffers, ec);
+        metrics_policy_access::on_read(
+            m, n, metrics_policy_access::now(m) - t0);
+        return n;
     }
 
     /** Read some data asynchronously.
@@ -1310,7 +1400,11 @@ public:
     std::size_t
     write_some(ConstBufferSequence const& buffers)
     {
-        return impl_->socket.write_some(buffers);
+        error_code ec;
+        auto const n = write_some(buffers, ec);
+        if(ec)
+            BOOST_THROW_EXCEPTION(system_error{ec});
+        return n;
     }
 
     /** Write some data.
@@ -1344,7 +1438,12 @@ public:
         ConstBufferSequence const& buffers,
         error_code& ec)
     {
-        return impl_->socket.write_some(buffers, ec);
+        auto& m = impl_->metrics();
+        auto const t0 = metrics_policy_access::now(m);
+        auto const n = impl_->socket.write_some(buffers, ec);
+        metrics_policy_access::on_write(
+            m, n, metrics_policy_access::now(m) - t0);
+        return n;
     }
 
     /** Write some data asynchronously.
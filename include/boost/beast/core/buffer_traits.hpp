@@ -14,6 +14,9 @@
 #include <boost/asio/buffer.hpp>
 #include <boost/config/workaround.hpp>
 #include <boost/mp11/function.hpp>
+#include <array>
+#include <cstddef>
+#include <limits>
 #include <type_traits>
 
 namespace boost {
@@ -156,6 +159,100 @@ using buffers_iterator_type =
         std::declval<T const&>()));
 #endif
 
+namespace detail {
+
+template<class T, class = void>
+struct buffer_sequence_max_length_impl
+    : std::integral_constant<std::size_t,
+        (std::numeric_limits<std::size_t>::max)()>
+{
+};
+
+template<class T>
+struct buffer_sequence_max_length_impl<T, typename
+    std::enable_if<std::is_convertible<
+        T const&, net::const_buffer>::value>::type>
+    : std::integral_constant<std::size_t, 1>
+{
+};
+
+template<class T, std::size_t N>
+struct buffer_sequence_max_length_impl<std::array<T, N>>
+    : std::integral_constant<std::size_t, N>
+{
+};
+
+// Sum of lengths, where the largest value means unbounded
+template<std::size_t... Ns>
+struct buffer_sequence_length_sum;
+
+template<>
+struct buffer_sequence_length_sum<>
+    : std::integral_constant<std::size_t, 0>
+{
+};
+
+template<std::size_t N, std::size_t... Ns>
+struct buffer_sequence_length_sum<N, Ns...>
+    : std::integral_constant<std::size_t,
+        (N > (std::numeric_limits<std::size_t>::max)() -
+            buffer_sequence_length_sum<Ns...>::value) ?
+        (std::numeric_limits<std::size_t>::max)() :
+        N + buffer_sequence_length_sum<Ns...>::value>
+{
+};
+
+} // detail
+
+/** The largest number of buffers in a buffer sequence type.
+
+    This metafunction yields, at compile time, an upper bound on the
+    number of buffers in any object of a buffer sequence type. The
+    bound is exact for the composed sequences returned by Beast's
+    buffer adaptors when the adapted sequences are themselves bounded,
+    for example the concatenation of a `net::const_buffer` and a
+    `std::array` of buffers. When no bound is known, the value is the
+    largest value of `std::size_t`.
+
+    The bound lets algorithms size arrays of buffers at compile time,
+    for example the array of `iovec` passed to `writev`.
+
+    The trait may be specialized for user-defined buffer sequence types.
+    It is provided for:
+
+    @li `net::const_buffer`, `net::mutable_buffer` and other types
+        convertible to a buffer, which have one element,
+
+    @li `std::array` of buffers, which have as many elements as the array,
+
+    @li @ref buffers_cat_view, whose bound is the sum of the bounds of
+        the concatenated sequences,
+
+    @li @ref buffers_prefix_view and @ref buffers_suffix, whose bound is
+        the bound of the adapted sequence,
+
+    @li @ref buffers_array, whose bound is its capacity,
+
+    @li the buffer sequences used in HTTP chunked encoding.
+
+    @tparam BufferSequence The buffer sequence type. References and
+    cv-qualifiers are ignored.
+*/
+template<class BufferSequence>
+struct buffer_sequence_max_length
+#if BOOST_BEAST_DOXYGEN
+    : std::integral_constant<std::size_t, __see_below__>
+#else
+    : std::conditional<
+        std::is_same<BufferSequence, typename
+            std::decay<BufferSequence>::type>::value,
+        detail::buffer_sequence_max_length_impl<BufferSequence>,
+        buffer_sequence_max_length<typename
+            std::decay<BufferSequence>::type>>::type
+#endif
+{
+};
+
 } // beast
 } // boost
 
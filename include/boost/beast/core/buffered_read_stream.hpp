@@ -11,6 +11,7 @@
 #define BOOST_BEAST_BUFFERED_READ_STREAM_HPP
 
 #include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/buffer_size.hpp>
 #include <boost/beast/core/error.hpp>
 #include <boost/beast/core/multi_buffer.hpp>
 #include <boost/beast/core/stream_traits.hpp>
@@ -46,6 +47,30 @@ namespace beast {
     @li "Preload" a stream with handshake input data acquired
       from other sources.
 
+    @li Read ahead, so that many small reads are served from
+      one read on the next layer. See @ref capacity.
+
+    @li Parse in place. The internal buffer meets the requirements
+      of <em>DynamicBuffer</em>, so it can be passed to `http::read`,
+      `http::async_read`, or `detect_protocol` together with the
+      next layer. The parser then works on the buffered bytes
+      directly, and anything read past the end of the message stays
+      in the buffer, to be returned by the next read on this stream.
+      A stack such as PROXY header, protocol detection, then HTTP
+      or WebSocket can share one buffer this way:
+      @code
+      buffered_read_stream<tcp::socket, flat_buffer> stream{ioc};
+      ...
+      http::request<http::string_body> req;
+      http::read(stream.next_layer(), stream.buffer(), req);
+
+      // Frames sent right after the upgrade request are
+      // still in stream.buffer(), and are read first.
+      websocket::stream<buffered_read_stream<
+          tcp::socket, flat_buffer>&> ws{stream};
+      ws.accept(req);
+      @endcode
+
     Example:
     @code
     // Process the next HTTP header on the stream,
@@ -101,6 +126,16 @@ class buffered_read_stream
     std::size_t capacity_ = 0;
     Stream next_layer_;
 
+    // Returns `true` if an empty buffer should be
+    // filled before reading into `buffers`
+    template<class MutableBufferSequence>
+    bool
+    read_ahead(MutableBufferSequence const& buffers) const
+    {
+        return capacity_ > 0 &&
+            beast::buffer_size(buffers) < capacity_;
+    }
+
 public:
     /// The type of the internal buffer
     using buffer_type = DynamicBuffer;
@@ -187,6 +222,14 @@ public:
         to hold read data. No bytes are discarded by this call. If
         the buffer size is set to zero, no more data will be buffered.
 
+        When the size is not zero, a read which finds the internal
+        buffer empty reads ahead: it reads up to `size` bytes from
+        the next layer into the internal buffer, and returns what
+        fits in the caller's buffers. The rest is returned by the
+        following reads without calling the next layer. A read into
+        buffers of at least `size` bytes goes directly to the next
+        layer, since reading ahead would only add a copy.
+
         Thread safety:
             The caller is responsible for making sure the call is
             made from the same implicit or explicit strand.
@@ -0,0 +1,162 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_BUFFERS_ARRAY_HPP
+#define BOOST_BEAST_BUFFERS_ARRAY_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/buffer_traits.hpp>
+#include <boost/beast/core/buffers_cat.hpp>
+#include <boost/beast/core/buffers_prefix.hpp>
+#include <boost/beast/core/buffers_suffix.hpp>
+#include <boost/asio/buffer.hpp>
+#include <cstddef>
+#include <limits>
+
+namespace boost {
+namespace beast {
+
+/** A buffer sequence holding a flat copy of another sequence.
+
+    This container stores up to `N` buffers in a plain array, copied
+    from another buffer sequence upon construction. Iterating the
+    array is as cheap as iterating a pointer, which makes it suitable
+    for handing to a system call which takes an array of buffers,
+    such as `writev` or `readv`.
+
+    The copy is made in bulk. When the source sequence is composed of
+    Beast's adaptors (@ref buffers_cat_view, @ref buffers_prefix_view
+    and @ref buffers_suffix, nested to any depth), each concatenated
+    sequence is walked with its own native iterator, so the cost of
+    dispatching to the right sequence is paid once per sequence
+    rather than once per buffer.
+
+    Empty buffers are not copied. If the source sequence has more than
+    `N` non-empty buffers, only the first `N` are copied; the array then
+    represents a prefix of the source. This is the same behavior as the
+    buffer limit applied by the operating system to scatter/gather I/O,
+    and is harmless for operations such as `write_some` and `read_some`
+    which may transfer fewer bytes than requested.
+
+    Only the buffers are copied. Ownership of the underlying memory is
+    not transferred, and the memory must remain valid while the array
+    is in use.
+
+    @tparam Buffer The buffer type stored in the array. This must be
+    `net::const_buffer` or `net::mutable_buffer`.
+
+    @tparam N The maximum number of buffers. The default is the number
+    of buffers which Asio passes to a single scatter/gather operation.
+*/
+template<class Buffer, std::size_t N = 64>
+class buffers_array
+{
+    static_assert(N > 0, "N must be positive");
+
+    static_assert(
+        std::is_same<Buffer, net::const_buffer>::value ||
+        std::is_same<Buffer, net::mutable_buffer>::value,
+        "Buffer must be net::const_buffer or net::mutable_buffer");
+
+    Buffer v_[N];
+    std::size_t n_ = 0;
+
+public:
+    /// The type of each buffer in the sequence.
+    using value_type = Buffer;
+
+    /// A bidirectional iterator type that may be used to read elements.
+    using const_iterator = Buffer const*;
+
+    /// Constructor
+    buffers_array() = default;
+
+    /// Copy Constructor
+    buffers_array(buffers_array const&) = default;
+
+    /// Copy Assignment
+    buffers_array& operator=(buffers_array const&) = default;
+
+    /** Constructor
+
+        Copies the buffers of a sequence into the array.
+
+        @param buffers The buffer sequence to copy. If `Buffer` is
+        `net::mutable_buffer`, this must meet the requirements of
+        <em>MutableBufferSequence</em>, otherwise it must meet the
+        requirements of <em>ConstBufferSequence</em>.
+
+        @param limit The maximum number of bytes represented by the
+        array. Buffers beyond this limit are not copied, and the last
+        buffer copied is shortened if necessary.
+    */
+    template<class BufferSequence>
+    explicit
+    buffers_array(
+        BufferSequence const& buffers,
+        std::size_t limit =
+            (std::numeric_limits<std::size_t>::max)());
+
+    /// Returns an iterator to the first buffer
+    const_iterator
+    begin() const noexcept
+    {
+        return v_;
+    }
+
+    /// Returns an iterator to one past the last buffer
+    const_iterator
+    end() const noexcept
+    {
+        return v_ + n_;
+    }
+
+    /// Returns the number of buffers in the array
+    std::size_t
+    size() const noexcept
+    {
+        return n_;
+    }
+
+    /// Returns the maximum number of buffers in the array
+    static
+    constexpr
+    std::size_t
+    max_size() noexcept
+    {
+        return N;
+    }
+};
+
+#if ! BOOST_BEAST_DOXYGEN
+template<class Buffer, std::size_t N>
+struct buffer_sequence_max_length<buffers_array<Buffer, N>>
+    : std::integral_constant<std::size_t, N>
+{
+};
+#endif
+
+namespace detail {
+
+// A buffers_array just large enough for any object of type
+// BufferSequence, and no larger than the default capacity.
+template<class Buffer, class BufferSequence>
+using buffers_array_for = buffers_array<Buffer,
+    (buffer_sequence_max_length<BufferSequence>::value < 1) ? 1 :
+    (buffer_sequence_max_length<BufferSequence>::value > 64) ? 64 :
+    buffer_sequence_max_length<BufferSequence>::value>;
+
+} // detail
+
+} // beast
+} // boost
+
+#include <boost/beast/core/impl/buffers_array.hpp>
+
+#endif
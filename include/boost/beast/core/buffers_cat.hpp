@@ -18,6 +18,10 @@
 namespace boost {
 namespace beast {
 
+namespace detail {
+struct buffers_array_access;
+} // detail
+
 /** A buffer sequence representing a concatenation of buffer sequences.
 
     @see @ref buffers_cat
@@ -27,6 +31,8 @@ class buffers_cat_view
 {
     detail::tuple<Buffers...> bn_;
 
+    friend struct detail::buffers_array_access;
+
 public:
     /** The type of buffer returned when dereferencing an iterator.
 
@@ -68,6 +74,15 @@ public:
     end() const;
 };
 
+#if ! BOOST_BEAST_DOXYGEN
+template<class... Buffers>
+struct buffer_sequence_max_length<buffers_cat_view<Buffers...>>
+    : detail::buffer_sequence_length_sum<
+        buffer_sequence_max_length<Buffers>::value...>
+{
+};
+#endif
+
 /** Concatenate 2 or more buffer sequences.
 
     This function returns a constant or mutable buffer sequence which,
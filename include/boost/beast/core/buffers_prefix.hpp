@@ -25,6 +25,10 @@
 namespace boost {
 namespace beast {
 
+namespace detail {
+struct buffers_array_access;
+} // detail
+
 /** A buffer sequence adaptor that shortens the sequence size.
 
     The class adapts a buffer sequence to efficiently represent
@@ -44,6 +48,8 @@ class buffers_prefix_view
     std::size_t remain_ = 0;
     iter_type end_{};
 
+    friend struct detail::buffers_array_access;
+
     void
     setup(std::size_t size);
 
@@ -137,6 +143,14 @@ public:
 #endif
 };
 
+#if ! BOOST_BEAST_DOXYGEN
+template<class BufferSequence>
+struct buffer_sequence_max_length<buffers_prefix_view<BufferSequence>>
+    : buffer_sequence_max_length<BufferSequence>
+{
+};
+#endif
+
 //------------------------------------------------------------------------------
 
 /** Returns a prefix of a constant or mutable buffer sequence.
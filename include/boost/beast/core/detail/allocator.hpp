@@ -11,6 +11,7 @@
 #define BOOST_BEAST_DETAIL_ALLOCATOR_HPP
 
 #include <boost/config.hpp>
+#include <cstddef>
 #ifdef BOOST_NO_CXX11_ALLOCATOR
 #include <boost/container/allocator_traits.hpp>
 #else
@@ -35,6 +36,31 @@ using allocator_traits = std::allocator_traits<Alloc>;
 
 #endif
 
+// Returns the number of bytes actually obtained when
+// allocating n bytes, for allocators which round up.
+
+template<class Alloc>
+auto
+allocation_size(Alloc const& a, std::size_t n, int) ->
+    decltype(a.good_size(n))
+{
+    return a.good_size(n);
+}
+
+template<class Alloc>
+std::size_t
+allocation_size(Alloc const&, std::size_t n, long)
+{
+    return n;
+}
+
+template<class Alloc>
+std::size_t
+allocation_size(Alloc const& a, std::size_t n)
+{
+    return allocation_size(a, n, 0);
+}
+
 } // detail
 } // beast
 } // boost
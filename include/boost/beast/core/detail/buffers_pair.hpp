@@ -10,6 +10,7 @@
 #ifndef BOOST_BEAST_DETAIL_BUFFERS_PAIR_HPP
 #define BOOST_BEAST_DETAIL_BUFFERS_PAIR_HPP
 
+#include <boost/beast/core/buffer_traits.hpp>
 #include <boost/asio/buffer.hpp>
 #include <boost/assert.hpp>
 #include <boost/config/workaround.hpp>
@@ -109,6 +110,14 @@ private:
 #endif
 
 } // detail
+
+template<bool isMutable>
+struct buffer_sequence_max_length<
+        detail::buffers_pair<isMutable>>
+    : std::integral_constant<std::size_t, 2>
+{
+};
+
 } // beast
 } // boost
 
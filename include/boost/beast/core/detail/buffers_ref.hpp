@@ -53,6 +53,17 @@ public:
     }
 };
 
+} // detail
+
+template<class BufferSequence>
+struct buffer_sequence_max_length<
+        detail::buffers_ref<BufferSequence>>
+    : buffer_sequence_max_length<BufferSequence>
+{
+};
+
+namespace detail {
+
 // Return a reference to a buffer sequence
 template<class BufferSequence>
 buffers_ref<BufferSequence>
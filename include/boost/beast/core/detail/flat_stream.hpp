@@ -64,6 +64,27 @@ public:
         }
         return result;
     }
+
+    // Like flatten, but when the buffers which fit leave room
+    // below the limit and the next one does not fit, the start
+    // of the next one is copied as well. A short header followed
+    // by a large body then goes out in one full record, instead
+    // of the header in a tiny record of its own.
+    template<class BufferSequence>
+    static
+    flatten_result
+    coalesce(
+        BufferSequence const& buffers, std::size_t limit)
+    {
+        auto result = flatten(buffers, limit);
+        if(result.size < limit &&
+            buffer_size(buffers) > result.size)
+        {
+            result.size = limit;
+            result.flatten = true;
+        }
+        return result;
+    }
 };
 
 } // detail
@@ -13,6 +13,7 @@
 #include <boost/beast/core/bind_handler.hpp>
 #include <boost/beast/core/async_op_base.hpp>
 #include <boost/beast/core/flat_static_buffer.hpp>
+#include <boost/beast/core/read_size.hpp>
 #include <boost/asio/basic_stream_socket.hpp>
 #include <boost/asio/coroutine.hpp>
 #include <boost/throw_exception.hpp>
@@ -44,8 +45,18 @@ class read_op
     Stream& s_;
     DynamicBuffer& b_;
     Condition cond_;
+    read_size_advisor* adv_;
+    read_size_advisor own_;
+    std::size_t prepared_ = 0;
     std::size_t total_ = 0;
 
+    // Use the caller's advisor if there is one
+    read_size_advisor&
+    advisor() noexcept
+    {
+        return adv_ ? *adv_ : own_;
+    }
+
 public:
     read_op(read_op&&) = default;
 
@@ -54,7 +65,8 @@ public:
         Handler_&& h,
         Stream& s,
         DynamicBuffer& b,
-        Condition_&& cond)
+        Condition_&& cond,
+        read_size_advisor* adv)
         : async_op_base<Handler,
             beast::executor_type<Stream>>(
                 std::forward<Handler_>(h),
@@ -62,6 +74,7 @@ public:
         , s_(s)
         , b_(b)
         , cond_(std::forward<Condition_>(cond))
+        , adv_(adv)
     {
         (*this)({}, 0, false);
     }
@@ -73,23 +86,23 @@ public:
         bool cont = true)
     {
         std::size_t max_size;
-        std::size_t max_prepare;
         BOOST_ASIO_CORO_REENTER(*this)
         {
             for(;;)
             {
                 max_size = cond_(ec, total_, b_);
-                max_prepare = std::min<std::size_t>(
+                prepared_ = std::min<std::size_t>(
                     std::max<std::size_t>(
-                        512, b_.capacity() - b_.size()),
+                        advisor().size(), b_.capacity() - b_.size()),
                     std::min<std::size_t>(
                         max_size, b_.max_size() - b_.size()));
-                if(max_prepare == 0)
+                if(prepared_ == 0)
                     break;
                 BOOST_ASIO_CORO_YIELD
                 s_.async_read_some(
-                    b_.prepare(max_prepare), std::move(*this));
+                    b_.prepare(prepared_), std::move(*this));
                 b_.commit(bytes_transferred);
+                advisor().feedback(prepared_, bytes_transferred);
                 total_ += bytes_transferred;
             }
             this->invoke(cont, ec, total_);
@@ -213,7 +226,8 @@ struct run_read_op
         ReadHandler&& h,
         AsyncReadStream& s,
         DynamicBuffer& b,
-        Condition&& c)
+        Condition&& c,
+        read_size_advisor* adv = nullptr)
     {
         // If you get an error on the following line it means
         // that your handler does not meet the documented type
@@ -232,7 +246,8 @@ struct run_read_op
                 std::forward<ReadHandler>(h),
                 s,
                 b,
-                std::forward<Condition>(c));
+                std::forward<Condition>(c),
+                adv);
     }
 
 #if BOOST_BEAST_ENABLE_NON_BLOCKING
@@ -279,7 +294,8 @@ struct run_read_op
                     std::forward<ReadHandler>(h),
                     s,
                     b,
-                    std::forward<Condition>(c));
+                    std::forward<Condition>(c),
+                    nullptr);
         }
     }
 #endif
@@ -328,6 +344,33 @@ read(
     DynamicBuffer& buffer,
     CompletionCondition cond,
     error_code& ec)
+{
+    static_assert(is_sync_read_stream<SyncReadStream>::value,
+        "SyncReadStream type requirements not met");
+    static_assert(
+        net::is_dynamic_buffer<DynamicBuffer>::value,
+        "DynamicBuffer type requirements not met");
+    static_assert(
+        detail::is_invocable<CompletionCondition,
+            void(error_code&, std::size_t, DynamicBuffer&)>::value,
+        "CompletionCondition type requirements not met");
+    read_size_advisor advisor;
+    return detail::read(stream, buffer,
+        std::move(cond), advisor, ec);
+}
+
+template<
+    class SyncReadStream,
+    class DynamicBuffer,
+    class CompletionCondition,
+    class>
+std::size_t
+read(
+    SyncReadStream& stream,
+    DynamicBuffer& buffer,
+    CompletionCondition cond,
+    read_size_advisor& advisor,
+    error_code& ec)
 {
     static_assert(is_sync_read_stream<SyncReadStream>::value,
         "SyncReadStream type requirements not met");
@@ -347,7 +390,7 @@ read(
         max_size = cond(ec, total, buffer);
         max_prepare = std::min<std::size_t>(
             std::max<std::size_t>(
-                512, buffer.capacity() - buffer.size()),
+                advisor.size(), buffer.capacity() - buffer.size()),
             std::min<std::size_t>(
                 max_size, buffer.max_size() - buffer.size()));
         if(max_prepare == 0)
@@ -355,6 +398,7 @@ read(
         std::size_t const bytes_transferred =
             stream.read_some(buffer.prepare(max_prepare), ec);
         buffer.commit(bytes_transferred);
+        advisor.feedback(max_prepare, bytes_transferred);
         total += bytes_transferred;
     }
     return total;
@@ -479,6 +523,41 @@ async_read(
             std::forward<CompletionCondition>(cond));
 }
 
+template<
+    class AsyncReadStream,
+    class DynamicBuffer,
+    class CompletionCondition,
+    class ReadHandler,
+    class>
+BOOST_ASIO_INITFN_RESULT_TYPE(
+    ReadHandler, void(error_code, std::size_t))
+async_read(
+    AsyncReadStream& stream,
+    DynamicBuffer& buffer,
+    CompletionCondition&& cond,
+    read_size_advisor& advisor,
+    ReadHandler&& handler)
+{
+    static_assert(is_async_read_stream<AsyncReadStream>::value,
+        "AsyncReadStream type requirements not met");
+    static_assert(
+        net::is_dynamic_buffer<DynamicBuffer>::value,
+        "DynamicBuffer type requirements not met");
+    static_assert(
+        detail::is_invocable<CompletionCondition,
+            void(error_code&, std::size_t, DynamicBuffer&)>::value,
+        "CompletionCondition type requirements not met");
+    return net::async_initiate<
+        ReadHandler,
+        void(error_code, std::size_t)>(
+            typename dynamic_read_ops::run_read_op{},
+            handler,
+            stream,
+            buffer,
+            std::forward<CompletionCondition>(cond),
+            &advisor);
+}
+
 } // detail
 } // beast
 } // boost
@@ -12,6 +12,7 @@
 
 #include <boost/beast/core/detail/config.hpp>
 #include <boost/beast/core/error.hpp>
+#include <boost/beast/core/read_size.hpp>
 #include <boost/beast/core/stream_traits.hpp>
 #include <boost/beast/core/detail/is_invocable.hpp>
 #include <boost/asio/async_result.hpp>
@@ -148,6 +149,36 @@ read(
     CompletionCondition completion_condition,
     error_code& ec);
 
+/** Read data into a dynamic buffer from a stream until a condition is met.
+
+    This function behaves as the overload without an advisor, except
+    that the sizes of the reads are chosen by the caller's advisor,
+    which is updated with the outcome of each read. Passing the same
+    advisor to successive calls keeps the history of the connection.
+
+    @param advisor The advisor to use. Ownership is not transferred.
+*/
+template<
+    class SyncReadStream,
+    class DynamicBuffer,
+    class CompletionCondition
+#if ! BOOST_BEAST_DOXYGEN
+    , class = typename std::enable_if<
+        is_sync_read_stream<SyncReadStream>::value &&
+        net::is_dynamic_buffer<DynamicBuffer>::value &&
+        detail::is_invocable<CompletionCondition,
+            void(error_code&, std::size_t, DynamicBuffer&)>::value
+    >::type
+#endif
+>
+std::size_t
+read(
+    SyncReadStream& stream,
+    DynamicBuffer& buffer,
+    CompletionCondition completion_condition,
+    read_size_advisor& advisor,
+    error_code& ec);
+
 /** Asynchronously read data into a dynamic buffer from a stream until a condition is met.
     
     This function is used to asynchronously read from a stream into a dynamic
@@ -238,6 +269,40 @@ async_read(
     CompletionCondition&& completion_condition,
     ReadHandler&& handler);
 
+/** Asynchronously read data into a dynamic buffer from a stream until a condition is met.
+
+    This function behaves as the overload without an advisor, except
+    that the sizes of the reads are chosen by the caller's advisor,
+    which is updated with the outcome of each read. Passing the same
+    advisor to successive calls keeps the history of the connection.
+
+    @param advisor The advisor to use. Ownership is retained by the
+    caller, which must guarantee that it remains valid until the
+    handler is called.
+*/
+template<
+    class AsyncReadStream,
+    class DynamicBuffer,
+    class CompletionCondition,
+    class ReadHandler
+#if ! BOOST_BEAST_DOXYGEN
+    , class = typename std::enable_if<
+        is_async_read_stream<AsyncReadStream>::value &&
+        net::is_dynamic_buffer<DynamicBuffer>::value &&
+        detail::is_invocable<CompletionCondition,
+            void(error_code&, std::size_t, DynamicBuffer&)>::value
+    >::type
+#endif
+>
+BOOST_ASIO_INITFN_RESULT_TYPE(
+    ReadHandler, void(error_code, std::size_t))
+async_read(
+    AsyncReadStream& stream,
+    DynamicBuffer& buffer,
+    CompletionCondition&& completion_condition,
+    read_size_advisor& advisor,
+    ReadHandler&& handler);
+
 } // detail
 } // beast
 } // boost
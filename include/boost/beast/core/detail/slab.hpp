@@ -0,0 +1,55 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_DETAIL_SLAB_HPP
+#define BOOST_BEAST_DETAIL_SLAB_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <cstddef>
+#include <cstdint>
+
+namespace boost {
+namespace beast {
+namespace detail {
+
+// Returns a block of at least n bytes
+BOOST_BEAST_DECL
+void*
+slab_allocate(std::size_t n);
+
+// Returns the size of the block obtained by slab_allocate(n)
+BOOST_BEAST_DECL
+std::size_t
+slab_size(std::size_t n) noexcept;
+
+// Returns a block obtained from slab_allocate(n)
+BOOST_BEAST_DECL
+void
+slab_deallocate(void* p, std::size_t n) noexcept;
+
+BOOST_BEAST_DECL
+void
+slab_thread_stats(
+    std::uint64_t& hits,
+    std::uint64_t& misses,
+    std::size_t& cached) noexcept;
+
+BOOST_BEAST_DECL
+void
+slab_thread_shrink() noexcept;
+
+} // detail
+} // beast
+} // boost
+
+#ifdef BOOST_BEAST_HEADER_ONLY
+#include <boost/beast/core/detail/slab.ipp>
+#endif
+
+#endif
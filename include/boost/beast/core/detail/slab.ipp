@@ -0,0 +1,189 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_DETAIL_SLAB_IPP
+#define BOOST_BEAST_DETAIL_SLAB_IPP
+
+#include <boost/beast/core/detail/slab.hpp>
+#include <boost/config.hpp>
+#include <new>
+
+namespace boost {
+namespace beast {
+namespace detail {
+
+namespace slab {
+
+// Size classes are 1KB, 4KB, 16KB and 64KB
+std::size_t constexpr classes = 4;
+
+inline
+std::size_t
+class_of(std::size_t n) noexcept
+{
+    std::size_t i = 0;
+    while(i < classes && n > (std::size_t(1024) << (2 * i)))
+        ++i;
+    return i;
+}
+
+inline
+std::size_t
+size_of(std::size_t i) noexcept
+{
+    return std::size_t(1024) << (2 * i);
+}
+
+// Each freelist holds up to 256KB, and at least 16 blocks
+inline
+std::size_t
+limit_of(std::size_t i) noexcept
+{
+    auto const n = 256 * 1024 / size_of(i);
+    return n < 16 ? 16 : n;
+}
+
+struct cache
+{
+    struct node
+    {
+        node* next;
+    };
+
+    node* free[classes] = {};
+    std::size_t count[classes] = {};
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+
+    ~cache()
+    {
+        shrink();
+    }
+
+    void
+    shrink() noexcept
+    {
+        for(std::size_t i = 0; i < classes; ++i)
+        {
+            while(free[i])
+            {
+                auto const p = free[i];
+                free[i] = p->next;
+                ::operator delete(p);
+            }
+            count[i] = 0;
+        }
+    }
+};
+
+inline
+cache*
+this_thread() noexcept
+{
+#ifdef BOOST_NO_CXX11_THREAD_LOCAL
+    return nullptr;
+#else
+    // Blocks may be freed after the cache of the thread is
+    // gone, for example by objects with static storage
+    // duration. The flag survives the cache.
+    thread_local bool destroyed = false;
+    struct thread_cache : cache
+    {
+        ~thread_cache()
+        {
+            destroyed = true;
+        }
+    };
+    thread_local thread_cache tc;
+    if(destroyed)
+        return nullptr;
+    return &tc;
+#endif
+}
+
+} // slab
+
+void*
+slab_allocate(std::size_t n)
+{
+    auto const i = slab::class_of(n);
+    if(i == slab::classes)
+        return ::operator new(n);
+    auto const c = slab::this_thread();
+    if(c)
+    {
+        if(auto const p = c->free[i])
+        {
+            c->free[i] = p->next;
+            --c->count[i];
+            ++c->hits;
+            return p;
+        }
+        ++c->misses;
+    }
+    return ::operator new(slab::size_of(i));
+}
+
+std::size_t
+slab_size(std::size_t n) noexcept
+{
+    auto const i = slab::class_of(n);
+    if(i == slab::classes)
+        return n;
+    return slab::size_of(i);
+}
+
+void
+slab_deallocate(void* p, std::size_t n) noexcept
+{
+    auto const i = slab::class_of(n);
+    auto const c = i < slab::classes ?
+        slab::this_thread() : nullptr;
+    if(! c || c->count[i] >= slab::limit_of(i))
+    {
+        ::operator delete(p);
+        return;
+    }
+    auto const node = ::new(p) slab::cache::node;
+    node->next = c->free[i];
+    c->free[i] = node;
+    ++c->count[i];
+}
+
+void
+slab_thread_stats(
+    std::uint64_t& hits,
+    std::uint64_t& misses,
+    std::size_t& cached) noexcept
+{
+    hits = 0;
+    misses = 0;
+    cached = 0;
+    auto const c = slab::this_thread();
+    if(! c)
+        return;
+    hits = c->hits;
+    misses = c->misses;
+    for(std::size_t i = 0; i < slab::classes; ++i)
+        cached += c->count[i] * slab::size_of(i);
+}
+
+void
+slab_thread_shrink() noexcept
+{
+    auto const c = slab::this_thread();
+    if(c)
+        c->shrink();
+}
+
+} // detail
+} // beast
+} // boost
+
+#endif
@@ -10,6 +10,7 @@
 #ifndef BOOST_BEAST_CORE_DETAIL_STREAM_BASE_HPP
 #define BOOST_BEAST_CORE_DETAIL_STREAM_BASE_HPP
 
+#include <boost/beast/core/detail/timeout_wheel.hpp>
 #include <boost/asio/steady_timer.hpp>
 #include <boost/assert.hpp>
 #include <boost/core/exchange.hpp>
@@ -42,6 +43,7 @@ struct stream_base
     struct op_state
     {
         net::steady_timer timer;    // for timing out
+        timeout_entry entry;        // or, in a timeout wheel
         tick_type tick = 0;         // counts waits
         bool pending = false;       // if op is pending
         bool timeout = false;       // if timed out
@@ -0,0 +1,127 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_DETAIL_TIMEOUT_WHEEL_HPP
+#define BOOST_BEAST_DETAIL_TIMEOUT_WHEEL_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/error.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/enable_shared_from_this.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace boost {
+namespace beast {
+namespace detail {
+
+class timeout_wheel_impl;
+
+// A deadline registered with a timeout wheel. Entries are
+// linked into the wheel intrusively, so inserting and
+// removing them never allocates.
+struct timeout_entry
+{
+    timeout_entry* prev = nullptr;
+    timeout_entry* next = nullptr;
+    timeout_wheel_impl* wheel = nullptr; // set while linked
+    std::chrono::steady_clock::time_point deadline;
+    void (*expire)(timeout_entry&) = nullptr;
+    void* owner = nullptr;
+
+    timeout_entry() = default;
+
+    // Copies are never linked
+    timeout_entry(timeout_entry const&) noexcept
+    {
+    }
+
+    timeout_entry& operator=(timeout_entry const&) = delete;
+
+    BOOST_BEAST_DECL
+    ~timeout_entry();
+
+    bool
+    linked() const noexcept
+    {
+        return wheel != nullptr;
+    }
+};
+
+// A hashed timing wheel. Deadlines are rounded up to the
+// next tick and kept in one of `slots` circular lists,
+// indexed by tick number. A single timer fires once per
+// tick, only while deadlines are pending, and expires the
+// entries in the current slot whose deadline has passed.
+// Entries more than one revolution away stay in place.
+class timeout_wheel_impl
+    : public boost::enable_shared_from_this<timeout_wheel_impl>
+{
+public:
+    using clock_type = std::chrono::steady_clock;
+    using duration = clock_type::duration;
+    using time_point = clock_type::time_point;
+
+    net::steady_timer timer;
+    duration const granularity;
+    time_point const start;     // the time of tick zero
+    std::uint64_t tick = 0;     // the next tick to process
+    std::size_t size = 0;       // number of linked entries
+    bool running = false;       // if the timer is waiting
+    std::vector<timeout_entry> slots; // list heads
+
+    BOOST_BEAST_DECL
+    timeout_wheel_impl(
+        net::steady_timer::executor_type const& ex,
+        duration granularity_,
+        std::size_t slots_);
+
+    BOOST_BEAST_DECL
+    ~timeout_wheel_impl();
+
+    // Register an entry, expire() is called after the deadline
+    BOOST_BEAST_DECL
+    void
+    insert(timeout_entry& e, time_point deadline);
+
+    // Unregister an entry, returns `true` if it was linked
+    BOOST_BEAST_DECL
+    bool
+    remove(timeout_entry& e) noexcept;
+
+    // Expire the entries due at the current time
+    BOOST_BEAST_DECL
+    void
+    on_tick();
+
+private:
+    BOOST_BEAST_DECL
+    std::uint64_t
+    ceil_tick(time_point t) const noexcept;
+
+    BOOST_BEAST_DECL
+    void
+    link(timeout_entry& e) noexcept;
+
+    BOOST_BEAST_DECL
+    void
+    wait();
+};
+
+} // detail
+} // beast
+} // boost
+
+#ifdef BOOST_BEAST_HEADER_ONLY
+#include <boost/beast/core/detail/timeout_wheel.ipp>
+#endif
+
+#endif
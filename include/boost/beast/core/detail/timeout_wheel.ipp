@@ -0,0 +1,201 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_DETAIL_TIMEOUT_WHEEL_IPP
+#define BOOST_BEAST_DETAIL_TIMEOUT_WHEEL_IPP
+
+#include <boost/beast/core/detail/timeout_wheel.hpp>
+#include <boost/assert.hpp>
+#include <boost/weak_ptr.hpp>
+
+namespace boost {
+namespace beast {
+namespace detail {
+
+timeout_entry::
+~timeout_entry()
+{
+    if(wheel)
+        wheel->remove(*this);
+}
+
+//------------------------------------------------------------------------------
+
+timeout_wheel_impl::
+timeout_wheel_impl(
+    net::steady_timer::executor_type const& ex,
+    duration granularity_,
+    std::size_t slots_)
+    : timer(ex)
+    , granularity(granularity_ > duration::zero() ?
+        granularity_ : duration(1))
+    , start(clock_type::now())
+    , slots(slots_ > 0 ? slots_ : 1)
+{
+    for(auto& head : slots)
+        head.prev = head.next = &head;
+}
+
+timeout_wheel_impl::
+~timeout_wheel_impl()
+{
+    // Leave the remaining entries unlinked
+    // so their destructors do not touch us.
+    for(auto& head : slots)
+    {
+        auto p = head.next;
+        while(p != &head)
+        {
+            auto const next = p->next;
+            p->prev = p->next = nullptr;
+            p->wheel = nullptr;
+            p = next;
+        }
+    }
+}
+
+void
+timeout_wheel_impl::
+insert(timeout_entry& e, time_point deadline)
+{
+    BOOST_ASSERT(! e.linked());
+    BOOST_ASSERT(e.expire);
+    if(! running)
+    {
+        // the ticks passed while idle had nothing to do
+        auto const t = ceil_tick(clock_type::now());
+        if(t > tick)
+            tick = t;
+        wait();
+    }
+    e.deadline = deadline;
+    link(e);
+    ++size;
+}
+
+bool
+timeout_wheel_impl::
+remove(timeout_entry& e) noexcept
+{
+    if(e.wheel != this)
+        return false;
+    e.prev->next = e.next;
+    e.next->prev = e.prev;
+    e.prev = e.next = nullptr;
+    e.wheel = nullptr;
+    --size;
+    return true;
+}
+
+void
+timeout_wheel_impl::
+on_tick()
+{
+    auto const now = clock_type::now();
+    // ticks at or before now are due
+    auto const last = static_cast<std::uint64_t>(
+        (now - start) / granularity);
+    auto const n = slots.size();
+    for(std::size_t i = 0; tick <= last && i < n; ++i, ++tick)
+    {
+        auto& head = slots[tick % n];
+        if(head.next == &head)
+            continue;
+
+        // Detach the slot so expiring or
+        // re-linking entries cannot disturb it.
+        timeout_entry list;
+        list.next = head.next;
+        list.prev = head.prev;
+        list.next->prev = &list;
+        list.prev->next = &list;
+        head.prev = head.next = &head;
+
+        while(list.next != &list)
+        {
+            auto& e = *list.next;
+            list.next = e.next;
+            e.next->prev = &list;
+            if(e.deadline > now)
+            {
+                // a later revolution
+                link(e);
+                continue;
+            }
+            e.prev = e.next = nullptr;
+            e.wheel = nullptr;
+            --size;
+            e.expire(e);
+        }
+    }
+    if(tick <= last)
+        tick = last + 1;
+    running = false;
+    if(size > 0)
+        wait();
+}
+
+std::uint64_t
+timeout_wheel_impl::
+ceil_tick(time_point t) const noexcept
+{
+    if(t <= start)
+        return 0;
+    auto const d = t - start;
+    auto const n = static_cast<std::uint64_t>(d / granularity);
+    if(d % granularity != duration::zero())
+        return n + 1;
+    return n;
+}
+
+void
+timeout_wheel_impl::
+link(timeout_entry& e) noexcept
+{
+    auto t = ceil_tick(e.deadline);
+    if(t < tick)
+        t = tick;
+    auto& head = slots[t % slots.size()];
+    e.next = &head;
+    e.prev = head.prev;
+    head.prev->next = &e;
+    head.prev = &e;
+    e.wheel = this;
+}
+
+void
+timeout_wheel_impl::
+wait()
+{
+    struct handler
+    {
+        boost::weak_ptr<timeout_wheel_impl> wp;
+
+        void
+        operator()(error_code ec)
+        {
+            if(ec == net::error::operation_aborted)
+                return;
+            if(auto sp = wp.lock())
+                sp->on_tick();
+        }
+    };
+
+    BOOST_ASSERT(! running);
+    running = true;
+    timer.expires_at(start + granularity *
+        static_cast<duration::rep>(tick));
+    timer.async_wait(handler{shared_from_this()});
+}
+
+} // detail
+} // beast
+} // boost
+
+#endif
@@ -0,0 +1,173 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_DETAIL_TOKEN_BUCKET_HPP
+#define BOOST_BEAST_DETAIL_TOKEN_BUCKET_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace boost {
+namespace beast {
+namespace detail {
+
+// Returns the default burst, the bytes earned in two intervals
+inline
+std::size_t
+token_bucket_burst(
+    std::size_t rate,
+    std::chrono::steady_clock::duration interval) noexcept
+{
+    auto constexpr most =
+        (std::numeric_limits<std::size_t>::max)();
+    if(rate == most)
+        return most;
+    auto const n = 2 * static_cast<double>(rate) *
+        std::chrono::duration<double>(interval).count();
+    if(n >= static_cast<double>(most))
+        return most;
+    return static_cast<std::size_t>(n);
+}
+
+// A budget of bytes which is refilled continuously at a fixed
+// rate, up to a maximum burst. A rate of `all` means unlimited,
+// and a rate of zero pauses until a new limit is set.
+class token_bucket
+{
+public:
+    using clock_type = std::chrono::steady_clock;
+
+    static std::size_t constexpr all =
+        (std::numeric_limits<std::size_t>::max)();
+
+private:
+    std::size_t rate_ = all;
+    std::size_t burst_ = all;
+    std::size_t tokens_ = all;
+    clock_type::time_point when_;
+
+public:
+    // Set the rate and burst, the bucket starts full
+    // unless the rate is zero
+    BOOST_BEAST_DECL
+    void
+    limit(std::size_t rate, std::size_t burst,
+        clock_type::time_point now) noexcept;
+
+    std::size_t
+    rate() const noexcept
+    {
+        return rate_;
+    }
+
+    std::size_t
+    burst() const noexcept
+    {
+        return burst_;
+    }
+
+    std::size_t
+    available() const noexcept
+    {
+        return tokens_;
+    }
+
+    void
+    take(std::size_t n) noexcept
+    {
+        if(rate_ != all)
+            tokens_ = (n < tokens_) ? tokens_ - n : 0;
+    }
+
+    // Add the tokens earned since the last refill
+    BOOST_BEAST_DECL
+    void
+    refill(clock_type::time_point now) noexcept;
+
+    void
+    refill() noexcept
+    {
+        if(rate_ != all)
+            refill(clock_type::now());
+    }
+};
+
+//------------------------------------------------------------------------------
+
+// A token_bucket which may be used by many threads at once.
+// Bytes taken beyond the available tokens are recorded as
+// debt, and paid back by subsequent refills.
+class shared_token_bucket
+{
+public:
+    using clock_type = std::chrono::steady_clock;
+
+    static std::size_t constexpr all =
+        (std::numeric_limits<std::size_t>::max)();
+
+private:
+    std::atomic<std::size_t> rate_{all};
+    std::atomic<std::size_t> burst_{all};
+    std::atomic<std::int64_t> tokens_{0};
+    std::atomic<clock_type::rep> when_{0};
+
+public:
+    // Set the rate and burst, the bucket starts full
+    // unless the rate is zero
+    BOOST_BEAST_DECL
+    void
+    limit(std::size_t rate, std::size_t burst,
+        clock_type::time_point now) noexcept;
+
+    std::size_t
+    rate() const noexcept
+    {
+        return rate_.load(std::memory_order_relaxed);
+    }
+
+    std::size_t
+    burst() const noexcept
+    {
+        return burst_.load(std::memory_order_relaxed);
+    }
+
+    BOOST_BEAST_DECL
+    std::size_t
+    available() const noexcept;
+
+    BOOST_BEAST_DECL
+    void
+    take(std::size_t n) noexcept;
+
+    // Add the tokens earned since the last refill
+    BOOST_BEAST_DECL
+    void
+    refill(clock_type::time_point now) noexcept;
+
+    void
+    refill() noexcept
+    {
+        if(rate() != all)
+            refill(clock_type::now());
+    }
+};
+
+} // detail
+} // beast
+} // boost
+
+#ifdef BOOST_BEAST_HEADER_ONLY
+#include <boost/beast/core/detail/token_bucket.ipp>
+#endif
+
+#endif
@@ -0,0 +1,182 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_DETAIL_TOKEN_BUCKET_IPP
+#define BOOST_BEAST_DETAIL_TOKEN_BUCKET_IPP
+
+#include <boost/beast/core/detail/token_bucket.hpp>
+
+namespace boost {
+namespace beast {
+namespace detail {
+
+// Returns the whole number of tokens earned at `rate` during
+// `elapsed`, at most `room`, and sets `used` to the part of
+// `elapsed` spent earning them. The remainder is kept for the
+// next refill, so no fraction of a token is ever lost. When the
+// bucket is full or the rate is zero, all of `elapsed` is used:
+// idle time does not accumulate beyond the burst.
+inline
+std::size_t
+token_bucket_earned(
+    std::size_t rate,
+    std::chrono::steady_clock::duration elapsed,
+    std::size_t room,
+    std::chrono::steady_clock::duration& used) noexcept
+{
+    using duration = std::chrono::steady_clock::duration;
+    if(room == 0 || rate == 0)
+    {
+        used = elapsed;
+        return 0;
+    }
+    auto const n =
+        std::chrono::duration<double>(elapsed).count() *
+            static_cast<double>(rate);
+    if(n >= static_cast<double>(room))
+    {
+        used = elapsed;
+        return room;
+    }
+    auto const whole = static_cast<std::size_t>(n);
+    used = std::chrono::duration_cast<duration>(
+        std::chrono::duration<double>(
+            static_cast<double>(whole) / static_cast<double>(rate)));
+    if(used > elapsed)
+        used = elapsed;
+    return whole;
+}
+
+inline
+std::int64_t
+token_bucket_clamp(std::size_t n) noexcept
+{
+    auto constexpr most =
+        (std::numeric_limits<std::int64_t>::max)();
+    if(static_cast<std::uint64_t>(n) >
+            static_cast<std::uint64_t>(most))
+        return most;
+    return static_cast<std::int64_t>(n);
+}
+
+//------------------------------------------------------------------------------
+
+void
+token_bucket::
+limit(std::size_t rate, std::size_t burst,
+    clock_type::time_point now) noexcept
+{
+    rate_ = rate;
+    if(rate_ == all)
+    {
+        burst_ = all;
+        tokens_ = all;
+        return;
+    }
+    burst_ = burst > 0 ? burst : 1;
+    // a zero rate pauses, nothing is available
+    tokens_ = rate_ > 0 ? burst_ : 0;
+    when_ = now;
+}
+
+void
+token_bucket::
+refill(clock_type::time_point now) noexcept
+{
+    if(rate_ == all || now <= when_)
+        return;
+    clock_type::duration used;
+    tokens_ += token_bucket_earned(
+        rate_, now - when_, burst_ - tokens_, used);
+    when_ += used;
+}
+
+//------------------------------------------------------------------------------
+
+void
+shared_token_bucket::
+limit(std::size_t rate, std::size_t burst,
+    clock_type::time_point now) noexcept
+{
+    if(burst == 0)
+        burst = 1;
+    when_.store(now.time_since_epoch().count());
+    // a zero rate pauses, nothing is available
+    tokens_.store(rate > 0 ? token_bucket_clamp(burst) : 0);
+    burst_.store(burst);
+    rate_.store(rate);
+}
+
+std::size_t
+shared_token_bucket::
+available() const noexcept
+{
+    if(rate_.load() == all)
+        return all;
+    auto const t = tokens_.load();
+    if(t <= 0)
+        return 0;
+    return static_cast<std::size_t>(t);
+}
+
+void
+shared_token_bucket::
+take(std::size_t n) noexcept
+{
+    if(rate_.load() == all)
+        return;
+    tokens_.fetch_sub(token_bucket_clamp(n));
+}
+
+void
+shared_token_bucket::
+refill(clock_type::time_point now) noexcept
+{
+    auto const rate = rate_.load();
+    if(rate == all)
+        return;
+    auto const t1 = now.time_since_epoch().count();
+    auto t0 = when_.load();
+    for(;;)
+    {
+        if(t1 <= t0)
+            return;
+        auto const tokens = tokens_.load();
+        auto const burst = token_bucket_clamp(burst_.load());
+        std::size_t room = 0;
+        if(tokens < burst)
+        {
+            // unsigned arithmetic, the debt may be large
+            auto const d =
+                static_cast<std::uint64_t>(burst) -
+                static_cast<std::uint64_t>(tokens);
+            auto constexpr most =
+                (std::numeric_limits<std::size_t>::max)();
+            room = d > static_cast<std::uint64_t>(most) ?
+                most : static_cast<std::size_t>(d);
+        }
+        clock_type::duration used;
+        auto const n = token_bucket_earned(
+            rate, clock_type::duration(t1 - t0), room, used);
+        if(used.count() == 0)
+            return;
+        // whoever advances the time adds the tokens
+        if(when_.compare_exchange_weak(t0, t0 + used.count()))
+        {
+            tokens_.fetch_add(token_bucket_clamp(n));
+            return;
+        }
+    }
+}
+
+} // detail
+} // beast
+} // boost
+
+#endif
@@ -124,6 +124,18 @@ struct is_contiguous_container<T, E, void_t<
     >::type>>: std::true_type
 {};
 
+//------------------------------------------------------------------------------
+
+// true if T is one buffer, rather than a sequence of them
+template<class T>
+struct is_single_buffer
+    : std::integral_constant<bool,
+        std::is_same<T, net::mutable_buffer>::value ||
+        std::is_same<T, net::const_buffer>::value
+    >
+{
+};
+
 } // detail
 } // beast
 } // boost
@@ -0,0 +1,167 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_CORE_DETECT_PROTOCOL_HPP
+#define BOOST_BEAST_CORE_DETECT_PROTOCOL_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/error.hpp>
+#include <boost/asio/async_result.hpp>
+#include <type_traits>
+
+namespace boost {
+namespace beast {
+
+/** The protocol spoken by the peer, as determined by @ref detect_protocol.
+
+    @see detect_protocol, async_detect_protocol
+*/
+enum class detected_protocol
+{
+    /// The bytes received do not start any of the protocols below
+    unknown,
+
+    /// A TLS client_hello message
+    tls,
+
+    /// An HTTP/1 request line
+    http1,
+
+    /// The HTTP/2 connection preface `"PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n"`
+    http2,
+
+    /// A PROXY protocol version 1 header, which starts with `"PROXY "`
+    proxy_v1,
+
+    /// A PROXY protocol version 2 header, which starts with its 12 byte signature
+    proxy_v2
+};
+
+/** Detect the protocol spoken by the peer on a stream.
+
+    This function reads from a stream until it has received enough
+    bytes to tell which protocol the peer is speaking. It allows one
+    listening port to accept TLS, plain HTTP/1, HTTP/2 with prior
+    knowledge, and connections from a proxy using the PROXY protocol.
+
+    The call blocks until one of the following is true:
+
+    @li The protocol is determined,
+
+    @li The received data cannot start any of the recognized protocols, or
+
+    @li An error occurs.
+
+    No more than 24 bytes are needed to reach a decision, and reading
+    stops as soon as one is reached. Bytes read from the stream are
+    stored in the dynamic buffer and are not consumed. They are
+    meant to be given to the next layer as-is, for example as the
+    buffer passed to `ssl_stream::handshake`, to `http::read`, or to
+    a parser for the PROXY header, so no further copies are made.
+    Any data already in the buffer is examined before reading.
+
+    @param stream The stream to read from. This type must meet the
+    requirements of <em>SyncReadStream</em>.
+
+    @param buffer The dynamic buffer to use. This type must meet the
+    requirements of <em>DynamicBuffer</em>.
+
+    @param ec Set to the error if any occurred.
+
+    @return The protocol detected, or @ref detected_protocol::unknown
+    if an error occurs.
+
+    @see
+
+    <a href="https://tools.ietf.org/html/rfc7540#section-3.5">3.5. HTTP/2 Connection Preface</a>
+    (RFC7540: Hypertext Transfer Protocol Version 2)
+
+    <a href="https://www.haproxy.org/download/1.8/doc/proxy-protocol.txt">The PROXY protocol</a>
+*/
+template<
+    class SyncReadStream,
+    class DynamicBuffer>
+detected_protocol
+detect_protocol(
+    SyncReadStream& stream,
+    DynamicBuffer& buffer,
+    error_code& ec);
+
+/** Detect the protocol spoken by the peer on a stream asynchronously.
+
+    This function reads asynchronously from a stream until it has
+    received enough bytes to tell which protocol the peer is speaking.
+
+    This call always returns immediately. The asynchronous operation
+    will continue until one of the following conditions is true:
+
+    @li The protocol is determined,
+
+    @li The received data cannot start any of the recognized protocols, or
+
+    @li An error occurs.
+
+    The algorithm, known as a <em>composed asynchronous operation</em>,
+    is implemented in terms of calls to the next layer's `async_read_some`
+    function. The program must ensure that no other calls to
+    `async_read_some` are performed until this operation completes.
+
+    No more than 24 bytes are needed to reach a decision, and reading
+    stops as soon as one is reached. Bytes read from the stream are
+    stored in the dynamic buffer and are not consumed. They are
+    meant to be given to the next layer as-is, for example as the
+    buffer passed to `ssl_stream::async_handshake`, to
+    `http::async_read`, or to a parser for the PROXY header, so no
+    further copies are made. Any data already in the buffer is
+    examined before reading.
+
+    @param stream The stream to read from. This type must meet the
+    requirements of <em>AsyncReadStream</em>.
+
+    @param buffer The dynamic buffer to use. This type must meet the
+    requirements of <em>DynamicBuffer</em>. The object must remain
+    valid until the handler is called.
+
+    @param token The completion token used to determine the method
+    used to provide the result of the asynchronous operation. If
+    this is a completion handler, the implementation takes ownership
+    of the handler by performing a decay-copy, and the equivalent
+    function signature of the handler must be:
+
+    @code
+    void handler(
+        error_code const& error,    // Set to the error, if any
+        detected_protocol result    // The protocol detected
+    );
+    @endcode
+
+    Regardless of whether the asynchronous operation completes
+    immediately or not, the handler will not be invoked from within
+    this function. Invocation of the handler will be performed in a
+    manner equivalent to using `net::post`.
+
+    @see detect_protocol
+*/
+template<
+    class AsyncReadStream,
+    class DynamicBuffer,
+    class CompletionToken>
+BOOST_ASIO_INITFN_RESULT_TYPE(
+    CompletionToken, void(error_code, detected_protocol))
+async_detect_protocol(
+    AsyncReadStream& stream,
+    DynamicBuffer& buffer,
+    CompletionToken&& token);
+
+} // beast
+} // boost
+
+#include <boost/beast/core/impl/detect_protocol.hpp>
+
+#endif
@@ -12,6 +12,7 @@
 
 #include <boost/beast/core/detail/config.hpp>
 #include <boost/beast/core/detail/allocator.hpp>
+#include <boost/beast/core/growth_policy.hpp>
 #include <boost/asio/buffer.hpp>
 #include <boost/core/empty_value.hpp>
 #include <limits>
@@ -49,26 +50,46 @@ namespace beast {
     specified. If this limit is exceeded, the `std::length_error`
     exception will be thrown.
 
+    When the existing capacity is insufficient, the new capacity is
+    chosen by the growth policy. A buffer may also be configured to
+    release its memory once it has been idle for a while, see
+    @ref idle_shrink_growth.
+
+    @tparam Allocator The allocator to use for managing memory.
+
+    @tparam GrowthPolicy The policy used to compute the new capacity
+    when the buffer grows. The default, @ref geometric_growth, doubles
+    the capacity. See also @ref page_growth, @ref fixed_growth and
+    @ref idle_shrink_growth.
+
     @note This class is designed for use with algorithms that
     take dynamic buffers as parameters, and are optimized
     for the case where the input sequence or output sequence
     is stored in a single contiguous buffer.
 */
-template<class Allocator>
+template<
+    class Allocator,
+    class GrowthPolicy = geometric_growth>
 class basic_flat_buffer
 #if ! BOOST_BEAST_DOXYGEN
     : private boost::empty_value<
         typename detail::allocator_traits<Allocator>::
             template rebind_alloc<char>>
+    , private boost::empty_value<GrowthPolicy, 1>
 #endif
 {
-    template<class OtherAlloc>
+    template<class OtherAlloc, class OtherPolicy>
     friend class basic_flat_buffer;
 
     using base_alloc_type = typename
         detail::allocator_traits<Allocator>::
             template rebind_alloc<char>;
 
+    using growth_base = boost::empty_value<GrowthPolicy, 1>;
+
+    // the allocator
+    using boost::empty_value<base_alloc_type>::get;
+
     static bool constexpr default_nothrow =
         std::is_nothrow_default_constructible<Allocator>::value;
 
@@ -236,9 +257,9 @@ public:
         @throws std::length_error if `other.size()` exceeds the
         maximum allocation size of the allocator.
     */
-    template<class OtherAlloc>
+    template<class OtherAlloc, class OtherPolicy>
     basic_flat_buffer(
-        basic_flat_buffer<OtherAlloc> const& other)
+        basic_flat_buffer<OtherAlloc, OtherPolicy> const& other)
             noexcept(default_nothrow);
 
     /** Copy Constructor
@@ -254,9 +275,9 @@ public:
         @throws std::length_error if `other.size()` exceeds the
         maximum allocation size of `alloc`.
     */
-    template<class OtherAlloc>
+    template<class OtherAlloc, class OtherPolicy>
     basic_flat_buffer(
-        basic_flat_buffer<OtherAlloc> const& other,
+        basic_flat_buffer<OtherAlloc, OtherPolicy> const& other,
         Allocator const& alloc);
 
     /** Move Assignment
@@ -308,9 +329,9 @@ public:
         @throws std::length_error if `other.size()` exceeds the
         maximum allocation size of the allocator.
     */
-    template<class OtherAlloc>
+    template<class OtherAlloc, class OtherPolicy>
     basic_flat_buffer&
-    operator=(basic_flat_buffer<OtherAlloc> const& other);
+    operator=(basic_flat_buffer<OtherAlloc, OtherPolicy> const& other);
 
     /// Returns a copy of the allocator used.
     allocator_type
@@ -383,13 +404,27 @@ public:
     void
     clear() noexcept;
 
+    /// Returns the growth policy
+    GrowthPolicy&
+    growth_policy() noexcept
+    {
+        return growth_base::get();
+    }
+
+    /// Returns the growth policy
+    GrowthPolicy const&
+    growth_policy() const noexcept
+    {
+        return growth_base::get();
+    }
+
     /// Exchange two dynamic buffers
-    template<class Alloc>
+    template<class Alloc, class Policy>
     friend
     void
     swap(
-        basic_flat_buffer<Alloc>&,
-        basic_flat_buffer<Alloc>&);
+        basic_flat_buffer<Alloc, Policy>&,
+        basic_flat_buffer<Alloc, Policy>&);
 
     //--------------------------------------------------------------------------
 
@@ -488,6 +523,8 @@ public:
     commit(std::size_t n) noexcept
     {
         out_ += (std::min)(n, dist(out_, last_));
+        detail::growth_on_commit(
+            growth_base::get(), dist(in_, out_));
     }
 
     /** Remove bytes from beginning of the readable bytes.
@@ -509,8 +546,8 @@ public:
     consume(std::size_t n) noexcept;
 
 private:
-    template<class OtherAlloc>
-    void copy_from(basic_flat_buffer<OtherAlloc> const& other);
+    template<class OtherAlloc, class OtherPolicy>
+    void copy_from(basic_flat_buffer<OtherAlloc, OtherPolicy> const& other);
     void move_assign(basic_flat_buffer&, std::true_type);
     void move_assign(basic_flat_buffer&, std::false_type);
     void copy_assign(basic_flat_buffer const&, std::true_type);
@@ -519,6 +556,7 @@ private:
     void swap(basic_flat_buffer&, std::true_type);
     void swap(basic_flat_buffer&, std::false_type);
     char* alloc(std::size_t n);
+    void idle() noexcept;
 };
 
 /// A flat buffer which uses the default allocator.
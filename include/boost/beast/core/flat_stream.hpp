@@ -31,6 +31,11 @@ namespace beast {
     which does not use OpenSSL's scatter/gather interface for its
     low-level read some and write some operations.
 
+    When the first buffer is small and the next one would not fit,
+    the start of the next one is flattened along with it. A short
+    HTTP header followed by a large body is then written as one
+    full TLS record, instead of a tiny record for the header alone.
+
     It is normally not necessary to use this class directly if you
     are already using @ref ssl_stream. The following examples shows
     how to use this class with the ssl stream that comes with
@@ -92,6 +97,7 @@ class flat_stream
 {
     NextLayer stream_;
     flat_buffer buffer_;
+    std::size_t limit_ = max_size;
 
     BOOST_STATIC_ASSERT(has_get_executor<NextLayer>::value);
 
@@ -175,6 +181,29 @@ public:
         return stream_;
     }
 
+    /** Set the largest number of bytes flattened into one write.
+
+        Buffer sequences are copied into a single buffer of at most
+        this size before being written. The default is 16KB, the
+        size of a full TLS record. When the peer has negotiated a
+        smaller maximum fragment length, setting the limit to that
+        length avoids copying more than one record can hold.
+
+        @param n The new limit. A value of zero disables flattening.
+    */
+    void
+    flatten_limit(std::size_t n) noexcept
+    {
+        limit_ = n;
+    }
+
+    /// Returns the largest number of bytes flattened into one write.
+    std::size_t
+    flatten_limit() const noexcept
+    {
+        return limit_;
+    }
+
     //--------------------------------------------------------------------------
 
     /** Read some data from the stream.
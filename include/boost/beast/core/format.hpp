@@ -0,0 +1,110 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_CORE_FORMAT_HPP
+#define BOOST_BEAST_CORE_FORMAT_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <cstddef>
+
+namespace boost {
+namespace beast {
+
+/** A floating point value formatted with a fixed number of decimals.
+
+    Objects of this type are passed to @ref format_to to write a
+    floating point number in fixed-point notation, without an
+    exponent, with exactly the given number of digits after the
+    decimal point. The last digit is rounded to nearest. The decimal
+    point is always `'.'`, regardless of the global locale.
+
+    Infinity and NaN are written as `inf`, `-inf` and `nan`. Numbers
+    whose magnitude is too large to be represented exactly in fixed-point
+    notation (1e19 or more) are written in exponent notation instead,
+    with the same number of decimals, for example `1.00e+20`. This is
+    the output of `printf("%.*e")` in the "C" locale.
+
+    @par Example
+    @code
+    format_to(buffer, "elapsed: ", fixed_point(ms / 1000.0, 3), "s");
+    @endcode
+*/
+struct fixed_point
+{
+    /// The value to format
+    double value;
+
+    /// The number of digits after the decimal point, at most 9
+    unsigned precision;
+
+    /** Constructor
+
+        @param value_ The value to format.
+
+        @param precision_ The number of digits after the decimal
+        point. Values greater than 9 are treated as 9.
+    */
+    explicit
+    fixed_point(double value_, unsigned precision_ = 2) noexcept
+        : value(value_)
+        , precision(precision_ > 9 ? 9 : precision_)
+    {
+    }
+};
+
+/** Append formatted values to a dynamic buffer.
+
+    This function converts each argument to text and appends the
+    results, in order, to the readable bytes of the dynamic buffer.
+    Unlike @ref ostream, no stream, locale or virtual dispatch is
+    involved: the arguments are converted on the stack, the total size
+    is computed, and the text is copied into a single region obtained
+    from one call to `prepare`. When the buffer already has sufficient
+    capacity, no memory is allocated.
+
+    The list of arguments takes the place of a format string, so the
+    layout of the output is fixed at compile time. The following
+    argument types are accepted:
+
+    @li Integer types, written in decimal.
+
+    @li `char`, written as a single character.
+
+    @li `bool`, written as `true` or `false`.
+
+    @li Any type convertible to @ref string_view, including string
+        literals, `std::string` and @ref static_string, copied verbatim.
+
+    @li @ref fixed_point, for floating point numbers.
+
+    @par Example
+    @code
+    flat_buffer b;
+    format_to(b, "HTTP/1.1 ", 200, " OK\r\nContent-Length: ", n, "\r\n\r\n");
+    @endcode
+
+    @param buffer The dynamic buffer to append to.
+
+    @param args The values to format.
+
+    @return The number of bytes appended.
+
+    @throws std::length_error if the buffer's maximum size would be
+    exceeded. In this case the buffer is not modified.
+*/
+template<class DynamicBuffer, class... Args>
+std::size_t
+format_to(DynamicBuffer& buffer, Args const&... args);
+
+} // beast
+} // boost
+
+#include <boost/beast/core/impl/format.hpp>
+
+#endif
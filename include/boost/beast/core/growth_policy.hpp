@@ -0,0 +1,234 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_CORE_GROWTH_POLICY_HPP
+#define BOOST_BEAST_CORE_GROWTH_POLICY_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <algorithm>
+#include <cstddef>
+
+namespace boost {
+namespace beast {
+
+/** A growth policy which doubles the capacity.
+
+    When the existing capacity is insufficient, the new
+    capacity is twice the number of readable bytes, or the
+    number of bytes needed if that is larger, limited to the
+    maximum size. This amortizes the cost of reallocations
+    over the number of bytes added.
+
+    This is the default growth policy of @ref basic_flat_buffer.
+
+    @par Growth Policy Requirements
+
+    A growth policy is a class with this member function:
+
+    @code
+    std::size_t
+    grow(std::size_t size, std::size_t n, std::size_t max) const;
+    @endcode
+
+    It is called when `n` writable bytes are requested from a
+    buffer holding `size` readable bytes, and the existing
+    capacity is insufficient. It returns the new capacity,
+    which must be no smaller than `size + n`. The result is
+    reduced to `max` by the caller if it is larger.
+*/
+struct geometric_growth
+{
+    /// Returns the new capacity
+    std::size_t
+    grow(std::size_t size, std::size_t n, std::size_t) const noexcept
+    {
+        return (std::max<std::size_t>)(2 * size, size + n);
+    }
+};
+
+/** A growth policy which allocates whole pages.
+
+    The new capacity is computed as with @ref geometric_growth,
+    then rounded up to a multiple of the page size. Allocators
+    which serve large requests directly from the operating system
+    hand out whole pages anyway; this policy makes the slack
+    usable instead of wasting it.
+*/
+struct page_growth
+{
+    /// The page size used for rounding
+    std::size_t page_size = 4096;
+
+    /// Returns the new capacity
+    std::size_t
+    grow(std::size_t size, std::size_t n, std::size_t) const noexcept
+    {
+        auto const needed =
+            (std::max<std::size_t>)(2 * size, size + n);
+        return (needed + page_size - 1) / page_size * page_size;
+    }
+};
+
+/** A growth policy which allocates the maximum size at once.
+
+    The first allocation reserves the maximum size of the buffer,
+    which therefore never reallocates while it is in use. This
+    suits buffers with a small, fixed limit which are filled
+    repeatedly, where reallocating would only add cost.
+
+    A maximum size larger than @ref limit is treated as unbounded,
+    for example the default maximum of a buffer constructed without
+    one. In that case the capacity grows as with @ref geometric_growth
+    instead of attempting to allocate the maximum.
+*/
+struct fixed_growth
+{
+    /// The largest maximum size which is allocated at once
+    std::size_t limit = 1024 * 1024;
+
+    /// Returns the new capacity
+    std::size_t
+    grow(std::size_t size, std::size_t n, std::size_t max) const noexcept
+    {
+        if(max > limit)
+            return geometric_growth{}.grow(size, n, max);
+        return max;
+    }
+};
+
+/** A growth policy which also releases memory after a number of small uses.
+
+    A buffer which once held a large message keeps its capacity
+    for as long as it lives. This adaptor grows the buffer as the
+    wrapped policy does. In addition, each time the readable bytes
+    are completely consumed, it checks whether the most bytes the
+    buffer held since the previous time used no more than a quarter
+    of the capacity. After @ref idle_limit such uses in a row, the
+    memory is deallocated; the next call to `prepare` allocates
+    again at the size needed. A single large use resets the count.
+
+    The bookkeeping is stored in the policy, so buffers using
+    another growth policy do not pay for it.
+
+    @par Example
+    @code
+    basic_flat_buffer<std::allocator<char>, idle_shrink_growth<>> b;
+    b.growth_policy().idle_limit = 8;
+    @endcode
+
+    @tparam GrowthPolicy The policy used to compute the new capacity
+    when the buffer grows.
+*/
+template<class GrowthPolicy = geometric_growth>
+class idle_shrink_growth : public GrowthPolicy
+{
+    std::size_t count_ = 0;
+    std::size_t peak_ = 0;
+
+public:
+    /** The number of consecutive small uses after which memory is released.
+
+        Zero, the default, disables idle shrinking.
+    */
+    std::size_t idle_limit = 0;
+
+    /// Constructor
+    idle_shrink_growth() = default;
+
+    /** Constructor
+
+        @param limit The number of consecutive small uses after
+        which memory is released.
+
+        @param policy The wrapped growth policy.
+    */
+    explicit
+    idle_shrink_growth(
+        std::size_t limit,
+        GrowthPolicy const& policy = GrowthPolicy{})
+        : GrowthPolicy(policy)
+        , idle_limit(limit)
+    {
+    }
+
+    /** Called by the buffer after bytes are committed.
+
+        @param size The number of readable bytes.
+    */
+    void
+    on_commit(std::size_t size) noexcept
+    {
+        if(peak_ < size)
+            peak_ = size;
+    }
+
+    /** Called by the buffer when the readable bytes are consumed.
+
+        @param capacity The capacity of the buffer.
+
+        @return `true` if the memory should be released.
+    */
+    bool
+    on_consume(std::size_t capacity) noexcept
+    {
+        auto const peak = peak_;
+        peak_ = 0;
+        if(idle_limit == 0 || capacity == 0)
+            return false;
+        if(peak > capacity / 4)
+        {
+            count_ = 0;
+            return false;
+        }
+        if(++count_ < idle_limit)
+            return false;
+        count_ = 0;
+        return true;
+    }
+};
+
+namespace detail {
+
+template<class GrowthPolicy>
+void
+growth_on_commit(GrowthPolicy&, std::size_t) noexcept
+{
+}
+
+template<class GrowthPolicy>
+void
+growth_on_commit(
+    idle_shrink_growth<GrowthPolicy>& g,
+    std::size_t size) noexcept
+{
+    g.on_commit(size);
+}
+
+template<class GrowthPolicy>
+bool
+growth_on_consume(GrowthPolicy&, std::size_t) noexcept
+{
+    return false;
+}
+
+template<class GrowthPolicy>
+bool
+growth_on_consume(
+    idle_shrink_growth<GrowthPolicy>& g,
+    std::size_t capacity) noexcept
+{
+    return g.on_consume(capacity);
+}
+
+} // detail
+
+} // beast
+} // boost
+
+#endif
@@ -12,7 +12,7 @@
 
 #include <boost/beast/core/async_op_base.hpp>
 #include <boost/beast/core/buffer_size.hpp>
-#include <boost/beast/core/buffers_prefix.hpp>
+#include <boost/beast/core/buffers_array.hpp>
 #include <boost/beast/core/detail/type_traits.hpp>
 #include <boost/beast/websocket/teardown.hpp>
 #include <boost/asio/bind_executor.hpp>
@@ -29,9 +29,9 @@ namespace beast {
 
 //------------------------------------------------------------------------------
 
-template<class Protocol, class Executor, class RatePolicy>
+template<class Protocol, class Executor, class RatePolicy, class MetricsPolicy>
 template<class... Args>
-basic_stream<Protocol, Executor, RatePolicy>::
+basic_stream<Protocol, Executor, RatePolicy, MetricsPolicy>::
 impl_type::
 impl_type(std::false_type, Args&&... args)
     : socket(std::forward<Args>(args)...)
@@ -42,9 +42,9 @@ impl_type(std::false_type, Args&&... args)
     reset();
 }
 
-template<class Protocol, class Executor, class RatePolicy>
+template<class Protocol, class Executor, class RatePolicy, class MetricsPolicy>
 template<class RatePolicy_, class... Args>
-basic_stream<Protocol, Executor, RatePolicy>::
+basic_stream<Protocol, Executor, RatePolicy, MetricsPolicy>::
 impl_type::
 impl_type(std::true_type,
     RatePolicy_&& policy, Args&&... args)
@@ -59,10 +59,10 @@ impl_type(std::true_type,
     reset();
 }
 
-template<class Protocol, class Executor, class RatePolicy>
+template<class Protocol, class Executor, class RatePolicy, class MetricsPolicy>
 template<class Executor2>
 void
-basic_stream<Protocol, Executor, RatePolicy>::
+basic_stream<Protocol, Executor, RatePolicy, MetricsPolicy>::
 impl_type::
 on_timer(Executor2 const& ex2)
 {
@@ -72,9 +72,17 @@ on_timer(Executor2 const& ex2)
     if(--waiting > 0)
         return;
 
+    // A policy with an interval measures the elapsed time
+    // itself, so the timer only runs while operations wait.
+    if(rate_policy_access::has_interval<RatePolicy>::value)
+    {
+        rate_policy_access::on_timer(policy());
+        return;
+    }
+
     // update the expiration time
     BOOST_VERIFY(timer.expires_after(
-        std::chrono::seconds(1)) == 0);
+        rate_policy_access::interval(policy())) == 0);
 
     rate_policy_access::on_timer(policy());
 
@@ -119,9 +127,24 @@ on_timer(Executor2 const& ex2)
     timer.async_wait(handler(ex2, this->shared_from_this()));
 }
 
-template<class Protocol, class Executor, class RatePolicy>
+template<class Protocol, class Executor, class RatePolicy, class MetricsPolicy>
+void
+basic_stream<Protocol, Executor, RatePolicy, MetricsPolicy>::
+impl_type::
+on_rate_wait()
+{
+    // Without a periodic timer, the first
+    // waiter starts a new interval.
+    if( rate_policy_access::has_interval<RatePolicy>::value &&
+        waiting == 0)
+        BOOST_VERIFY(timer.expires_after(
+            rate_policy_access::interval(policy())) == 0);
+    ++waiting;
+}
+
+template<class Protocol, class Executor, class RatePolicy, class MetricsPolicy>
 void
-basic_stream<Protocol, Executor, RatePolicy>::
+basic_stream<Protocol, Executor, RatePolicy, MetricsPolicy>::
 impl_type::
 reset()
 {
@@ -141,9 +164,9 @@ reset()
             write.timer.expires_at(never()) == 0);
 }
 
-template<class Protocol, class Executor, class RatePolicy>
+template<class Protocol, class Executor, class RatePolicy, class MetricsPolicy>
 void
-basic_stream<Protocol, Executor, RatePolicy>::
+basic_stream<Protocol, Executor, RatePolicy, MetricsPolicy>::
 impl_type::
 close()
 {
@@ -160,8 +183,8 @@ close()
 
 //------------------------------------------------------------------------------
 
-template<class Protocol, class Executor, class RatePolicy>
-struct basic_stream<Protocol, Executor, RatePolicy>::
+template<class Protocol, class Executor, class RatePolicy, class MetricsPolicy>
+struct basic_stream<Protocol, Executor, RatePolicy, MetricsPolicy>::
     timeout_handler
 {
     op_state& state;
@@ -194,10 +217,59 @@ struct basic_stream<Protocol, Executor, RatePolicy>::
     }
 };
 
+template<class Protocol, class Executor, class RatePolicy, class MetricsPolicy>
+template<class Executor2>
+void
+basic_stream<Protocol, Executor, RatePolicy, MetricsPolicy>::
+impl_type::
+start_timeout(op_state& state, Executor2 const& ex2)
+{
+    if(wheel)
+    {
+        state.entry.owner = this;
+        state.entry.expire = &impl_type::on_expire;
+        wheel->insert(state.entry, state.timer.expiry());
+        return;
+    }
+    state.timer.async_wait(
+        net::bind_executor(ex2,
+            timeout_handler{
+                state,
+                this->shared_from_this(),
+                state.tick}));
+}
+
+template<class Protocol, class Executor, class RatePolicy, class MetricsPolicy>
+std::size_t
+basic_stream<Protocol, Executor, RatePolicy, MetricsPolicy>::
+impl_type::
+stop_timeout(op_state& state)
+{
+    if(wheel)
+        return wheel->remove(state.entry) ? 1 : 0;
+    return state.timer.cancel();
+}
+
+template<class Protocol, class Executor, class RatePolicy, class MetricsPolicy>
+void
+basic_stream<Protocol, Executor, RatePolicy, MetricsPolicy>::
+impl_type::
+on_expire(detail::timeout_entry& e)
+{
+    // The entry is unlinked when the
+    // operation or the stream goes away.
+    auto& self = *static_cast<impl_type*>(e.owner);
+    auto& state = &e == &self.read.entry ?
+        self.read : self.write;
+    BOOST_ASSERT(! state.timeout);
+    self.close();
+    state.timeout = true;
+}
+
 //------------------------------------------------------------------------------
 
-template<class Protocol, class Executor, class RatePolicy>
-struct basic_stream<Protocol, Executor, RatePolicy>::ops
+template<class Protocol, class Executor, class RatePolicy, class MetricsPolicy>
+struct basic_stream<Protocol, Executor, RatePolicy, MetricsPolicy>::ops
 {
 
 template<bool isRead, class Buffers, class Handler>
@@ -208,6 +280,7 @@ class transfer_op
     boost::shared_ptr<impl_type> impl_;
     pending_guard pg_;
     Buffers b_;
+    std::chrono::steady_clock::time_point t0_;
 
     using is_read = std::integral_constant<bool, isRead>;
 
@@ -270,12 +343,55 @@ class transfer_op
         transfer_bytes(n, is_read{});
     }
 
+    std::chrono::steady_clock::time_point
+    now()
+    {
+        return metrics_policy_access::now(impl_->metrics());
+    }
+
+    void
+    on_transfer(std::size_t n, std::true_type)
+    {
+        metrics_policy_access::on_read(
+            impl_->metrics(), n, now() - t0_);
+    }
+
+    void
+    on_transfer(std::size_t n, std::false_type)
+    {
+        metrics_policy_access::on_write(
+            impl_->metrics(), n, now() - t0_);
+    }
+
+    // The buffers are flattened in bulk, so the socket
+    // iterates a plain array instead of nested adaptors.
+    // The array is no larger than the sequence can ever be.
+    using buffers_array_type =
+        beast::detail::buffers_array_for<
+            buffers_type<Buffers>, Buffers>;
+
+    // A single buffer is passed through as-is, so the socket
+    // can take its single buffer path.
+    using is_single_buffer = detail::is_single_buffer<Buffers>;
+
+    buffers_array_type
+    prepare(std::size_t amount, std::false_type)
+    {
+        return buffers_array_type(b_, amount);
+    }
+
+    Buffers
+    prepare(std::size_t amount, std::true_type)
+    {
+        return net::buffer(b_, amount);
+    }
+
     void
     async_perform(
         std::size_t amount, std::true_type)
     {
         impl_->socket.async_read_some(
-            beast::buffers_prefix(amount, b_),
+            prepare(amount, is_single_buffer{}),
                 std::move(*this));
     }
 
@@ -284,7 +400,7 @@ class transfer_op
         std::size_t amount, std::false_type)
     {
         impl_->socket.async_write_some(
-            beast::buffers_prefix(amount, b_),
+            prepare(amount, is_single_buffer{}),
                 std::move(*this));
     }
 
@@ -314,8 +430,10 @@ public:
             if(detail::buffers_empty(b_))
             {
                 // make sure we perform the no-op
+                t0_ = now();
                 BOOST_ASIO_CORO_YIELD
                 async_perform(0, is_read{});
+                on_transfer(bytes_transferred, is_read{});
                 // apply the timeout manually, otherwise
                 // behavior varies across platforms.
                 if(state().timer.expiry() <= clock_type::now())
@@ -328,23 +446,20 @@ public:
 
             // if a timeout is active, wait on the timer
             if(state().timer.expiry() != never())
-                state().timer.async_wait(
-                    net::bind_executor(
-                        this->get_executor(),
-                        timeout_handler{
-                            state(),
-                            impl_,
-                            state().tick
-                        }));
+                impl_->start_timeout(
+                    state(), this->get_executor());
 
             // check rate limit, maybe wait
             std::size_t amount;
             amount = available_bytes();
-            if(amount == 0)
+            while(amount == 0)
             {
-                ++impl_->waiting;
+                impl_->on_rate_wait();
+                t0_ = now();
                 BOOST_ASIO_CORO_YIELD
                 impl_->timer.async_wait(std::move(*this));
+                metrics_policy_access::on_rate_wait(
+                    impl_->metrics(), now() - t0_);
                 if(ec)
                 {
                     // socket was closed, or a timeout
@@ -361,14 +476,20 @@ public:
                 }
                 impl_->on_timer(this->get_executor());
 
-                // Allow at least one byte, otherwise
-                // bytes_transferred could be 0.
-                amount = std::max<std::size_t>(
-                    available_bytes(), 1);
+                // A policy with an interval is refilled over
+                // time, keep waiting until it allows bytes.
+                // Otherwise allow at least one byte, so that
+                // bytes_transferred is never 0.
+                amount = available_bytes();
+                if(! rate_policy_access::has_interval<
+                        RatePolicy>::value && amount == 0)
+                    amount = 1;
             }
 
+            t0_ = now();
             BOOST_ASIO_CORO_YIELD
             async_perform(amount, is_read{});
+            on_transfer(bytes_transferred, is_read{});
 
             if(state().timer.expiry() != never())
             {
@@ -376,7 +497,7 @@ public:
 
                 // try cancelling timer
                 auto const n =
-                    state().timer.cancel();
+                    impl_->stop_timeout(state());
                 if(n == 0)
                 {
                     // timeout handler invoked?
@@ -397,7 +518,14 @@ public:
         upcall:
             pg_.reset();
             transfer_bytes(bytes_transferred);
+            if(ec == beast::error::timeout)
+                metrics_policy_access::on_timeout(
+                    impl_->metrics());
+            // the handler runs before invoke_now returns
+            t0_ = now();
             this->invoke_now(ec, bytes_transferred);
+            metrics_policy_access::on_handler(
+                impl_->metrics(), now() - t0_);
         }
     }
 };
@@ -429,13 +557,8 @@ public:
         , pg1_(impl_->write.pending)
     {
         if(state().timer.expiry() != stream_base::never())
-            impl_->write.timer.async_wait(
-                net::bind_executor(
-                    this->get_executor(),
-                    timeout_handler{
-                        state(),
-                        impl_,
-                        state().tick}));
+            impl_->start_timeout(
+                state(), this->get_executor());
 
         impl_->socket.async_connect(
             ep, std::move(*this));
@@ -457,13 +580,8 @@ public:
         , pg1_(impl_->write.pending)
     {
         if(state().timer.expiry() != stream_base::never())
-            impl_->write.timer.async_wait(
-                net::bind_executor(
-                    this->get_executor(),
-                    timeout_handler{
-                        state(),
-                        impl_,
-                        state().tick}));
+            impl_->start_timeout(
+                state(), this->get_executor());
 
         net::async_connect(impl_->socket,
             eps, cond, std::move(*this));
@@ -485,13 +603,8 @@ public:
         , pg1_(impl_->write.pending)
     {
         if(state().timer.expiry() != stream_base::never())
-            impl_->write.timer.async_wait(
-                net::bind_executor(
-                    this->get_executor(),
-                    timeout_handler{
-                        state(),
-                        impl_,
-                        state().tick}));
+            impl_->start_timeout(
+                state(), this->get_executor());
 
         net::async_connect(impl_->socket,
             begin, end, cond, std::move(*this));
@@ -508,7 +621,7 @@ public:
 
             // try cancelling timer
             auto const n =
-                impl_->write.timer.cancel();
+                impl_->stop_timeout(state());
             if(n == 0)
             {
                 // timeout handler invoked?
@@ -526,6 +639,9 @@ public:
             }
         }
 
+        if(ec == beast::error::timeout)
+            metrics_policy_access::on_timeout(
+                impl_->metrics());
         pg0_.reset();
         pg1_.reset();
         this->invoke_now(ec, std::forward<Args>(args)...);
@@ -665,8 +781,8 @@ struct run_connect_iter_op
 
 //------------------------------------------------------------------------------
 
-template<class Protocol, class Executor, class RatePolicy>
-basic_stream<Protocol, Executor, RatePolicy>::
+template<class Protocol, class Executor, class RatePolicy, class MetricsPolicy>
+basic_stream<Protocol, Executor, RatePolicy, MetricsPolicy>::
 ~basic_stream()
 {
     // the shared object can outlive *this,
@@ -675,9 +791,9 @@ basic_stream<Protocol, Executor, RatePolicy>::
     impl_->close();
 }
 
-template<class Protocol, class Executor, class RatePolicy>
+template<class Protocol, class Executor, class RatePolicy, class MetricsPolicy>
 template<class Arg0, class... Args, class>
-basic_stream<Protocol, Executor, RatePolicy>::
+basic_stream<Protocol, Executor, RatePolicy, MetricsPolicy>::
 basic_stream(Arg0&& arg0, Args&&... args)
     : impl_(boost::make_shared<impl_type>(
         std::false_type{},
@@ -686,9 +802,9 @@ basic_stream(Arg0&& arg0, Args&&... args)
 {
 }
 
-template<class Protocol, class Executor, class RatePolicy>
+template<class Protocol, class Executor, class RatePolicy, class MetricsPolicy>
 template<class RatePolicy_, class Arg0, class... Args, class>
-basic_stream<Protocol, Executor, RatePolicy>::
+basic_stream<Protocol, Executor, RatePolicy, MetricsPolicy>::
 basic_stream(
     RatePolicy_&& policy, Arg0&& arg0, Args&&... args)
     : impl_(boost::make_shared<impl_type>(
@@ -699,8 +815,8 @@ basic_stream(
 {
 }
 
-template<class Protocol, class Executor, class RatePolicy>
-basic_stream<Protocol, Executor, RatePolicy>::
+template<class Protocol, class Executor, class RatePolicy, class MetricsPolicy>
+basic_stream<Protocol, Executor, RatePolicy, MetricsPolicy>::
 basic_stream(basic_stream&& other)
     : impl_(boost::make_shared<impl_type>(
         std::move(*other.impl_)))
@@ -710,9 +826,9 @@ basic_stream(basic_stream&& other)
 
 //------------------------------------------------------------------------------
 
-template<class Protocol, class Executor, class RatePolicy>
+template<class Protocol, class Executor, class RatePolicy, class MetricsPolicy>
 auto
-basic_stream<Protocol, Executor, RatePolicy>::
+basic_stream<Protocol, Executor, RatePolicy, MetricsPolicy>::
 release_socket() ->
     socket_type
 {
@@ -720,9 +836,9 @@ release_socket() ->
     return std::move(impl_->socket);
 }
 
-template<class Protocol, class Executor, class RatePolicy>
+template<class Protocol, class Executor, class RatePolicy, class MetricsPolicy>
 void
-basic_stream<Protocol, Executor, RatePolicy>::
+basic_stream<Protocol, Executor, RatePolicy, MetricsPolicy>::
 expires_after(std::chrono::nanoseconds expiry_time)
 {
     // If assert goes off, it means that there are
@@ -745,9 +861,9 @@ expires_after(std::chrono::nanoseconds expiry_time)
                 expiry_time) == 0);
 }
 
-template<class Protocol, class Executor, class RatePolicy>
+template<class Protocol, class Executor, class RatePolicy, class MetricsPolicy>
 void
-basic_stream<Protocol, Executor, RatePolicy>::
+basic_stream<Protocol, Executor, RatePolicy, MetricsPolicy>::
 expires_at(
     net::steady_timer::time_point expiry_time)
 {
@@ -771,17 +887,36 @@ expires_at(
                 expiry_time) == 0);
 }
 
-template<class Protocol, class Executor, class RatePolicy>
+template<class Protocol, class Executor, class RatePolicy, class MetricsPolicy>
 void
-basic_stream<Protocol, Executor, RatePolicy>::
+basic_stream<Protocol, Executor, RatePolicy, MetricsPolicy>::
 expires_never()
 {
     impl_->reset();
 }
 
-template<class Protocol, class Executor, class RatePolicy>
+template<class Protocol, class Executor, class RatePolicy, class MetricsPolicy>
+void
+basic_stream<Protocol, Executor, RatePolicy, MetricsPolicy>::
+use_timeout_wheel(timeout_wheel* wheel) noexcept
+{
+    // If assert goes off, it means that there are
+    // operations outstanding, which may be waiting
+    // on the timers being replaced.
+    //
+    BOOST_ASSERT(
+        ! impl_->read.pending &&
+        ! impl_->write.pending);
+
+    if(wheel)
+        impl_->wheel = wheel->impl_;
+    else
+        impl_->wheel.reset();
+}
+
+template<class Protocol, class Executor, class RatePolicy, class MetricsPolicy>
 void
-basic_stream<Protocol, Executor, RatePolicy>::
+basic_stream<Protocol, Executor, RatePolicy, MetricsPolicy>::
 cancel()
 {
     error_code ec;
@@ -789,9 +924,9 @@ cancel()
     impl_->timer.cancel();
 }
 
-template<class Protocol, class Executor, class RatePolicy>
+template<class Protocol, class Executor, class RatePolicy, class MetricsPolicy>
 void
-basic_stream<Protocol, Executor, RatePolicy>::
+basic_stream<Protocol, Executor, RatePolicy, MetricsPolicy>::
 close()
 {
     impl_->close();
@@ -799,11 +934,11 @@ close()
 
 //------------------------------------------------------------------------------
 
-template<class Protocol, class Executor, class RatePolicy>
+template<class Protocol, class Executor, class RatePolicy, class MetricsPolicy>
 template<class ConnectHandler>
 BOOST_ASIO_INITFN_RESULT_TYPE(ConnectHandler,
     void(error_code))
-basic_stream<Protocol, Executor, RatePolicy>::
+basic_stream<Protocol, Executor, RatePolicy, MetricsPolicy>::
 async_connect(
     endpoint_type const& ep,
     ConnectHandler&& handler)
@@ -817,14 +952,14 @@ async_connect(
             ep);
 }
 
-template<class Protocol, class Executor, class RatePolicy>
+template<class Protocol, class Executor, class RatePolicy, class MetricsPolicy>
 template<
     class EndpointSequence,
     class RangeConnectHandler,
     class>
 BOOST_ASIO_INITFN_RESULT_TYPE(RangeConnectHandler,
     void(error_code, typename Protocol::endpoint))
-basic_stream<Protocol, Executor, RatePolicy>::
+basic_stream<Protocol, Executor, RatePolicy, MetricsPolicy>::
 async_connect(
     EndpointSequence const& endpoints,
     RangeConnectHandler&& handler)
@@ -839,7 +974,7 @@ async_connect(
             detail::any_endpoint{});
 }
 
-template<class Protocol, class Executor, class RatePolicy>
+template<class Protocol, class Executor, class RatePolicy, class MetricsPolicy>
 template<
     class EndpointSequence,
     class ConnectCondition,
@@ -847,7 +982,7 @@ template<
     class>
 BOOST_ASIO_INITFN_RESULT_TYPE(RangeConnectHandler,
     void (error_code, typename Protocol::endpoint))
-basic_stream<Protocol, Executor, RatePolicy>::
+basic_stream<Protocol, Executor, RatePolicy, MetricsPolicy>::
 async_connect(
     EndpointSequence const& endpoints,
     ConnectCondition connect_condition,
@@ -863,13 +998,13 @@ async_connect(
             connect_condition);
 }
 
-template<class Protocol, class Executor, class RatePolicy>
+template<class Protocol, class Executor, class RatePolicy, class MetricsPolicy>
 template<
     class Iterator,
     class IteratorConnectHandler>
 BOOST_ASIO_INITFN_RESULT_TYPE(IteratorConnectHandler,
     void (error_code, Iterator))
-basic_stream<Protocol, Executor, RatePolicy>::
+basic_stream<Protocol, Executor, RatePolicy, MetricsPolicy>::
 async_connect(
     Iterator begin, Iterator end,
     IteratorConnectHandler&& handler)
@@ -884,14 +1019,14 @@ async_connect(
             detail::any_endpoint{});
 }
 
-template<class Protocol, class Executor, class RatePolicy>
+template<class Protocol, class Executor, class RatePolicy, class MetricsPolicy>
 template<
     class Iterator,
     class ConnectCondition,
     class IteratorConnectHandler>
 BOOST_ASIO_INITFN_RESULT_TYPE(IteratorConnectHandler,
     void (error_code, Iterator))
-basic_stream<Protocol, Executor, RatePolicy>::
+basic_stream<Protocol, Executor, RatePolicy, MetricsPolicy>::
 async_connect(
     Iterator begin, Iterator end,
     ConnectCondition connect_condition,
@@ -909,11 +1044,11 @@ async_connect(
 
 //------------------------------------------------------------------------------
 
-template<class Protocol, class Executor, class RatePolicy>
+template<class Protocol, class Executor, class RatePolicy, class MetricsPolicy>
 template<class MutableBufferSequence, class ReadHandler>
 BOOST_ASIO_INITFN_RESULT_TYPE(ReadHandler,
     void(error_code, std::size_t))
-basic_stream<Protocol, Executor, RatePolicy>::
+basic_stream<Protocol, Executor, RatePolicy, MetricsPolicy>::
 async_read_some(
     MutableBufferSequence const& buffers,
     ReadHandler&& handler)
@@ -930,11 +1065,11 @@ async_read_some(
             buffers);
 }
 
-template<class Protocol, class Executor, class RatePolicy>
+template<class Protocol, class Executor, class RatePolicy, class MetricsPolicy>
 template<class ConstBufferSequence, class WriteHandler>
 BOOST_ASIO_INITFN_RESULT_TYPE(WriteHandler,
     void(error_code, std::size_t))
-basic_stream<Protocol, Executor, RatePolicy>::
+basic_stream<Protocol, Executor, RatePolicy, MetricsPolicy>::
 async_write_some(
     ConstBufferSequence const& buffers,
     WriteHandler&& handler)
@@ -959,21 +1094,23 @@ async_write_some(
 #if ! BOOST_BEAST_DOXYGEN
 
 template<
-    class Protocol, class Executor, class RatePolicy>
+    class Protocol, class Executor,
+    class RatePolicy, class MetricsPolicy>
 void
 beast_close_socket(
-    basic_stream<Protocol, Executor, RatePolicy>& stream)
+    basic_stream<Protocol, Executor, RatePolicy, MetricsPolicy>& stream)
 {
     error_code ec;
     stream.socket().close(ec);
 }
 
 template<
-    class Protocol, class Executor, class RatePolicy>
+    class Protocol, class Executor,
+    class RatePolicy, class MetricsPolicy>
 void
 teardown(
     websocket::role_type role,
-    basic_stream<Protocol, Executor, RatePolicy>& stream,
+    basic_stream<Protocol, Executor, RatePolicy, MetricsPolicy>& stream,
     error_code& ec)
 {
     using beast::websocket::teardown;
@@ -981,12 +1118,13 @@ teardown(
 }
 
 template<
-    class Protocol, class Executor, class RatePolicy,
+    class Protocol, class Executor,
+    class RatePolicy, class MetricsPolicy,
     class TeardownHandler>
 void
 async_teardown(
     websocket::role_type role,
-    basic_stream<Protocol, Executor, RatePolicy>& stream,
+    basic_stream<Protocol, Executor, RatePolicy, MetricsPolicy>& stream,
     TeardownHandler&& handler)
 {
     using beast::websocket::async_teardown;
@@ -65,7 +65,7 @@ public:
         case 0:
             if(s_.buffer_.size() == 0)
             {
-                if(s_.capacity_ == 0)
+                if(! s_.read_ahead(b_))
                 {
                     // read (unbuffered)
                     step_ = 1;
@@ -196,7 +196,7 @@ read_some(MutableBufferSequence const& buffers,
             "MutableBufferSequence type requirements not met");
     if(buffer_.size() == 0)
     {
-        if(capacity_ == 0)
+        if(! read_ahead(buffers))
             return next_layer_.read_some(buffers, ec);
         buffer_.commit(next_layer_.read_some(
             buffer_.prepare(read_size(buffer_,
@@ -228,7 +228,7 @@ async_read_some(
     static_assert(net::is_mutable_buffer_sequence<
         MutableBufferSequence>::value,
             "MutableBufferSequence type requirements not met");
-    if(buffer_.size() == 0 && capacity_ == 0)
+    if(buffer_.size() == 0 && ! read_ahead(buffers))
         return next_layer_.async_read_some(buffers,
             std::forward<ReadHandler>(handler));
     return net::async_initiate<
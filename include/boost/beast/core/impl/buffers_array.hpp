@@ -0,0 +1,223 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_IMPL_BUFFERS_ARRAY_HPP
+#define BOOST_BEAST_IMPL_BUFFERS_ARRAY_HPP
+
+#include <boost/mp11/integral.hpp>
+#include <boost/mp11/algorithm.hpp>
+#include <algorithm>
+#include <type_traits>
+
+namespace boost {
+namespace beast {
+
+namespace detail {
+
+// Receives buffers in order, until the
+// array is full or the byte limit is reached.
+template<class Buffer>
+struct buffers_array_sink
+{
+    using value_type = Buffer;
+
+    Buffer* it;
+    Buffer* end;
+    std::size_t limit;
+
+    bool
+    full() const noexcept
+    {
+        return it == end || limit == 0;
+    }
+
+    void
+    push(Buffer b) noexcept
+    {
+        if(b.size() == 0)
+            return;
+        if(b.size() > limit)
+            b = Buffer(b.data(), limit);
+        *it++ = b;
+        limit -= b.size();
+    }
+};
+
+struct buffers_array_access
+{
+    template<class Sink, class Iterator, class Sentinel>
+    static
+    void
+    copy(
+        Sink& sink,
+        Iterator first,
+        Sentinel const& last,
+        std::size_t skip)
+    {
+        for(; first != last && ! sink.full(); ++first)
+        {
+            typename Sink::value_type b(*first);
+            sink.push(b + skip);
+            skip = 0;
+        }
+    }
+
+    // any buffer sequence
+    template<class Sink, class BufferSequence>
+    static
+    void
+    materialize(Sink& sink, BufferSequence const& buffers)
+    {
+        copy(sink,
+            net::buffer_sequence_begin(buffers),
+            net::buffer_sequence_end(buffers), 0);
+    }
+
+    template<class Sink, class... Bn>
+    struct cat_visitor
+    {
+        Sink& sink;
+        buffers_cat_view<Bn...> const& view;
+        typename buffers_cat_view<Bn...>::const_iterator const& it;
+        std::size_t skip;
+
+        // each sequence starting at I, in order
+        template<std::size_t I>
+        void
+        rest(mp11::mp_size_t<I>)
+        {
+            if(sink.full())
+                return;
+            materialize(sink, detail::get<I>(view.bn_));
+            rest(mp11::mp_size_t<I+1>{});
+        }
+
+        void
+        rest(mp11::mp_size_t<sizeof...(Bn)>)
+        {
+        }
+
+        // default-constructed iterator
+        void
+        operator()(mp11::mp_size_t<0>)
+        {
+        }
+
+        // the remainder of the sequence holding the
+        // iterator, followed by all later sequences
+        template<std::size_t I>
+        void
+        operator()(mp11::mp_size_t<I>)
+        {
+            copy(sink,
+                it.it_.template get<I>(),
+                net::buffer_sequence_end(
+                    detail::get<I-1>(view.bn_)),
+                skip);
+            rest(mp11::mp_size_t<I>{});
+        }
+
+        // one past the end
+        void
+        operator()(mp11::mp_size_t<sizeof...(Bn)+1>)
+        {
+        }
+    };
+
+    // buffers starting at an iterator into a concatenation
+    template<class Sink, class... Bn>
+    static
+    void
+    materialize_from(
+        Sink& sink,
+        buffers_cat_view<Bn...> const& view,
+        typename buffers_cat_view<Bn...>::const_iterator const& it,
+        std::size_t skip)
+    {
+        mp11::mp_with_index<sizeof...(Bn) + 2>(
+            it.it_.index(),
+            cat_visitor<Sink, Bn...>{sink, view, it, skip});
+    }
+
+    template<class Sink, class BufferSequence, class Iterator>
+    static
+    void
+    materialize_from(
+        Sink& sink,
+        BufferSequence const& buffers,
+        Iterator const& it,
+        std::size_t skip)
+    {
+        copy(sink, it,
+            net::buffer_sequence_end(buffers), skip);
+    }
+
+    template<class Sink, class... Bn>
+    static
+    void
+    materialize(
+        Sink& sink,
+        buffers_cat_view<Bn...> const& view)
+    {
+        cat_visitor<Sink, Bn...>{sink, view, {}, 0}.rest(
+            mp11::mp_size_t<0>{});
+    }
+
+    template<class Sink, class BufferSequence>
+    static
+    void
+    materialize(
+        Sink& sink,
+        buffers_prefix_view<BufferSequence> const& view)
+    {
+        auto const limit = sink.limit;
+        auto const n = (std::min)(limit, view.size_);
+        sink.limit = n;
+        materialize(sink, view.bs_);
+        sink.limit = limit - (n - sink.limit);
+    }
+
+    template<class Sink, class BufferSequence>
+    static
+    void
+    materialize(
+        Sink& sink,
+        buffers_suffix<BufferSequence> const& view)
+    {
+        materialize_from(sink,
+            view.bs_, view.begin_, view.skip_);
+    }
+};
+
+} // detail
+
+template<class Buffer, std::size_t N>
+template<class BufferSequence>
+buffers_array<Buffer, N>::
+buffers_array(
+    BufferSequence const& buffers,
+    std::size_t limit)
+{
+    static_assert(
+        net::is_const_buffer_sequence<BufferSequence>::value,
+        "BufferSequence type requirements not met");
+    static_assert(
+        std::is_convertible<
+            buffers_type<BufferSequence>, Buffer>::value,
+        "BufferSequence type requirements not met");
+    detail::buffers_array_sink<Buffer> sink{
+        v_, v_ + N, limit};
+    detail::buffers_array_access::materialize(sink, buffers);
+    n_ = static_cast<std::size_t>(sink.it - v_);
+}
+
+} // beast
+} // boost
+
+#endif
@@ -100,6 +100,7 @@ class buffers_cat_view<Bn...>::const_iterator
         buffers_iterator_type<Bn>..., past_end> it_{};
 
     friend class buffers_cat_view<Bn...>;
+    friend struct detail::buffers_array_access;
 
     template<std::size_t I>
     using C = std::integral_constant<std::size_t, I>;
@@ -0,0 +1,282 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_CORE_IMPL_DETECT_PROTOCOL_HPP
+#define BOOST_BEAST_CORE_IMPL_DETECT_PROTOCOL_HPP
+
+#include <boost/beast/core/async_op_base.hpp>
+#include <boost/beast/core/detect_ssl.hpp>
+#include <boost/beast/core/read_size.hpp>
+#include <boost/beast/core/stream_traits.hpp>
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/coroutine.hpp>
+#include <boost/optional.hpp>
+#include <cstring>
+
+namespace boost {
+namespace beast {
+
+namespace detail {
+
+// The most bytes needed to reach a decision,
+// which is the length of the HTTP/2 preface.
+static std::size_t constexpr detect_protocol_max = 24;
+
+inline
+bool
+is_protocol_tchar(unsigned char c)
+{
+    // tchar = "!" / "#" / "$" / "%" / "&" / "'" / "*" / "+" / "-" / "."
+    //       / "^" / "_" / "`" / "|" / "~" / DIGIT / ALPHA
+    if((c >= 'a' && c <= 'z') ||
+        (c >= 'A' && c <= 'Z') ||
+        (c >= '0' && c <= '9'))
+        return true;
+    return c != 0 && std::strchr("!#$%&'*+-.^_`|~", c) != nullptr;
+}
+
+// Returns `true` if the first `n` bytes of `p` match the start of
+// `s`, `false` if they differ, or `indeterminate` if all of the
+// bytes match but there are fewer than the length of `s`.
+inline
+boost::tribool
+match_protocol_prefix(
+    unsigned char const* p, std::size_t n,
+    char const* s, std::size_t len)
+{
+    auto const m = n < len ? n : len;
+    if(std::memcmp(p, s, m) != 0)
+        return false;
+    if(m < len)
+        return boost::indeterminate;
+    return true;
+}
+
+/*  Classify the first `n` bytes received from a peer.
+
+    Returns the protocol, or `boost::none` if more bytes are needed.
+    Only as many bytes as it takes to tell the protocols apart are
+    examined; the messages themselves are not validated.
+*/
+inline
+boost::optional<detected_protocol>
+classify_protocol(unsigned char const* p, std::size_t n)
+{
+    if(n == 0)
+        return boost::none;
+
+    // TLS record, content type handshake
+    if(p[0] == 0x16)
+    {
+        auto const result = is_tls_client_hello(
+            net::const_buffer(p, n));
+        if(boost::indeterminate(result))
+            return boost::none;
+        if(result)
+            return detected_protocol::tls;
+        return detected_protocol::unknown;
+    }
+
+    // PROXY protocol version 2 signature
+    if(p[0] == '\r')
+    {
+        auto const result = match_protocol_prefix(
+            p, n, "\r\n\r\n\0\r\nQUIT\n", 12);
+        if(boost::indeterminate(result))
+            return boost::none;
+        if(result)
+            return detected_protocol::proxy_v2;
+        return detected_protocol::unknown;
+    }
+
+    // method SP
+    std::size_t i = 0;
+    while(i < n && is_protocol_tchar(p[i]))
+        ++i;
+    if(i == n)
+    {
+        if(n < detect_protocol_max)
+            return boost::none;
+        return detected_protocol::unknown;
+    }
+    if(i == 0 || p[i] != ' ')
+        return detected_protocol::unknown;
+
+    // Both of these are also valid HTTP/1 methods
+    if(i == 5 && std::memcmp(p, "PROXY", 5) == 0)
+        return detected_protocol::proxy_v1;
+    if(i == 3 && std::memcmp(p, "PRI", 3) == 0)
+    {
+        auto const result = match_protocol_prefix(
+            p, n, "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n", 24);
+        if(boost::indeterminate(result))
+            return boost::none;
+        if(result)
+            return detected_protocol::http2;
+    }
+    return detected_protocol::http1;
+}
+
+template<class ConstBufferSequence>
+boost::optional<detected_protocol>
+classify_protocol(ConstBufferSequence const& buffers)
+{
+    unsigned char buf[detect_protocol_max];
+    auto const n = net::buffer_copy(
+        net::mutable_buffer(buf, sizeof(buf)), buffers);
+    return classify_protocol(buf, n);
+}
+
+template<
+    class Handler,
+    class AsyncReadStream,
+    class DynamicBuffer>
+class detect_protocol_op
+    : public net::coroutine
+    , public async_op_base<
+        Handler, beast::executor_type<AsyncReadStream>>
+{
+    AsyncReadStream& stream_;
+    DynamicBuffer& buffer_;
+    boost::optional<detected_protocol> result_;
+
+public:
+    detect_protocol_op(detect_protocol_op&&) = default;
+
+    template<class Handler_>
+    detect_protocol_op(
+        Handler_&& h,
+        AsyncReadStream& stream,
+        DynamicBuffer& buffer)
+        : async_op_base<
+            Handler, beast::executor_type<AsyncReadStream>>(
+                std::forward<Handler_>(h),
+                stream.get_executor())
+        , stream_(stream)
+        , buffer_(buffer)
+    {
+        (*this)({}, 0, false);
+    }
+
+    void
+    operator()(
+        error_code ec,
+        std::size_t bytes_transferred,
+        bool cont = true)
+    {
+        BOOST_ASIO_CORO_REENTER(*this)
+        {
+            for(;;)
+            {
+                result_ = classify_protocol(buffer_.data());
+                if(result_)
+                    break;
+                // Whatever arrives past the bytes needed stays
+                // in the buffer for the next layer's first read.
+                BOOST_ASIO_CORO_YIELD
+                stream_.async_read_some(buffer_.prepare(
+                    read_size(buffer_, 1536)), std::move(*this));
+                buffer_.commit(bytes_transferred);
+                if(ec)
+                {
+                    result_ = detected_protocol::unknown;
+                    break;
+                }
+            }
+            this->invoke(cont, ec, *result_);
+        }
+    }
+};
+
+struct run_detect_protocol_op
+{
+    template<
+        class DetectHandler,
+        class AsyncReadStream,
+        class DynamicBuffer>
+    void
+    operator()(
+        DetectHandler&& h,
+        AsyncReadStream* s,
+        DynamicBuffer* b)
+    {
+        detect_protocol_op<
+            typename std::decay<DetectHandler>::type,
+            AsyncReadStream,
+            DynamicBuffer>(
+                std::forward<DetectHandler>(h), *s, *b);
+    }
+};
+
+} // detail
+
+template<
+    class SyncReadStream,
+    class DynamicBuffer>
+detected_protocol
+detect_protocol(
+    SyncReadStream& stream,
+    DynamicBuffer& buffer,
+    error_code& ec)
+{
+    static_assert(
+        is_sync_read_stream<SyncReadStream>::value,
+        "SyncReadStream type requirements not met");
+    static_assert(
+        net::is_dynamic_buffer<DynamicBuffer>::value,
+        "DynamicBuffer type requirements not met");
+
+    for(;;)
+    {
+        auto const result =
+            detail::classify_protocol(buffer.data());
+        if(result)
+        {
+            ec = {};
+            return *result;
+        }
+        auto const bytes_transferred = stream.read_some(
+            buffer.prepare(read_size(buffer, 1536)), ec);
+        buffer.commit(bytes_transferred);
+        if(ec)
+            break;
+    }
+    return detected_protocol::unknown;
+}
+
+template<
+    class AsyncReadStream,
+    class DynamicBuffer,
+    class CompletionToken>
+BOOST_ASIO_INITFN_RESULT_TYPE(
+    CompletionToken, void(error_code, detected_protocol))
+async_detect_protocol(
+    AsyncReadStream& stream,
+    DynamicBuffer& buffer,
+    CompletionToken&& token)
+{
+    static_assert(
+        is_async_read_stream<AsyncReadStream>::value,
+        "AsyncReadStream type requirements not met");
+    static_assert(
+        net::is_dynamic_buffer<DynamicBuffer>::value,
+        "DynamicBuffer type requirements not met");
+    return net::async_initiate<
+        CompletionToken,
+        void(error_code, detected_protocol)>(
+            detail::run_detect_protocol_op{},
+            token,
+            &stream,
+            &buffer);
+}
+
+} // beast
+} // boost
+
+#endif
@@ -26,8 +26,8 @@ namespace beast {
                   |  readable  |  writable  |
 */
 
-template<class Allocator>
-basic_flat_buffer<Allocator>::
+template<class Allocator, class GrowthPolicy>
+basic_flat_buffer<Allocator, GrowthPolicy>::
 ~basic_flat_buffer()
 {
     if(! begin_)
@@ -36,8 +36,8 @@ basic_flat_buffer<Allocator>::
         this->get(), begin_, capacity());
 }
 
-template<class Allocator>
-basic_flat_buffer<Allocator>::
+template<class Allocator, class GrowthPolicy>
+basic_flat_buffer<Allocator, GrowthPolicy>::
 basic_flat_buffer() noexcept(default_nothrow)
     : begin_(nullptr)
     , in_(nullptr)
@@ -49,8 +49,8 @@ basic_flat_buffer() noexcept(default_nothrow)
 {
 }
 
-template<class Allocator>
-basic_flat_buffer<Allocator>::
+template<class Allocator, class GrowthPolicy>
+basic_flat_buffer<Allocator, GrowthPolicy>::
 basic_flat_buffer(
     std::size_t limit) noexcept(default_nothrow)
     : begin_(nullptr)
@@ -62,8 +62,8 @@ basic_flat_buffer(
 {
 }
 
-template<class Allocator>
-basic_flat_buffer<Allocator>::
+template<class Allocator, class GrowthPolicy>
+basic_flat_buffer<Allocator, GrowthPolicy>::
 basic_flat_buffer(Allocator const& alloc) noexcept
     : boost::empty_value<base_alloc_type>(
         boost::empty_init_t{}, alloc)
@@ -77,8 +77,8 @@ basic_flat_buffer(Allocator const& alloc) noexcept
 {
 }
 
-template<class Allocator>
-basic_flat_buffer<Allocator>::
+template<class Allocator, class GrowthPolicy>
+basic_flat_buffer<Allocator, GrowthPolicy>::
 basic_flat_buffer(
     std::size_t limit,
     Allocator const& alloc) noexcept
@@ -93,11 +93,13 @@ basic_flat_buffer(
 {
 }
 
-template<class Allocator>
-basic_flat_buffer<Allocator>::
+template<class Allocator, class GrowthPolicy>
+basic_flat_buffer<Allocator, GrowthPolicy>::
 basic_flat_buffer(basic_flat_buffer&& other) noexcept
     : boost::empty_value<base_alloc_type>(
         boost::empty_init_t{}, std::move(other.get()))
+    , growth_base(boost::empty_init_t{},
+        std::move(other.growth_policy()))
     , begin_(boost::exchange(other.begin_, nullptr))
     , in_(boost::exchange(other.in_, nullptr))
     , out_(boost::exchange(other.out_, nullptr))
@@ -107,13 +109,15 @@ basic_flat_buffer(basic_flat_buffer&& other) noexcept
 {
 }
 
-template<class Allocator>
-basic_flat_buffer<Allocator>::
+template<class Allocator, class GrowthPolicy>
+basic_flat_buffer<Allocator, GrowthPolicy>::
 basic_flat_buffer(
     basic_flat_buffer&& other,
     Allocator const& alloc)
     : boost::empty_value<base_alloc_type>(
         boost::empty_init_t{}, alloc)
+    , growth_base(boost::empty_init_t{},
+        std::move(other.growth_policy()))
 {
     if(this->get() != other.get())
     {
@@ -145,12 +149,14 @@ basic_flat_buffer(
     other.end_ = nullptr;
 }
 
-template<class Allocator>
-basic_flat_buffer<Allocator>::
+template<class Allocator, class GrowthPolicy>
+basic_flat_buffer<Allocator, GrowthPolicy>::
 basic_flat_buffer(basic_flat_buffer const& other)
     : boost::empty_value<base_alloc_type>(boost::empty_init_t{},
         alloc_traits::select_on_container_copy_construction(
             other.get()))
+    , growth_base(boost::empty_init_t{},
+        other.growth_policy())
     , begin_(nullptr)
     , in_(nullptr)
     , out_(nullptr)
@@ -161,13 +167,15 @@ basic_flat_buffer(basic_flat_buffer const& other)
     copy_from(other);
 }
 
-template<class Allocator>
-basic_flat_buffer<Allocator>::
+template<class Allocator, class GrowthPolicy>
+basic_flat_buffer<Allocator, GrowthPolicy>::
 basic_flat_buffer(
     basic_flat_buffer const& other,
     Allocator const& alloc)
     : boost::empty_value<base_alloc_type>(
         boost::empty_init_t{}, alloc)
+    , growth_base(boost::empty_init_t{},
+        other.growth_policy())
     , begin_(nullptr)
     , in_(nullptr)
     , out_(nullptr)
@@ -178,11 +186,11 @@ basic_flat_buffer(
     copy_from(other);
 }
 
-template<class Allocator>
-template<class OtherAlloc>
-basic_flat_buffer<Allocator>::
+template<class Allocator, class GrowthPolicy>
+template<class OtherAlloc, class OtherPolicy>
+basic_flat_buffer<Allocator, GrowthPolicy>::
 basic_flat_buffer(
-    basic_flat_buffer<OtherAlloc> const& other)
+    basic_flat_buffer<OtherAlloc, OtherPolicy> const& other)
         noexcept(default_nothrow)
     : begin_(nullptr)
     , in_(nullptr)
@@ -194,11 +202,11 @@ basic_flat_buffer(
     copy_from(other);
 }
 
-template<class Allocator>
-template<class OtherAlloc>
-basic_flat_buffer<Allocator>::
+template<class Allocator, class GrowthPolicy>
+template<class OtherAlloc, class OtherPolicy>
+basic_flat_buffer<Allocator, GrowthPolicy>::
 basic_flat_buffer(
-    basic_flat_buffer<OtherAlloc> const& other,
+    basic_flat_buffer<OtherAlloc, OtherPolicy> const& other,
     Allocator const& alloc)
     : boost::empty_value<base_alloc_type>(
         boost::empty_init_t{}, alloc)
@@ -212,9 +220,9 @@ basic_flat_buffer(
     copy_from(other);
 }
 
-template<class Allocator>
+template<class Allocator, class GrowthPolicy>
 auto
-basic_flat_buffer<Allocator>::
+basic_flat_buffer<Allocator, GrowthPolicy>::
 operator=(basic_flat_buffer&& other) noexcept ->
     basic_flat_buffer&
 {
@@ -224,9 +232,9 @@ operator=(basic_flat_buffer&& other) noexcept ->
     return *this;
 }
 
-template<class Allocator>
+template<class Allocator, class GrowthPolicy>
 auto
-basic_flat_buffer<Allocator>::
+basic_flat_buffer<Allocator, GrowthPolicy>::
 operator=(basic_flat_buffer const& other) ->
     basic_flat_buffer&
 {
@@ -236,21 +244,21 @@ operator=(basic_flat_buffer const& other) ->
     return *this;
 }
 
-template<class Allocator>
-template<class OtherAlloc>
+template<class Allocator, class GrowthPolicy>
+template<class OtherAlloc, class OtherPolicy>
 auto
-basic_flat_buffer<Allocator>::
+basic_flat_buffer<Allocator, GrowthPolicy>::
 operator=(
-    basic_flat_buffer<OtherAlloc> const& other) ->
+    basic_flat_buffer<OtherAlloc, OtherPolicy> const& other) ->
     basic_flat_buffer&
 {
     copy_from(other);
     return *this;
 }
 
-template<class Allocator>
+template<class Allocator, class GrowthPolicy>
 void
-basic_flat_buffer<Allocator>::
+basic_flat_buffer<Allocator, GrowthPolicy>::
 reserve(std::size_t n)
 {
     if(max_ < n)
@@ -259,9 +267,9 @@ reserve(std::size_t n)
         prepare(n - size());
 }
 
-template<class Allocator>
+template<class Allocator, class GrowthPolicy>
 void
-basic_flat_buffer<Allocator>::
+basic_flat_buffer<Allocator, GrowthPolicy>::
 shrink_to_fit()
 {
     auto const len = size();
@@ -288,9 +296,9 @@ shrink_to_fit()
     end_ = out_;
 }
 
-template<class Allocator>
+template<class Allocator, class GrowthPolicy>
 void
-basic_flat_buffer<Allocator>::
+basic_flat_buffer<Allocator, GrowthPolicy>::
 clear() noexcept
 {
     in_ = begin_;
@@ -300,9 +308,9 @@ clear() noexcept
 
 //------------------------------------------------------------------------------
 
-template<class Allocator>
+template<class Allocator, class GrowthPolicy>
 auto
-basic_flat_buffer<Allocator>::
+basic_flat_buffer<Allocator, GrowthPolicy>::
 prepare(std::size_t n) ->
     mutable_buffers_type
 {
@@ -334,7 +342,8 @@ prepare(std::size_t n) ->
     // allocate a new buffer
     auto const new_size = (std::min<std::size_t>)(
         max_,
-        (std::max<std::size_t>)(2 * len, len + n));
+        (std::max<std::size_t>)(
+            growth_policy().grow(len, n, max_), len + n));
     auto const p = alloc(new_size);
     if(begin_)
     {
@@ -352,13 +361,15 @@ prepare(std::size_t n) ->
     return {out_, n};
 }
 
-template<class Allocator>
+template<class Allocator, class GrowthPolicy>
 void
-basic_flat_buffer<Allocator>::
+basic_flat_buffer<Allocator, GrowthPolicy>::
 consume(std::size_t n) noexcept
 {
     if(n >= dist(in_, out_))
     {
+        if(in_ != out_)
+            idle();
         in_ = begin_;
         out_ = begin_;
         return;
@@ -368,12 +379,12 @@ consume(std::size_t n) noexcept
 
 //------------------------------------------------------------------------------
 
-template<class Allocator>
-template<class OtherAlloc>
+template<class Allocator, class GrowthPolicy>
+template<class OtherAlloc, class OtherPolicy>
 void
-basic_flat_buffer<Allocator>::
+basic_flat_buffer<Allocator, GrowthPolicy>::
 copy_from(
-    basic_flat_buffer<OtherAlloc> const& other)
+    basic_flat_buffer<OtherAlloc, OtherPolicy> const& other)
 {
     std::size_t const n = other.size();
     if(n == 0 || n > capacity())
@@ -407,9 +418,9 @@ copy_from(
     }
 }
 
-template<class Allocator>
+template<class Allocator, class GrowthPolicy>
 void
-basic_flat_buffer<Allocator>::
+basic_flat_buffer<Allocator, GrowthPolicy>::
 move_assign(basic_flat_buffer& other, std::true_type)
 {
     clear();
@@ -421,6 +432,7 @@ move_assign(basic_flat_buffer& other, std::true_type)
     last_ = out_;
     end_ = other.end_;
     max_ = other.max_;
+    growth_policy() = std::move(other.growth_policy());
     other.begin_ = nullptr;
     other.in_ = nullptr;
     other.out_ = nullptr;
@@ -428,13 +440,15 @@ move_assign(basic_flat_buffer& other, std::true_type)
     other.end_ = nullptr;
 }
 
-template<class Allocator>
+template<class Allocator, class GrowthPolicy>
 void
-basic_flat_buffer<Allocator>::
+basic_flat_buffer<Allocator, GrowthPolicy>::
 move_assign(basic_flat_buffer& other, std::false_type)
 {
     if(this->get() != other.get())
     {
+        max_ = other.max_;
+        growth_policy() = std::move(other.growth_policy());
         copy_from(other);
         other.clear();
         other.shrink_to_fit();
@@ -445,44 +459,47 @@ move_assign(basic_flat_buffer& other, std::false_type)
     }
 }
 
-template<class Allocator>
+template<class Allocator, class GrowthPolicy>
 void
-basic_flat_buffer<Allocator>::
+basic_flat_buffer<Allocator, GrowthPolicy>::
 copy_assign(basic_flat_buffer const& other, std::true_type)
 {
     max_ = other.max_;
+    growth_policy() = other.growth_policy();
     this->get() = other.get();
     copy_from(other);
 }
 
-template<class Allocator>
+template<class Allocator, class GrowthPolicy>
 void
-basic_flat_buffer<Allocator>::
+basic_flat_buffer<Allocator, GrowthPolicy>::
 copy_assign(basic_flat_buffer const& other, std::false_type)
 {
     clear();
     shrink_to_fit();
     max_ = other.max_;
+    growth_policy() = other.growth_policy();
     copy_from(other);
 }
 
-template<class Allocator>
+template<class Allocator, class GrowthPolicy>
 void
-basic_flat_buffer<Allocator>::
+basic_flat_buffer<Allocator, GrowthPolicy>::
 swap(basic_flat_buffer& other)
 {
     swap(other, typename
         alloc_traits::propagate_on_container_swap{});
 }
 
-template<class Allocator>
+template<class Allocator, class GrowthPolicy>
 void
-basic_flat_buffer<Allocator>::
+basic_flat_buffer<Allocator, GrowthPolicy>::
 swap(basic_flat_buffer& other, std::true_type)
 {
     using std::swap;
     swap(this->get(), other.get());
     swap(max_, other.max_);
+    swap(growth_policy(), other.growth_policy());
     swap(begin_, other.begin_);
     swap(in_, other.in_);
     swap(out_, other.out_);
@@ -491,14 +508,15 @@ swap(basic_flat_buffer& other, std::true_type)
     swap(end_, other.end_);
 }
 
-template<class Allocator>
+template<class Allocator, class GrowthPolicy>
 void
-basic_flat_buffer<Allocator>::
+basic_flat_buffer<Allocator, GrowthPolicy>::
 swap(basic_flat_buffer& other, std::false_type)
 {
     BOOST_ASSERT(this->get() == other.get());
     using std::swap;
     swap(max_, other.max_);
+    swap(growth_policy(), other.growth_policy());
     swap(begin_, other.begin_);
     swap(in_, other.in_);
     swap(out_, other.out_);
@@ -507,18 +525,18 @@ swap(basic_flat_buffer& other, std::false_type)
     swap(end_, other.end_);
 }
 
-template<class Allocator>
+template<class Allocator, class GrowthPolicy>
 void
 swap(
-    basic_flat_buffer<Allocator>& lhs,
-    basic_flat_buffer<Allocator>& rhs)
+    basic_flat_buffer<Allocator, GrowthPolicy>& lhs,
+    basic_flat_buffer<Allocator, GrowthPolicy>& rhs)
 {
     lhs.swap(rhs);
 }
 
-template<class Allocator>
+template<class Allocator, class GrowthPolicy>
 char*
-basic_flat_buffer<Allocator>::
+basic_flat_buffer<Allocator, GrowthPolicy>::
 alloc(std::size_t n)
 {
     if(n > alloc_traits::max_size(this->get()))
@@ -527,6 +545,24 @@ alloc(std::size_t n)
     return alloc_traits::allocate(this->get(), n);
 }
 
+template<class Allocator, class GrowthPolicy>
+void
+basic_flat_buffer<Allocator, GrowthPolicy>::
+idle() noexcept
+{
+    // called when the readable bytes become empty
+    if(! detail::growth_on_consume(
+            growth_policy(), capacity()))
+        return;
+    alloc_traits::deallocate(
+        this->get(), begin_, capacity());
+    begin_ = nullptr;
+    in_ = nullptr;
+    out_ = nullptr;
+    last_ = nullptr;
+    end_ = nullptr;
+}
+
 } // beast
 } // boost
 
@@ -46,7 +46,7 @@ public:
                 s.get_executor())
     {
         auto const result =
-            flatten(b, max_size);
+            coalesce(b, s.limit_);
         if(result.flatten)
         {
             s.buffer_.clear();
@@ -209,7 +209,7 @@ write_some(ConstBufferSequence const& buffers, error_code& ec)
     static_assert(net::is_const_buffer_sequence<
         ConstBufferSequence>::value,
         "ConstBufferSequence type requirements not met");
-    auto const result = flatten(buffers, max_size);
+    auto const result = coalesce(buffers, limit_);
     if(result.flatten)
     {
         if(result.size <= max_stack)
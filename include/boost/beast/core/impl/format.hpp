@@ -0,0 +1,295 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_CORE_IMPL_FORMAT_HPP
+#define BOOST_BEAST_CORE_IMPL_FORMAT_HPP
+
+#include <boost/beast/core/string.hpp>
+#include <boost/asio/buffer.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+
+namespace boost {
+namespace beast {
+
+namespace detail {
+
+// One argument to format_to, converted to text. Short
+// conversions are stored inline, strings are referenced.
+class format_arg
+{
+    // Large enough for a 64-bit integer with sign, for
+    // 20 integer digits, a point and 9 decimals, and for
+    // the exponent form of larger values.
+    char buf_[32];
+    char const* p_ = buf_;
+    std::size_t n_ = 0;
+
+    template<class Integer>
+    using is_number = std::integral_constant<bool,
+        std::is_integral<Integer>::value &&
+        ! std::is_same<Integer, bool>::value &&
+        ! std::is_same<Integer, char>::value>;
+
+    char*
+    end() noexcept
+    {
+        return buf_ + sizeof(buf_);
+    }
+
+    void
+    set(char const* first) noexcept
+    {
+        p_ = first;
+        n_ = static_cast<std::size_t>(end() - first);
+    }
+
+    static
+    char*
+    write_digits(char* last, std::uint64_t u) noexcept
+    {
+        do
+        {
+            *--last = static_cast<char>('0' + u % 10);
+            u /= 10;
+        }
+        while(u > 0);
+        return last;
+    }
+
+    template<class Integer>
+    void
+    integer(Integer v, std::true_type) noexcept
+    {
+        using U = typename std::make_unsigned<Integer>::type;
+        auto u = static_cast<U>(v);
+        if(v < 0)
+        {
+            // well defined for the most negative value
+            u = static_cast<U>(U(0) - u);
+            auto const first = write_digits(end(), u);
+            *(first - 1) = '-';
+            set(first - 1);
+            return;
+        }
+        set(write_digits(end(), u));
+    }
+
+    template<class Integer>
+    void
+    integer(Integer v, std::false_type) noexcept
+    {
+        set(write_digits(end(), v));
+    }
+
+    // Writes d.ddde+XX without consulting the locale,
+    // the same text as printf("%.*e") in the "C" locale.
+    void
+    exponent(double a, bool neg, unsigned precision) noexcept
+    {
+        static std::uint64_t const pow10[] = {
+            1, 10, 100, 1000, 10000, 100000, 1000000,
+            10000000, 100000000, 1000000000, 10000000000 };
+        auto e = static_cast<int>(std::floor(std::log10(a)));
+        auto const digits = [a, precision](int e)
+        {
+            return static_cast<std::uint64_t>(a / std::pow(10.0,
+                e - static_cast<int>(precision)) + 0.5);
+        };
+        auto m = digits(e);
+        // log10 may be off by one near a power of ten
+        if(m < pow10[precision])
+            m = digits(--e);
+        else if(m >= pow10[precision + 1])
+            m = digits(++e);
+        // rounding carried into another digit
+        if(m >= pow10[precision + 1])
+        {
+            m /= 10;
+            ++e;
+        }
+        auto first = write_digits(end(), static_cast<unsigned>(e));
+        if(e < 10)
+            *--first = '0';
+        *--first = '+';
+        *--first = 'e';
+        if(precision > 0)
+        {
+            for(auto i = precision; i > 0; --i)
+            {
+                *--first = static_cast<char>('0' + m % 10);
+                m /= 10;
+            }
+            *--first = '.';
+        }
+        *--first = static_cast<char>('0' + m);
+        if(neg)
+            *--first = '-';
+        set(first);
+    }
+
+public:
+    format_arg() = default;
+
+    format_arg(format_arg const& other) noexcept
+        : n_(other.n_)
+    {
+        std::less<char const*> const lt{};
+        if( ! lt(other.p_, other.buf_) &&
+            lt(other.p_, other.buf_ + sizeof(other.buf_)))
+        {
+            std::memcpy(buf_, other.buf_, sizeof(buf_));
+            p_ = buf_ + (other.p_ - other.buf_);
+        }
+        else
+        {
+            p_ = other.p_;
+        }
+    }
+
+    format_arg& operator=(format_arg const&) = delete;
+
+    format_arg(bool b) noexcept
+        : p_(b ? "true" : "false")
+        , n_(b ? 4 : 5)
+    {
+    }
+
+    format_arg(char c) noexcept
+        : n_(1)
+    {
+        buf_[0] = c;
+    }
+
+    template<class Integer, class = typename
+        std::enable_if<is_number<Integer>::value>::type>
+    format_arg(Integer v) noexcept
+    {
+        integer(v, std::is_signed<Integer>{});
+    }
+
+    template<class String, class = typename
+        std::enable_if<std::is_convertible<
+            String const&, string_view>::value>::type>
+    format_arg(String const& s) noexcept
+    {
+        string_view const sv(s);
+        p_ = sv.data();
+        n_ = sv.size();
+    }
+
+    format_arg(fixed_point const& f) noexcept
+    {
+        static std::uint64_t const pow10[] = {
+            1, 10, 100, 1000, 10000, 100000, 1000000,
+            10000000, 100000000, 1000000000 };
+        auto const v = f.value;
+        if(std::isnan(v))
+        {
+            p_ = "nan";
+            n_ = 3;
+            return;
+        }
+        if(std::isinf(v))
+        {
+            p_ = v < 0 ? "-inf" : "inf";
+            n_ = v < 0 ? 4 : 3;
+            return;
+        }
+        auto const a = std::fabs(v);
+        if(a >= 1e19)
+        {
+            exponent(a, v < 0, f.precision);
+            return;
+        }
+        auto const scale = pow10[f.precision];
+        auto ip = static_cast<std::uint64_t>(a);
+        auto fp = static_cast<std::uint64_t>(
+            (a - static_cast<double>(ip)) *
+                static_cast<double>(scale) + 0.5);
+        if(fp >= scale)
+        {
+            fp -= scale;
+            ++ip;
+        }
+        // no sign when the rounded value is zero
+        bool const neg = v < 0 && (ip > 0 || fp > 0);
+        auto first = end();
+        if(f.precision > 0)
+        {
+            for(auto i = f.precision; i > 0; --i)
+            {
+                *--first = static_cast<char>('0' + fp % 10);
+                fp /= 10;
+            }
+            *--first = '.';
+        }
+        first = write_digits(first, ip);
+        if(neg)
+            *--first = '-';
+        set(first);
+    }
+
+    char const*
+    data() const noexcept
+    {
+        return p_;
+    }
+
+    std::size_t
+    size() const noexcept
+    {
+        return n_;
+    }
+};
+
+} // detail
+
+template<class DynamicBuffer, class... Args>
+std::size_t
+format_to(DynamicBuffer& buffer, Args const&... args)
+{
+    static_assert(
+        net::is_dynamic_buffer<DynamicBuffer>::value,
+        "DynamicBuffer type requirements not met");
+    // The trailing element keeps the array non-empty
+    detail::format_arg const list[] = { {args}..., {} };
+    std::size_t n = 0;
+    for(auto const& a : list)
+        n += a.size();
+    auto const mb = buffer.prepare(n);
+    auto it = net::buffer_sequence_begin(mb);
+    net::mutable_buffer out;
+    for(auto const& a : list)
+    {
+        auto p = a.data();
+        auto k = a.size();
+        while(k > 0)
+        {
+            if(out.size() == 0)
+                out = *it++;
+            auto const m = (std::min)(k, out.size());
+            std::memcpy(out.data(), p, m);
+            out += m;
+            p += m;
+            k -= m;
+        }
+    }
+    buffer.commit(n);
+    return n;
+}
+
+} // beast
+} // boost
+
+#endif
@@ -0,0 +1,130 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_IMPL_METRICS_POLICY_IPP
+#define BOOST_BEAST_IMPL_METRICS_POLICY_IPP
+
+#include <boost/beast/core/metrics_policy.hpp>
+
+namespace boost {
+namespace beast {
+
+metrics_registry::
+metrics_registry() noexcept
+{
+    for(auto& g : groups_)
+        for(auto& v : g.v)
+            v.store(0, std::memory_order_relaxed);
+}
+
+stream_metrics
+metrics_registry::
+totals() const noexcept
+{
+    std::uint64_t v[counters] = {};
+    for(auto const& g : groups_)
+        for(int i = 0; i < counters; ++i)
+            v[i] += g.v[i].load(std::memory_order_relaxed);
+    stream_metrics m;
+    m.bytes_read = v[bytes_read];
+    m.bytes_written = v[bytes_written];
+    m.reads = v[reads];
+    m.writes = v[writes];
+    m.timeouts = v[timeouts];
+    m.read_wait = std::chrono::nanoseconds(v[read_wait]);
+    m.write_wait = std::chrono::nanoseconds(v[write_wait]);
+    m.handler_time = std::chrono::nanoseconds(v[handler_time]);
+    m.rate_wait = std::chrono::nanoseconds(v[rate_wait]);
+    return m;
+}
+
+namespace detail {
+
+// Append a metric in the Prometheus text format
+inline
+void
+append_metric(
+    std::string& s,
+    string_view prefix,
+    string_view name,
+    string_view help,
+    std::uint64_t v,
+    bool seconds)
+{
+    auto const append_name =
+        [&]
+        {
+            s.append(prefix.data(), prefix.size());
+            s.push_back('_');
+            s.append(name.data(), name.size());
+        };
+    s.append("# HELP ");
+    append_name();
+    s.push_back(' ');
+    s.append(help.data(), help.size());
+    s.append("\n# TYPE ");
+    append_name();
+    s.append(" counter\n");
+    append_name();
+    s.push_back(' ');
+    if(! seconds)
+    {
+        s.append(std::to_string(v));
+        s.push_back('\n');
+        return;
+    }
+    // Format nanoseconds exactly, without
+    // going through floating point.
+    auto const frac = std::to_string(v % 1000000000);
+    s.append(std::to_string(v / 1000000000));
+    s.push_back('.');
+    s.append(9 - frac.size(), '0');
+    s.append(frac);
+    s.push_back('\n');
+}
+
+} // detail
+
+std::string
+metrics_registry::
+to_prometheus(string_view prefix) const
+{
+    auto const m = totals();
+    std::string s;
+    detail::append_metric(s, prefix, "read_bytes_total",
+        "Bytes read.", m.bytes_read, false);
+    detail::append_metric(s, prefix, "write_bytes_total",
+        "Bytes written.", m.bytes_written, false);
+    detail::append_metric(s, prefix, "reads_total",
+        "Read operations performed on the socket.",
+        m.reads, false);
+    detail::append_metric(s, prefix, "writes_total",
+        "Write operations performed on the socket.",
+        m.writes, false);
+    detail::append_metric(s, prefix, "timeouts_total",
+        "Operations which timed out.", m.timeouts, false);
+    detail::append_metric(s, prefix, "read_wait_seconds_total",
+        "Time spent waiting for the socket to complete reads.",
+        static_cast<std::uint64_t>(m.read_wait.count()), true);
+    detail::append_metric(s, prefix, "write_wait_seconds_total",
+        "Time spent waiting for the socket to complete writes.",
+        static_cast<std::uint64_t>(m.write_wait.count()), true);
+    detail::append_metric(s, prefix, "handler_seconds_total",
+        "Time spent in completion handlers.",
+        static_cast<std::uint64_t>(m.handler_time.count()), true);
+    detail::append_metric(s, prefix, "rate_limit_wait_seconds_total",
+        "Time spent waiting for the rate limit.",
+        static_cast<std::uint64_t>(m.rate_wait.count()), true);
+    return s;
+}
+
+} // beast
+} // boost
+
+#endif
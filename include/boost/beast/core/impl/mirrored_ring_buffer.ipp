@@ -0,0 +1,290 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_CORE_IMPL_MIRRORED_RING_BUFFER_IPP
+#define BOOST_BEAST_CORE_IMPL_MIRRORED_RING_BUFFER_IPP
+
+#include <boost/beast/core/mirrored_ring_buffer.hpp>
+
+#if BOOST_BEAST_USE_MIRRORED_RING_BUFFER
+
+#include <boost/beast/core/error.hpp>
+#include <boost/core/exchange.hpp>
+#include <boost/throw_exception.hpp>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#if defined(__linux__)
+# include <sys/syscall.h>
+#endif
+
+namespace boost {
+namespace beast {
+
+namespace detail {
+
+namespace mirrored {
+
+inline
+std::size_t
+page_size() noexcept
+{
+    static std::size_t const n =
+        static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    return n;
+}
+
+inline
+std::size_t
+round_up(std::size_t n) noexcept
+{
+    auto const page = page_size();
+    return (n + page - 1) / page * page;
+}
+
+// Returns an anonymous shared memory file, or -1
+inline
+int
+create_file()
+{
+#if defined(__linux__) && defined(SYS_memfd_create)
+    {
+        auto const fd = static_cast<int>(::syscall(
+            SYS_memfd_create, "beast-ring", 1U)); // MFD_CLOEXEC
+        if(fd != -1)
+            return fd;
+    }
+#endif
+    static std::atomic<unsigned> counter{0};
+    for(int i = 0; i < 16; ++i)
+    {
+        char name[64];
+        std::snprintf(name, sizeof(name), "/beast-ring-%ld-%u",
+            static_cast<long>(::getpid()), counter++);
+        auto const fd = ::shm_open(
+            name, O_RDWR | O_CREAT | O_EXCL, 0600);
+        if(fd != -1)
+        {
+            ::shm_unlink(name);
+            return fd;
+        }
+        if(errno != EEXIST)
+            break;
+    }
+    return -1;
+}
+
+inline
+void
+fail(int ev)
+{
+    BOOST_THROW_EXCEPTION(system_error(
+        error_code(ev, system::generic_category())));
+}
+
+// Map n bytes twice, back to back
+inline
+char*
+map(std::size_t n)
+{
+    auto const fd = create_file();
+    if(fd == -1)
+        fail(errno);
+    if(::ftruncate(fd, static_cast<off_t>(n)) != 0)
+    {
+        auto const ev = errno;
+        ::close(fd);
+        fail(ev);
+    }
+    // Reserve the address range for both halves
+    auto const p = ::mmap(nullptr, 2 * n,
+        PROT_NONE, MAP_PRIVATE | MAP_ANON, -1, 0);
+    if(p == MAP_FAILED)
+    {
+        auto const ev = errno;
+        ::close(fd);
+        fail(ev);
+    }
+    auto const base = static_cast<char*>(p);
+    auto const p0 = ::mmap(base, n, PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_FIXED, fd, 0);
+    auto const p1 = p0 == MAP_FAILED ? MAP_FAILED :
+        ::mmap(base + n, n, PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_FIXED, fd, 0);
+    auto const ev = errno;
+    // The mappings keep the memory alive, so the
+    // descriptor is not held for the life of the buffer
+    ::close(fd);
+    if(p1 == MAP_FAILED)
+    {
+        ::munmap(base, 2 * n);
+        fail(ev);
+    }
+    return base;
+}
+
+inline
+void
+unmap(char* p, std::size_t n) noexcept
+{
+    if(p)
+        ::munmap(p, 2 * n);
+}
+
+} // mirrored
+
+} // detail
+
+mirrored_ring_buffer::
+~mirrored_ring_buffer()
+{
+    detail::mirrored::unmap(begin_, capacity_);
+}
+
+mirrored_ring_buffer::
+mirrored_ring_buffer(mirrored_ring_buffer&& other) noexcept
+    : begin_(boost::exchange(other.begin_, nullptr))
+    , capacity_(boost::exchange(other.capacity_, 0))
+    , in_off_(boost::exchange(other.in_off_, 0))
+    , in_size_(boost::exchange(other.in_size_, 0))
+    , max_(other.max_)
+{
+    other.out_size_ = 0;
+}
+
+mirrored_ring_buffer::
+mirrored_ring_buffer(mirrored_ring_buffer const& other)
+    : max_(other.max_)
+{
+    if(other.in_size_ == 0)
+        return;
+    realloc(detail::mirrored::round_up(other.in_size_));
+    std::memcpy(begin_,
+        other.begin_ + other.in_off_, other.in_size_);
+    in_size_ = other.in_size_;
+}
+
+auto
+mirrored_ring_buffer::
+operator=(mirrored_ring_buffer&& other) noexcept ->
+    mirrored_ring_buffer&
+{
+    if(this != &other)
+    {
+        mirrored_ring_buffer tmp(std::move(other));
+        swap(*this, tmp);
+    }
+    return *this;
+}
+
+auto
+mirrored_ring_buffer::
+operator=(mirrored_ring_buffer const& other) ->
+    mirrored_ring_buffer&
+{
+    if(this != &other)
+    {
+        mirrored_ring_buffer tmp(other);
+        swap(*this, tmp);
+    }
+    return *this;
+}
+
+void
+mirrored_ring_buffer::
+reserve(std::size_t n)
+{
+    if(max_ < n)
+        max_ = n;
+    if(n > capacity_)
+        realloc(detail::mirrored::round_up(n));
+}
+
+void
+mirrored_ring_buffer::
+shrink_to_fit()
+{
+    if(in_size_ == 0)
+    {
+        detail::mirrored::unmap(begin_, capacity_);
+        begin_ = nullptr;
+        capacity_ = 0;
+        in_off_ = 0;
+        out_size_ = 0;
+        return;
+    }
+    auto const n = detail::mirrored::round_up(in_size_);
+    if(n < capacity_)
+        realloc(n);
+}
+
+void
+swap(
+    mirrored_ring_buffer& lhs,
+    mirrored_ring_buffer& rhs) noexcept
+{
+    using std::swap;
+    swap(lhs.begin_, rhs.begin_);
+    swap(lhs.capacity_, rhs.capacity_);
+    swap(lhs.in_off_, rhs.in_off_);
+    swap(lhs.in_size_, rhs.in_size_);
+    swap(lhs.out_size_, rhs.out_size_);
+    swap(lhs.max_, rhs.max_);
+}
+
+auto
+mirrored_ring_buffer::
+prepare(std::size_t n) ->
+    mutable_buffers_type
+{
+    if(n > max_ || in_size_ > max_ - n)
+        BOOST_THROW_EXCEPTION(std::length_error{
+            "mirrored_ring_buffer too long"});
+    if(n > capacity_ - in_size_)
+    {
+        // grow geometrically, up to the maximum size
+        auto const growth = (std::min)(
+            max_, capacity_ > max_ / 2 ? max_ : 2 * capacity_);
+        realloc(detail::mirrored::round_up(
+            (std::max)(in_size_ + n, growth)));
+    }
+    out_size_ = n;
+    if(capacity_ == 0)
+        return {begin_, 0};
+    return {begin_ + (in_off_ + in_size_) % capacity_, n};
+}
+
+void
+mirrored_ring_buffer::
+realloc(std::size_t capacity)
+{
+    auto const p = detail::mirrored::map(capacity);
+    // The readable bytes are contiguous, even when wrapped
+    if(in_size_ > 0)
+        std::memcpy(p, begin_ + in_off_, in_size_);
+    detail::mirrored::unmap(begin_, capacity_);
+    begin_ = p;
+    capacity_ = capacity;
+    in_off_ = 0;
+    out_size_ = 0;
+}
+
+} // beast
+} // boost
+
+#endif
+
+#endif
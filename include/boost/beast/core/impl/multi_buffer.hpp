@@ -925,7 +925,7 @@ prepare(size_type n) ->
                             in_size_ * growth_factor - in_size_),
                         512,
                         n}));
-            auto& e = alloc(size);
+            auto& e = alloc(size, max_ - total);
             list_.push_back(e);
             if(out_ == list_.end())
                 out_ = list_.iterator_to(e);
@@ -1236,6 +1236,21 @@ alloc(std::size_t size) ->
         sizeof(element) + size)) element(size);
 }
 
+template<class Allocator>
+auto
+basic_multi_buffer<Allocator>::
+alloc(std::size_t size, std::size_t limit) ->
+    element&
+{
+    // When the allocator rounds up the request, the
+    // element is enlarged to use the whole block.
+    auto const fill = detail::allocation_size(
+        this->get(), sizeof(element) + size) - sizeof(element);
+    if(fill > size && fill <= limit)
+        size = fill;
+    return alloc(size);
+}
+
 template<class Allocator>
 void
 basic_multi_buffer<Allocator>::
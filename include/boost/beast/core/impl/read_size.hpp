@@ -33,7 +33,7 @@ struct has_read_size_helper<T, decltype(
 template<class DynamicBuffer>
 std::size_t
 read_size(DynamicBuffer& buffer,
-    std::size_t max_size, std::true_type)
+    std::size_t max_size, std::size_t, std::true_type)
 {
     return read_size_helper(buffer, max_size);
 }
@@ -41,7 +41,7 @@ read_size(DynamicBuffer& buffer,
 template<class DynamicBuffer>
 std::size_t
 read_size(DynamicBuffer& buffer,
-    std::size_t max_size, std::false_type)
+    std::size_t max_size, std::size_t min_size, std::false_type)
 {
     static_assert(
         net::is_dynamic_buffer<DynamicBuffer>::value,
@@ -51,7 +51,7 @@ read_size(DynamicBuffer& buffer,
     auto const limit = buffer.max_size() - size;
     BOOST_ASSERT(size <= buffer.max_size());
     return std::min<std::size_t>(
-        std::max<std::size_t>(512, buffer.capacity() - size),
+        std::max<std::size_t>(min_size, buffer.capacity() - size),
         std::min<std::size_t>(max_size, limit));
 }
 
@@ -62,7 +62,18 @@ std::size_t
 read_size(
     DynamicBuffer& buffer, std::size_t max_size)
 {
-    return detail::read_size(buffer, max_size,
+    return detail::read_size(buffer, max_size, 512,
+        detail::has_read_size_helper<DynamicBuffer>{});
+}
+
+template<class DynamicBuffer>
+std::size_t
+read_size(
+    DynamicBuffer& buffer,
+    std::size_t max_size,
+    read_size_advisor const& advisor)
+{
+    return detail::read_size(buffer, max_size, advisor.size(),
         detail::has_read_size_helper<DynamicBuffer>{});
 }
 
@@ -0,0 +1,189 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_IMPL_SPSC_BUFFER_HPP
+#define BOOST_BEAST_IMPL_SPSC_BUFFER_HPP
+
+#include <boost/beast/core/detail/is_invocable.hpp>
+#include <boost/asio/associated_allocator.hpp>
+#include <boost/asio/associated_executor.hpp>
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/error.hpp>
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/post.hpp>
+#include <atomic>
+#include <mutex>
+#include <utility>
+
+namespace boost {
+namespace beast {
+
+// Stored while the consumer waits. When invoked, the
+// completion handler is posted with the saved result.
+template<class Handler>
+class spsc_buffer_base::wait_op
+{
+    Handler h_;
+    spsc_buffer_base& b_;
+
+    // Keeps the executor busy until the handler is posted
+    net::executor_work_guard<
+        net::associated_executor_t<Handler>> wg_;
+
+    // The posted function object
+    class result
+    {
+        Handler h_;
+        error_code ec_;
+
+    public:
+        using allocator_type =
+            net::associated_allocator_t<Handler>;
+
+        using executor_type =
+            net::associated_executor_t<Handler>;
+
+        result(Handler&& h, error_code ec)
+            : h_(std::move(h))
+            , ec_(ec)
+        {
+        }
+
+        allocator_type
+        get_allocator() const noexcept
+        {
+            return net::get_associated_allocator(h_);
+        }
+
+        executor_type
+        get_executor() const noexcept
+        {
+            return net::get_associated_executor(h_);
+        }
+
+        void
+        operator()()
+        {
+            h_(ec_);
+        }
+    };
+
+public:
+    using allocator_type =
+        net::associated_allocator_t<Handler>;
+
+    using executor_type =
+        net::associated_executor_t<Handler>;
+
+    template<class Handler_>
+    wait_op(Handler_&& h, spsc_buffer_base& b)
+        : h_(std::forward<Handler_>(h))
+        , b_(b)
+        , wg_(net::get_associated_executor(h_))
+    {
+    }
+
+    allocator_type
+    get_allocator() const noexcept
+    {
+        return net::get_associated_allocator(h_);
+    }
+
+    executor_type
+    get_executor() const noexcept
+    {
+        return net::get_associated_executor(h_);
+    }
+
+    void
+    operator()()
+    {
+        // The result is saved before the wait is taken out
+        net::post(result(std::move(h_), b_.wait_ec_));
+    }
+};
+
+struct spsc_buffer_base::run_wait_op
+{
+    template<class WaitHandler>
+    void
+    operator()(
+        WaitHandler&& h,
+        spsc_buffer_base* b)
+    {
+        // If you get an error on the following line it means
+        // that your handler does not meet the documented type
+        // requirements for the handler.
+
+        static_assert(
+            beast::detail::is_invocable<WaitHandler,
+            void(error_code)>::value,
+            "WaitHandler type requirements not met");
+
+        std::lock_guard<std::mutex> lock(b->m_);
+        BOOST_ASSERT(! b->wait_.has_value());
+        b->wait_.emplace(wait_op<typename std::decay<
+            WaitHandler>::type>(std::forward<WaitHandler>(h), *b));
+        b->waiting_.store(true);
+
+        // Pairs with the fence in commit and close, so that
+        // either the producer sees the waiter, or the waiter
+        // sees the bytes or the close.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if(b->size() > 0)
+            b->wait_ec_ = {};
+        else if(b->is_closed())
+            b->wait_ec_ = net::error::eof;
+        else
+            return;
+        b->waiting_.store(false);
+        b->wait_.invoke();
+    }
+};
+
+template<class WaitHandler>
+BOOST_ASIO_INITFN_RESULT_TYPE(WaitHandler, void(error_code))
+spsc_buffer_base::
+async_wait(WaitHandler&& handler)
+{
+    return net::async_initiate<
+        WaitHandler,
+        void(error_code)>(
+            run_wait_op{},
+            handler,
+            this);
+}
+
+template<std::size_t N>
+spsc_buffer<N>::
+spsc_buffer(spsc_buffer const& other) noexcept
+    : spsc_buffer_base(buf_, N)
+{
+    this->commit(net::buffer_copy(
+        this->prepare(other.size()), other.data()));
+}
+
+template<std::size_t N>
+auto
+spsc_buffer<N>::
+operator=(spsc_buffer const& other) ->
+    spsc_buffer<N>&
+{
+    if(this == &other)
+        return *this;
+    this->consume(this->size());
+    this->commit(net::buffer_copy(
+        this->prepare(other.size()), other.data()));
+    return *this;
+}
+
+} // beast
+} // boost
+
+#endif
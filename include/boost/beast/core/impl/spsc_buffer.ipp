@@ -0,0 +1,186 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_IMPL_SPSC_BUFFER_IPP
+#define BOOST_BEAST_IMPL_SPSC_BUFFER_IPP
+
+#include <boost/beast/core/spsc_buffer.hpp>
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/error.hpp>
+#include <boost/throw_exception.hpp>
+#include <algorithm>
+#include <stdexcept>
+
+namespace boost {
+namespace beast {
+
+// The counters only ever increase. Offsets into the storage
+// are taken modulo the capacity, which stays correct until a
+// counter wraps after 2^64 bytes have been transferred.
+
+spsc_buffer_base::
+spsc_buffer_base(
+    void* p, std::size_t size) noexcept
+    : begin_(static_cast<char*>(p))
+    , capacity_(size)
+{
+}
+
+auto
+spsc_buffer_base::
+data() const noexcept ->
+    const_buffers_type
+{
+    auto const head = head_.load(std::memory_order_relaxed);
+    auto const in_size =
+        tail_.load(std::memory_order_acquire) - head;
+    if(in_size == 0)
+        return {
+            net::const_buffer{begin_, 0},
+            net::const_buffer{begin_, 0}};
+    auto const in_off = head % capacity_;
+    if(in_off + in_size <= capacity_)
+        return {
+            net::const_buffer{
+                begin_ + in_off, in_size},
+            net::const_buffer{
+                begin_, 0}};
+    return {
+        net::const_buffer{
+            begin_ + in_off, capacity_ - in_off},
+        net::const_buffer{
+            begin_, in_size - (capacity_ - in_off)}};
+}
+
+auto
+spsc_buffer_base::
+data() noexcept ->
+    mutable_data_type
+{
+    auto const head = head_.load(std::memory_order_relaxed);
+    auto const in_size =
+        tail_.load(std::memory_order_acquire) - head;
+    if(in_size == 0)
+        return {
+            net::mutable_buffer{begin_, 0},
+            net::mutable_buffer{begin_, 0}};
+    auto const in_off = head % capacity_;
+    if(in_off + in_size <= capacity_)
+        return {
+            net::mutable_buffer{
+                begin_ + in_off, in_size},
+            net::mutable_buffer{
+                begin_, 0}};
+    return {
+        net::mutable_buffer{
+            begin_ + in_off, capacity_ - in_off},
+        net::mutable_buffer{
+            begin_, in_size - (capacity_ - in_off)}};
+}
+
+auto
+spsc_buffer_base::
+prepare(std::size_t n) ->
+    mutable_buffers_type
+{
+    auto const tail = tail_.load(std::memory_order_relaxed);
+    // acquire, so the consumer is done with the space it freed
+    auto const in_size =
+        tail - head_.load(std::memory_order_acquire);
+    if(n > capacity_ - in_size)
+        BOOST_THROW_EXCEPTION(std::length_error{
+            "spsc_buffer overflow"});
+    out_size_ = n;
+    if(n == 0)
+        return {
+            net::mutable_buffer{begin_, 0},
+            net::mutable_buffer{begin_, 0}};
+    auto const out_off = tail % capacity_;
+    if(out_off + out_size_ <= capacity_ )
+        return {
+            net::mutable_buffer{
+                begin_ + out_off, out_size_},
+            net::mutable_buffer{
+                begin_, 0}};
+    return {
+        net::mutable_buffer{
+            begin_ + out_off, capacity_ - out_off},
+        net::mutable_buffer{
+            begin_, out_size_ - (capacity_ - out_off)}};
+}
+
+void
+spsc_buffer_base::
+commit(std::size_t n)
+{
+    n = (std::min)(n, out_size_);
+    out_size_ = 0;
+    if(n == 0)
+        return;
+    // release, so the consumer sees the bytes written
+    tail_.store(
+        tail_.load(std::memory_order_relaxed) + n,
+        std::memory_order_release);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if(waiting_.load(std::memory_order_relaxed))
+        notify({});
+}
+
+void
+spsc_buffer_base::
+consume(std::size_t n) noexcept
+{
+    auto const head = head_.load(std::memory_order_relaxed);
+    auto const in_size =
+        tail_.load(std::memory_order_acquire) - head;
+    // release, so the producer only reuses the space
+    // after the consumer has finished reading it
+    head_.store(head + (std::min)(n, in_size),
+        std::memory_order_release);
+}
+
+void
+spsc_buffer_base::
+close()
+{
+    closed_.store(true, std::memory_order_release);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if(waiting_.load(std::memory_order_relaxed))
+        notify(net::error::eof);
+}
+
+void
+spsc_buffer_base::
+cancel()
+{
+    notify(net::error::operation_aborted);
+}
+
+void
+spsc_buffer_base::
+notify(error_code ec)
+{
+    saved_handler h;
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        if(! waiting_.load(std::memory_order_relaxed))
+            return;
+        waiting_.store(false, std::memory_order_relaxed);
+        wait_ec_ = ec;
+        h = std::move(wait_);
+    }
+    // Posting may throw, so it is done without the lock.
+    // No other wait can start until this one completes.
+    h.invoke();
+}
+
+} // beast
+} // boost
+
+#endif
@@ -0,0 +1,438 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_CORE_METRICS_POLICY_HPP
+#define BOOST_BEAST_CORE_METRICS_POLICY_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/string.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace boost {
+namespace beast {
+
+/** Helper class to assist implementing a MetricsPolicy.
+
+    This class is used by the implementation to gain access to the
+    private members of a user-defined object meeting the requirements
+    of <em>MetricsPolicy</em>. To use it, simply declare it as a friend
+    in your class:
+
+    @par Example
+    @code
+    class custom_metrics_policy
+    {
+        friend class beast::metrics_policy_access;
+        ...
+    @endcode
+
+    @par Concepts
+
+    @li <em>MetricsPolicy</em>
+
+    @see @ref beast::basic_stream
+*/
+class metrics_policy_access
+{
+private:
+    template<class, class, class, class>
+    friend class basic_stream;
+
+    using clock_type = std::chrono::steady_clock;
+
+    template<class Policy>
+    static
+    clock_type::time_point
+    now(Policy& policy)
+    {
+        return policy.now();
+    }
+
+    template<class Policy>
+    static
+    void
+    on_read(Policy& policy,
+        std::size_t n, clock_type::duration wait)
+    {
+        return policy.on_read(n, wait);
+    }
+
+    template<class Policy>
+    static
+    void
+    on_write(Policy& policy,
+        std::size_t n, clock_type::duration wait)
+    {
+        return policy.on_write(n, wait);
+    }
+
+    template<class Policy>
+    static
+    void
+    on_handler(Policy& policy, clock_type::duration d)
+    {
+        return policy.on_handler(d);
+    }
+
+    template<class Policy>
+    static
+    void
+    on_rate_wait(Policy& policy, clock_type::duration d)
+    {
+        return policy.on_rate_wait(d);
+    }
+
+    template<class Policy>
+    static
+    void
+    on_timeout(Policy& policy)
+    {
+        return policy.on_timeout();
+    }
+};
+
+//------------------------------------------------------------------------------
+
+/** A metrics policy which records nothing.
+
+    This is the default metrics policy of @ref basic_stream. Its
+    functions are empty, and `now` does not read the clock, so the
+    stream does no additional work.
+
+    @par Concepts
+
+    @li <em>MetricsPolicy</em>
+
+    @see @ref beast::basic_stream
+*/
+class null_metrics_policy
+{
+    friend class metrics_policy_access;
+
+    using clock_type = std::chrono::steady_clock;
+
+    clock_type::time_point
+    now() const noexcept
+    {
+        return {};
+    }
+
+    void
+    on_read(std::size_t, clock_type::duration) const noexcept
+    {
+    }
+
+    void
+    on_write(std::size_t, clock_type::duration) const noexcept
+    {
+    }
+
+    void
+    on_handler(clock_type::duration) const noexcept
+    {
+    }
+
+    void
+    on_rate_wait(clock_type::duration) const noexcept
+    {
+    }
+
+    void
+    on_timeout() const noexcept
+    {
+    }
+};
+
+//------------------------------------------------------------------------------
+
+/** Counters describing the I/O performed by streams.
+
+    @see @ref simple_metrics_policy, @ref metrics_registry
+*/
+struct stream_metrics
+{
+    /// Number of bytes read
+    std::uint64_t bytes_read = 0;
+
+    /// Number of bytes written
+    std::uint64_t bytes_written = 0;
+
+    /// Number of read operations performed on the socket
+    std::uint64_t reads = 0;
+
+    /// Number of write operations performed on the socket
+    std::uint64_t writes = 0;
+
+    /// Number of operations which completed with @ref error::timeout
+    std::uint64_t timeouts = 0;
+
+    /// Time spent waiting for the socket to complete reads
+    std::chrono::nanoseconds read_wait{0};
+
+    /// Time spent waiting for the socket to complete writes
+    std::chrono::nanoseconds write_wait{0};
+
+    /// Time spent in the completion handlers of reads and writes
+    std::chrono::nanoseconds handler_time{0};
+
+    /// Time spent waiting for the rate policy to allow a transfer
+    std::chrono::nanoseconds rate_wait{0};
+};
+
+/** A set of counters aggregated from many streams.
+
+    Streams using a @ref simple_metrics_policy attached to the
+    registry add their counters to it as they go. The counters are
+    atomic and spread over several cache lines, and each stream
+    updates its own group of counters, so streams running on
+    different threads can update the registry concurrently without
+    locks and with little contention. The totals are the sum of
+    all groups.
+
+    @par Example
+
+    Serve the totals of all connections to a Prometheus scraper:
+
+    @code
+    beast::metrics_registry registry;
+    ...
+    stream.metrics_policy().attach(registry);
+    ...
+    http::response<http::string_body> res;
+    res.set(http::field::content_type, "text/plain; version=0.0.4");
+    res.body() = registry.to_prometheus();
+    @endcode
+
+    @par Thread Safety
+    <em>Distinct objects</em>: Safe.@n
+    <em>Shared objects</em>: Safe.
+
+    @note The registry must outlive the streams attached to it.
+*/
+class metrics_registry
+{
+    friend class simple_metrics_policy;
+
+    enum counter
+    {
+        bytes_read,
+        bytes_written,
+        reads,
+        writes,
+        timeouts,
+        read_wait,
+        write_wait,
+        handler_time,
+        rate_wait,
+        counters
+    };
+
+    // Padding to keep the groups on separate cache lines
+    static std::size_t constexpr cache_line = 64;
+
+    static std::size_t constexpr groups = 16;
+
+    struct group
+    {
+        std::atomic<std::uint64_t> v[counters];
+        char pad[cache_line];
+    };
+
+    group groups_[groups];
+    std::atomic<std::size_t> next_{0};
+
+    std::size_t
+    select() noexcept
+    {
+        return next_.fetch_add(1,
+            std::memory_order_relaxed) % groups;
+    }
+
+    void
+    add(std::size_t g, counter c, std::uint64_t n) noexcept
+    {
+        groups_[g].v[c].fetch_add(n,
+            std::memory_order_relaxed);
+    }
+
+public:
+    /// Constructor
+    BOOST_BEAST_DECL
+    metrics_registry() noexcept;
+
+    metrics_registry(metrics_registry const&) = delete;
+    metrics_registry& operator=(metrics_registry const&) = delete;
+
+    /** Return the sum of the counters of all streams.
+
+        Counters updated concurrently with this call may or
+        may not be included.
+    */
+    BOOST_BEAST_DECL
+    stream_metrics
+    totals() const noexcept;
+
+    /** Return the totals in the Prometheus text format.
+
+        Each counter is reported as a metric of type `counter`, named
+        with the given prefix, such as `beast_stream_read_bytes_total`.
+        Times are reported in seconds.
+
+        @param prefix The prefix of the metric names.
+    */
+    BOOST_BEAST_DECL
+    std::string
+    to_prometheus(
+        string_view prefix = "beast_stream") const;
+};
+
+//------------------------------------------------------------------------------
+
+/** A metrics policy which counts the I/O of a stream.
+
+    This policy keeps the @ref stream_metrics of the stream it belongs
+    to. When attached to a @ref metrics_registry, it also adds them to
+    the registry as they are updated. The counters are updated directly
+    by the stream's operations, without wrapping their handlers.
+
+    A read or write is counted when the operation on the socket
+    completes, including the synchronous `read_some` and `write_some`.
+    The handler time of an asynchronous operation covers the call to
+    its completion handler, including any operation the handler starts.
+
+    @par Example
+    @code
+    using stream_type = basic_stream<net::ip::tcp, net::executor,
+        unlimited_rate_policy, simple_metrics_policy>;
+
+    stream_type stream(ioc);
+    stream.metrics_policy().attach(registry);
+    ...
+    std::cout << stream.metrics_policy().metrics().bytes_read << "\n";
+    @endcode
+
+    @par Concepts
+
+    @li <em>MetricsPolicy</em>
+
+    @see @ref beast::basic_stream, @ref metrics_registry
+*/
+class simple_metrics_policy
+{
+public:
+    /// The clock used to measure times
+    using clock_type = std::chrono::steady_clock;
+
+private:
+    friend class metrics_policy_access;
+
+    stream_metrics m_;
+    metrics_registry* r_ = nullptr;
+    std::size_t g_ = 0;
+
+    static
+    std::uint64_t
+    count(clock_type::duration d) noexcept
+    {
+        return static_cast<std::uint64_t>(
+            std::chrono::duration_cast<
+                std::chrono::nanoseconds>(d).count());
+    }
+
+    clock_type::time_point
+    now() const noexcept
+    {
+        return clock_type::now();
+    }
+
+    void
+    on_read(std::size_t n, clock_type::duration wait) noexcept
+    {
+        m_.bytes_read += n;
+        ++m_.reads;
+        m_.read_wait += wait;
+        if(! r_)
+            return;
+        r_->add(g_, metrics_registry::bytes_read, n);
+        r_->add(g_, metrics_registry::reads, 1);
+        r_->add(g_, metrics_registry::read_wait, count(wait));
+    }
+
+    void
+    on_write(std::size_t n, clock_type::duration wait) noexcept
+    {
+        m_.bytes_written += n;
+        ++m_.writes;
+        m_.write_wait += wait;
+        if(! r_)
+            return;
+        r_->add(g_, metrics_registry::bytes_written, n);
+        r_->add(g_, metrics_registry::writes, 1);
+        r_->add(g_, metrics_registry::write_wait, count(wait));
+    }
+
+    void
+    on_handler(clock_type::duration d) noexcept
+    {
+        m_.handler_time += d;
+        if(r_)
+            r_->add(g_, metrics_registry::handler_time, count(d));
+    }
+
+    void
+    on_rate_wait(clock_type::duration d) noexcept
+    {
+        m_.rate_wait += d;
+        if(r_)
+            r_->add(g_, metrics_registry::rate_wait, count(d));
+    }
+
+    void
+    on_timeout() noexcept
+    {
+        ++m_.timeouts;
+        if(r_)
+            r_->add(g_, metrics_registry::timeouts, 1);
+    }
+
+public:
+    /** Add the counters of the stream to a registry.
+
+        Only the counters updated after this call are added.
+
+        @param registry The registry to use. It must outlive
+        the stream.
+    */
+    void
+    attach(metrics_registry& registry) noexcept
+    {
+        r_ = &registry;
+        g_ = registry.select();
+    }
+
+    /// Return the counters of the stream
+    stream_metrics const&
+    metrics() const noexcept
+    {
+        return m_;
+    }
+};
+
+} // beast
+} // boost
+
+#ifdef BOOST_BEAST_HEADER_ONLY
+#include <boost/beast/core/impl/metrics_policy.ipp>
+#endif
+
+#endif
@@ -0,0 +1,388 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_CORE_MIRRORED_RING_BUFFER_HPP
+#define BOOST_BEAST_CORE_MIRRORED_RING_BUFFER_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+
+#if ! defined(BOOST_BEAST_NO_MIRRORED_RING_BUFFER)
+# if ! defined(__APPLE__) && ! defined(__linux__)
+#  define BOOST_BEAST_NO_MIRRORED_RING_BUFFER
+# endif
+#endif
+
+#if ! defined(BOOST_BEAST_USE_MIRRORED_RING_BUFFER)
+# if ! defined(BOOST_BEAST_NO_MIRRORED_RING_BUFFER)
+#  define BOOST_BEAST_USE_MIRRORED_RING_BUFFER 1
+# else
+#  define BOOST_BEAST_USE_MIRRORED_RING_BUFFER 0
+# endif
+#endif
+
+#if BOOST_BEAST_USE_MIRRORED_RING_BUFFER
+
+#include <boost/asio/buffer.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+
+namespace boost {
+namespace beast {
+
+/** A circular dynamic buffer whose sequences are always contiguous.
+
+    This buffer stores its bytes in a ring, like @ref static_buffer,
+    but the pages holding the ring are mapped twice, back to back,
+    into the address space. A region which wraps around the end of
+    the ring therefore continues seamlessly into the second mapping,
+    and the readable and writable bytes are each always represented
+    by a single buffer. Consuming bytes never moves memory, and
+    wraparound never needs a copy or a second buffer.
+
+    When more space is needed, the buffer grows geometrically up to
+    its maximum size, in multiples of the page size. This makes it
+    a drop-in replacement for @ref flat_buffer on long-lived
+    connections which read continuously, such as HTTP parsers and
+    websocket streams.
+
+    Objects of this type meet the requirements of <em>DynamicBuffer</em>
+    and have the following additional properties:
+
+    @li A mutable buffer sequence representing the readable
+    bytes is returned by @ref data when `this` is non-const.
+
+    @li A configurable maximum buffer size may be set upon
+    construction. Attempts to exceed the buffer size will throw
+    `std::length_error`.
+
+    @li Buffer sequences representing the readable and writable
+    bytes, returned by @ref data and @ref prepare, will have
+    length one.
+
+    @li Each mapping is a whole number of pages, so the capacity
+    is at least one page once memory is allocated.
+
+    The mappings are created with `memfd_create` where available,
+    and `shm_open` otherwise. This class is not available on other
+    platforms; there, `BOOST_BEAST_USE_MIRRORED_RING_BUFFER` is
+    defined to `0`.
+
+    @par Remarks
+
+    Each buffer with allocated memory uses two memory mappings, and
+    twice that while it grows, since the old mappings are released
+    only after the bytes are copied. On Linux the number of mappings
+    per process is limited by `vm.max_map_count`, 65530 by default,
+    which allows roughly 32000 buffers; creating more fails with
+    `ENOMEM`. A file descriptor is also needed while the memory is
+    mapped, counted against `RLIMIT_NOFILE`. It is closed as soon as
+    both mappings exist, so buffers do not hold descriptors while
+    they are in use. Applications which keep one buffer for each of
+    a very large number of connections should raise
+    `vm.max_map_count`, or use @ref flat_buffer instead.
+*/
+class mirrored_ring_buffer
+{
+    char* begin_ = nullptr;
+    std::size_t capacity_ = 0;
+    std::size_t in_off_ = 0;
+    std::size_t in_size_ = 0;
+    std::size_t out_size_ = 0;
+    std::size_t max_ = (std::numeric_limits<std::size_t>::max)();
+
+public:
+    /// Destructor
+    BOOST_BEAST_DECL
+    ~mirrored_ring_buffer();
+
+    /** Constructor
+
+        After construction, @ref capacity will return zero, and
+        @ref max_size will return the largest value of `std::size_t`.
+    */
+    mirrored_ring_buffer() = default;
+
+    /** Constructor
+
+        After construction, @ref capacity will return zero, and
+        @ref max_size will return the specified value of `limit`.
+
+        @param limit The desired maximum size.
+    */
+    explicit
+    mirrored_ring_buffer(std::size_t limit) noexcept
+        : max_(limit)
+    {
+    }
+
+    /** Move Constructor
+
+        After the move, `*this` will have an empty output sequence,
+        and `other` will be empty with zero capacity.
+    */
+    BOOST_BEAST_DECL
+    mirrored_ring_buffer(mirrored_ring_buffer&& other) noexcept;
+
+    /** Copy Constructor
+
+        After construction, `*this` has a copy of the readable
+        bytes of `other`, and the same maximum size.
+    */
+    BOOST_BEAST_DECL
+    mirrored_ring_buffer(mirrored_ring_buffer const& other);
+
+    /** Move Assignment
+
+        After the move, `*this` will have the contents of `other`,
+        and `other` will be empty with zero capacity.
+    */
+    BOOST_BEAST_DECL
+    mirrored_ring_buffer&
+    operator=(mirrored_ring_buffer&& other) noexcept;
+
+    /** Copy Assignment
+
+        After the copy, `*this` has a copy of the readable
+        bytes of `other`, and the same maximum size.
+    */
+    BOOST_BEAST_DECL
+    mirrored_ring_buffer&
+    operator=(mirrored_ring_buffer const& other);
+
+    /** Set the maximum allowed capacity
+
+        This function changes the currently configured upper limit
+        on capacity to the specified value.
+
+        @param n The maximum number of bytes ever allowed for capacity.
+
+        @par Exception Safety
+
+        No-throw guarantee.
+    */
+    void
+    max_size(std::size_t n) noexcept
+    {
+        max_ = n;
+    }
+
+    /** Guarantee a minimum capacity
+
+        This function adjusts the internal storage (if necessary)
+        to guarantee space for at least `n` bytes.
+
+        Buffer sequences previously obtained using @ref data or
+        @ref prepare become invalid.
+
+        @param n The minimum number of byte for the new capacity.
+        If this value is greater than the maximum size, then the
+        maximum size will be adjusted upwards to this value.
+
+        @par Exception Safety
+
+        Strong guarantee.
+
+        @throws system_error if the memory could not be mapped.
+    */
+    BOOST_BEAST_DECL
+    void
+    reserve(std::size_t n);
+
+    /** Reallocate the buffer to fit the readable bytes.
+
+        The capacity becomes the size of the readable bytes
+        rounded up to a whole number of pages, or zero when
+        there are no readable bytes.
+
+        Buffer sequences previously obtained using @ref data or
+        @ref prepare become invalid.
+
+        @par Exception Safety
+
+        Strong guarantee.
+    */
+    BOOST_BEAST_DECL
+    void
+    shrink_to_fit();
+
+    /** Set the size of the readable and writable bytes to zero.
+
+        This clears the buffer without changing capacity.
+        Buffer sequences previously obtained using @ref data or
+        @ref prepare become invalid.
+
+        @par Exception Safety
+
+        No-throw guarantee.
+    */
+    void
+    clear() noexcept
+    {
+        in_off_ = 0;
+        in_size_ = 0;
+        out_size_ = 0;
+    }
+
+    /// Exchange two dynamic buffers
+    BOOST_BEAST_DECL
+    friend
+    void
+    swap(
+        mirrored_ring_buffer& lhs,
+        mirrored_ring_buffer& rhs) noexcept;
+
+    //--------------------------------------------------------------------------
+
+    /// The ConstBufferSequence used to represent the readable bytes.
+    using const_buffers_type = net::const_buffer;
+
+    /// The MutableBufferSequence used to represent the readable bytes.
+    using mutable_data_type = net::mutable_buffer;
+
+    /// The MutableBufferSequence used to represent the writable bytes.
+    using mutable_buffers_type = net::mutable_buffer;
+
+    /// Returns the number of readable bytes.
+    std::size_t
+    size() const noexcept
+    {
+        return in_size_;
+    }
+
+    /// Return the maximum number of bytes, both readable and writable, that can ever be held.
+    std::size_t
+    max_size() const noexcept
+    {
+        return max_;
+    }
+
+    /// Return the maximum number of bytes, both readable and writable, that can be held without requiring an allocation.
+    std::size_t
+    capacity() const noexcept
+    {
+        return capacity_;
+    }
+
+    /// Returns a constant buffer sequence representing the readable bytes
+    const_buffers_type
+    data() const noexcept
+    {
+        return {begin_ + in_off_, in_size_};
+    }
+
+    /// Returns a constant buffer sequence representing the readable bytes
+    const_buffers_type
+    cdata() const noexcept
+    {
+        return data();
+    }
+
+    /// Returns a mutable buffer sequence representing the readable bytes
+    mutable_data_type
+    data() noexcept
+    {
+        return {begin_ + in_off_, in_size_};
+    }
+
+    /** Returns a mutable buffer sequence representing writable bytes.
+
+        Returns a mutable buffer sequence representing the writable
+        bytes containing exactly `n` bytes of storage. Memory may be
+        reallocated as needed.
+
+        All buffers sequences previously obtained using
+        @ref data or @ref prepare are invalidated.
+
+        @param n The desired number of bytes in the returned buffer
+        sequence.
+
+        @throws std::length_error if `size() + n` exceeds `max_size()`.
+
+        @throws system_error if the memory could not be mapped.
+
+        @par Exception Safety
+
+        Strong guarantee.
+    */
+    BOOST_BEAST_DECL
+    mutable_buffers_type
+    prepare(std::size_t n);
+
+    /** Append writable bytes to the readable bytes.
+
+        Appends n bytes from the start of the writable bytes to the
+        end of the readable bytes. The remainder of the writable bytes
+        are discarded. If n is greater than the number of writable
+        bytes, all writable bytes are appended to the readable bytes.
+
+        All buffers sequences previously obtained using
+        @ref data or @ref prepare are invalidated.
+
+        @param n The number of bytes to append. If this number
+        is greater than the number of writable bytes, all
+        writable bytes are appended.
+
+        @par Exception Safety
+
+        No-throw guarantee.
+    */
+    void
+    commit(std::size_t n) noexcept
+    {
+        in_size_ += (std::min)(n, out_size_);
+        out_size_ = 0;
+    }
+
+    /** Remove bytes from beginning of the readable bytes.
+
+        Removes n bytes from the beginning of the readable bytes.
+
+        All buffers sequences previously obtained using
+        @ref data or @ref prepare are invalidated.
+
+        @param n The number of bytes to remove. If this number
+        is greater than the number of readable bytes, all
+        readable bytes are removed.
+
+        @par Exception Safety
+
+        No-throw guarantee.
+    */
+    void
+    consume(std::size_t n) noexcept
+    {
+        if(n < in_size_)
+        {
+            in_off_ = (in_off_ + n) % capacity_;
+            in_size_ -= n;
+        }
+        else
+        {
+            in_off_ = 0;
+            in_size_ = 0;
+        }
+    }
+
+private:
+    BOOST_BEAST_DECL
+    void
+    realloc(std::size_t capacity);
+};
+
+} // beast
+} // boost
+
+#ifdef BOOST_BEAST_HEADER_ONLY
+#include <boost/beast/core/impl/mirrored_ring_buffer.ipp>
+#endif
+
+#endif
+
+#endif
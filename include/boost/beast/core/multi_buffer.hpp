@@ -12,6 +12,7 @@
 
 #include <boost/beast/core/detail/config.hpp>
 #include <boost/beast/core/detail/allocator.hpp>
+#include <boost/beast/core/slab_allocator.hpp>
 #include <boost/asio/buffer.hpp>
 #include <boost/core/empty_value.hpp>
 #include <boost/intrusive/list.hpp>
@@ -541,12 +542,22 @@ private:
     void destroy(const_iter it);
     void destroy(element& e);
     element& alloc(std::size_t size);
+    element& alloc(std::size_t size, std::size_t limit);
     void debug_check() const;
 };
 
 /// A typical multi buffer
 using multi_buffer = basic_multi_buffer<std::allocator<char>>;
 
+/** A multi buffer whose elements are allocated from slabs.
+
+    The elements are allocated with @ref slab_allocator, which
+    recycles blocks of common sizes through per-thread freelists.
+    Each element grows to fill its size class, and the extra
+    bytes are available as capacity.
+*/
+using slab_multi_buffer = basic_multi_buffer<slab_allocator<char>>;
+
 } // beast
 } // boost
 
@@ -11,8 +11,15 @@
 #define BOOST_BEAST_CORE_RATE_POLICY_HPP
 
 #include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/detail/token_bucket.hpp>
+#include <boost/beast/core/detail/type_traits.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/shared_ptr.hpp>
+#include <chrono>
 #include <cstdint>
 #include <limits>
+#include <type_traits>
+#include <utility>
 
 namespace boost {
 namespace beast {
@@ -41,7 +48,7 @@ namespace beast {
 class rate_policy_access
 {
 private:
-    template<class, class, class>
+    template<class, class, class, class>
     friend class basic_stream;
 
     template<class Policy>
@@ -85,6 +92,42 @@ private:
     {
         return policy.on_timer();
     }
+
+    // true if the policy provides interval()
+    template<class Policy, class = void>
+    struct has_interval : std::false_type
+    {
+    };
+
+    template<class Policy>
+    struct has_interval<Policy, detail::void_t<decltype(
+        std::declval<Policy&>().interval())>> : std::true_type
+    {
+    };
+
+    template<class Policy>
+    static
+    std::chrono::steady_clock::duration
+    interval(Policy& policy, std::true_type)
+    {
+        return policy.interval();
+    }
+
+    template<class Policy>
+    static
+    std::chrono::steady_clock::duration
+    interval(Policy&, std::false_type)
+    {
+        return std::chrono::seconds(1);
+    }
+
+    template<class Policy>
+    static
+    std::chrono::steady_clock::duration
+    interval(Policy& policy)
+    {
+        return interval(policy, has_interval<Policy>{});
+    }
 };
 
 //------------------------------------------------------------------------------
@@ -215,6 +258,333 @@ public:
     }
 };
 
+//------------------------------------------------------------------------------
+
+/** A rate policy which refills a token bucket at a smooth rate.
+
+    Each direction has a bucket holding a budget of bytes. The budget
+    is refilled continuously at the configured number of bytes per
+    second, up to a maximum called the burst, and each transfer takes
+    bytes from it. Unlike @ref simple_rate_policy, which makes the
+    whole budget for a second available at the start of that second,
+    traffic flows evenly: when a stream runs out of budget it waits
+    only until the next refill interval, which defaults to 10
+    milliseconds.
+
+    A small burst gives the smoothest traffic, while a larger burst
+    allows an idle stream to catch up quickly.
+
+    @par Example
+    @code
+    token_bucket_rate_policy policy;
+    policy.write_limit(1024 * 1024);        // 1MB/s, default burst
+    policy.read_limit(64 * 1024, 16 * 1024); // 64KB/s, 16KB burst
+
+    basic_stream<net::ip::tcp, net::executor,
+        token_bucket_rate_policy> stream(policy, ioc);
+    @endcode
+
+    @par Concepts
+
+    @li <em>RatePolicy</em>
+
+    @see @ref beast::basic_stream, @ref shared_token_bucket_rate_policy
+*/
+class token_bucket_rate_policy
+{
+public:
+    /// The clock used to measure the rate
+    using clock_type = std::chrono::steady_clock;
+
+private:
+    friend class rate_policy_access;
+
+    detail::token_bucket rd_;
+    detail::token_bucket wr_;
+    clock_type::duration interval_;
+
+    std::size_t
+    available_read_bytes() noexcept
+    {
+        rd_.refill();
+        return rd_.available();
+    }
+
+    std::size_t
+    available_write_bytes() noexcept
+    {
+        wr_.refill();
+        return wr_.available();
+    }
+
+    void
+    transfer_read_bytes(std::size_t n) noexcept
+    {
+        rd_.take(n);
+    }
+
+    void
+    transfer_write_bytes(std::size_t n) noexcept
+    {
+        wr_.take(n);
+    }
+
+    void
+    on_timer() noexcept
+    {
+        rd_.refill();
+        wr_.refill();
+    }
+
+    clock_type::duration
+    interval() const noexcept
+    {
+        return interval_;
+    }
+
+public:
+    /** Constructor
+
+        Reads and writes are unlimited until a limit is set.
+
+        @param refill_interval How often a stream which ran out of
+        budget checks the bucket again.
+    */
+    explicit
+    token_bucket_rate_policy(
+        clock_type::duration refill_interval =
+            std::chrono::milliseconds(10)) noexcept
+        : interval_(refill_interval)
+    {
+    }
+
+    /// Return the refill interval
+    clock_type::duration
+    refill_interval() const noexcept
+    {
+        return interval_;
+    }
+
+    /** Set the limit of bytes per second to read
+
+        The bucket starts full, unless the rate is zero.
+
+        @param bytes_per_second The rate. The largest value of
+        `std::size_t` means unlimited. Zero pauses the transfers
+        in this direction, until a non-zero limit is set.
+
+        @param burst The size of the bucket. If zero, the bucket
+        holds the bytes earned in two refill intervals.
+    */
+    void
+    read_limit(
+        std::size_t bytes_per_second,
+        std::size_t burst = 0) noexcept
+    {
+        rd_.limit(bytes_per_second, burst > 0 ? burst :
+            detail::token_bucket_burst(bytes_per_second, interval_),
+                clock_type::now());
+    }
+
+    /** Set the limit of bytes per second to write
+
+        The bucket starts full, unless the rate is zero.
+
+        @param bytes_per_second The rate. The largest value of
+        `std::size_t` means unlimited. Zero pauses the transfers
+        in this direction, until a non-zero limit is set.
+
+        @param burst The size of the bucket. If zero, the bucket
+        holds the bytes earned in two refill intervals.
+    */
+    void
+    write_limit(
+        std::size_t bytes_per_second,
+        std::size_t burst = 0) noexcept
+    {
+        wr_.limit(bytes_per_second, burst > 0 ? burst :
+            detail::token_bucket_burst(bytes_per_second, interval_),
+                clock_type::now());
+    }
+
+};
+
+//------------------------------------------------------------------------------
+
+/** A token bucket rate policy whose budget is shared by many streams.
+
+    This policy works like @ref token_bucket_rate_policy, except that
+    copies of the policy object share the same buckets. Every stream
+    constructed with a copy draws from one aggregate budget, which
+    caps the combined throughput of a group of connections, such as
+    all connections of a tenant or all connections accepted by a
+    listener. The buckets are updated atomically, so the streams may
+    run on different threads.
+
+    A default-constructed stream creates its own policy and does not
+    share it; pass a copy of the shared policy to each stream instead.
+    Bytes transferred concurrently by several streams may briefly
+    exceed the budget, and the excess is recovered from later refills.
+
+    @par Example
+    @code
+    shared_token_bucket_rate_policy tenant;
+    tenant.write_limit(10 * 1024 * 1024); // 10MB/s for all streams
+
+    using stream_type = basic_stream<net::ip::tcp,
+        net::executor, shared_token_bucket_rate_policy>;
+
+    stream_type s1(tenant, ioc);
+    stream_type s2(tenant, ioc);
+    @endcode
+
+    @par Thread Safety
+    @e Distinct @e objects: Safe.@n
+    @e Shared @e objects: Unsafe. Copies which share buckets
+    may be used concurrently.
+
+    @par Concepts
+
+    @li <em>RatePolicy</em>
+
+    @see @ref beast::basic_stream, @ref token_bucket_rate_policy
+*/
+class shared_token_bucket_rate_policy
+{
+public:
+    /// The clock used to measure the rate
+    using clock_type = std::chrono::steady_clock;
+
+private:
+    friend class rate_policy_access;
+
+    struct state
+    {
+        detail::shared_token_bucket rd;
+        detail::shared_token_bucket wr;
+        clock_type::duration interval;
+
+        explicit
+        state(clock_type::duration interval_)
+            : interval(interval_)
+        {
+        }
+    };
+
+    boost::shared_ptr<state> sp_;
+
+    std::size_t
+    available_read_bytes() noexcept
+    {
+        sp_->rd.refill();
+        return sp_->rd.available();
+    }
+
+    std::size_t
+    available_write_bytes() noexcept
+    {
+        sp_->wr.refill();
+        return sp_->wr.available();
+    }
+
+    void
+    transfer_read_bytes(std::size_t n) noexcept
+    {
+        sp_->rd.take(n);
+    }
+
+    void
+    transfer_write_bytes(std::size_t n) noexcept
+    {
+        sp_->wr.take(n);
+    }
+
+    void
+    on_timer() noexcept
+    {
+        sp_->rd.refill();
+        sp_->wr.refill();
+    }
+
+    clock_type::duration
+    interval() const noexcept
+    {
+        return sp_->interval;
+    }
+
+public:
+    /** Constructor
+
+        This creates new buckets, shared by all copies of this object.
+        Reads and writes are unlimited until a limit is set.
+
+        @param refill_interval How often a stream which ran out of
+        budget checks the bucket again.
+    */
+    explicit
+    shared_token_bucket_rate_policy(
+        clock_type::duration refill_interval =
+            std::chrono::milliseconds(10))
+        : sp_(boost::make_shared<state>(refill_interval))
+    {
+    }
+
+    /// Return the refill interval
+    clock_type::duration
+    refill_interval() const noexcept
+    {
+        return sp_->interval;
+    }
+
+    /** Set the limit of bytes per second to read, for all streams
+
+        The bucket starts full, unless the rate is zero. This
+        function may be called while streams sharing the
+        buckets are in use.
+
+        @param bytes_per_second The rate. The largest value of
+        `std::size_t` means unlimited. Zero pauses the transfers
+        in this direction, until a non-zero limit is set.
+
+        @param burst The size of the bucket. If zero, the bucket
+        holds the bytes earned in two refill intervals.
+    */
+    void
+    read_limit(
+        std::size_t bytes_per_second,
+        std::size_t burst = 0) noexcept
+    {
+        sp_->rd.limit(bytes_per_second, burst > 0 ? burst :
+            detail::token_bucket_burst(
+                bytes_per_second, sp_->interval),
+                    clock_type::now());
+    }
+
+    /** Set the limit of bytes per second to write, for all streams
+
+        The bucket starts full, unless the rate is zero. This
+        function may be called while streams sharing the
+        buckets are in use.
+
+        @param bytes_per_second The rate. The largest value of
+        `std::size_t` means unlimited. Zero pauses the transfers
+        in this direction, until a non-zero limit is set.
+
+        @param burst The size of the bucket. If zero, the bucket
+        holds the bytes earned in two refill intervals.
+    */
+    void
+    write_limit(
+        std::size_t bytes_per_second,
+        std::size_t burst = 0) noexcept
+    {
+        sp_->wr.limit(bytes_per_second, burst > 0 ? burst :
+            detail::token_bucket_burst(
+                bytes_per_second, sp_->interval),
+                    clock_type::now());
+    }
+};
+
 } // beast
 } // boost
 
@@ -11,7 +11,10 @@
 #define BOOST_BEAST_READ_SIZE_HELPER_HPP
 
 #include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/error.hpp>
+#include <boost/asio/socket_base.hpp>
 #include <boost/throw_exception.hpp>
+#include <cstddef>
 
 namespace boost {
 namespace beast {
@@ -35,6 +38,206 @@ template<class DynamicBuffer>
 std::size_t
 read_size(DynamicBuffer& buffer, std::size_t max_size);
 
+/** Tracks the amount of data arriving on a connection to size reads.
+
+    Reading into a dynamic buffer requires choosing how many bytes
+    to prepare before the amount of available data is known. Asking
+    for too little turns a large message into many small reads, each
+    costing a system call, while asking for too much on many idle
+    connections wastes memory.
+
+    An advisor remembers the outcome of recent reads on one
+    connection. When a read fills all of the space prepared for it,
+    more data was probably waiting and the advised size doubles.
+    Otherwise the advised size follows a moving average of the number
+    of bytes transferred per read, with room for twice that amount.
+    The result always lies between a minimum and a maximum size.
+
+    For sockets, @ref update additionally queries the number of bytes
+    which may be read without blocking (`FIONREAD`) and the size of
+    the kernel receive buffer (`SO_RCVBUF`). These cost a system call
+    each, so they are only obtained when requested.
+
+    @par Example
+    @code
+    read_size_advisor advisor;
+    for(;;)
+    {
+        auto const n = read_size(buffer, 65536, advisor);
+        auto const bytes_transferred =
+            sock.read_some(buffer.prepare(n));
+        buffer.commit(bytes_transferred);
+        advisor.feedback(n, bytes_transferred);
+        ...
+    }
+    @endcode
+
+    @see read_size
+*/
+class read_size_advisor
+{
+    std::size_t min_;
+    std::size_t max_;
+    std::size_t size_;
+    std::size_t avg_ = 0;
+    std::size_t available_ = 0;
+
+    std::size_t
+    clamp(std::size_t n) const noexcept
+    {
+        if(n < min_)
+            return min_;
+        if(n > max_)
+            return max_;
+        return n;
+    }
+
+public:
+    /** Constructor
+
+        @param min_size The smallest size which will be advised.
+        The default matches the minimum used by @ref read_size.
+
+        @param max_size The largest size which will be advised.
+    */
+    explicit
+    read_size_advisor(
+        std::size_t min_size = 512,
+        std::size_t max_size = 65536) noexcept
+        : min_(min_size)
+        , max_(max_size < min_size ? min_size : max_size)
+        , size_(min_size)
+    {
+    }
+
+    /** Returns the number of bytes to prepare for the next read.
+
+        The returned value is at least the minimum size and at
+        most the maximum size.
+    */
+    std::size_t
+    size() const noexcept
+    {
+        if(available_ > size_)
+            return clamp(available_);
+        return size_;
+    }
+
+    /** Report the outcome of a read.
+
+        @param requested The number of bytes prepared for the read.
+
+        @param bytes_transferred The number of bytes actually read.
+    */
+    void
+    feedback(
+        std::size_t requested,
+        std::size_t bytes_transferred) noexcept
+    {
+        available_ = 0;
+        if(bytes_transferred == 0)
+            return;
+        if(avg_ == 0)
+            avg_ = bytes_transferred;
+        else
+            avg_ = avg_ - avg_ / 4 + bytes_transferred / 4;
+        if(bytes_transferred >= requested)
+            size_ = clamp(requested > max_ / 2 ? max_ : 2 * requested);
+        else
+            size_ = clamp(avg_ > max_ / 2 ? max_ : 2 * avg_);
+    }
+
+    /** Report the number of bytes which may be read without blocking.
+
+        The next advised size is raised to cover this amount, up to
+        the maximum size. The hint applies to the next read only.
+    */
+    void
+    available(std::size_t n) noexcept
+    {
+        available_ = n;
+    }
+
+    /** Limit the advised size.
+
+        This lowers the maximum size, but never below the
+        minimum size. A value of zero has no effect.
+    */
+    void
+    limit(std::size_t n) noexcept
+    {
+        if(n == 0)
+            return;
+        if(n < max_)
+            max_ = n < min_ ? min_ : n;
+        if(size_ > max_)
+            size_ = max_;
+    }
+
+    /** Query a socket for the amount of pending data.
+
+        This obtains the number of bytes which may be read without
+        blocking and the size of the kernel receive buffer, and
+        applies them as if by calling @ref available and @ref limit.
+        Reading more than the receive buffer can hold in one call
+        is never useful.
+
+        @param socket The socket to query. The type must provide
+        the `available` and `get_option` members of
+        `net::basic_socket`.
+
+        @param ec Set to indicate what error occurred, if any.
+    */
+    template<class Socket>
+    void
+    update(Socket& socket, error_code& ec)
+    {
+        net::socket_base::receive_buffer_size option;
+        socket.get_option(option, ec);
+        if(ec)
+            return;
+        if(option.value() > 0)
+            limit(static_cast<std::size_t>(option.value()));
+        auto const n = socket.available(ec);
+        if(ec)
+            return;
+        available(n);
+    }
+
+    /// Forget the history of reads
+    void
+    reset() noexcept
+    {
+        size_ = min_;
+        avg_ = 0;
+        available_ = 0;
+    }
+};
+
+/** Returns a read size suggested by an advisor.
+
+    This function works like the overload without the advisor,
+    except that the minimum read size is the size suggested by
+    the advisor instead of a fixed amount. As with the other
+    overload, free space already allocated in the buffer is
+    always offered to the read.
+
+    @param buffer The dynamic buffer to inspect.
+
+    @param max_size An upper limit on the returned value.
+
+    @param advisor The advisor for the connection being read.
+
+    @note If the buffer is already at its maximum size, zero
+    is returned.
+*/
+template<class DynamicBuffer>
+std::size_t
+read_size(
+    DynamicBuffer& buffer,
+    std::size_t max_size,
+    read_size_advisor const& advisor);
+
 /** Returns a natural read size or throw if the buffer is full.
 
     This function inspects the capacity, size, and maximum
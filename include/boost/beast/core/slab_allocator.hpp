@@ -0,0 +1,171 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_CORE_SLAB_ALLOCATOR_HPP
+#define BOOST_BEAST_CORE_SLAB_ALLOCATOR_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/detail/slab.hpp>
+#include <boost/throw_exception.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+namespace boost {
+namespace beast {
+
+/** Allocation counters for the slabs of the calling thread.
+
+    @see slab_allocator::thread_stats
+*/
+struct slab_stats
+{
+    /// Allocations satisfied from a freelist
+    std::uint64_t hits = 0;
+
+    /// Allocations of a size class which went to `operator new`
+    std::uint64_t misses = 0;
+
+    /// Number of bytes held in the freelists
+    std::size_t cached = 0;
+};
+
+/** An allocator which recycles blocks in fixed size classes.
+
+    Requests for up to 64KB are rounded up to one of the size
+    classes 1KB, 4KB, 16KB or 64KB. Blocks of a size class are
+    taken from and returned to a freelist belonging to the
+    calling thread, so that busy threads reuse memory without
+    touching the global heap and its locks. Each freelist holds
+    a bounded number of blocks; any excess is returned to
+    `operator delete`. Larger requests bypass the freelists.
+
+    Blocks may be freed on a different thread than the one
+    which allocated them, in which case they join the freelist
+    of the freeing thread. When a thread exits, its freelists
+    are released.
+
+    This allocator is stateless and all instances compare
+    equal. It is the allocator used by @ref slab_multi_buffer.
+
+    @tparam T The type of object to allocate.
+*/
+template<class T>
+class slab_allocator
+{
+public:
+    /// The type of object allocated
+    using value_type = T;
+
+    /// The allocator is stateless
+    using is_always_equal = std::true_type;
+
+    /// The allocator rebound to another type
+    template<class U>
+    struct rebind
+    {
+        using other = slab_allocator<U>;
+    };
+
+    /// Constructor
+    slab_allocator() = default;
+
+    /// Constructor
+    template<class U>
+    slab_allocator(slab_allocator<U> const&) noexcept
+    {
+    }
+
+    /// Allocate storage for `n` objects
+    T*
+    allocate(std::size_t n)
+    {
+        if(n > (std::numeric_limits<std::size_t>::max)() / sizeof(T))
+            BOOST_THROW_EXCEPTION(std::bad_alloc{});
+        return static_cast<T*>(
+            detail::slab_allocate(n * sizeof(T)));
+    }
+
+    /// Deallocate storage obtained from @ref allocate
+    void
+    deallocate(T* p, std::size_t n) noexcept
+    {
+        detail::slab_deallocate(p, n * sizeof(T));
+    }
+
+    /** Return the number of objects obtained by allocating `n`.
+
+        Requests are rounded up to their size class, so that
+        a container may use the extra space. The result is
+        never less than `n`.
+    */
+    static
+    std::size_t
+    good_size(std::size_t n) noexcept
+    {
+        if(n > (std::numeric_limits<std::size_t>::max)() / sizeof(T))
+            return n;
+        return detail::slab_size(n * sizeof(T)) / sizeof(T);
+    }
+
+    /** Return the counters of the calling thread.
+
+        The counters are shared by all specializations of
+        this allocator, and are not synchronized between
+        threads.
+    */
+    static
+    slab_stats
+    thread_stats() noexcept
+    {
+        slab_stats s;
+        detail::slab_thread_stats(
+            s.hits, s.misses, s.cached);
+        return s;
+    }
+
+    /** Free the blocks held by the freelists of the calling thread.
+
+        This may be used to give memory back to the system when
+        a thread becomes idle.
+    */
+    static
+    void
+    thread_shrink() noexcept
+    {
+        detail::slab_thread_shrink();
+    }
+
+    template<class U>
+    friend
+    bool
+    operator==(
+        slab_allocator const&,
+        slab_allocator<U> const&) noexcept
+    {
+        return true;
+    }
+
+    template<class U>
+    friend
+    bool
+    operator!=(
+        slab_allocator const&,
+        slab_allocator<U> const&) noexcept
+    {
+        return false;
+    }
+};
+
+} // beast
+} // boost
+
+#endif
@@ -0,0 +1,413 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_SPSC_BUFFER_HPP
+#define BOOST_BEAST_SPSC_BUFFER_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/error.hpp>
+#include <boost/beast/core/saved_handler.hpp>
+#include <boost/beast/core/detail/buffers_pair.hpp>
+#include <boost/asio/async_result.hpp>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+
+namespace boost {
+namespace beast {
+
+/** A circular dynamic buffer shared by a producer and a consumer thread.
+
+    This buffer has the same fixed size, circular layout as
+    @ref static_buffer_base, but the readable bytes are delimited by
+    two atomic counters instead of plain integers. One thread, the
+    producer, appends bytes with @ref prepare and @ref commit, while
+    another thread, the consumer, reads them with @ref data and
+    removes them with @ref consume. The producer and the consumer may
+    call their respective functions concurrently without any other
+    synchronization. No locks are taken on these paths.
+
+    A typical use is to hand bytes from an I/O thread reading a
+    socket to a worker thread which parses or processes them, in
+    place of a @ref multi_buffer guarded by a mutex.
+
+    The consumer can wait for data without spinning by calling
+    @ref async_wait, which completes when readable bytes become
+    available, when the producer calls @ref close, or when the wait
+    is canceled.
+
+    Objects of this type meet the requirements of @b DynamicBuffer
+    and have the following additional properties:
+
+    @li Buffer sequences representing the readable and writable
+    bytes, returned by @ref data and @ref prepare, may have
+    length up to two.
+
+    @li All operations execute in constant time. Only
+    @ref async_wait, and the completion of a pending wait by
+    @ref commit or @ref close, may allocate memory.
+
+    @li Ownership of the underlying storage belongs to the
+    derived class.
+
+    @par Thread Safety
+    @e Distinct @e objects: Safe.@n
+    @e Shared @e objects: Safe for one producer thread calling
+    @ref prepare, @ref commit and @ref close, concurrently with one
+    consumer thread calling @ref data, @ref consume, @ref async_wait
+    and @ref cancel. @ref size may be called from either thread and
+    returns a snapshot. Other functions are unsafe.
+
+    @note Variables are usually declared using the template class
+    @ref spsc_buffer; however, to reduce the number of template
+    instantiations, objects should be passed `spsc_buffer_base&`.
+
+    @see @ref spsc_buffer
+*/
+class spsc_buffer_base
+{
+    template<class Handler>
+    class wait_op;
+
+    struct run_wait_op;
+
+    // Padding to keep the counters on separate cache lines
+    static std::size_t constexpr cache_line = 64;
+
+    char* begin_;
+    std::size_t capacity_;
+
+    // Total number of bytes ever consumed, written by the consumer
+    std::atomic<std::size_t> head_{0};
+    char pad0_[cache_line];
+
+    // Total number of bytes ever committed, written by the producer
+    std::atomic<std::size_t> tail_{0};
+    std::size_t out_size_ = 0;
+    std::atomic<bool> closed_{false};
+    char pad1_[cache_line];
+
+    std::atomic<bool> waiting_{false};
+    std::mutex m_;
+    saved_handler wait_;
+    error_code wait_ec_;
+
+    spsc_buffer_base(spsc_buffer_base const&) = delete;
+    spsc_buffer_base& operator=(spsc_buffer_base const&) = delete;
+
+    BOOST_BEAST_DECL
+    void
+    notify(error_code ec);
+
+public:
+    /** Constructor
+
+        This creates a dynamic buffer using the provided storage area.
+
+        @param p A pointer to valid storage of at least `n` bytes.
+
+        @param size The number of valid bytes pointed to by `p`.
+    */
+    BOOST_BEAST_DECL
+    spsc_buffer_base(void* p, std::size_t size) noexcept;
+
+    /** Destructor
+
+        A pending wait is destroyed without being invoked.
+    */
+    ~spsc_buffer_base() = default;
+
+    //--------------------------------------------------------------------------
+
+#if BOOST_BEAST_DOXYGEN
+    /// The ConstBufferSequence used to represent the readable bytes.
+    using const_buffers_type = __implementation_defined__;
+
+    /// The MutableBufferSequence used to represent the readable bytes.
+    using mutable_data_type = __implementation_defined__;
+
+    /// The MutableBufferSequence used to represent the writable bytes.
+    using mutable_buffers_type = __implementation_defined__;
+#else
+    using const_buffers_type   = detail::buffers_pair<false>;
+    using mutable_data_type    = detail::buffers_pair<true>;
+    using mutable_buffers_type = detail::buffers_pair<true>;
+#endif
+
+    /** Returns the number of readable bytes.
+
+        When called from the producer, the result may be larger
+        than the actual number of readable bytes. When called from
+        the consumer, it may be smaller.
+    */
+    std::size_t
+    size() const noexcept
+    {
+        return tail_.load(std::memory_order_acquire) -
+            head_.load(std::memory_order_acquire);
+    }
+
+    /// Return the maximum number of bytes, both readable and writable, that can ever be held.
+    std::size_t
+    max_size() const noexcept
+    {
+        return capacity_;
+    }
+
+    /// Return the maximum number of bytes, both readable and writable, that can be held without requiring an allocation.
+    std::size_t
+    capacity() const noexcept
+    {
+        return capacity_;
+    }
+
+    /** Returns a constant buffer sequence representing the readable bytes
+
+        This function may only be called by the consumer.
+    */
+    BOOST_BEAST_DECL
+    const_buffers_type
+    data() const noexcept;
+
+    /** Returns a constant buffer sequence representing the readable bytes
+
+        This function may only be called by the consumer.
+    */
+    const_buffers_type
+    cdata() const noexcept
+    {
+        return data();
+    }
+
+    /** Returns a mutable buffer sequence representing the readable bytes
+
+        This function may only be called by the consumer.
+    */
+    BOOST_BEAST_DECL
+    mutable_data_type
+    data() noexcept;
+
+    /** Returns a mutable buffer sequence representing writable bytes.
+
+        Returns a mutable buffer sequence representing the writable
+        bytes containing exactly `n` bytes of storage.
+
+        This function may only be called by the producer.
+
+        @param n The desired number of bytes in the returned buffer
+        sequence.
+
+        @throws std::length_error if `size() + n` exceeds `max_size()`.
+        Since the consumer may free space concurrently, this reflects
+        the readable bytes observed at the time of the call.
+
+        @par Exception Safety
+
+        Strong guarantee.
+    */
+    BOOST_BEAST_DECL
+    mutable_buffers_type
+    prepare(std::size_t n);
+
+    /** Append writable bytes to the readable bytes.
+
+        Appends n bytes from the start of the writable bytes to the
+        end of the readable bytes, making them visible to the consumer.
+        If the consumer is waiting, the wait completes.
+
+        This function may only be called by the producer.
+
+        @param n The number of bytes to append. If this number
+        is greater than the number of writable bytes, all
+        writable bytes are appended.
+
+        @throws Any exception thrown when posting the completion
+        of a pending wait, such as `std::bad_alloc`. The bytes are
+        appended regardless, and the wait is destroyed without its
+        handler being invoked.
+    */
+    BOOST_BEAST_DECL
+    void
+    commit(std::size_t n);
+
+    /** Remove bytes from beginning of the readable bytes.
+
+        Removes n bytes from the beginning of the readable bytes,
+        making the space available to the producer.
+
+        This function may only be called by the consumer.
+
+        @param n The number of bytes to remove. If this number
+        is greater than the number of readable bytes, all
+        readable bytes are removed.
+
+        @par Exception Safety
+
+        No-throw guarantee.
+    */
+    BOOST_BEAST_DECL
+    void
+    consume(std::size_t n) noexcept;
+
+    /** Indicate that no more bytes will be committed.
+
+        If the consumer is waiting on an empty buffer, the wait
+        completes with `net::error::eof`. Bytes already committed
+        remain readable.
+
+        This function may only be called by the producer.
+
+        @throws Any exception thrown when posting the completion
+        of a pending wait, such as `std::bad_alloc`. The buffer is
+        closed regardless, and the wait is destroyed without its
+        handler being invoked.
+    */
+    BOOST_BEAST_DECL
+    void
+    close();
+
+    /// Returns `true` if @ref close has been called
+    bool
+    is_closed() const noexcept
+    {
+        return closed_.load(std::memory_order_acquire);
+    }
+
+    /** Cancel a pending wait.
+
+        If the consumer is waiting, the wait completes with
+        `net::error::operation_aborted`.
+
+        This function may only be called by the consumer, or by
+        a thread which is synchronized with it.
+    */
+    BOOST_BEAST_DECL
+    void
+    cancel();
+
+    /** Wait asynchronously until bytes are readable.
+
+        This function is used to asynchronously wait until the
+        buffer holds readable bytes. The function call always
+        returns immediately. The wait completes when one of the
+        following conditions is true:
+
+        @li There are readable bytes.
+
+        @li The buffer is empty and @ref close was called.
+
+        @li The wait is canceled with @ref cancel.
+
+        Only one wait may be pending at a time. This function may
+        only be called by the consumer.
+
+        @param handler The completion handler to invoke when the
+        operation completes. The implementation takes ownership of
+        the handler by performing a decay-copy. The equivalent
+        function signature of the handler must be:
+        @code
+        void handler(
+            error_code const& ec    // Result of operation
+        );
+        @endcode
+        The error is `net::error::eof` if the buffer was closed, and
+        `net::error::operation_aborted` if the wait was canceled.
+        Regardless of whether the asynchronous operation completes
+        immediately or not, the handler will not be invoked from
+        within this function. Invocation of the handler will be
+        performed in a manner equivalent to using `net::post`, on
+        the handler's associated executor.
+    */
+    template<class WaitHandler>
+    BOOST_ASIO_INITFN_RESULT_TYPE(WaitHandler, void(error_code))
+    async_wait(WaitHandler&& handler);
+};
+
+//------------------------------------------------------------------------------
+
+/** A circular dynamic buffer shared by a producer and a consumer thread.
+
+    Objects of this type meet the requirements of @b DynamicBuffer.
+    One thread may append bytes while another thread reads and
+    removes them, without locks. See @ref spsc_buffer_base for the
+    thread safety rules and the wait mechanism.
+
+    @tparam N The number of bytes in the internal buffer.
+
+    @note To reduce the number of template instantiations when passing
+    objects of this type in a deduced context, the signature of the
+    receiving function should use @ref spsc_buffer_base instead.
+
+    @see @ref spsc_buffer_base
+*/
+template<std::size_t N>
+class spsc_buffer : public spsc_buffer_base
+{
+    char buf_[N];
+
+public:
+    /// Constructor
+    spsc_buffer() noexcept
+        : spsc_buffer_base(buf_, N)
+    {
+    }
+
+    /** Constructor
+
+        The readable bytes of `other` are copied. Neither
+        buffer may be in use by another thread.
+    */
+    spsc_buffer(spsc_buffer const& other) noexcept;
+
+    /** Assignment
+
+        The readable bytes of `other` are copied. Neither
+        buffer may be in use by another thread. A pending
+        wait completes if bytes were copied.
+    */
+    spsc_buffer& operator=(spsc_buffer const& other);
+
+    /// Returns the @ref spsc_buffer_base portion of this object
+    spsc_buffer_base&
+    base() noexcept
+    {
+        return *this;
+    }
+
+    /// Returns the @ref spsc_buffer_base portion of this object
+    spsc_buffer_base const&
+    base() const noexcept
+    {
+        return *this;
+    }
+
+    /// Return the maximum sum of the input and output sequence sizes.
+    std::size_t constexpr
+    max_size() const noexcept
+    {
+        return N;
+    }
+
+    /// Return the maximum sum of input and output sizes that can be held without an allocation.
+    std::size_t constexpr
+    capacity() const noexcept
+    {
+        return N;
+    }
+};
+
+} // beast
+} // boost
+
+#include <boost/beast/core/impl/spsc_buffer.hpp>
+#ifdef BOOST_BEAST_HEADER_ONLY
+#include <boost/beast/core/impl/spsc_buffer.ipp>
+#endif
+
+#endif
@@ -0,0 +1,148 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_CORE_TIMEOUT_WHEEL_HPP
+#define BOOST_BEAST_CORE_TIMEOUT_WHEEL_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/detail/timeout_wheel.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/shared_ptr.hpp>
+#include <chrono>
+#include <cstddef>
+
+namespace boost {
+namespace beast {
+
+#if ! BOOST_BEAST_DOXYGEN
+template<class, class, class, class>
+class basic_stream;
+#endif
+
+/** A shared, coarse-grained timer service for stream timeouts.
+
+    By default each @ref basic_stream waits on its own timers to
+    enforce the timeouts set with `expires_after` or `expires_at`.
+    Every logical operation with a timeout then registers a wait
+    with the reactor, and cancels it on completion. With many
+    thousands of connections this adds up to constant churn in
+    the reactor's timer queue.
+
+    A timeout wheel replaces those waits for the streams which opt
+    in by calling `basic_stream::use_timeout_wheel`. Deadlines are
+    rounded up to the next multiple of the wheel's granularity and
+    kept in intrusive lists, so starting and stopping the timeout of
+    an operation takes constant time and never allocates. The wheel
+    uses a single timer, which only runs while deadlines are pending.
+
+    The semantics of the stream timeouts are unchanged, except that a
+    timeout may be reported up to one granularity later than the
+    expiry time. It is never reported early.
+
+    @par Example
+
+    One wheel per thread, shared by the connections on that thread:
+
+    @code
+    net::io_context ioc(1);
+    beast::timeout_wheel wheel(ioc.get_executor());
+
+    beast::tcp_stream stream(ioc);
+    stream.use_timeout_wheel(&wheel);
+    stream.expires_after(std::chrono::seconds(30));
+    @endcode
+
+    @par Thread Safety
+    <em>Distinct objects</em>: Safe.@n
+    <em>Shared objects</em>: Unsafe. The wheel and every stream using
+    it must perform their asynchronous operations within the same
+    implicit or explicit strand, such as the thread running a single
+    threaded `net::io_context`.
+
+    @note The streams which use the wheel share ownership of its
+    state. When the wheel is destroyed first, its timer keeps
+    running until the last of these streams is destroyed or stops
+    using the wheel.
+*/
+class timeout_wheel
+{
+    boost::shared_ptr<detail::timeout_wheel_impl> impl_;
+
+    template<class, class, class, class>
+    friend class basic_stream;
+
+public:
+    /// The type of executor used to run the wheel's timer
+    using executor_type = net::steady_timer::executor_type;
+
+    /// The type used to represent the granularity
+    using duration = std::chrono::steady_clock::duration;
+
+    /** Constructor
+
+        @param ex The executor used to wait on the wheel's timer.
+
+        @param granularity The interval between ticks of the wheel.
+        Timeouts are reported at the first tick following their
+        expiry time.
+
+        @param slots The number of lists in the wheel. Deadlines
+        further than `slots * granularity` in the future are visited
+        once per revolution until they expire.
+    */
+    explicit
+    timeout_wheel(
+        executor_type const& ex,
+        duration granularity = std::chrono::milliseconds(100),
+        std::size_t slots = 512)
+        : impl_(boost::make_shared<detail::timeout_wheel_impl>(
+            ex, granularity, slots))
+    {
+    }
+
+    /** Destructor
+
+        If no stream uses the wheel, the wheel's timer is canceled.
+        Otherwise, the deadlines of those streams are still enforced.
+    */
+    ~timeout_wheel() = default;
+
+    ///
+    timeout_wheel(timeout_wheel const&) = delete;
+
+    ///
+    timeout_wheel& operator=(timeout_wheel const&) = delete;
+
+    /// Return the executor used to run the wheel's timer
+    executor_type
+    get_executor() noexcept
+    {
+        return impl_->timer.get_executor();
+    }
+
+    /// Return the interval between ticks of the wheel
+    duration
+    granularity() const noexcept
+    {
+        return impl_->granularity;
+    }
+
+    /// Return the number of pending deadlines
+    std::size_t
+    size() const noexcept
+    {
+        return impl_->size;
+    }
+};
+
+} // beast
+} // boost
+
+#endif
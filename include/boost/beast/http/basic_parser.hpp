@@ -203,22 +203,6 @@ class basic_parser
     static unsigned constexpr flagUpgrade               = 1<< 12;
     static unsigned constexpr flagFinalChunk            = 1<< 13;
 
-    static constexpr
-    std::uint64_t
-    default_body_limit(std::true_type)
-    {
-        // limit for requests
-        return 1 * 1024 * 1024; // 1MB
-    }
-
-    static constexpr
-    std::uint64_t
-    default_body_limit(std::false_type)
-    {
-        // limit for responses
-        return 8 * 1024 * 1024; // 8MB
-    }
-
     std::uint64_t body_limit_ =
         default_body_limit(is_request{});   // max payload body
     std::uint64_t len_ = 0;                 // size of chunk or body
@@ -11,6 +11,7 @@
 #define BOOST_BEAST_HTTP_CHUNK_ENCODE_HPP
 
 #include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/buffer_traits.hpp>
 #include <boost/beast/core/buffers_cat.hpp>
 #include <boost/beast/core/string.hpp>
 #include <boost/beast/http/type_traits.hpp>
@@ -729,6 +730,53 @@ make_chunk_last(
 }
 
 } // http
+
+#if ! BOOST_BEAST_DOXYGEN
+
+template<>
+struct buffer_sequence_max_length<http::chunk_crlf>
+    : std::integral_constant<std::size_t, 1>
+{
+};
+
+template<>
+struct buffer_sequence_max_length<http::detail::chunk_size>
+    : std::integral_constant<std::size_t, 1>
+{
+};
+
+template<>
+struct buffer_sequence_max_length<http::detail::chunk_size0>
+    : std::integral_constant<std::size_t, 1>
+{
+};
+
+// chunk-size, chunk-extensions, CRLF
+template<>
+struct buffer_sequence_max_length<http::chunk_header>
+    : std::integral_constant<std::size_t, 3>
+{
+};
+
+// chunk-size, chunk-extensions, CRLF, chunk-body, CRLF
+template<class ConstBufferSequence>
+struct buffer_sequence_max_length<http::chunk_body<ConstBufferSequence>>
+    : detail::buffer_sequence_length_sum<4,
+        buffer_sequence_max_length<ConstBufferSequence>::value>
+{
+};
+
+// "0\r\n", trailer
+template<class Trailer>
+struct buffer_sequence_max_length<http::chunk_last<Trailer>>
+    : detail::buffer_sequence_length_sum<1,
+        buffer_sequence_max_length<typename
+            http::detail::buffers_or_fields<Trailer>::type>::value>
+{
+};
+
+#endif
+
 } // beast
 } // boost
 
@@ -19,7 +19,9 @@
 #include <boost/version.hpp>
 #include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <limits>
+#include <type_traits>
 #include <utility>
 
 namespace boost {
@@ -35,6 +37,22 @@ struct basic_parser_base
     //
     static std::size_t constexpr max_obs_fold = 4096;
 
+    static constexpr
+    std::uint64_t
+    default_body_limit(std::true_type)
+    {
+        // limit for requests
+        return 1 * 1024 * 1024; // 1MB
+    }
+
+    static constexpr
+    std::uint64_t
+    default_body_limit(std::false_type)
+    {
+        // limit for responses
+        return 8 * 1024 * 1024; // 8MB
+    }
+
     template<class T>
     struct is_unsigned_integer:
         std::integral_constant<bool,
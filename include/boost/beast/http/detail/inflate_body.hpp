@@ -0,0 +1,323 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_HTTP_DETAIL_INFLATE_BODY_HPP
+#define BOOST_BEAST_HTTP_DETAIL_INFLATE_BODY_HPP
+
+#include <boost/beast/core/error.hpp>
+#include <boost/beast/core/string.hpp>
+#include <boost/beast/http/error.hpp>
+#include <boost/beast/zlib/error.hpp>
+#include <boost/beast/zlib/detail/checksum.hpp>
+#include <boost/asio/buffer.hpp>
+#include <cstddef>
+#include <cstdint>
+
+namespace boost {
+namespace beast {
+namespace http {
+namespace detail {
+
+/*  Parses the header and the trailer around the deflate stream
+    in the gzip (RFC 1952) and zlib (RFC 1950) formats, and keeps
+    the checksum of the decompressed data.
+*/
+class inflate_framing
+{
+public:
+    enum class format
+    {
+        raw,
+        zlib,
+        gzip
+    };
+
+private:
+    enum class state
+    {
+        zlib,
+        gz_fixed,
+        gz_xlen,
+        gz_extra,
+        gz_name,
+        gz_comment,
+        gz_hcrc,
+        done
+    };
+
+    // gzip header flags
+    static unsigned constexpr fhcrc     = 0x02;
+    static unsigned constexpr fextra    = 0x04;
+    static unsigned constexpr fname     = 0x08;
+    static unsigned constexpr fcomment  = 0x10;
+
+    format f_;
+    state st_;
+    unsigned char buf_[10];
+    std::size_t n_ = 0;         // octets in buf_
+    std::size_t skip_ = 0;      // extra field octets left
+    unsigned flags_ = 0;        // gzip fields left
+    std::uint32_t hcrc_ = 0;    // crc32 of the gzip header
+    std::uint32_t check_;       // checksum of the data
+    std::uint32_t size_ = 0;    // size of the data, modulo 2^32
+
+    static
+    std::uint32_t
+    get_le32(unsigned char const* p) noexcept
+    {
+        return
+            static_cast<std::uint32_t>(p[0]) |
+            static_cast<std::uint32_t>(p[1]) << 8 |
+            static_cast<std::uint32_t>(p[2]) << 16 |
+            static_cast<std::uint32_t>(p[3]) << 24;
+    }
+
+    static
+    std::uint32_t
+    get_be32(unsigned char const* p) noexcept
+    {
+        return
+            static_cast<std::uint32_t>(p[0]) << 24 |
+            static_cast<std::uint32_t>(p[1]) << 16 |
+            static_cast<std::uint32_t>(p[2]) << 8 |
+            static_cast<std::uint32_t>(p[3]);
+    }
+
+    // Move on to the next optional field of the gzip header
+    void
+    next_field() noexcept
+    {
+        n_ = 0;
+        if(flags_ & fextra)
+        {
+            flags_ &= ~fextra;
+            st_ = state::gz_xlen;
+        }
+        else if(flags_ & fname)
+        {
+            flags_ &= ~fname;
+            st_ = state::gz_name;
+        }
+        else if(flags_ & fcomment)
+        {
+            flags_ &= ~fcomment;
+            st_ = state::gz_comment;
+        }
+        else if(flags_ & fhcrc)
+        {
+            flags_ &= ~fhcrc;
+            st_ = state::gz_hcrc;
+        }
+        else
+        {
+            st_ = state::done;
+        }
+    }
+
+public:
+    explicit
+    inflate_framing(format f) noexcept
+        : f_(f)
+        , st_(
+            f == format::gzip ? state::gz_fixed :
+            f == format::zlib ? state::zlib :
+                state::done)
+        , check_(f == format::zlib ? 1 : 0)
+    {
+    }
+
+    format
+    get_format() const noexcept
+    {
+        return f_;
+    }
+
+    bool
+    is_header_done() const noexcept
+    {
+        return st_ == state::done;
+    }
+
+    /*  Parse header octets, returning the number consumed.
+
+        When a "deflate" payload turns out to be a raw deflate
+        stream without the zlib header, which some servers send,
+        the format becomes raw and `replay` is set to the octets
+        consumed so far, which belong to the deflate stream.
+    */
+    std::size_t
+    header(
+        unsigned char const* p, std::size_t n,
+        net::const_buffer& replay, error_code& ec)
+    {
+        ec = {};
+        replay = {};
+        std::size_t used = 0;
+        while(st_ != state::done && used < n)
+        {
+            auto const c = p[used++];
+            if(st_ != state::gz_hcrc)
+                hcrc_ = zlib::detail::crc32(hcrc_, &c, 1);
+            switch(st_)
+            {
+            case state::zlib:
+                buf_[n_++] = c;
+                if(n_ < 2)
+                    break;
+                if( (buf_[0] & 0x0f) != 8 ||
+                    (buf_[0] >> 4) > 7 ||
+                    ((buf_[0] << 8) | buf_[1]) % 31 != 0)
+                {
+                    f_ = format::raw;
+                    check_ = 0;
+                    replay = net::const_buffer(buf_, n_);
+                }
+                else if(buf_[1] & 0x20)
+                {
+                    // preset dictionaries are not supported
+                    ec = zlib::error::invalid_header;
+                    return used;
+                }
+                n_ = 0;
+                st_ = state::done;
+                break;
+
+            case state::gz_fixed:
+                buf_[n_++] = c;
+                if(n_ < 10)
+                    break;
+                if( buf_[0] != 0x1f || buf_[1] != 0x8b ||
+                    buf_[2] != 8 || (buf_[3] & 0xe0) != 0)
+                {
+                    ec = zlib::error::invalid_header;
+                    return used;
+                }
+                flags_ = buf_[3];
+                next_field();
+                break;
+
+            case state::gz_xlen:
+                buf_[n_++] = c;
+                if(n_ < 2)
+                    break;
+                skip_ = buf_[0] | (buf_[1] << 8);
+                n_ = 0;
+                st_ = state::gz_extra;
+                if(skip_ == 0)
+                    next_field();
+                break;
+
+            case state::gz_extra:
+                if(--skip_ == 0)
+                    next_field();
+                break;
+
+            case state::gz_name:
+            case state::gz_comment:
+                if(c == 0)
+                    next_field();
+                break;
+
+            case state::gz_hcrc:
+                buf_[n_++] = c;
+                if(n_ < 2)
+                    break;
+                if(static_cast<std::uint32_t>(
+                    buf_[0] | (buf_[1] << 8)) != (hcrc_ & 0xffff))
+                {
+                    ec = zlib::error::invalid_header;
+                    return used;
+                }
+                next_field();
+                break;
+
+            case state::done:
+                break;
+            }
+        }
+        return used;
+    }
+
+    // Add decompressed data to the checksum
+    void
+    update(void const* p, std::size_t n) noexcept
+    {
+        if(f_ == format::gzip)
+        {
+            check_ = zlib::detail::crc32(check_, p, n);
+            size_ += static_cast<std::uint32_t>(n);
+        }
+        else if(f_ == format::zlib)
+        {
+            check_ = zlib::detail::adler32(check_, p, n);
+        }
+    }
+
+    /*  Parse trailer octets, returning the number consumed.
+
+        Sets `done` when the trailer is complete and matches
+        the decompressed data.
+    */
+    std::size_t
+    trailer(
+        unsigned char const* p, std::size_t n,
+        bool& done, error_code& ec)
+    {
+        std::size_t const size =
+            f_ == format::gzip ? 8 :
+            f_ == format::zlib ? 4 : 0;
+        std::size_t used = 0;
+        while(n_ < size && used < n)
+            buf_[n_++] = p[used++];
+        ec = {};
+        done = n_ == size;
+        if(! done)
+            return used;
+        if(f_ == format::gzip)
+        {
+            if( get_le32(buf_) != check_ ||
+                get_le32(buf_ + 4) != size_)
+                ec = zlib::error::invalid_checksum;
+        }
+        else if(f_ == format::zlib)
+        {
+            if(get_be32(buf_) != check_)
+                ec = zlib::error::invalid_checksum;
+        }
+        return used;
+    }
+};
+
+/*  Return the format for a Content-Encoding field value.
+
+    A missing value means a raw deflate stream. Sets `ec`
+    to error::bad_value for an unsupported content coding.
+*/
+inline
+inflate_framing::format
+inflate_format(string_view coding, error_code& ec)
+{
+    ec = {};
+    if(coding.empty())
+        return inflate_framing::format::raw;
+    if( beast::iequals(coding, "gzip") ||
+        beast::iequals(coding, "x-gzip"))
+        return inflate_framing::format::gzip;
+    if(beast::iequals(coding, "deflate"))
+        return inflate_framing::format::zlib;
+    ec = error::bad_value;
+    return inflate_framing::format::raw;
+}
+
+} // detail
+} // http
+} // beast
+} // boost
+
+#endif
@@ -310,6 +310,77 @@ async_read_some(
         std::forward<ReadHandler>(handler));
 }
 
+template<
+    class SyncReadStream,
+    class DynamicBuffer,
+    bool isRequest, class Derived>
+std::size_t
+read_some(
+    SyncReadStream& stream,
+    DynamicBuffer& buffer,
+    basic_parser<isRequest, Derived>& parser,
+    read_size_advisor& advisor)
+{
+    static_assert(
+        is_sync_read_stream<SyncReadStream>::value,
+        "SyncReadStream type requirements not met");
+    static_assert(
+        net::is_dynamic_buffer<DynamicBuffer>::value,
+        "DynamicBuffer type requirements not met");
+    error_code ec;
+    auto const bytes_transferred =
+        read_some(stream, buffer, parser, advisor, ec);
+    if(ec)
+        BOOST_THROW_EXCEPTION(system_error{ec});
+    return bytes_transferred;
+}
+
+template<
+    class SyncReadStream,
+    class DynamicBuffer,
+    bool isRequest, class Derived>
+std::size_t
+read_some(
+    SyncReadStream& stream,
+    DynamicBuffer& buffer,
+    basic_parser<isRequest, Derived>& parser,
+    read_size_advisor& advisor,
+    error_code& ec)
+{
+    static_assert(
+        is_sync_read_stream<SyncReadStream>::value,
+        "SyncReadStream type requirements not met");
+    static_assert(
+        net::is_dynamic_buffer<DynamicBuffer>::value,
+        "DynamicBuffer type requirements not met");
+    return beast::detail::read(stream, buffer,
+        detail::read_some_condition<
+            isRequest, Derived>{parser}, advisor, ec);
+}
+
+template<
+    class AsyncReadStream,
+    class DynamicBuffer,
+    bool isRequest, class Derived,
+    class ReadHandler>
+BOOST_ASIO_INITFN_RESULT_TYPE(
+    ReadHandler, void(error_code, std::size_t))
+async_read_some(
+    AsyncReadStream& stream,
+    DynamicBuffer& buffer,
+    basic_parser<isRequest, Derived>& parser,
+    read_size_advisor& advisor,
+    ReadHandler&& handler)
+{
+    return beast::detail::async_read(
+        stream,
+        buffer,
+        detail::read_some_condition<
+            isRequest, Derived>{parser},
+        advisor,
+        std::forward<ReadHandler>(handler));
+}
+
 //------------------------------------------------------------------------------
 
 template<
@@ -0,0 +1,178 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_HTTP_IMPL_SMALL_STRING_BODY_HPP
+#define BOOST_BEAST_HTTP_IMPL_SMALL_STRING_BODY_HPP
+
+#include <boost/throw_exception.hpp>
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+
+namespace boost {
+namespace beast {
+namespace http {
+
+template<std::size_t N, class Allocator>
+void
+small_string_body<N, Allocator>::
+value_type::
+take(value_type& other) noexcept
+{
+    if(other.is_local())
+    {
+        std::memcpy(buf_, other.buf_, other.size_);
+        p_ = buf_;
+        capacity_ = N;
+    }
+    else
+    {
+        p_ = other.p_;
+        capacity_ = other.capacity_;
+        other.p_ = other.buf_;
+        other.capacity_ = N;
+    }
+    size_ = other.size_;
+    other.size_ = 0;
+}
+
+template<std::size_t N, class Allocator>
+void
+small_string_body<N, Allocator>::
+value_type::
+release() noexcept
+{
+    if(! is_local())
+    {
+        alloc_traits::deallocate(this->get(), p_, capacity_);
+        p_ = buf_;
+        capacity_ = N;
+    }
+}
+
+template<std::size_t N, class Allocator>
+void
+small_string_body<N, Allocator>::
+value_type::
+grow(std::size_t n)
+{
+    if(n > alloc_traits::max_size(this->get()))
+        BOOST_THROW_EXCEPTION(std::length_error{
+            "small_string_body too long"});
+    // grow geometrically to keep appends amortized constant
+    auto const capacity = (std::max)(n,
+        capacity_ > alloc_traits::max_size(this->get()) / 2 ?
+            n : 2 * capacity_);
+    auto const p = alloc_traits::allocate(this->get(), capacity);
+    std::memcpy(p, p_, size_);
+    release();
+    p_ = p;
+    capacity_ = capacity;
+}
+
+template<std::size_t N, class Allocator>
+auto
+small_string_body<N, Allocator>::
+value_type::
+operator=(value_type&& other) noexcept(
+    alloc_traits::propagate_on_container_move_assignment::value) ->
+    value_type&
+{
+    if(this == &other)
+        return *this;
+    if( alloc_traits::propagate_on_container_move_assignment::value ||
+        this->get() == other.get())
+    {
+        release();
+        if(alloc_traits::propagate_on_container_move_assignment::value)
+            this->get() = std::move(other.get());
+        take(other);
+        return *this;
+    }
+    // the storage cannot be transferred, copy the characters
+    assign(other);
+    other.clear();
+    return *this;
+}
+
+template<std::size_t N, class Allocator>
+auto
+small_string_body<N, Allocator>::
+value_type::
+operator=(value_type const& other) ->
+    value_type&
+{
+    if(this == &other)
+        return *this;
+    if( alloc_traits::propagate_on_container_copy_assignment::value &&
+        this->get() != other.get())
+    {
+        release();
+        size_ = 0;
+        this->get() = other.get();
+    }
+    return assign(other);
+}
+
+template<std::size_t N, class Allocator>
+void
+small_string_body<N, Allocator>::
+value_type::
+shrink_to_fit() noexcept
+{
+    if(is_local() || size_ > N)
+        return;
+    auto const p = p_;
+    auto const capacity = capacity_;
+    std::memcpy(buf_, p, size_);
+    p_ = buf_;
+    capacity_ = N;
+    alloc_traits::deallocate(this->get(), p, capacity);
+}
+
+template<std::size_t N, class Allocator>
+auto
+small_string_body<N, Allocator>::
+value_type::
+append(string_view s) ->
+    value_type&
+{
+    if(s.size() > capacity_ - size_)
+    {
+        if(s.size() > alloc_traits::max_size(this->get()) - size_)
+            BOOST_THROW_EXCEPTION(std::length_error{
+                "small_string_body too long"});
+        // s may refer to our own characters. Pointers into
+        // unrelated objects may not be subtracted, so the
+        // offset is only computed once aliasing is known.
+        std::less<char const*> const lt{};
+        if( ! lt(s.data(), p_) &&
+            lt(s.data(), p_ + size_))
+        {
+            auto const off = s.data() - p_;
+            grow(size_ + s.size());
+            s = string_view(p_ + off, s.size());
+        }
+        else
+        {
+            grow(size_ + s.size());
+        }
+    }
+    if(! s.empty())
+        std::memcpy(p_ + size_, s.data(), s.size());
+    size_ += s.size();
+    return *this;
+}
+
+} // http
+} // beast
+} // boost
+
+#endif
@@ -13,6 +13,7 @@
 #include <boost/beast/http/type_traits.hpp>
 #include <boost/beast/core/async_op_base.hpp>
 #include <boost/beast/core/bind_handler.hpp>
+#include <boost/beast/core/buffers_array.hpp>
 #include <boost/beast/core/buffers_range.hpp>
 #include <boost/beast/core/ostream.hpp>
 #include <boost/beast/core/stream_traits.hpp>
@@ -62,7 +63,9 @@ class write_some_op
             invoked = true;
             ec = {};
             op_.s_.async_write_some(
-                buffers, std::move(op_));
+                beast::detail::buffers_array_for<
+                    net::const_buffer, ConstBufferSequence>(buffers),
+                std::move(op_));
         }
     };
 
@@ -412,8 +415,9 @@ public:
         ConstBufferSequence const& buffers)
     {
         invoked = true;
-        bytes_transferred =
-            stream_.write_some(buffers, ec);
+        bytes_transferred = stream_.write_some(
+            beast::detail::buffers_array_for<
+                net::const_buffer, ConstBufferSequence>(buffers), ec);
     }
 };
 
@@ -0,0 +1,428 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_HTTP_INFLATE_BODY_HPP
+#define BOOST_BEAST_HTTP_INFLATE_BODY_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/buffer_size.hpp>
+#include <boost/beast/core/buffers_range.hpp>
+#include <boost/beast/http/error.hpp>
+#include <boost/beast/http/field.hpp>
+#include <boost/beast/http/message.hpp>
+#include <boost/beast/http/detail/basic_parser.hpp>
+#include <boost/beast/http/detail/inflate_body.hpp>
+#include <boost/beast/http/type_traits.hpp>
+#include <boost/beast/zlib/error.hpp>
+#include <boost/beast/zlib/inflate_stream.hpp>
+#include <boost/asio/buffer.hpp>
+#include <boost/assert.hpp>
+#include <boost/optional.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+
+namespace boost {
+namespace beast {
+namespace http {
+
+/** A @b Body adaptor which decompresses the payload while parsing.
+
+    This body wraps another body type. When a message using this
+    body is parsed, each piece of the payload delivered by the
+    parser is passed through a decompressor (see
+    @ref zlib::inflate_stream) and the decompressed octets are
+    handed to the reader of the inner body as they are produced.
+    The compressed payload is never buffered in its entirety.
+
+    The format of the payload is chosen by the Content-Encoding
+    field of the message:
+
+    @li `gzip` or `x-gzip`: the gzip format (RFC 1952). The CRC-32
+    and the size in the trailer are checked.
+
+    @li `deflate`: the zlib format (RFC 1950). The Adler-32 checksum
+    in the trailer is checked. A raw deflate stream without the
+    zlib header, which some servers send, is also accepted.
+
+    @li No Content-Encoding: a raw deflate stream (RFC 1951).
+
+    Any other content coding fails with @ref error::bad_value.
+    A checksum which does not match fails with
+    @ref zlib::error::invalid_checksum, and octets following the end
+    of the compressed stream fail with @ref zlib::error::trailing_data.
+
+    To guard against decompression bombs, the number of octets
+    produced by the decompressor is limited. The limit has the
+    same meaning and the same defaults as
+    @ref basic_parser::body_limit, except that it applies to the
+    payload after the content coding has been removed. When the
+    limit is exceeded, the parse fails with @ref error::body_limit.
+
+    The inner body's reader may take only part of the octets
+    presented to it, for example a @ref buffer_body reader which
+    returns @ref error::need_buffer. The remaining output is kept
+    and delivered first on the next call.
+
+    This body type may only be used for parsing.
+
+    @par Example
+    @code
+    request_parser<inflate_body<string_body>> p;
+    p.get().body().body_limit(64 * 1024 * 1024);
+    read(stream, buffer, p);
+    std::string const& s = p.get().body().body();
+    @endcode
+
+    @tparam InnerBody The body type which receives the
+    decompressed payload. This type must meet the
+    requirements of @b Body and have a @b BodyReader.
+*/
+template<class InnerBody>
+struct inflate_body
+{
+    static_assert(is_body_reader<InnerBody>::value,
+        "BodyReader type requirements not met");
+
+    /// The type of the inner body
+    using body_type = InnerBody;
+
+    /** The type of the @ref message::body member.
+
+        This holds the container of the inner body along
+        with the limit on the size of the decompressed payload.
+    */
+    class value_type
+    {
+        friend struct inflate_body;
+
+        typename InnerBody::value_type body_;
+        boost::optional<std::uint64_t> limit_;
+
+    public:
+        /// Constructor
+        value_type() = default;
+
+        /// Constructor
+        value_type(value_type&&) = default;
+
+        /// Assignment
+        value_type& operator=(value_type&&) = default;
+
+        /// Returns the container of the inner body
+        typename InnerBody::value_type&
+        body() noexcept
+        {
+            return body_;
+        }
+
+        /// Returns the container of the inner body
+        typename InnerBody::value_type const&
+        body() const noexcept
+        {
+            return body_;
+        }
+
+        /** Set the limit on the decompressed payload.
+
+            The default limit is 1MB for requests and 8MB
+            for responses.
+
+            Setting the limit after the header has been
+            parsed has no effect.
+
+            @param v The decompressed payload limit to set
+        */
+        void
+        body_limit(std::uint64_t v) noexcept
+        {
+            limit_ = v;
+        }
+    };
+
+    /** The algorithm for parsing the body
+
+        Meets the requirements of @b BodyReader.
+    */
+#if BOOST_BEAST_DOXYGEN
+    using reader = __implementation_defined__;
+#else
+    class reader
+    {
+        enum class state
+        {
+            header,
+            body,
+            trailer,
+            done
+        };
+
+        // size of the output area for each call to inflate
+        static std::size_t constexpr chunk_size = 4096;
+
+        value_type& body_;
+        typename InnerBody::reader rd_;
+        zlib::inflate_stream zi_;
+        void const* h_;
+        string_view(*coding_)(void const*);
+        detail::inflate_framing fr_;
+        std::uint64_t limit_;
+        state state_ = state::header;
+        std::size_t held_ = 0;      // consumed but not reported
+        std::size_t out_pos_ = 0;   // output not yet delivered
+        std::size_t out_end_ = 0;
+        char buf_[chunk_size];
+
+    public:
+        template<bool isRequest, class Fields>
+        explicit
+        reader(header<isRequest, Fields>& h, value_type& b)
+            : body_(b)
+            , rd_(h, b.body_)
+            , h_(&h)
+            , coding_(
+                [](void const* h)
+                {
+                    return (*static_cast<header<
+                        isRequest, Fields> const*>(h))[
+                            field::content_encoding];
+                })
+            , fr_(detail::inflate_framing::format::raw)
+            , limit_(detail::basic_parser_base::default_body_limit(
+                std::integral_constant<bool, isRequest>{}))
+        {
+        }
+
+        void
+        init(boost::optional<
+            std::uint64_t> const&, error_code& ec)
+        {
+            // The fields are not known when the reader is constructed
+            fr_ = detail::inflate_framing(
+                detail::inflate_format(coding_(h_), ec));
+            if(ec)
+                return;
+            if(body_.limit_)
+                limit_ = *body_.limit_;
+            // The Content-Length describes the compressed
+            // payload, it says nothing about the inner body.
+            rd_.init(boost::none, ec);
+        }
+
+        template<class ConstBufferSequence>
+        std::size_t
+        put(ConstBufferSequence const& buffers,
+            error_code& ec)
+        {
+            if(! resume(ec))
+                return 0;
+            std::size_t used = 0;
+            for(auto b : beast::buffers_range_ref(buffers))
+            {
+                auto p = static_cast<
+                    unsigned char const*>(b.data());
+                auto n = b.size();
+
+                // These were already decompressed
+                auto const k = (std::min)(held_, n);
+                held_ -= k;
+                p += k;
+                n -= k;
+                used += k;
+
+                while(n > 0)
+                {
+                    auto const k = decode(p, n, ec);
+                    p += k;
+                    n -= k;
+                    used += k;
+                    if(ec || out_pos_ < out_end_)
+                        return hold(used, buffer_size(buffers));
+                }
+            }
+            ec = {};
+            return used;
+        }
+
+        void
+        finish(error_code& ec)
+        {
+            if(! resume(ec))
+            {
+                if(! ec)
+                    ec = error::need_buffer;
+                return;
+            }
+            if(state_ != state::done)
+            {
+                ec = error::partial_message;
+                return;
+            }
+            rd_.finish(ec);
+        }
+
+    private:
+        // Deliver the output left over from the previous
+        // call, and any output still held by the inflater.
+        bool
+        resume(error_code& ec)
+        {
+            if(! flush(ec))
+                return false;
+            if(state_ == state::body)
+            {
+                zlib::z_params zs;
+                zs.next_in = nullptr;
+                zs.avail_in = 0;
+                inflate(zs, ec);
+                if(ec || out_pos_ < out_end_)
+                    return false;
+            }
+            return true;
+        }
+
+        // When output is left over, the last octet of the input
+        // is reported as unused, so the parser calls again even if
+        // no more input arrives. That octet is skipped next time.
+        std::size_t
+        hold(std::size_t used, std::size_t size)
+        {
+            if(used == size && used > 0 && out_pos_ < out_end_)
+            {
+                --used;
+                ++held_;
+            }
+            return used;
+        }
+
+        // Give the pending output to the inner reader, returns
+        // `false` if it did not take all of it.
+        bool
+        flush(error_code& ec)
+        {
+            ec = {};
+            while(out_pos_ < out_end_)
+            {
+                auto const n = rd_.put(net::const_buffer(
+                    buf_ + out_pos_, out_end_ - out_pos_), ec);
+                out_pos_ += n;
+                if(ec || n == 0)
+                    return false;
+            }
+            return true;
+        }
+
+        // Process input, returning the number of octets consumed
+        std::size_t
+        decode(
+            unsigned char const* p,
+            std::size_t n, error_code& ec)
+        {
+            switch(state_)
+            {
+            case state::header:
+            {
+                net::const_buffer replay;
+                auto const used = fr_.header(p, n, replay, ec);
+                if(ec || ! fr_.is_header_done())
+                    return used;
+                state_ = state::body;
+                if(replay.size() > 0)
+                {
+                    zlib::z_params zs;
+                    zs.next_in = replay.data();
+                    zs.avail_in = replay.size();
+                    inflate(zs, ec);
+                    // The inflater needs more than two octets
+                    // before it can end or stall.
+                    BOOST_ASSERT(ec || zs.avail_in == 0);
+                }
+                return used;
+            }
+
+            case state::body:
+            {
+                zlib::z_params zs;
+                zs.next_in = p;
+                zs.avail_in = n;
+                inflate(zs, ec);
+                return n - zs.avail_in;
+            }
+
+            case state::trailer:
+            {
+                bool done;
+                auto const used = fr_.trailer(p, n, done, ec);
+                if(! ec && done)
+                    state_ = state::done;
+                return used;
+            }
+
+            case state::done:
+            default:
+                break;
+            }
+            ec = zlib::error::trailing_data;
+            return 0;
+        }
+
+        // Decompress the input in `zs`, handing the output to
+        // the inner reader. Stops early if the inner reader does
+        // not take all of the output.
+        void
+        inflate(zlib::z_params& zs, error_code& ec)
+        {
+            for(;;)
+            {
+                auto const avail_in = zs.avail_in;
+                zs.next_out = buf_;
+                zs.avail_out = sizeof(buf_);
+                zi_.write(zs, zlib::Flush::sync, ec);
+                bool const end = ec == zlib::error::end_of_stream;
+                if(ec && ! end && ec != zlib::error::need_buffers)
+                    return;
+                ec = {};
+                auto const n = sizeof(buf_) - zs.avail_out;
+                if(n > limit_)
+                {
+                    ec = error::body_limit;
+                    return;
+                }
+                limit_ -= n;
+                fr_.update(buf_, n);
+                out_pos_ = 0;
+                out_end_ = n;
+                if(end)
+                    state_ = fr_.get_format() ==
+                        detail::inflate_framing::format::raw ?
+                            state::done : state::trailer;
+                if(! flush(ec) || end)
+                    return;
+                if(zs.avail_out > 0)
+                {
+                    if(zs.avail_in == 0)
+                        return;
+                    if(n == 0 && zs.avail_in == avail_in)
+                    {
+                        // no forward progress is possible
+                        ec = zlib::error::general;
+                        return;
+                    }
+                }
+            }
+        }
+    };
+#endif
+};
+
+} // http
+} // beast
+} // boost
+
+#endif
@@ -12,6 +12,7 @@
 
 #include <boost/beast/core/detail/config.hpp>
 #include <boost/beast/core/error.hpp>
+#include <boost/beast/core/read_size.hpp>
 #include <boost/beast/http/basic_parser.hpp>
 #include <boost/beast/http/message.hpp>
 #include <boost/asio/async_result.hpp>
@@ -214,6 +215,140 @@ async_read_some(
     basic_parser<isRequest, Derived>& parser,
     ReadHandler&& handler);
 
+/** Read part of a message from a stream using a parser and an advisor.
+
+    This function behaves as the overload without an advisor, except
+    that the number of bytes prepared in the dynamic buffer for each
+    read is chosen by the caller's @ref read_size_advisor, which is
+    updated with the outcome of the read. Using one advisor for all
+    the reads on a connection lets its history of the connection
+    persist from one message to the next.
+
+    @param stream The stream from which the data is to be read. The type must
+    support the <em>SyncReadStream</em> requirements.
+
+    @param buffer Storage for additional bytes read by the implementation from
+    the stream. The type must meet the <em>DynamicBuffer</em> requirements.
+
+    @param parser The parser to use.
+
+    @param advisor The advisor to use.
+
+    @return The number of bytes transferred from the stream.
+
+    @throws system_error Thrown on failure.
+
+    @par Example
+    @code
+    read_size_advisor advisor;
+    for(;;)
+    {
+        request_parser<string_body> p;
+        while(! p.is_done())
+            read_some(sock, buffer, p, advisor);
+        ...
+    }
+    @endcode
+*/
+template<
+    class SyncReadStream,
+    class DynamicBuffer,
+    bool isRequest, class Derived>
+std::size_t
+read_some(
+    SyncReadStream& stream,
+    DynamicBuffer& buffer,
+    basic_parser<isRequest, Derived>& parser,
+    read_size_advisor& advisor);
+
+/** Read part of a message from a stream using a parser and an advisor.
+
+    This function behaves as the overload without an advisor, except
+    that the number of bytes prepared in the dynamic buffer for each
+    read is chosen by the caller's @ref read_size_advisor, which is
+    updated with the outcome of the read. Using one advisor for all
+    the reads on a connection lets its history of the connection
+    persist from one message to the next.
+
+    @param stream The stream from which the data is to be read. The type must
+    support the <em>SyncReadStream</em> requirements.
+
+    @param buffer Storage for additional bytes read by the implementation from
+    the stream. The type must meet the <em>DynamicBuffer</em> requirements.
+
+    @param parser The parser to use.
+
+    @param advisor The advisor to use.
+
+    @param ec Set to the error, if any occurred.
+
+    @return The number of bytes transferred from the stream.
+*/
+template<
+    class SyncReadStream,
+    class DynamicBuffer,
+    bool isRequest, class Derived>
+std::size_t
+read_some(
+    SyncReadStream& stream,
+    DynamicBuffer& buffer,
+    basic_parser<isRequest, Derived>& parser,
+    read_size_advisor& advisor,
+    error_code& ec);
+
+/** Read part of a message asynchronously from a stream using a parser and an advisor.
+
+    This function behaves as the overload without an advisor, except
+    that the number of bytes prepared in the dynamic buffer for each
+    read is chosen by the caller's @ref read_size_advisor, which is
+    updated with the outcome of the read. Using one advisor for all
+    the reads on a connection lets its history of the connection
+    persist from one message to the next.
+
+    @param stream The stream from which the data is to be read. The type
+    must meet the <em>AsyncReadStream</em> requirements.
+
+    @param buffer Storage for additional bytes read by the implementation from
+    the stream. The type must meet the <em>DynamicBuffer</em> requirements.
+    The object must remain valid at least until the handler is called;
+    ownership is not transferred.
+
+    @param parser The parser to use. The object must remain valid at least until
+    the handler is called; ownership is not transferred.
+
+    @param advisor The advisor to use. The object must remain valid at least
+    until the handler is called; ownership is not transferred.
+
+    @param handler The completion handler to invoke when the operation
+    completes. The implementation takes ownership of the handler by
+    performing a decay-copy. The equivalent function signature of
+    the handler must be:
+
+    @code
+    void handler(
+        error_code const& error,        // result of operation
+        std::size_t bytes_transferred   // the total number of bytes transferred from the stream
+    );
+    @endcode
+    Regardless of whether the asynchronous operation completes
+    immediately or not, the handler will not be invoked from within
+    this function. Invocation of the handler will be performed in a
+    manner equivalent to using `net::post`.
+*/
+template<
+    class AsyncReadStream,
+    class DynamicBuffer,
+    bool isRequest, class Derived,
+    class ReadHandler>
+BOOST_ASIO_INITFN_RESULT_TYPE(
+    ReadHandler, void(error_code, std::size_t))
+async_read_some(
+    AsyncReadStream& stream,
+    DynamicBuffer& buffer,
+    basic_parser<isRequest, Derived>& parser,
+    read_size_advisor& advisor,
+    ReadHandler&& handler);
+
 //------------------------------------------------------------------------------
 
 /** Read a complete message header from a stream using a parser.
@@ -0,0 +1,461 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_HTTP_SMALL_STRING_BODY_HPP
+#define BOOST_BEAST_HTTP_SMALL_STRING_BODY_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/core/buffer_size.hpp>
+#include <boost/beast/core/buffers_range.hpp>
+#include <boost/beast/core/string.hpp>
+#include <boost/beast/core/detail/allocator.hpp>
+#include <boost/beast/http/error.hpp>
+#include <boost/beast/http/message.hpp>
+#include <boost/asio/buffer.hpp>
+#include <boost/core/empty_value.hpp>
+#include <boost/optional.hpp>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace boost {
+namespace beast {
+namespace http {
+
+/** A @b Body using a string with inline storage
+
+    This body holds the payload in a string which stores up to
+    `N` characters inside the body object itself, and only allocates
+    memory from the heap when the payload grows larger. Messages
+    with small payloads, such as `OK` or `{}`, are then parsed and
+    serialized without any memory allocation for the body.
+
+    Messages using this body type may be serialized and parsed.
+
+    @par Example
+    @code
+    response<small_string_body<256>> res{status::ok, 11};
+    res.body() = "{}";
+    res.prepare_payload();
+    @endcode
+
+    @tparam N The number of characters stored inline.
+
+    @tparam Allocator The allocator used when the payload
+    does not fit in the inline storage.
+*/
+template<
+    std::size_t N,
+    class Allocator = std::allocator<char>>
+struct small_string_body
+{
+private:
+    static_assert(N > 0,
+        "N must be positive");
+
+public:
+    /** The type of container used for the body
+
+        This determines the type of @ref message::body
+        when this body type is used with a message container.
+    */
+    class value_type;
+
+    /** Returns the payload size of the body
+
+        When this body is used with @ref message::prepare_payload,
+        the Content-Length will be set to the payload size, and
+        any chunked Transfer-Encoding will be removed.
+    */
+    static
+    std::uint64_t
+    size(value_type const& body)
+    {
+        return body.size();
+    }
+
+    /** The algorithm for parsing the body
+
+        Meets the requirements of @b BodyReader.
+    */
+#if BOOST_BEAST_DOXYGEN
+    using reader = __implementation_defined__;
+#else
+    class reader;
+#endif
+
+    /** The algorithm for serializing the body
+
+        Meets the requirements of @b BodyWriter.
+    */
+#if BOOST_BEAST_DOXYGEN
+    using writer = __implementation_defined__;
+#else
+    class writer;
+#endif
+};
+
+/** The type of the @ref message::body member.
+
+    Messages declared using `small_string_body` will have this type
+    for the body member. This is a contiguous string of characters
+    which is stored in the object itself while its size is at most
+    `N`, and on the heap otherwise. It is not null-terminated.
+*/
+template<std::size_t N, class Allocator>
+class small_string_body<N, Allocator>::value_type
+#if ! BOOST_BEAST_DOXYGEN
+    : private boost::empty_value<Allocator>
+#endif
+{
+    using alloc_traits =
+        beast::detail::allocator_traits<Allocator>;
+
+    char* p_;
+    std::size_t size_ = 0;
+    std::size_t capacity_ = N;
+    char buf_[N];
+
+    bool
+    is_local() const noexcept
+    {
+        return p_ == buf_;
+    }
+
+    void
+    take(value_type& other) noexcept;
+
+    void
+    release() noexcept;
+
+    void
+    grow(std::size_t n);
+
+public:
+    /// The type of allocator used for heap storage
+    using allocator_type = Allocator;
+
+    /// Destructor
+    ~value_type()
+    {
+        release();
+    }
+
+    /** Constructor
+
+        The string is empty and uses the inline storage.
+    */
+    value_type() noexcept(
+        std::is_nothrow_default_constructible<Allocator>::value)
+        : boost::empty_value<Allocator>(boost::empty_init_t{})
+        , p_(buf_)
+    {
+    }
+
+    /** Constructor
+
+        The string is empty and uses the inline storage.
+
+        @param alloc The allocator to use for heap storage.
+    */
+    explicit
+    value_type(Allocator const& alloc) noexcept
+        : boost::empty_value<Allocator>(
+            boost::empty_init_t{}, alloc)
+        , p_(buf_)
+    {
+    }
+
+    /** Constructor
+
+        @param s The characters to copy.
+    */
+    value_type(string_view s)
+        : value_type()
+    {
+        append(s);
+    }
+
+    /** Move Constructor
+
+        Heap storage is transferred to the new object, inline
+        contents are copied. After the move, `other` is empty.
+    */
+    value_type(value_type&& other) noexcept
+        : boost::empty_value<Allocator>(boost::empty_init_t{},
+            std::move(other.get()))
+        , p_(buf_)
+    {
+        take(other);
+    }
+
+    /// Copy Constructor
+    value_type(value_type const& other)
+        : boost::empty_value<Allocator>(boost::empty_init_t{},
+            alloc_traits::select_on_container_copy_construction(
+                other.get()))
+        , p_(buf_)
+    {
+        append(other);
+    }
+
+    /** Move Assignment
+
+        After the move, `other` is empty.
+    */
+    value_type&
+    operator=(value_type&& other) noexcept(
+        alloc_traits::propagate_on_container_move_assignment::value);
+
+    /// Copy Assignment
+    value_type&
+    operator=(value_type const& other);
+
+    /// Replace the contents with a copy of a string
+    value_type&
+    operator=(string_view s)
+    {
+        assign(s);
+        return *this;
+    }
+
+    /// Returns the allocator used for heap storage
+    allocator_type
+    get_allocator() const noexcept
+    {
+        return this->get();
+    }
+
+    /// Returns a pointer to the characters
+    char*
+    data() noexcept
+    {
+        return p_;
+    }
+
+    /// Returns a pointer to the characters
+    char const*
+    data() const noexcept
+    {
+        return p_;
+    }
+
+    /// Returns the number of characters
+    std::size_t
+    size() const noexcept
+    {
+        return size_;
+    }
+
+    /// Returns `true` if the string is empty
+    bool
+    empty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+    /// Returns the number of characters which fit without reallocating
+    std::size_t
+    capacity() const noexcept
+    {
+        return capacity_;
+    }
+
+    /// Returns the number of characters stored inline
+    static
+    constexpr
+    std::size_t
+    inline_capacity() noexcept
+    {
+        return N;
+    }
+
+    /// Returns `true` if the characters are stored on the heap
+    bool
+    is_heap() const noexcept
+    {
+        return ! is_local();
+    }
+
+    /// Returns a view of the characters
+    operator string_view() const noexcept
+    {
+        return {p_, size_};
+    }
+
+    /** Guarantee a minimum capacity
+
+        @throws std::length_error if `n` exceeds the maximum
+        size supported by the allocator.
+    */
+    void
+    reserve(std::size_t n)
+    {
+        if(n > capacity_)
+            grow(n);
+    }
+
+    /** Change the number of characters
+
+        New characters are left uninitialized.
+    */
+    void
+    resize(std::size_t n)
+    {
+        reserve(n);
+        size_ = n;
+    }
+
+    /** Remove all characters
+
+        The capacity is not changed.
+    */
+    void
+    clear() noexcept
+    {
+        size_ = 0;
+    }
+
+    /** Release heap storage which is not needed
+
+        If the characters fit in the inline storage, they are moved
+        there and the heap storage is deallocated.
+    */
+    void
+    shrink_to_fit() noexcept;
+
+    /// Append characters to the end
+    value_type&
+    append(string_view s);
+
+    /// Replace the contents with a copy of a string
+    value_type&
+    assign(string_view s)
+    {
+        clear();
+        return append(s);
+    }
+};
+
+#if ! BOOST_BEAST_DOXYGEN
+
+template<std::size_t N, class Allocator>
+class small_string_body<N, Allocator>::reader
+{
+    value_type& body_;
+
+public:
+    template<bool isRequest, class Fields>
+    explicit
+    reader(header<isRequest, Fields>&, value_type& b)
+        : body_(b)
+    {
+    }
+
+    void
+    init(boost::optional<
+        std::uint64_t> const& length, error_code& ec)
+    {
+        if(length)
+        {
+            if(static_cast<std::size_t>(*length) != *length)
+            {
+                ec = error::buffer_overflow;
+                return;
+            }
+            try
+            {
+                body_.reserve(
+                    static_cast<std::size_t>(*length));
+            }
+            catch(std::exception const&)
+            {
+                ec = error::buffer_overflow;
+                return;
+            }
+        }
+        ec = {};
+    }
+
+    template<class ConstBufferSequence>
+    std::size_t
+    put(ConstBufferSequence const& buffers,
+        error_code& ec)
+    {
+        auto const extra = buffer_size(buffers);
+        auto const size = body_.size();
+        try
+        {
+            body_.resize(size + extra);
+        }
+        catch(std::exception const&)
+        {
+            ec = error::buffer_overflow;
+            return 0;
+        }
+        ec = {};
+        char* dest = body_.data() + size;
+        for(auto b : beast::buffers_range_ref(buffers))
+        {
+            std::memcpy(dest, b.data(), b.size());
+            dest += b.size();
+        }
+        return extra;
+    }
+
+    void
+    finish(error_code& ec)
+    {
+        ec = {};
+    }
+};
+
+template<std::size_t N, class Allocator>
+class small_string_body<N, Allocator>::writer
+{
+    value_type const& body_;
+
+public:
+    using const_buffers_type =
+        net::const_buffer;
+
+    template<bool isRequest, class Fields>
+    explicit
+    writer(header<isRequest, Fields> const&, value_type const& b)
+        : body_(b)
+    {
+    }
+
+    void
+    init(error_code& ec)
+    {
+        ec = {};
+    }
+
+    boost::optional<std::pair<const_buffers_type, bool>>
+    get(error_code& ec)
+    {
+        ec = {};
+        return {{const_buffers_type{
+            body_.data(), body_.size()}, false}};
+    }
+};
+
+#endif
+
+} // http
+} // beast
+} // boost
+
+#include <boost/beast/http/impl/small_string_body.hpp>
+
+#endif
@@ -25,15 +25,22 @@ the program, with the macro BOOST_BEAST_SPLIT_COMPILATION defined.
 # error Do not compile Beast library source with BOOST_BEAST_HEADER_ONLY defined
 #endif
 
+#include <boost/beast/_experimental/core/impl/proxy_protocol_error.ipp>
 #include <boost/beast/_experimental/test/impl/error.ipp>
 #include <boost/beast/_experimental/test/impl/stream.ipp>
 
 #include <boost/beast/core/detail/base64.ipp>
 #include <boost/beast/core/detail/sha1.ipp>
+#include <boost/beast/core/detail/slab.ipp>
+#include <boost/beast/core/detail/timeout_wheel.ipp>
+#include <boost/beast/core/detail/token_bucket.ipp>
 #include <boost/beast/core/impl/error.ipp>
 #include <boost/beast/core/impl/file_posix.ipp>
 #include <boost/beast/core/impl/file_stdio.ipp>
 #include <boost/beast/core/impl/file_win32.ipp>
+#include <boost/beast/core/impl/metrics_policy.ipp>
+#include <boost/beast/core/impl/mirrored_ring_buffer.ipp>
+#include <boost/beast/core/impl/spsc_buffer.ipp>
 #include <boost/beast/core/impl/static_buffer.ipp>
 
 #include <boost/beast/http/impl/error.ipp>
@@ -47,5 +54,6 @@ the program, with the macro BOOST_BEAST_SPLIT_COMPILATION defined.
 #include <boost/beast/zlib/detail/deflate_stream.ipp>
 #include <boost/beast/zlib/detail/inflate_stream.ipp>
 #include <boost/beast/zlib/impl/error.ipp>
+#include <boost/beast/zlib/impl/window_pool.ipp>
 
 #endif
@@ -89,36 +89,23 @@ struct impl_base<true>
     {
         BOOST_ASSERT(out.size() >= 6);
         auto& zo = this->pmd_->zo;
+        std::size_t total_out;
+        zo.write(cb, out, total_in, total_out,
+            zlib::Flush::none, ec);
+        if(ec)
+        {
+            // no input, or the output is full
+            if(ec != zlib::error::need_buffers)
+                return false;
+            ec = {};
+        }
+        cb.consume(total_in);
         zlib::z_params zs;
         zs.avail_in = 0;
         zs.next_in = nullptr;
-        zs.avail_out = out.size();
-        zs.next_out = out.data();
-        for(auto in : beast::buffers_range_ref(cb))
-        {
-            zs.avail_in = in.size();
-            if(zs.avail_in == 0)
-                continue;
-            zs.next_in = in.data();
-            zo.write(zs, zlib::Flush::none, ec);
-            if(ec)
-            {
-                if(ec != zlib::error::need_buffers)
-                    return false;
-                BOOST_ASSERT(zs.avail_out == 0);
-                BOOST_ASSERT(zs.total_out == out.size());
-                ec = {};
-                break;
-            }
-            if(zs.avail_out == 0)
-            {
-                BOOST_ASSERT(zs.total_out == out.size());
-                break;
-            }
-            BOOST_ASSERT(zs.avail_in == 0);
-        }
-        total_in = zs.total_in;
-        cb.consume(zs.total_in);
+        zs.avail_out = out.size() - total_out;
+        zs.next_out = static_cast<char*>(out.data()) + total_out;
+        zs.total_out = total_out;
         if(zs.avail_out > 0 && fin)
         {
             auto const remain = buffer_size(cb);
@@ -137,7 +124,9 @@ struct impl_base<true>
                     return false;
                 if(zs.avail_out >= 6)
                 {
-                    zo.write(zs, zlib::Flush::full, ec);
+                    // A sync flush keeps the history, which is
+                    // only discarded when context takeover is off.
+                    zo.write(zs, zlib::Flush::sync, ec);
                     BOOST_ASSERT(! ec);
                     // remove flush marker
                     zs.total_out -= 4;
@@ -172,6 +161,23 @@ struct impl_base<true>
         pmd_->zi.write(zs, flush, ec);
     }
 
+    // Decompress a buffer sequence, filling as many
+    // of the output buffers as possible in one call.
+    template<
+        class ConstBufferSequence,
+        class MutableBufferSequence>
+    void
+    inflate(
+        ConstBufferSequence const& in,
+        MutableBufferSequence const& out,
+        std::size_t& total_in,
+        std::size_t& total_out,
+        error_code& ec)
+    {
+        pmd_->zi.write(in, out, total_in, total_out,
+            zlib::Flush::sync, ec);
+    }
+
     void
     do_context_takeover_read(role_type role)
     {
@@ -289,6 +295,8 @@ struct impl_base<true>
                     pmd_opts_.memLevel,
                     zlib::Strategy::normal);
             }
+            pmd_->zo.fixed_threshold(
+                pmd_opts_.fixed_threshold);
         }
     }
 
@@ -383,6 +391,21 @@ struct impl_base<false>
     {
     }
 
+    template<
+        class ConstBufferSequence,
+        class MutableBufferSequence>
+    void
+    inflate(
+        ConstBufferSequence const&,
+        MutableBufferSequence const&,
+        std::size_t& total_in,
+        std::size_t& total_out,
+        error_code&)
+    {
+        total_in = 0;
+        total_out = 0;
+    }
+
     void
     do_context_takeover_read(role_type)
     {
@@ -458,34 +458,21 @@ public:
                                     impl.rd_buf.data()), impl.rd_key);
                         did_read_ = true;
                     }
-                    zlib::z_params zs;
-                    {
-                        auto const out = buffers_front(cb_);
-                        zs.next_out = out.data();
-                        zs.avail_out = out.size();
-                        BOOST_ASSERT(zs.avail_out > 0);
-                    }
                     if(impl.rd_remain > 0)
                     {
-                        if(impl.rd_buf.size() > 0)
-                        {
-                            // use what's there
-                            auto const in = buffers_prefix(
-                                clamp(impl.rd_remain), buffers_front(
-                                    impl.rd_buf.data()));
-                            zs.avail_in = in.size();
-                            zs.next_in = in.data();
-                        }
-                        else
-                        {
+                        if(impl.rd_buf.size() == 0)
                             break;
-                        }
                     }
                     else if(impl.rd_fh.fin)
                     {
                         // append the empty block codes
                         std::uint8_t constexpr
                             empty_block[4] = { 0x00, 0x00, 0xff, 0xff };
+                        zlib::z_params zs;
+                        auto const out = buffers_front(cb_);
+                        zs.next_out = out.data();
+                        zs.avail_out = out.size();
+                        BOOST_ASSERT(zs.avail_out > 0);
                         zs.next_in = empty_block;
                         zs.avail_in = sizeof(empty_block);
                         impl.inflate(zs, zlib::Flush::sync, ec);
@@ -505,22 +492,30 @@ public:
                     {
                         break;
                     }
-                    impl.inflate(zs, zlib::Flush::sync, ec);
-                    if(impl.check_stop_now(ec))
-                        goto upcall;
-                    if(impl.rd_msg_max && beast::detail::sum_exceeds(
-                        impl.rd_size, zs.total_out, impl.rd_msg_max))
                     {
-                        // _Fail the WebSocket Connection_
-                        code_ = close_code::too_big;
-                        result_ = error::message_too_big;
-                        goto close;
+                        // use what's there, filling as many
+                        // of the caller's buffers as possible
+                        std::size_t total_in;
+                        std::size_t total_out;
+                        impl.inflate(buffers_prefix(
+                            clamp(impl.rd_remain), impl.rd_buf.data()),
+                                cb_, total_in, total_out, ec);
+                        if(impl.check_stop_now(ec))
+                            goto upcall;
+                        if(impl.rd_msg_max && beast::detail::sum_exceeds(
+                            impl.rd_size, total_out, impl.rd_msg_max))
+                        {
+                            // _Fail the WebSocket Connection_
+                            code_ = close_code::too_big;
+                            result_ = error::message_too_big;
+                            goto close;
+                        }
+                        cb_.consume(total_out);
+                        impl.rd_size += total_out;
+                        impl.rd_remain -= total_in;
+                        impl.rd_buf.consume(total_in);
+                        bytes_written_ += total_out;
                     }
-                    cb_.consume(zs.total_out);
-                    impl.rd_size += zs.total_out;
-                    impl.rd_remain -= zs.total_in;
-                    impl.rd_buf.consume(zs.total_in);
-                    bytes_written_ += zs.total_out;
                 }
                 if(impl.rd_op == detail::opcode::text)
                 {
@@ -620,6 +615,7 @@ class stream<NextLayer, deflateSupported>::read_op
     boost::weak_ptr<impl_type> wp_;
     DynamicBuffer& b_;
     std::size_t limit_;
+    std::size_t prepared_ = 0;
     std::size_t bytes_written_ = 0;
     bool some_;
 
@@ -662,9 +658,9 @@ public:
         {
             do
             {
+                prepared_ = clamp(impl.read_size_hint_db(b_), limit_);
                 mb = beast::detail::dynamic_buffer_prepare(b_,
-                    clamp(impl.read_size_hint_db(b_), limit_),
-                        ec, error::buffer_overflow);
+                    prepared_, ec, error::buffer_overflow);
                 if(impl.check_stop_now(ec))
                     goto upcall;
 
@@ -673,6 +669,7 @@ public:
                 read_some_op<read_op, mutable_buffers_type>(
                     std::move(*this), sp, *mb);
                 b_.commit(bytes_transferred);
+                impl.rd_adv.feedback(prepared_, bytes_transferred);
                 bytes_written_ += bytes_transferred;
                 if(ec)
                     goto upcall;
@@ -865,6 +862,7 @@ read_some(
         return 0;
     auto const bytes_written = read_some(*mb, ec);
     buffer.commit(bytes_written);
+    impl_->rd_adv.feedback(size, bytes_written);
     return bytes_written;
 }
 
@@ -1148,26 +1146,12 @@ loop:
         buffers_suffix<MutableBufferSequence> cb(buffers);
         while(buffer_size(cb) > 0)
         {
-            zlib::z_params zs;
-            {
-                auto const out = beast::buffers_front(cb);
-                zs.next_out = out.data();
-                zs.avail_out = out.size();
-                BOOST_ASSERT(zs.avail_out > 0);
-            }
             if(impl.rd_remain > 0)
             {
-                if(impl.rd_buf.size() > 0)
-                {
-                    // use what's there
-                    auto const in = buffers_prefix(
-                        clamp(impl.rd_remain), beast::buffers_front(
-                            impl.rd_buf.data()));
-                    zs.avail_in = in.size();
-                    zs.next_in = in.data();
-                }
-                else if(! did_read)
+                if(impl.rd_buf.size() == 0)
                 {
+                    if(did_read)
+                        break;
                     // read new
                     auto const bytes_transferred =
                         impl.stream.read_some(
@@ -1182,17 +1166,8 @@ loop:
                         detail::mask_inplace(
                             buffers_prefix(clamp(impl.rd_remain),
                                 impl.rd_buf.data()), impl.rd_key);
-                    auto const in = buffers_prefix(
-                        clamp(impl.rd_remain), buffers_front(
-                            impl.rd_buf.data()));
-                    zs.avail_in = in.size();
-                    zs.next_in = in.data();
                     did_read = true;
                 }
-                else
-                {
-                    break;
-                }
             }
             else if(impl.rd_fh.fin)
             {
@@ -1200,6 +1175,11 @@ loop:
                 static std::uint8_t constexpr
                     empty_block[4] = {
                         0x00, 0x00, 0xff, 0xff };
+                zlib::z_params zs;
+                auto const out = beast::buffers_front(cb);
+                zs.next_out = out.data();
+                zs.avail_out = out.size();
+                BOOST_ASSERT(zs.avail_out > 0);
                 zs.next_in = empty_block;
                 zs.avail_in = sizeof(empty_block);
                 impl.inflate(zs, zlib::Flush::sync, ec);
@@ -1219,21 +1199,26 @@ loop:
             {
                 break;
             }
-            impl.inflate(zs, zlib::Flush::sync, ec);
+            // fill as many of the caller's buffers as possible
+            std::size_t total_in;
+            std::size_t total_out;
+            impl.inflate(buffers_prefix(
+                clamp(impl.rd_remain), impl.rd_buf.data()),
+                    cb, total_in, total_out, ec);
             if(impl.check_stop_now(ec))
                 return bytes_written;
             if(impl.rd_msg_max && beast::detail::sum_exceeds(
-                impl.rd_size, zs.total_out, impl.rd_msg_max))
+                impl.rd_size, total_out, impl.rd_msg_max))
             {
                 do_fail(close_code::too_big,
                     error::message_too_big, ec);
                 return bytes_written;
             }
-            cb.consume(zs.total_out);
-            impl.rd_size += zs.total_out;
-            impl.rd_remain -= zs.total_in;
-            impl.rd_buf.consume(zs.total_in);
-            bytes_written += zs.total_out;
+            cb.consume(total_out);
+            impl.rd_size += total_out;
+            impl.rd_remain -= total_in;
+            impl.rd_buf.consume(total_in);
+            bytes_written += total_out;
         }
         if(impl.rd_op == detail::opcode::text)
         {
@@ -25,6 +25,7 @@
 #include <boost/beast/core/buffers_prefix.hpp>
 #include <boost/beast/core/buffers_suffix.hpp>
 #include <boost/beast/core/flat_static_buffer.hpp>
+#include <boost/beast/core/read_size.hpp>
 #include <boost/beast/core/saved_handler.hpp>
 #include <boost/beast/core/static_buffer.hpp>
 #include <boost/beast/core/stream_traits.hpp>
@@ -61,6 +62,8 @@ struct stream<NextLayer, deflateSupported>::impl_type
     detail::utf8_checker    rd_utf8;        // to validate utf8
     static_buffer<
         +tcp_frame_size>    rd_buf;         // buffer for reads
+    read_size_advisor       rd_adv{         // sizes reads into caller buffers
+                                +tcp_frame_size};
     detail::opcode          rd_op           /* current message binary or text */ = detail::opcode::text;
     bool                    rd_cont         /* `true` if the next frame is a continuation */ = false;
     bool                    rd_done         /* set when a message is done */ = true;
@@ -123,6 +126,7 @@ struct stream<NextLayer, deflateSupported>::impl_type
         rd_remain = 0;
         rd_cont = false;
         rd_done = true;
+        rd_adv.reset();
         // Can't clear this because accept uses it
         //rd_buf.reset();
         rd_fh.fin = false;
@@ -248,7 +252,7 @@ struct stream<NextLayer, deflateSupported>::impl_type
     read_size_hint_db(DynamicBuffer& buffer) const
     {
         auto const initial_size = (std::min)(
-            +tcp_frame_size,
+            rd_adv.size(),
             buffer.max_size() - buffer.size());
         if(initial_size == 0)
             return 1; // buffer is full
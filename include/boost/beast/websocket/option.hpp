@@ -64,6 +64,18 @@ struct permessage_deflate
 
     /// Deflate memory level, 1..9
     int memLevel = 4;
+
+    /** Size below which compressed blocks use fixed codes
+
+        Messages, or the parts of a message sent in a single
+        write, which are smaller than this many bytes are
+        compressed without building dynamic Huffman codes.
+        This reduces the cost of compressing short messages.
+        Zero disables this behavior.
+
+        @see zlib::deflate_stream::fixed_threshold
+    */
+    std::size_t fixed_threshold = 0;
 };
 
 } // websocket
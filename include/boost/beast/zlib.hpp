@@ -15,6 +15,7 @@
 #include <boost/beast/zlib/deflate_stream.hpp>
 #include <boost/beast/zlib/error.hpp>
 #include <boost/beast/zlib/inflate_stream.hpp>
+#include <boost/beast/zlib/window_pool.hpp>
 #include <boost/beast/zlib/zlib.hpp>
 
 #endif
@@ -13,7 +13,10 @@
 #include <boost/beast/core/detail/config.hpp>
 #include <boost/beast/zlib/error.hpp>
 #include <boost/beast/zlib/zlib.hpp>
+#include <boost/beast/zlib/window_pool.hpp>
 #include <boost/beast/zlib/detail/deflate_stream.hpp>
+#include <boost/beast/zlib/detail/write_buffers.hpp>
+#include <boost/asio/buffer.hpp>
 #include <algorithm>
 #include <cstdlib>
 #include <cstdint>
@@ -82,6 +85,23 @@ public:
         reset(6, 15, DEF_MEM_LEVEL, Strategy::normal);
     }
 
+    /** Construct a default deflate stream using a pool.
+
+        The stream settings are the same as those of a default
+        constructed stream. The internal buffers are obtained
+        from, and returned to, the specified pool instead of
+        the pool of the calling thread.
+
+        @param pool The pool to use. Ownership is not
+        transferred; the pool must outlive the stream.
+    */
+    explicit
+    deflate_stream(window_pool& pool)
+        : detail::deflate_stream(pool)
+    {
+        reset(6, 15, DEF_MEM_LEVEL, Strategy::normal);
+    }
+
     /** Reset the stream and compression settings.
 
         This function initializes the stream to the specified
@@ -121,9 +141,9 @@ public:
 
     /** Clear the stream.
 
-        This function resets the stream and frees all dynamically
-        allocated internal buffers. The compression settings are
-        left unchanged.
+        This function resets the stream and returns all dynamically
+        allocated internal buffers to the pool. The compression
+        settings are left unchanged.
 
         @note Any unprocessed input or pending output from
         previous calls are discarded.
@@ -170,6 +190,28 @@ public:
         doTune(good_length, max_lazy, nice_length, max_chain);
     }
 
+    /** Set the size below which blocks are sent with fixed codes.
+
+        Normally the compressor builds a set of dynamic Huffman
+        codes for every block and sends their description along
+        with the block. For the short blocks produced when small
+        messages are flushed individually, building and sending
+        those codes often costs more than it saves. Blocks holding
+        fewer than `n` bytes of input are instead sent using the
+        fixed codes defined by the deflate format, or stored if
+        that is smaller.
+
+        A value around 1024 works well for short interactive
+        messages. The default of zero disables this behavior.
+
+        @param n The block size in bytes, in uncompressed input.
+    */
+    void
+    fixed_threshold(std::size_t n)
+    {
+        doFixedThreshold(n);
+    }
+
     /** Compress input and write output.
 
         This function compresses as much data as possible, and stops when
@@ -289,6 +331,62 @@ public:
         doWrite(zs, flush, ec);
     }
 
+    /** Compress a buffer sequence into a buffer sequence.
+
+        This function behaves as if `write` were called repeatedly
+        with `zs` describing successive elements of the input and
+        output buffer sequences. Processing continues across element
+        boundaries without returning to the caller, so fragmented
+        buffers such as those of a `multi_buffer` need not be
+        flattened first.
+
+        Input is compressed with `Flush::none` until the last
+        input buffer is presented, after which `flush` is used.
+
+        @param in The buffers to compress. This object must meet
+        the requirements of <em>ConstBufferSequence</em>.
+
+        @param out The buffers receiving the output. This object
+        must meet the requirements of <em>MutableBufferSequence</em>.
+
+        @param total_in Set to the number of bytes consumed from `in`.
+
+        @param total_out Set to the number of bytes written to `out`.
+
+        @param flush The flush parameter to apply once all of the
+        input has been presented.
+
+        @param ec Set to the error, if any occurred. The meaning is
+        the same as for the other overload of `write`. If the output
+        sequence is filled, no error is indicated; call this function
+        again with more output space to continue.
+    */
+    template<
+        class ConstBufferSequence,
+        class MutableBufferSequence>
+    void
+    write(
+        ConstBufferSequence const& in,
+        MutableBufferSequence const& out,
+        std::size_t& total_in,
+        std::size_t& total_out,
+        Flush flush,
+        error_code& ec)
+    {
+        static_assert(net::is_const_buffer_sequence<
+            ConstBufferSequence>::value,
+                "ConstBufferSequence type requirements not met");
+        static_assert(net::is_mutable_buffer_sequence<
+            MutableBufferSequence>::value,
+                "MutableBufferSequence type requirements not met");
+        detail::write_buffers(
+            [this](z_params& zs, Flush f, error_code& ev)
+            {
+                doWrite(zs, f, ev);
+            },
+            in, out, total_in, total_out, flush, ec);
+    }
+
     /** Update the compression level and strategy.
 
         This function dynamically updates the compression level and
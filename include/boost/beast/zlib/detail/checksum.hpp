@@ -0,0 +1,92 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_ZLIB_DETAIL_CHECKSUM_HPP
+#define BOOST_BEAST_ZLIB_DETAIL_CHECKSUM_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace boost {
+namespace beast {
+namespace zlib {
+namespace detail {
+
+// The checksums of the gzip (RFC 1952) and zlib (RFC 1950)
+// formats. Pass the previous value to continue a checksum,
+// starting with 0 for crc32 and 1 for adler32.
+
+inline
+std::uint32_t const*
+crc32_table() noexcept
+{
+    struct table
+    {
+        std::uint32_t v[256];
+
+        table() noexcept
+        {
+            for(std::uint32_t i = 0; i < 256; ++i)
+            {
+                auto c = i;
+                for(int k = 0; k < 8; ++k)
+                    c = (c & 1) ? 0xedb88320 ^ (c >> 1) : c >> 1;
+                v[i] = c;
+            }
+        }
+    };
+    static table const t;
+    return t.v;
+}
+
+inline
+std::uint32_t
+crc32(std::uint32_t crc,
+    void const* data, std::size_t size) noexcept
+{
+    auto const t = crc32_table();
+    auto p = static_cast<unsigned char const*>(data);
+    crc = ~crc;
+    while(size--)
+        crc = t[(crc ^ *p++) & 0xff] ^ (crc >> 8);
+    return ~crc;
+}
+
+inline
+std::uint32_t
+adler32(std::uint32_t adler,
+    void const* data, std::size_t size) noexcept
+{
+    // largest n such that 255n(n+1)/2 + (n+1)(BASE-1) fits 32 bits
+    std::size_t constexpr nmax = 5552;
+    std::uint32_t constexpr base = 65521;
+    auto p = static_cast<unsigned char const*>(data);
+    std::uint32_t a = adler & 0xffff;
+    std::uint32_t b = adler >> 16;
+    while(size > 0)
+    {
+        auto n = size < nmax ? size : nmax;
+        size -= n;
+        while(n--)
+        {
+            a += *p++;
+            b += a;
+        }
+        a %= base;
+        b %= base;
+    }
+    return (b << 16) | a;
+}
+
+} // detail
+} // zlib
+} // beast
+} // boost
+
+#endif
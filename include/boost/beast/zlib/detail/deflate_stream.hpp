@@ -39,6 +39,7 @@
 
 #include <boost/beast/zlib/error.hpp>
 #include <boost/beast/zlib/zlib.hpp>
+#include <boost/beast/zlib/detail/pooled_buffer.hpp>
 #include <boost/beast/zlib/detail/ranges.hpp>
 #include <boost/beast/core/detail/type_traits.hpp>
 #include <boost/assert.hpp>
@@ -252,8 +253,8 @@ protected:
     lut_type const& lut_;
 
     bool inited_ = false;
-    std::size_t buf_size_;
-    std::unique_ptr<std::uint8_t[]> buf_;
+    bool reused_ = false;           // window and hash survived a reset
+    pooled_buffer buf_;
 
     int status_;                    // as the name implies
     Byte* pending_buf_;             // output still pending
@@ -339,6 +340,9 @@ protected:
     int level_;                     // compression level (1..9)
     Strategy strategy_;             // favor or force Huffman coding
 
+    // Blocks smaller than this are sent with the fixed codes
+    std::uint32_t fixed_threshold_ = 0;
+
     // Use a faster search when the previous match is longer than this
     uInt good_match_;
 
@@ -430,6 +434,13 @@ protected:
     {
     }
 
+    explicit
+    deflate_stream(window_pool& pool)
+        : lut_(get_lut())
+        , buf_(&pool)
+    {
+    }
+
     /*  In order to simplify the code, particularly on 16 bit machines, match
         distances are limited to MAX_DIST instead of WSIZE.
     */
@@ -514,6 +525,25 @@ protected:
             (unsigned)(hash_size_-1)*sizeof(*head_));
     }
 
+    /*  Clear only the hash chain heads which could have been set
+        by strings starting in the first n bytes of the window.
+        This is cheaper than clear_hash() when little input was
+        processed since the hash table was last cleared.
+    */
+    void
+    clear_hash(uInt n)
+    {
+        if(n < minMatch)
+            return;
+        uInt h = window_[0];
+        update_hash(h, window_[1]);
+        for(uInt str = 0; str + (minMatch-1) < n; ++str)
+        {
+            update_hash(h, window_[str + (minMatch-1)]);
+            head_[h] = 0;
+        }
+    }
+
     /*  Compares two subtrees, using the tree depth as tie breaker
         when the subtrees have equal frequency. This minimizes the
         worst case length.
@@ -622,6 +652,7 @@ protected:
     BOOST_BEAST_DECL void doClear             ();
     BOOST_BEAST_DECL std::size_t doUpperBound (std::size_t sourceLen) const;
     BOOST_BEAST_DECL void doTune              (int good_length, int max_lazy, int nice_length, int max_chain);
+    BOOST_BEAST_DECL void doFixedThreshold    (std::size_t n);
     BOOST_BEAST_DECL void doParams            (z_params& zs, int level, Strategy strategy, error_code& ec);
     BOOST_BEAST_DECL void doWrite             (z_params& zs, boost::optional<Flush> flush, error_code& ec);
     BOOST_BEAST_DECL void doDictionary        (Byte const* dict, uInt dictLength, error_code& ec);
@@ -641,6 +672,7 @@ protected:
     BOOST_BEAST_DECL void send_all_trees      (int lcodes, int dcodes, int blcodes);
     BOOST_BEAST_DECL void compress_block      (ct_data const* ltree, ct_data const* dtree);
     BOOST_BEAST_DECL int  detect_data_type    ();
+    BOOST_BEAST_DECL std::uint32_t fixed_len  () const;
     BOOST_BEAST_DECL void bi_windup           ();
     BOOST_BEAST_DECL void bi_flush            ();
     BOOST_BEAST_DECL void copy_block          (char *buf, unsigned len, int header);
@@ -263,12 +263,17 @@ doReset(
     level_ = level;
     strategy_ = strategy;
     inited_ = false;
+    reused_ = false;
 }
 
 void
 deflate_stream::
 doReset()
 {
+    // The window and hash table of the previous
+    // stream are kept, see lm_init().
+    if(inited_)
+        reused_ = true;
     inited_ = false;
 }
 
@@ -277,6 +282,7 @@ deflate_stream::
 doClear()
 {
     inited_ = false;
+    reused_ = false;
     buf_.reset();
 }
 
@@ -317,6 +323,15 @@ doTune(
     max_chain_length_ = max_chain;
 }
 
+void
+deflate_stream::
+doFixedThreshold(std::size_t n)
+{
+    // No block is ever larger than 64K
+    fixed_threshold_ = static_cast<std::uint32_t>(
+        (std::min<std::size_t>)(n, 65536));
+}
+
 void
 deflate_stream::
 doParams(z_params& zs, int level, Strategy strategy, error_code& ec)
@@ -614,11 +629,10 @@ init()
     auto const noverlay = lit_bufsize_ * (sizeof(std::uint16_t)+2);
     auto const needed   = nwindow + nprev + nhead + noverlay;
 
-    if(! buf_ || buf_size_ != needed)
+    if(! buf_ || buf_.size() != needed)
     {
-        buf_ = boost::make_unique_noinit<
-            std::uint8_t[]>(needed);
-        buf_size_ = needed;
+        buf_.allocate(needed);
+        reused_ = false;
     }
 
     window_ = reinterpret_cast<Byte*>(buf_.get());
@@ -664,7 +678,15 @@ lm_init()
 {
     window_size_ = (std::uint32_t)2L*w_size_;
 
-    clear_hash();
+    /*  After a reset with unchanged parameters, only the chains
+        for the strings of the previous stream need to be cleared.
+        This makes resetting between short messages cheap.
+    */
+    if(reused_ && strstart_ + lookahead_ < hash_size_ / 8)
+        clear_hash(strstart_ + lookahead_);
+    else
+        clear_hash();
+    reused_ = false;
 
     /* Set the default configuration parameters:
      */
@@ -1244,6 +1266,33 @@ detect_data_type()
     return binary;
 }
 
+/*  Return the bit length of the current block when
+    compressed with the fixed codes.
+*/
+std::uint32_t
+deflate_stream::
+fixed_len() const
+{
+    std::uint32_t len = 0;
+    for(int n = 0; n < lCodes; n++)
+    {
+        std::uint32_t const f = dyn_ltree_[n].fc;
+        if(f == 0)
+            continue;
+        int xbits = 0;
+        if(n >= literals + 1)
+            xbits = lut_.extra_lbits[n - (literals + 1)];
+        len += f * (lut_.ltree[n].dl + xbits);
+    }
+    for(int n = 0; n < dCodes; n++)
+    {
+        std::uint32_t const f = dyn_dtree_[n].fc;
+        if(f != 0)
+            len += f * (lut_.dtree[n].dl + lut_.extra_dbits[n]);
+    }
+    return len;
+}
+
 /*  Flush the bit buffer and align the output on a byte boundary
 */
 void
@@ -1404,25 +1453,37 @@ tr_flush_block(
         if(zs.data_type == unknown)
             zs.data_type = detect_data_type();
 
-        // Construct the literal and distance trees
-        build_tree((tree_desc *)(&(l_desc_)));
+        if(stored_len < fixed_threshold_)
+        {
+            /* Small block: the dynamic trees would rarely pay for
+             * their own description, so skip building them and
+             * choose between the fixed codes and a stored block.
+             */
+            static_lenb = (fixed_len()+3+7)>>3;
+            opt_lenb = static_lenb;
+        }
+        else
+        {
+            // Construct the literal and distance trees
+            build_tree((tree_desc *)(&(l_desc_)));
 
-        build_tree((tree_desc *)(&(d_desc_)));
-        /* At this point, opt_len and static_len are the total bit lengths of
-         * the compressed block data, excluding the tree representations.
-         */
+            build_tree((tree_desc *)(&(d_desc_)));
+            /* At this point, opt_len and static_len are the total bit lengths of
+             * the compressed block data, excluding the tree representations.
+             */
 
-        /* Build the bit length tree for the above two trees, and get the index
-         * in bl_order of the last bit length code to send.
-         */
-        max_blindex = build_bl_tree();
+            /* Build the bit length tree for the above two trees, and get the index
+             * in bl_order of the last bit length code to send.
+             */
+            max_blindex = build_bl_tree();
 
-        /* Determine the best encoding. Compute the block lengths in bytes. */
-        opt_lenb = (opt_len_+3+7)>>3;
-        static_lenb = (static_len_+3+7)>>3;
+            /* Determine the best encoding. Compute the block lengths in bytes. */
+            opt_lenb = (opt_len_+3+7)>>3;
+            static_lenb = (static_len_+3+7)>>3;
 
-        if(static_lenb <= opt_lenb)
-            opt_lenb = static_lenb;
+            if(static_lenb <= opt_lenb)
+                opt_lenb = static_lenb;
+        }
     }
     else
     {
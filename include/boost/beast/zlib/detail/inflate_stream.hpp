@@ -65,6 +65,13 @@ protected:
         w_.reset(15);
     }
 
+    explicit
+    inflate_stream(window_pool& pool)
+        : w_(pool)
+    {
+        w_.reset(15);
+    }
+
     BOOST_BEAST_DECL
     void
     doClear();
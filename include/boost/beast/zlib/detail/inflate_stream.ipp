@@ -50,6 +50,8 @@ void
 inflate_stream::
 doClear()
 {
+    w_.clear();
+    doReset(w_.bits());
 }
 
 void
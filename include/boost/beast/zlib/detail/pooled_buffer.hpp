@@ -0,0 +1,135 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_ZLIB_DETAIL_POOLED_BUFFER_HPP
+#define BOOST_BEAST_ZLIB_DETAIL_POOLED_BUFFER_HPP
+
+#include <boost/beast/zlib/window_pool.hpp>
+#include <boost/core/exchange.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+namespace boost {
+namespace beast {
+namespace zlib {
+namespace detail {
+
+/*  An owning pointer to an uninitialized block of bytes
+    obtained from a window_pool.
+
+    When no pool is specified, the pool of the thread
+    performing the allocation or deallocation is used.
+*/
+class pooled_buffer
+{
+    window_pool* pool_ = nullptr;
+    std::uint8_t* p_ = nullptr;
+    std::size_t n_ = 0;
+
+    window_pool*
+    pool() const noexcept
+    {
+        if(pool_)
+            return pool_;
+        return window_pool::this_thread();
+    }
+
+public:
+    pooled_buffer() = default;
+
+    explicit
+    pooled_buffer(window_pool* pool) noexcept
+        : pool_(pool)
+    {
+    }
+
+    pooled_buffer(pooled_buffer&& other) noexcept
+        : pool_(other.pool_)
+        , p_(boost::exchange(other.p_, nullptr))
+        , n_(boost::exchange(other.n_, 0))
+    {
+    }
+
+    pooled_buffer&
+    operator=(pooled_buffer&& other) noexcept
+    {
+        if(this != &other)
+        {
+            reset();
+            pool_ = other.pool_;
+            p_ = boost::exchange(other.p_, nullptr);
+            n_ = boost::exchange(other.n_, 0);
+        }
+        return *this;
+    }
+
+    ~pooled_buffer()
+    {
+        reset();
+    }
+
+    explicit
+    operator bool() const noexcept
+    {
+        return p_ != nullptr;
+    }
+
+    std::uint8_t*
+    get() const noexcept
+    {
+        return p_;
+    }
+
+    std::uint8_t&
+    operator[](std::size_t i) const noexcept
+    {
+        return p_[i];
+    }
+
+    std::size_t
+    size() const noexcept
+    {
+        return n_;
+    }
+
+    // Replace the block with one of n bytes. The
+    // previous contents are not preserved.
+    void
+    allocate(std::size_t n)
+    {
+        reset();
+        auto const pool = this->pool();
+        p_ = static_cast<std::uint8_t*>(pool ?
+            pool->allocate(n) : ::operator new(n));
+        n_ = n;
+    }
+
+    void
+    reset() noexcept
+    {
+        if(! p_)
+            return;
+        auto const pool = this->pool();
+        if(pool)
+            pool->deallocate(p_, n_);
+        else
+            ::operator delete(p_);
+        p_ = nullptr;
+        n_ = 0;
+    }
+};
+
+} // detail
+} // zlib
+} // beast
+} // boost
+
+#endif
@@ -37,11 +37,10 @@
 #ifndef BOOST_BEAST_ZLIB_DETAIL_WINDOW_HPP
 #define BOOST_BEAST_ZLIB_DETAIL_WINDOW_HPP
 
+#include <boost/beast/zlib/detail/pooled_buffer.hpp>
 #include <boost/assert.hpp>
-#include <boost/make_unique.hpp>
 #include <cstdint>
 #include <cstring>
-#include <memory>
 
 namespace boost {
 namespace beast {
@@ -50,13 +49,21 @@ namespace detail {
 
 class window
 {
-    std::unique_ptr<std::uint8_t[]> p_;
+    pooled_buffer p_;
     std::uint16_t i_ = 0;
     std::uint16_t size_ = 0;
     std::uint16_t capacity_ = 0;
     std::uint8_t bits_ = 0;
 
 public:
+    window() = default;
+
+    explicit
+    window(window_pool& pool)
+        : p_(&pool)
+    {
+    }
+
     int
     bits() const
     {
@@ -88,6 +95,14 @@ public:
         size_ = 0;
     }
 
+    void
+    clear()
+    {
+        p_.reset();
+        i_ = 0;
+        size_ = 0;
+    }
+
     void
     read(std::uint8_t* out, std::size_t pos, std::size_t n)
     {
@@ -113,8 +128,7 @@ public:
     write(std::uint8_t const* in, std::size_t n)
     {
         if(! p_)
-            p_ = boost::make_unique<
-                std::uint8_t[]>(capacity_);
+            p_.allocate(capacity_);
         if(n >= capacity_)
         {
             i_ = 0;
@@ -0,0 +1,109 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_ZLIB_DETAIL_WRITE_BUFFERS_HPP
+#define BOOST_BEAST_ZLIB_DETAIL_WRITE_BUFFERS_HPP
+
+#include <boost/beast/core/error.hpp>
+#include <boost/beast/zlib/error.hpp>
+#include <boost/beast/zlib/zlib.hpp>
+#include <boost/asio/buffer.hpp>
+#include <cstddef>
+
+namespace boost {
+namespace beast {
+namespace zlib {
+namespace detail {
+
+/*  Run a codec over a sequence of input buffers and a sequence of
+    output buffers, moving to the next element of either sequence
+    as soon as the current one is used up. The flush parameter is
+    only applied once the last input buffer is presented; before
+    that, Flush::none is used so no block boundaries are forced at
+    element boundaries.
+*/
+template<
+    class Write,
+    class ConstBufferSequence,
+    class MutableBufferSequence>
+void
+write_buffers(
+    Write const& write,
+    ConstBufferSequence const& in,
+    MutableBufferSequence const& out,
+    std::size_t& total_in,
+    std::size_t& total_out,
+    Flush flush,
+    error_code& ec)
+{
+    auto in_it = net::buffer_sequence_begin(in);
+    auto const in_end = net::buffer_sequence_end(in);
+    auto out_it = net::buffer_sequence_begin(out);
+    auto const out_end = net::buffer_sequence_end(out);
+    z_params zs;
+    zs.next_in = nullptr;
+    zs.avail_in = 0;
+    zs.next_out = nullptr;
+    zs.avail_out = 0;
+    ec = {};
+    for(;;)
+    {
+        while(zs.avail_in == 0 && in_it != in_end)
+        {
+            net::const_buffer const b(*in_it++);
+            zs.next_in = b.data();
+            zs.avail_in = b.size();
+        }
+        while(zs.avail_out == 0 && out_it != out_end)
+        {
+            net::mutable_buffer const b(*out_it++);
+            zs.next_out = b.data();
+            zs.avail_out = b.size();
+        }
+        if(zs.avail_out == 0)
+        {
+            // the output sequence is full
+            if(zs.total_out == 0)
+                ec = error::need_buffers;
+            break;
+        }
+        auto const avail_in = zs.avail_in;
+        auto const avail_out = zs.avail_out;
+        write(zs, in_it == in_end ? flush : Flush::none, ec);
+        if(ec == error::need_buffers &&
+            zs.avail_in == 0 && in_it == in_end &&
+            (zs.total_in > 0 || zs.total_out > 0))
+        {
+            // all input was used before this call
+            ec = {};
+            break;
+        }
+        if(ec)
+            break;
+        if(zs.avail_in == 0 && in_it == in_end &&
+                zs.avail_out > 0)
+            break;
+        if( zs.avail_in == avail_in &&
+            zs.avail_out == avail_out)
+        {
+            // no forward progress is possible
+            ec = error::need_buffers;
+            break;
+        }
+    }
+    total_in = zs.total_in;
+    total_out = zs.total_out;
+}
+
+} // detail
+} // zlib
+} // beast
+} // boost
+
+#endif
@@ -122,6 +122,19 @@ enum class error
     /// Incomplete length set
     incomplete_length_set,
 
+    //
+    // Errors generated by the gzip and zlib formats
+    //
+
+    /// Invalid gzip or zlib header
+    invalid_header,
+
+    /// Checksum or length in the trailer does not match the data
+    invalid_checksum,
+
+    /// Data follows the end of the compressed stream
+    trailing_data,
+
 
 
     /// general error
@@ -77,6 +77,10 @@ public:
         case error::over_subscribed_length: return "over-subscribed length";
         case error::incomplete_length_set: return "incomplete length set";
 
+        case error::invalid_header: return "invalid gzip or zlib header";
+        case error::invalid_checksum: return "checksum mismatch";
+        case error::trailing_data: return "data after end of compressed stream";
+
         case error::general:
         default:
             return "beast.zlib error";
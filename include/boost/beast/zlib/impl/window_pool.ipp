@@ -0,0 +1,104 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_ZLIB_IMPL_WINDOW_POOL_IPP
+#define BOOST_BEAST_ZLIB_IMPL_WINDOW_POOL_IPP
+
+#include <boost/beast/zlib/window_pool.hpp>
+#include <boost/config.hpp>
+#include <new>
+
+namespace boost {
+namespace beast {
+namespace zlib {
+
+void
+window_pool::
+capacity(std::size_t n) noexcept
+{
+    capacity_ = n;
+    while(list_ && size_ > capacity_)
+    {
+        auto const b = list_;
+        list_ = b->next;
+        size_ -= b->size;
+        ::operator delete(b);
+    }
+}
+
+void*
+window_pool::
+allocate(std::size_t n)
+{
+    for(auto pb = &list_; *pb; pb = &(*pb)->next)
+    {
+        auto const b = *pb;
+        if(b->size == n)
+        {
+            *pb = b->next;
+            size_ -= n;
+            return b;
+        }
+    }
+    return ::operator new(n);
+}
+
+void
+window_pool::
+deallocate(void* p, std::size_t n) noexcept
+{
+    // The bookkeeping is stored in the block itself
+    if(n < sizeof(block) || n > capacity_ - size_)
+    {
+        ::operator delete(p);
+        return;
+    }
+    auto const b = ::new(p) block;
+    b->next = list_;
+    b->size = n;
+    list_ = b;
+    size_ += n;
+}
+
+window_pool*
+window_pool::
+this_thread() noexcept
+{
+#ifdef BOOST_NO_CXX11_THREAD_LOCAL
+    return nullptr;
+#else
+    // Streams may be destroyed after the pool of the
+    // thread, for example when they have static storage
+    // duration. The flag survives the pool.
+    thread_local bool destroyed = false;
+    struct pool : window_pool
+    {
+        // Caching is opt-in for the implicit pool
+        pool() noexcept
+            : window_pool(0)
+        {
+        }
+
+        ~pool()
+        {
+            destroyed = true;
+        }
+    };
+    thread_local pool tp;
+    if(destroyed)
+        return nullptr;
+    return &tp;
+#endif
+}
+
+} // zlib
+} // beast
+} // boost
+
+#endif
@@ -38,7 +38,10 @@
 #define BOOST_BEAST_ZLIB_INFLATE_STREAM_HPP
 
 #include <boost/beast/core/detail/config.hpp>
+#include <boost/beast/zlib/window_pool.hpp>
 #include <boost/beast/zlib/detail/inflate_stream.hpp>
+#include <boost/beast/zlib/detail/write_buffers.hpp>
+#include <boost/asio/buffer.hpp>
 
 namespace boost {
 namespace beast {
@@ -70,6 +73,21 @@ public:
     */
     inflate_stream() = default;
 
+    /** Construct a raw deflate decompression stream using a pool.
+
+        The window size is set to the default of 15 bits. The
+        window is obtained from, and returned to, the specified
+        pool instead of the pool of the calling thread.
+
+        @param pool The pool to use. Ownership is not
+        transferred; the pool must outlive the stream.
+    */
+    explicit
+    inflate_stream(window_pool& pool)
+        : detail::inflate_stream(pool)
+    {
+    }
+
     /** Reset the stream.
 
         This puts the stream in a newly constructed state with
@@ -96,7 +114,7 @@ public:
 
     /** Put the stream in a newly constructed state.
 
-        All dynamically allocated memory is de-allocated.
+        All dynamically allocated memory is returned to the pool.
     */
     void
     clear()
@@ -210,6 +228,62 @@ public:
     {
         doWrite(zs, flush, ec);
     }
+
+    /** Decompress a buffer sequence into a buffer sequence.
+
+        This function behaves as if `write` were called repeatedly
+        with `zs` describing successive elements of the input and
+        output buffer sequences. Processing continues across element
+        boundaries without returning to the caller, so fragmented
+        buffers such as those of a `multi_buffer` need not be
+        flattened first.
+
+        Input is decompressed with `Flush::none` until the last
+        input buffer is presented, after which `flush` is used.
+
+        @param in The buffers to decompress. This object must meet
+        the requirements of <em>ConstBufferSequence</em>.
+
+        @param out The buffers receiving the output. This object
+        must meet the requirements of <em>MutableBufferSequence</em>.
+
+        @param total_in Set to the number of bytes consumed from `in`.
+
+        @param total_out Set to the number of bytes written to `out`.
+
+        @param flush The flush parameter to apply once all of the
+        input has been presented.
+
+        @param ec Set to the error, if any occurred. The meaning is
+        the same as for the other overload of `write`. If the output
+        sequence is filled, no error is indicated; call this function
+        again with more output space to continue.
+    */
+    template<
+        class ConstBufferSequence,
+        class MutableBufferSequence>
+    void
+    write(
+        ConstBufferSequence const& in,
+        MutableBufferSequence const& out,
+        std::size_t& total_in,
+        std::size_t& total_out,
+        Flush flush,
+        error_code& ec)
+    {
+        static_assert(net::is_const_buffer_sequence<
+            ConstBufferSequence>::value,
+                "ConstBufferSequence type requirements not met");
+        static_assert(net::is_mutable_buffer_sequence<
+            MutableBufferSequence>::value,
+                "MutableBufferSequence type requirements not met");
+        detail::write_buffers(
+            [this](z_params& zs, Flush f, error_code& ev)
+            {
+                doWrite(zs, f, ev);
+            },
+            in, out, total_in, total_out, flush, ec);
+    }
 };
 
 } // zlib
@@ -0,0 +1,174 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#ifndef BOOST_BEAST_ZLIB_WINDOW_POOL_HPP
+#define BOOST_BEAST_ZLIB_WINDOW_POOL_HPP
+
+#include <boost/beast/core/detail/config.hpp>
+#include <cstddef>
+
+namespace boost {
+namespace beast {
+namespace zlib {
+
+/** A cache of memory blocks for the internal buffers of zlib streams.
+
+    Each @ref deflate_stream needs a single block of about 256KB
+    (with the default settings) for its window, hash chains and
+    pending output, and each @ref inflate_stream needs a block of
+    up to 32KB for its window. When streams are short lived, for
+    example one compressor per HTTP response, the cost of obtaining
+    these blocks from the global allocator can dominate.
+
+    A pool keeps blocks returned by destroyed or cleared streams
+    and hands them out again to streams which need a block of
+    exactly the same size. The total number of bytes held by the
+    pool is bounded by its capacity; blocks which do not fit are
+    freed immediately.
+
+    Unless a pool is passed upon construction, streams use the
+    pool belonging to the calling thread, see @ref this_thread.
+    Blocks are always taken from and returned to the pool of the
+    thread performing the operation, so streams may migrate
+    freely between threads. The pool of a thread starts with a
+    capacity of zero, so no blocks are cached until the
+    application opts in by raising it:
+
+    @code
+    zlib::window_pool::this_thread()->capacity(
+        zlib::window_pool::default_capacity);
+    @endcode
+
+    @par Thread Safety
+    @e Distinct @e objects: Safe.@n
+    @e Shared @e objects: Unsafe. A pool passed explicitly to a
+    stream must only be used from one thread at a time, for
+    example from the single thread running an `io_context`.
+*/
+class window_pool
+{
+    struct block
+    {
+        block* next;
+        std::size_t size;
+    };
+
+    block* list_ = nullptr;
+    std::size_t size_ = 0;
+    std::size_t capacity_;
+
+public:
+    /// The default capacity of a pool, in bytes
+    static std::size_t constexpr default_capacity = 1024 * 1024;
+
+    /** Constructor
+
+        @param capacity The largest number of bytes the pool
+        will hold on to.
+    */
+    explicit
+    window_pool(
+        std::size_t capacity = default_capacity) noexcept
+        : capacity_(capacity)
+    {
+    }
+
+    /// Destructor. All cached blocks are freed.
+    ~window_pool()
+    {
+        shrink();
+    }
+
+    window_pool(window_pool const&) = delete;
+    window_pool& operator=(window_pool const&) = delete;
+
+    /// Returns the number of bytes held by the pool
+    std::size_t
+    size() const noexcept
+    {
+        return size_;
+    }
+
+    /// Returns the largest number of bytes the pool will hold
+    std::size_t
+    capacity() const noexcept
+    {
+        return capacity_;
+    }
+
+    /** Set the largest number of bytes the pool will hold.
+
+        Cached blocks are freed until the size of the pool
+        does not exceed the new capacity.
+    */
+    BOOST_BEAST_DECL
+    void
+    capacity(std::size_t n) noexcept;
+
+    /// Free all cached blocks
+    void
+    shrink() noexcept
+    {
+        auto const n = capacity_;
+        capacity(0);
+        capacity_ = n;
+    }
+
+    /** Return a block of `n` bytes.
+
+        A cached block of exactly `n` bytes is returned if one is
+        available, otherwise a new block is obtained from
+        `operator new`.
+    */
+    BOOST_BEAST_DECL
+    void*
+    allocate(std::size_t n);
+
+    /** Give back a block obtained from @ref allocate.
+
+        The block is cached if it fits within the capacity of
+        the pool, otherwise it is freed.
+
+        @param p The block to give back. This may have been
+        obtained from any pool.
+
+        @param n The size of the block, which must be equal to
+        the value passed to @ref allocate.
+    */
+    BOOST_BEAST_DECL
+    void
+    deallocate(void* p, std::size_t n) noexcept;
+
+    /** Returns the pool of the calling thread.
+
+        The pool is created with a capacity of zero on first use,
+        which means that blocks are freed as soon as they are given
+        back, as if no pool were used. Call @ref capacity to enable
+        caching for the thread. The pool is destroyed along with
+        its cached blocks when the thread exits.
+
+        @return A pointer to the pool, or `nullptr` if the thread
+        is exiting or the platform does not support thread local
+        storage. In that case streams use `operator new` directly.
+    */
+    BOOST_BEAST_DECL
+    static
+    window_pool*
+    this_thread() noexcept;
+};
+
+} // zlib
+} // beast
+} // boost
+
+#ifdef BOOST_BEAST_HEADER_ONLY
+#include <boost/beast/zlib/impl/window_pool.ipp>
+#endif
+
+#endif
@@ -0,0 +1,202 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+// Test that header file is self-contained.
+#include <boost/beast/core/detail/token_bucket.hpp>
+
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace boost {
+namespace beast {
+namespace detail {
+
+class token_bucket_test : public beast::unit_test::suite
+{
+public:
+    using clock_type = std::chrono::steady_clock;
+    using ms = std::chrono::milliseconds;
+
+    static std::size_t constexpr all =
+        (std::numeric_limits<std::size_t>::max)();
+
+    template<class Bucket>
+    void
+    testBucket()
+    {
+        auto const t0 = clock_type::now();
+
+        // unlimited
+        {
+            Bucket b;
+            BEAST_EXPECT(b.available() == all);
+            b.take(1000);
+            b.refill(t0);
+            BEAST_EXPECT(b.available() == all);
+        }
+
+        // starts full, refills continuously
+        {
+            Bucket b;
+            b.limit(1000, 100, t0);
+            BEAST_EXPECT(b.rate() == 1000);
+            BEAST_EXPECT(b.burst() == 100);
+            BEAST_EXPECT(b.available() == 100);
+            b.take(100);
+            BEAST_EXPECT(b.available() == 0);
+            b.refill(t0 + ms(10));
+            BEAST_EXPECT(b.available() == 10);
+            b.refill(t0 + ms(15));
+            BEAST_EXPECT(b.available() == 15);
+            b.refill(t0 + ms(15));
+            BEAST_EXPECT(b.available() == 15);
+            b.take(5);
+            BEAST_EXPECT(b.available() == 10);
+        }
+
+        // capped at the burst, idle time is not banked
+        {
+            Bucket b;
+            b.limit(1000, 100, t0);
+            b.take(100);
+            b.refill(t0 + std::chrono::seconds(10));
+            BEAST_EXPECT(b.available() == 100);
+            b.take(100);
+            b.refill(t0 + std::chrono::seconds(10) + ms(20));
+            BEAST_EXPECT(b.available() == 20);
+        }
+
+        // fractions of a token are carried over
+        {
+            Bucket b;
+            b.limit(333, 1000, t0);
+            b.take(1000);
+            std::size_t total = 0;
+            for(int i = 1; i <= 100; ++i)
+            {
+                b.refill(t0 + ms(10 * i));
+                total += b.available();
+                b.take(b.available());
+            }
+            BEAST_EXPECT(total == 333);
+        }
+
+        // a zero burst holds one byte
+        {
+            Bucket b;
+            b.limit(1000, 0, t0);
+            BEAST_EXPECT(b.burst() == 1);
+            BEAST_EXPECT(b.available() == 1);
+        }
+
+        // a zero rate pauses
+        {
+            Bucket b;
+            b.limit(0, 100, t0);
+            BEAST_EXPECT(b.available() == 0);
+            b.refill(t0 + std::chrono::seconds(10));
+            BEAST_EXPECT(b.available() == 0);
+            b.limit(1000, 100, t0 + std::chrono::seconds(10));
+            BEAST_EXPECT(b.available() == 100);
+        }
+
+        // back to unlimited
+        {
+            Bucket b;
+            b.limit(1000, 100, t0);
+            b.take(100);
+            b.limit(all, 0, t0);
+            BEAST_EXPECT(b.available() == all);
+        }
+    }
+
+    void
+    testDebt()
+    {
+        auto const t0 = clock_type::now();
+
+        // overdrawing is repaid by later refills
+        shared_token_bucket b;
+        b.limit(1000, 100, t0);
+        b.take(150);
+        BEAST_EXPECT(b.available() == 0);
+        b.refill(t0 + ms(40));
+        BEAST_EXPECT(b.available() == 0);
+        b.refill(t0 + ms(60));
+        BEAST_EXPECT(b.available() == 10);
+    }
+
+    void
+    testConcurrent()
+    {
+        // Several threads drawing from one bucket
+        // stay close to the aggregate rate.
+        std::size_t constexpr rate = 4 * 1024 * 1024;
+        std::size_t constexpr burst = 64 * 1024;
+        std::size_t constexpr chunk = 4096;
+        shared_token_bucket b;
+        auto const t0 = clock_type::now();
+        b.limit(rate, burst, t0);
+        std::atomic<std::size_t> total{0};
+        auto const until = t0 + ms(200);
+        std::vector<std::thread> v;
+        for(int i = 0; i < 4; ++i)
+            v.emplace_back(
+                [&]
+                {
+                    while(clock_type::now() < until)
+                    {
+                        b.refill();
+                        auto const n = (std::min)(
+                            b.available(), chunk);
+                        if(n == 0)
+                        {
+                            std::this_thread::yield();
+                            continue;
+                        }
+                        b.take(n);
+                        total += n;
+                    }
+                });
+        for(auto& t : v)
+            t.join();
+        auto const elapsed = std::chrono::duration<double>(
+            clock_type::now() - t0).count();
+        auto const most = static_cast<double>(rate) * elapsed +
+            burst + 4 * chunk;
+        BEAST_EXPECT(static_cast<double>(total) <= most);
+        BEAST_EXPECT(total > burst);
+    }
+
+    void
+    testBurst()
+    {
+        BEAST_EXPECT(token_bucket_burst(1000, ms(10)) == 20);
+        BEAST_EXPECT(token_bucket_burst(1000, ms(0)) == 0);
+        BEAST_EXPECT(token_bucket_burst(all, ms(10)) == all);
+    }
+
+    void
+    run() override
+    {
+        testBucket<token_bucket>();
+        testBucket<shared_token_bucket>();
+        testDebt();
+        testConcurrent();
+        testBurst();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,core,token_bucket);
+
+} // detail
+} // beast
+} // boost
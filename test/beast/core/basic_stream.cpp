@@ -28,6 +28,8 @@
 #include <boost/asio/write.hpp>
 #include <boost/optional.hpp>
 #include <array>
+#include <functional>
+#include <string>
 #include <thread>
 
 namespace boost {
@@ -447,6 +449,22 @@ public:
                 unlimited_rate_policy> s(
                     unlimited_rate_policy{}, ioc);
         }
+
+        {
+            basic_stream<tcp,
+                net::io_context::executor_type,
+                token_bucket_rate_policy> s(ioc);
+        }
+
+        {
+            shared_token_bucket_rate_policy p;
+            basic_stream<tcp,
+                net::io_context::executor_type,
+                shared_token_bucket_rate_policy> s1(p, ioc);
+            basic_stream<tcp,
+                net::io_context::executor_type,
+                shared_token_bucket_rate_policy> s2(p, ioc);
+        }
     }
 
     class handler
@@ -530,6 +548,20 @@ public:
             ioc.restart();
         }
 
+        {
+            // success, buffer sequence
+            test_server srv("*", ep, log);
+            stream_type s(ioc);
+            s.socket().connect(srv.local_endpoint());
+            s.expires_never();
+            std::array<net::mutable_buffer, 2> v{{
+                net::mutable_buffer(buf, 1),
+                net::mutable_buffer(buf + 1, sizeof(buf) - 1)}};
+            s.async_read_some(v, handler({}, 1));
+            ioc.run();
+            ioc.restart();
+        }
+
         {
             // empty buffer
             test_server srv("*", ep, log);
@@ -1251,6 +1283,140 @@ public:
         http::async_write (stream, res, yield);
     }
 
+    // Write with async_write_some until `size` bytes are written,
+    // returning the largest amount written by one operation.
+    template<class Stream>
+    static
+    std::size_t
+    write_all(
+        net::io_context& ioc,
+        Stream& s,
+        std::size_t size)
+    {
+        std::string const data(size, '*');
+        std::size_t written = 0;
+        std::size_t most = 0;
+        std::function<void(error_code, std::size_t)> on_write =
+            [&](error_code ec, std::size_t n)
+            {
+                if(ec)
+                    return;
+                written += n;
+                most = (std::max)(most, n);
+                if(written < size)
+                    s.async_write_some(net::buffer(
+                        data.data() + written, size - written),
+                            on_write);
+            };
+        s.async_write_some(net::buffer(data), on_write);
+        ioc.restart();
+        ioc.run();
+        return most;
+    }
+
+    void
+    testTokenBucket()
+    {
+        using clock_type = std::chrono::steady_clock;
+        using ms = std::chrono::milliseconds;
+
+        net::io_context ioc;
+        tcp::acceptor a(ioc, tcp::endpoint(
+            net::ip::make_address("127.0.0.1"), 0));
+
+        // bytes per interval, capped at the burst
+        {
+            token_bucket_rate_policy p(ms(10));
+            p.write_limit(100000, 1000);
+            basic_stream<tcp,
+                net::io_context::executor_type,
+                token_bucket_rate_policy> s(p, ioc);
+            tcp::socket server(ioc);
+            s.socket().connect(a.local_endpoint());
+            a.accept(server);
+            auto const t0 = clock_type::now();
+            BEAST_EXPECT(write_all(ioc, s, 20000) == 1000);
+            // all but the first burst is earned at the rate
+            BEAST_EXPECT(clock_type::now() - t0 >= ms(190));
+        }
+
+        // a zero rate pauses
+        {
+            token_bucket_rate_policy p(ms(10));
+            p.write_limit(0);
+            basic_stream<tcp,
+                net::io_context::executor_type,
+                token_bucket_rate_policy> s(p, ioc);
+            tcp::socket server(ioc);
+            s.socket().connect(a.local_endpoint());
+            a.accept(server);
+            bool invoked = false;
+            s.async_write_some(net::buffer("*", 1),
+                [&](error_code, std::size_t)
+                {
+                    invoked = true;
+                });
+            ioc.restart();
+            ioc.run_for(ms(50));
+            BEAST_EXPECT(! invoked);
+            s.close();
+            ioc.run();
+            BEAST_EXPECT(invoked);
+        }
+
+        // streams sharing a bucket repay the debt
+        // of bytes transferred concurrently
+        {
+            using stream_type = basic_stream<tcp,
+                net::io_context::executor_type,
+                shared_token_bucket_rate_policy>;
+            shared_token_bucket_rate_policy p(ms(10));
+            auto const t0 = clock_type::now();
+            p.write_limit(10000, 1000);
+            stream_type s1(p, ioc);
+            stream_type s2(p, ioc);
+            tcp::socket server1(ioc);
+            tcp::socket server2(ioc);
+            s1.socket().connect(a.local_endpoint());
+            a.accept(server1);
+            s2.socket().connect(a.local_endpoint());
+            a.accept(server2);
+
+            // both see the full bucket
+            std::string const data(5000, '*');
+            std::size_t n1 = 0;
+            std::size_t n2 = 0;
+            s1.async_write_some(net::buffer(data),
+                [&](error_code ec, std::size_t n)
+                {
+                    BEAST_EXPECTS(! ec, ec.message());
+                    n1 = n;
+                });
+            s2.async_write_some(net::buffer(data),
+                [&](error_code ec, std::size_t n)
+                {
+                    BEAST_EXPECTS(! ec, ec.message());
+                    n2 = n;
+                });
+            ioc.restart();
+            ioc.run();
+            BEAST_EXPECT(n1 == 1000);
+            BEAST_EXPECT(n2 == 1000);
+
+            // the 1000 bytes overdrawn take 100ms to repay
+            s1.async_write_some(net::buffer(data),
+                [&](error_code ec, std::size_t n)
+                {
+                    BEAST_EXPECTS(! ec, ec.message());
+                    n1 = n;
+                });
+            ioc.restart();
+            ioc.run();
+            BEAST_EXPECT(n1 > 0);
+            BEAST_EXPECT(clock_type::now() - t0 >= ms(100));
+        }
+    }
+
     void
     testJavadocs()
     {
@@ -1268,6 +1434,7 @@ public:
         testWrite();
         testConnect();
         testMembers();
+        testTokenBucket();
         testJavadocs();
     }
 };
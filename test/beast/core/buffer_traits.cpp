@@ -12,6 +12,8 @@
 
 #include <boost/beast/_experimental/unit_test/suite.hpp>
 #include <array>
+#include <limits>
+#include <vector>
 
 namespace boost {
 namespace beast {
@@ -139,6 +141,24 @@ public:
             net::mutable_buffer
         >>::value);
 
+    // buffer_sequence_max_length
+
+    BOOST_STATIC_ASSERT(buffer_sequence_max_length<
+        net::const_buffer>::value == 1);
+
+    BOOST_STATIC_ASSERT(buffer_sequence_max_length<
+        net::mutable_buffer const&>::value == 1);
+
+    BOOST_STATIC_ASSERT(buffer_sequence_max_length<
+        std::array<net::const_buffer, 3>>::value == 3);
+
+    BOOST_STATIC_ASSERT(buffer_sequence_max_length<
+        std::array<net::mutable_buffer, 5> const>::value == 5);
+
+    BOOST_STATIC_ASSERT(buffer_sequence_max_length<
+        std::vector<net::const_buffer>>::value ==
+            (std::numeric_limits<std::size_t>::max)());
+
     // javadoc: buffers_type
     template <class BufferSequence>
     buffers_type <BufferSequence>
@@ -10,10 +10,13 @@
 // Test that header file is self-contained.
 #include <boost/beast/core/buffered_read_stream.hpp>
 
+#include <boost/beast/core/flat_buffer.hpp>
 #include <boost/beast/core/multi_buffer.hpp>
 #include <boost/beast/_experimental/test/stream.hpp>
 #include <boost/beast/_experimental/unit_test/suite.hpp>
 #include <boost/beast/core/bind_handler.hpp>
+#include <boost/beast/http/read.hpp>
+#include <boost/beast/http/string_body.hpp>
 #include <boost/beast/test/yield_to.hpp>
 #include <boost/asio/buffer.hpp>
 #include <boost/asio/io_context.hpp>
@@ -202,6 +205,73 @@ public:
         BEAST_EXPECT(n < limit);
     }
 
+    void
+    testReadAhead()
+    {
+        net::io_context ioc;
+
+        // small reads are served from one read ahead
+        {
+            test::stream ts(ioc, "Hello, world!");
+            buffered_read_stream<test::stream&, flat_buffer> brs(ts);
+            brs.capacity(1024);
+            std::string s;
+            char buf[4];
+            while(s.size() < 13)
+            {
+                auto const n = brs.read_some(net::buffer(buf));
+                s.append(buf, n);
+            }
+            BEAST_EXPECT(s == "Hello, world!");
+            BEAST_EXPECT(ts.nread() == 1);
+        }
+
+        // large reads go to the next layer
+        {
+            test::stream ts(ioc, "Hello, world!");
+            buffered_read_stream<test::stream&, flat_buffer> brs(ts);
+            brs.capacity(8);
+            char buf[16];
+            auto const n = brs.read_some(net::buffer(buf));
+            BEAST_EXPECT(string_view(buf, n) == "Hello, world!");
+            BEAST_EXPECT(brs.buffer().size() == 0);
+            BEAST_EXPECT(brs.buffer().capacity() == 0);
+        }
+
+        // buffered bytes are returned first
+        {
+            test::stream ts(ioc, ", world!");
+            buffered_read_stream<test::stream&, flat_buffer> brs(ts);
+            brs.capacity(8);
+            brs.buffer().commit(net::buffer_copy(
+                brs.buffer().prepare(5), net::buffer("Hello", 5)));
+            char buf[16];
+            auto const n = brs.read_some(net::buffer(buf));
+            BEAST_EXPECT(string_view(buf, n) == "Hello");
+        }
+    }
+
+    void
+    testParseInPlace()
+    {
+        // The parser reads into the stream's own buffer,
+        // and what follows the message is read next.
+        net::io_context ioc;
+        test::stream ts(ioc,
+            "GET / HTTP/1.1\r\n"
+            "Content-Length: 5\r\n"
+            "\r\n"
+            "*****"
+            "extra");
+        buffered_read_stream<test::stream&, flat_buffer> brs(ts);
+        http::request<http::string_body> req;
+        http::read(brs.next_layer(), brs.buffer(), req);
+        BEAST_EXPECT(req.body() == "*****");
+        std::string s(5, 0);
+        net::read(brs, net::buffer(&s[0], s.size()));
+        BEAST_EXPECT(s == "extra");
+    }
+
     struct copyable_handler
     {
         template<class... Args>
@@ -221,6 +291,8 @@ public:
         });
 
         testAsyncLoop();
+        testReadAhead();
+        testParseInPlace();
     }
 };
 
@@ -0,0 +1,168 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+// Test that header file is self-contained.
+#include <boost/beast/core/buffers_array.hpp>
+
+#include "test_buffer.hpp"
+
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <boost/beast/core/buffer_size.hpp>
+#include <boost/beast/core/buffers_to_string.hpp>
+#include <boost/beast/core/multi_buffer.hpp>
+#include <boost/beast/core/ostream.hpp>
+#include <array>
+#include <string>
+#include <vector>
+
+namespace boost {
+namespace beast {
+
+class buffers_array_test : public unit_test::suite
+{
+public:
+    BOOST_STATIC_ASSERT(net::is_const_buffer_sequence<
+        buffers_array<net::const_buffer>>::value);
+    BOOST_STATIC_ASSERT(! net::is_mutable_buffer_sequence<
+        buffers_array<net::const_buffer>>::value);
+    BOOST_STATIC_ASSERT(net::is_mutable_buffer_sequence<
+        buffers_array<net::mutable_buffer>>::value);
+    BOOST_STATIC_ASSERT(
+        buffers_array<net::const_buffer, 8>::max_size() == 8);
+    BOOST_STATIC_ASSERT(buffer_sequence_max_length<
+        buffers_array<net::const_buffer, 8>>::value == 8);
+    BOOST_STATIC_ASSERT(detail::buffers_array_for<net::const_buffer,
+        buffers_cat_view<net::const_buffer, net::const_buffer>
+            >::max_size() == 2);
+    BOOST_STATIC_ASSERT(detail::buffers_array_for<net::const_buffer,
+        std::vector<net::const_buffer>>::max_size() == 64);
+
+    template<std::size_t N, class BufferSequence>
+    void
+    check(
+        BufferSequence const& buffers,
+        std::size_t limit =
+            (std::numeric_limits<std::size_t>::max)())
+    {
+        auto const s = buffers_to_string(buffers);
+        buffers_array<net::const_buffer, N> a(buffers, limit);
+        BEAST_EXPECT(a.size() <= N);
+        for(auto b : a)
+            BEAST_EXPECT(b.size() > 0);
+        auto const n = (std::min)(s.size(), limit);
+        std::size_t count = 0;
+        for(auto it = net::buffer_sequence_begin(buffers);
+            it != net::buffer_sequence_end(buffers); ++it)
+            if(net::const_buffer(*it).size() > 0)
+                ++count;
+        if(count <= N)
+        {
+            BEAST_EXPECT(buffers_to_string(a) == s.substr(0, n));
+        }
+        else
+        {
+            // only a prefix fits
+            auto const t = buffers_to_string(a);
+            BEAST_EXPECT(t == s.substr(0, t.size()));
+        }
+    }
+
+    void
+    testEmpty()
+    {
+        buffers_array<net::const_buffer> a;
+        BEAST_EXPECT(a.size() == 0);
+        BEAST_EXPECT(a.begin() == a.end());
+        BEAST_EXPECT(buffer_size(a) == 0);
+
+        buffers_array<net::const_buffer> a2(
+            net::const_buffer{});
+        BEAST_EXPECT(a2.size() == 0);
+    }
+
+    void
+    testSequences()
+    {
+        std::string const s =
+            "Hello, world! This is a test of buffers_array.";
+        net::const_buffer b[6];
+        b[0] = net::const_buffer(&s[0], 5);
+        b[1] = net::const_buffer(&s[5], 0);
+        b[2] = net::const_buffer(&s[5], 10);
+        b[3] = net::const_buffer(&s[15], 1);
+        b[4] = net::const_buffer(&s[16], 0);
+        b[5] = net::const_buffer(&s[16], s.size() - 16);
+        std::array<net::const_buffer, 2> b1{{b[0], b[1]}};
+        std::vector<net::const_buffer> b2{b[2], b[3], b[4]};
+        net::const_buffer b3 = b[5];
+
+        check<64>(b3);
+        check<64>(b2);
+
+        auto const cat = buffers_cat(b1, b2, b3);
+        check<64>(cat);
+        check<2>(cat);
+        for(std::size_t i = 0; i <= s.size() + 1; ++i)
+        {
+            check<64>(cat, i);
+            check<3>(cat, i);
+
+            check<64>(buffers_prefix(i, cat));
+            check<64>(buffers_prefix(i, cat), i / 2);
+
+            buffers_suffix<decltype(cat)> cs(cat);
+            cs.consume(i);
+            check<64>(cs);
+            check<2>(cs);
+            for(std::size_t j = 0; j <= s.size() + 1; ++j)
+            {
+                check<64>(buffers_prefix(j, cs));
+                check<64>(buffers_prefix(j, cs), i);
+                check<1>(buffers_prefix(j, cs));
+            }
+
+            // nested concatenations
+            auto const cat2 = buffers_cat(
+                buffers_prefix(i, cat), net::const_buffer{}, cs);
+            check<64>(cat2);
+            check<64>(cat2, i);
+            buffers_suffix<decltype(cat2)> cs2(cat2);
+            cs2.consume(i);
+            check<64>(cs2);
+            check<64>(buffers_prefix(i, cs2));
+        }
+    }
+
+    void
+    testMutable()
+    {
+        multi_buffer b;
+        ostream(b) << std::string(1000, '*');
+        buffers_array<net::mutable_buffer> a(b.data());
+        BEAST_EXPECT(buffer_size(a) == 1000);
+        BEAST_EXPECT(buffers_to_string(a) == std::string(1000, '*'));
+        buffers_array<net::mutable_buffer> a2(b.prepare(100), 10);
+        BEAST_EXPECT(buffer_size(a2) == 10);
+        buffers_array<net::const_buffer> a3(b.data(), 10);
+        BEAST_EXPECT(buffers_to_string(a3) == std::string(10, '*'));
+    }
+
+    void
+    run() override
+    {
+        testEmpty();
+        testSequences();
+        testMutable();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,core,buffers_array);
+
+} // beast
+} // boost
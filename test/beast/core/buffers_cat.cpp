@@ -18,7 +18,9 @@
 #include <boost/beast/core/buffers_suffix.hpp>
 #include <boost/asio/buffer.hpp>
 #include <boost/asio/streambuf.hpp>
+#include <array>
 #include <iterator>
+#include <limits>
 #include <list>
 #include <type_traits>
 #include <vector>
@@ -29,6 +31,39 @@ namespace beast {
 class buffers_cat_test : public unit_test::suite
 {
 public:
+    // buffer_sequence_max_length
+
+    BOOST_STATIC_ASSERT(buffer_sequence_max_length<
+        buffers_cat_view<net::const_buffer, net::mutable_buffer>
+            >::value == 2);
+
+    BOOST_STATIC_ASSERT(buffer_sequence_max_length<
+        buffers_cat_view<
+            net::const_buffer,
+            std::array<net::const_buffer, 3>,
+            buffers_cat_view<net::const_buffer, net::const_buffer>>
+                >::value == 6);
+
+    BOOST_STATIC_ASSERT(buffer_sequence_max_length<
+        buffers_prefix_view<buffers_cat_view<
+            net::const_buffer, std::array<net::const_buffer, 2>>>
+                >::value == 3);
+
+    BOOST_STATIC_ASSERT(buffer_sequence_max_length<
+        buffers_suffix<std::array<net::mutable_buffer, 4>>
+            >::value == 4);
+
+    BOOST_STATIC_ASSERT(buffer_sequence_max_length<
+        buffers_cat_view<net::const_buffer,
+            std::vector<net::const_buffer>>
+                >::value == (std::numeric_limits<std::size_t>::max)());
+
+    BOOST_STATIC_ASSERT(buffer_sequence_max_length<
+        buffers_cat_view<
+            std::vector<net::const_buffer>,
+            std::vector<net::const_buffer>>
+                >::value == (std::numeric_limits<std::size_t>::max)());
+
     void
     testDefaultIterators()
     {
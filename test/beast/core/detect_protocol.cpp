@@ -0,0 +1,258 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+// Test that header file is self-contained.
+#include <boost/beast/core/detect_protocol.hpp>
+
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <boost/beast/core/buffers_to_string.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/core/string.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/write.hpp>
+#include <array>
+
+namespace boost {
+namespace beast {
+
+class detect_protocol_test : public unit_test::suite
+{
+public:
+    using tcp = net::ip::tcp;
+    using socket_type = net::basic_stream_socket<
+        tcp, net::io_context::executor_type>;
+
+    static
+    boost::optional<detected_protocol>
+    classify(string_view s)
+    {
+        return detail::classify_protocol(
+            net::const_buffer(s.data(), s.size()));
+    }
+
+    void
+    testClassify()
+    {
+        auto const is =
+            [&](string_view s, detected_protocol p)
+            {
+                auto const result = classify(s);
+                BEAST_EXPECTS(result && *result == p, s);
+            };
+
+        auto const maybe =
+            [&](string_view s)
+            {
+                BEAST_EXPECTS(! classify(s), s);
+            };
+
+        using p = detected_protocol;
+
+        maybe("");
+
+        // tls
+        maybe({"\x16\x03\x01\x01", 4});
+        is({"\x16\x00\x00\x01\x00\x01\x00\x00\x00", 9}, p::tls);
+        is({"\x16\x00\x00\x01\x00\x01\x01\x00\x00", 9}, p::unknown);
+
+        // http1
+        maybe("G");
+        maybe("GET");
+        is("GET ", p::http1);
+        is("GET / HTTP/1.1\r\n", p::http1);
+        is("M-SEARCH * HTTP/1.1\r\n", p::http1);
+        maybe("PROX");
+        is("PROXYFOO / HTTP/1.1\r\n", p::http1);
+        maybe({"123456789012345678901234", 23});
+        is("123456789012345678901234", p::unknown);
+        is(" GET", p::unknown);
+        is("GET\r\n", p::unknown);
+        is({"\x00", 1}, p::unknown);
+
+        // http2
+        maybe("PRI");
+        maybe("PRI * HTTP/2.0\r\n");
+        maybe("PRI * HTTP/2.0\r\n\r\nSM\r\n\r");
+        is("PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n", p::http2);
+        is("PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n\x00\x00", p::http2);
+        is("PRI / HTTP/1.1\r\n", p::http1);
+
+        // proxy_v1
+        is("PROXY ", p::proxy_v1);
+        is("PROXY TCP4 192.168.0.1 192.168.0.11 56324 443\r\n",
+            p::proxy_v1);
+
+        // proxy_v2
+        maybe("\r");
+        maybe({"\r\n\r\n\0\r\nQUIT", 11});
+        is({"\r\n\r\n\0\r\nQUIT\n", 12}, p::proxy_v2);
+        is({"\r\n\r\n\0\r\nQUIT\n\x21\x11", 14}, p::proxy_v2);
+        is("\r\r", p::unknown);
+
+        // split across buffers
+        {
+            std::array<net::const_buffer, 3> bs;
+            bs[0] = net::const_buffer("PRI * ", 6);
+            bs[1] = net::const_buffer("HTTP/2.0\r\n\r\n", 12);
+            bs[2] = net::const_buffer("SM\r\n\r\n", 6);
+            auto const result = detail::classify_protocol(bs);
+            BEAST_EXPECT(result && *result == p::http2);
+        }
+    }
+
+    // Make a connected pair of sockets
+    static
+    void
+    connect(net::io_context& ioc, socket_type& s1, socket_type& s2)
+    {
+        tcp::acceptor a(ioc, tcp::endpoint(
+            net::ip::make_address("127.0.0.1"), 0));
+        s2.connect(a.local_endpoint());
+        a.accept(s1);
+    }
+
+    void
+    testRead()
+    {
+        net::io_context ioc;
+
+        // the bytes stay in the buffer
+        {
+            socket_type s1(ioc.get_executor());
+            socket_type s2(ioc.get_executor());
+            connect(ioc, s1, s2);
+            string_view const s = "GET / HTTP/1.1\r\n\r\n";
+            net::write(s2, net::buffer(s.data(), s.size()));
+            error_code ec;
+            flat_buffer b;
+            auto const result = detect_protocol(s1, b, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(result == detected_protocol::http1);
+            BEAST_EXPECT(buffers_to_string(b.data()) == s);
+        }
+
+        // the buffer already holds part of the preface
+        {
+            socket_type s1(ioc.get_executor());
+            socket_type s2(ioc.get_executor());
+            connect(ioc, s1, s2);
+            flat_buffer b;
+            b.commit(net::buffer_copy(b.prepare(9),
+                net::buffer("PRI * HTT", 9)));
+            net::write(s2, net::buffer("P/2.0\r\n\r\nSM\r\n\r\n", 15));
+            error_code ec;
+            auto const result = detect_protocol(s1, b, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(result == detected_protocol::http2);
+            BEAST_EXPECT(b.size() == 24);
+        }
+
+        // eof
+        {
+            socket_type s1(ioc.get_executor());
+            socket_type s2(ioc.get_executor());
+            connect(ioc, s1, s2);
+            net::write(s2, net::buffer("PRI * ", 6));
+            s2.close();
+            error_code ec;
+            flat_buffer b;
+            auto const result = detect_protocol(s1, b, ec);
+            BEAST_EXPECT(ec == net::error::eof);
+            BEAST_EXPECT(result == detected_protocol::unknown);
+            BEAST_EXPECT(b.size() == 6);
+        }
+    }
+
+    void
+    testAsyncRead()
+    {
+        net::io_context ioc;
+
+        {
+            socket_type s1(ioc.get_executor());
+            socket_type s2(ioc.get_executor());
+            connect(ioc, s1, s2);
+            flat_buffer b;
+            b.commit(net::buffer_copy(b.prepare(4),
+                net::buffer("\r\n\r\n", 4)));
+            net::write(s2, net::buffer("\0\r\nQUIT\n\x21\x11", 10));
+            bool invoked = false;
+            async_detect_protocol(s1, b,
+                [&](error_code ec, detected_protocol result)
+                {
+                    invoked = true;
+                    BEAST_EXPECTS(! ec, ec.message());
+                    BEAST_EXPECT(
+                        result == detected_protocol::proxy_v2);
+                });
+            BEAST_EXPECT(! invoked);
+            ioc.run();
+            BEAST_EXPECT(invoked);
+            BEAST_EXPECT(b.size() == 14);
+        }
+
+        // decided without reading
+        {
+            socket_type s1(ioc.get_executor());
+            socket_type s2(ioc.get_executor());
+            connect(ioc, s1, s2);
+            flat_buffer b;
+            b.commit(net::buffer_copy(b.prepare(6),
+                net::buffer("PROXY ", 6)));
+            bool invoked = false;
+            async_detect_protocol(s1, b,
+                [&](error_code ec, detected_protocol result)
+                {
+                    invoked = true;
+                    BEAST_EXPECTS(! ec, ec.message());
+                    BEAST_EXPECT(
+                        result == detected_protocol::proxy_v1);
+                });
+            BEAST_EXPECT(! invoked);
+            ioc.restart();
+            ioc.run();
+            BEAST_EXPECT(invoked);
+        }
+
+        // eof
+        {
+            socket_type s1(ioc.get_executor());
+            socket_type s2(ioc.get_executor());
+            connect(ioc, s1, s2);
+            s2.close();
+            flat_buffer b;
+            bool invoked = false;
+            async_detect_protocol(s1, b,
+                [&](error_code ec, detected_protocol result)
+                {
+                    invoked = true;
+                    BEAST_EXPECT(ec == net::error::eof);
+                    BEAST_EXPECT(
+                        result == detected_protocol::unknown);
+                });
+            ioc.restart();
+            ioc.run();
+            BEAST_EXPECT(invoked);
+        }
+    }
+
+    void
+    run() override
+    {
+        testClassify();
+        testRead();
+        testAsyncRead();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,core,detect_protocol);
+
+} // beast
+} // boost
@@ -424,11 +424,177 @@ public:
         }
     }
 
+    void
+    testGrowthPolicy()
+    {
+        // the policy is stored without overhead
+        BOOST_STATIC_ASSERT(sizeof(flat_buffer) ==
+            5 * sizeof(char*) + sizeof(std::size_t));
+        BOOST_STATIC_ASSERT(sizeof(basic_flat_buffer<
+            std::allocator<char>, fixed_growth>) ==
+                5 * sizeof(char*) + 2 * sizeof(std::size_t));
+
+        // geometric
+        {
+            flat_buffer b;
+            b.commit(net::buffer_copy(
+                b.prepare(100), net::const_buffer("*", 1)));
+            b.prepare(150);
+            BEAST_EXPECT(b.capacity() == 151);
+            b.commit(151);
+            b.prepare(1);
+            BEAST_EXPECT(b.capacity() == 302);
+        }
+
+        // page
+        {
+            basic_flat_buffer<
+                std::allocator<char>, page_growth> b;
+            b.prepare(100);
+            BEAST_EXPECT(b.capacity() == 4096);
+            b.commit(b.prepare(4096).size());
+            b.prepare(1);
+            BEAST_EXPECT(b.capacity() == 8192);
+            b.growth_policy().page_size = 512;
+            b.commit(b.prepare(4096).size());
+            b.prepare(1);
+            BEAST_EXPECT(b.capacity() == 16384);
+
+            // clamped to the maximum size
+            basic_flat_buffer<
+                std::allocator<char>, page_growth> b2(1000);
+            b2.prepare(10);
+            BEAST_EXPECT(b2.capacity() == 1000);
+        }
+
+        // fixed
+        {
+            basic_flat_buffer<
+                std::allocator<char>, fixed_growth> b(1000);
+            b.prepare(1);
+            BEAST_EXPECT(b.capacity() == 1000);
+            auto const p = b.data().data();
+            b.commit(1);
+            b.prepare(999);
+            BEAST_EXPECT(b.data().data() == p);
+            BEAST_EXPECT(b.capacity() == 1000);
+        }
+
+        // conversion between policies
+        {
+            flat_buffer b1;
+            ostream(b1) << "Hello";
+            basic_flat_buffer<
+                std::allocator<char>, page_growth> b2(b1);
+            BEAST_EXPECT(buffers_to_string(b2.data()) == "Hello");
+            b1 = b2;
+            BEAST_EXPECT(buffers_to_string(b1.data()) == "Hello");
+        }
+    }
+
+    void
+    testIdleShrink()
+    {
+        using buffer_type = basic_flat_buffer<
+            std::allocator<char>, idle_shrink_growth<>>;
+
+        auto const use =
+            [](buffer_type& b, std::size_t n)
+            {
+                b.commit(n);
+                b.consume(n);
+            };
+
+        // disabled by default
+        {
+            buffer_type b;
+            b.prepare(1000);
+            for(int i = 0; i < 100; ++i)
+            {
+                b.prepare(10);
+                use(b, 10);
+            }
+            BEAST_EXPECT(b.capacity() == 1000);
+        }
+
+        // released after n small uses in a row
+        {
+            buffer_type b;
+            b.growth_policy().idle_limit = 3;
+            b.prepare(1000);
+            use(b, 1000);
+            BEAST_EXPECT(b.capacity() == 1000);
+            b.prepare(10);
+            use(b, 10);
+            b.prepare(10);
+            use(b, 10);
+            BEAST_EXPECT(b.capacity() == 1000);
+            b.prepare(10);
+            use(b, 10);
+            BEAST_EXPECT(b.capacity() == 0);
+            b.prepare(10);
+            BEAST_EXPECT(b.capacity() == 10);
+        }
+
+        // a large use resets the count
+        {
+            buffer_type b;
+            b.growth_policy().idle_limit = 2;
+            b.prepare(1000);
+            use(b, 10);
+            use(b, 0);
+            b.prepare(500);
+            use(b, 500);
+            b.prepare(10);
+            use(b, 10);
+            BEAST_EXPECT(b.capacity() == 1000);
+            b.prepare(10);
+            use(b, 10);
+            BEAST_EXPECT(b.capacity() == 0);
+        }
+
+        // partial consumption does not count
+        {
+            buffer_type b;
+            b.growth_policy().idle_limit = 1;
+            b.prepare(1000);
+            b.commit(10);
+            b.consume(5);
+            BEAST_EXPECT(b.capacity() == 1000);
+            b.consume(5);
+            BEAST_EXPECT(b.capacity() == 0);
+        }
+
+        // the wrapped policy still chooses the capacity
+        {
+            basic_flat_buffer<std::allocator<char>,
+                idle_shrink_growth<page_growth>> b;
+            b.growth_policy().idle_limit = 1;
+            b.prepare(10);
+            BEAST_EXPECT(b.capacity() == 4096);
+            b.commit(10);
+            b.consume(10);
+            BEAST_EXPECT(b.capacity() == 0);
+        }
+
+        // the setting is copied
+        {
+            buffer_type b1;
+            b1.growth_policy().idle_limit = 1;
+            buffer_type b2(b1);
+            b2.prepare(1000);
+            use(b2, 1);
+            BEAST_EXPECT(b2.capacity() == 0);
+        }
+    }
+
     void
     run() override
     {
         testDynamicBuffer();
         testSpecialMembers();
+        testGrowthPolicy();
+        testIdleShrink();
     }
 };
 
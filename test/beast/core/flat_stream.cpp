@@ -15,7 +15,9 @@
 #include <boost/beast/_experimental/unit_test/suite.hpp>
 #include <boost/beast/_experimental/test/stream.hpp>
 #include <boost/beast/websocket/role.hpp>
+#include <array>
 #include <initializer_list>
+#include <string>
 #include <vector>
 
 namespace boost {
@@ -155,6 +157,72 @@ public:
                 });
         }
 
+        // coalesce a small buffer with a large one
+
+        {
+            std::string const s0(100, 'h');
+            std::string const s1(
+                2 * detail::flat_stream_base::max_size, 'b');
+            std::array<net::const_buffer, 2> bs;
+            bs[0] = net::buffer(s0);
+            bs[1] = net::buffer(s1);
+            auto const check =
+                [&](string_view sv)
+                {
+                    BEAST_EXPECT(sv.size() ==
+                        detail::flat_stream_base::max_size);
+                    BEAST_EXPECT(sv.substr(0, 100) == s0);
+                    BEAST_EXPECT(sv.substr(100) ==
+                        s1.substr(0, sv.size() - 100));
+                };
+            {
+                test::stream ts(ioc);
+                flat_stream<test::stream> s(ioc);
+                s.next_layer().connect(ts);
+                error_code ec;
+                auto const n = s.write_some(bs, ec);
+                BEAST_EXPECTS(! ec, ec.message());
+                BEAST_EXPECT(n == detail::flat_stream_base::max_size);
+                check(ts.str());
+            }
+            {
+                test::stream ts(ioc);
+                flat_stream<test::stream> s(ioc);
+                s.next_layer().connect(ts);
+                s.async_write_some(bs,
+                    [&](error_code ec, std::size_t n)
+                    {
+                        BEAST_EXPECTS(! ec, ec.message());
+                        BEAST_EXPECT(n ==
+                            detail::flat_stream_base::max_size);
+                    });
+                ioc.run();
+                ioc.restart();
+                check(ts.str());
+            }
+        }
+
+        // flatten_limit
+
+        {
+            std::string const s0(100, 'h');
+            std::string const s1(1000, 'b');
+            std::array<net::const_buffer, 2> bs;
+            bs[0] = net::buffer(s0);
+            bs[1] = net::buffer(s1);
+            test::stream ts(ioc);
+            flat_stream<test::stream> s(ioc);
+            s.next_layer().connect(ts);
+            BEAST_EXPECT(s.flatten_limit() ==
+                detail::flat_stream_base::max_size);
+            s.flatten_limit(512);
+            BEAST_EXPECT(s.flatten_limit() == 512);
+            error_code ec;
+            BEAST_EXPECT(s.write_some(bs, ec) == 512);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(ts.str() == s0 + s1.substr(0, 412));
+        }
+
         // teardown
 
         {
@@ -207,6 +275,35 @@ public:
         check({1,2,3},      4,    3, true);
         check({1,2,3},      7,    6, true);
         check({1,2,3,4},    3,    3, true);
+
+        auto const coalesce =
+            [&](
+                std::initializer_list<int> v0,
+                std::size_t limit,
+                unsigned long count,
+                bool copy)
+            {
+                std::vector<net::const_buffer> v;
+                v.reserve(v0.size());
+                for(auto const n : v0)
+                    v.emplace_back("", n);
+                auto const result =
+                    boost::beast::detail::flat_stream_base::coalesce(v, limit);
+                BEAST_EXPECT(result.size == count);
+                BEAST_EXPECT(result.flatten == copy);
+            };
+        coalesce({},        1,    0, false);
+        coalesce({1},       2,    1, false);
+        coalesce({3},       2,    3, false);
+        coalesce({1,2},     1,    1, false);
+        coalesce({1,2},     2,    2, true);
+        coalesce({1,2},     3,    3, true);
+        coalesce({1,2},     4,    3, true);
+        coalesce({1,2,3},   2,    2, true);
+        coalesce({1,2,3},   4,    4, true);
+        coalesce({1,2,3},   7,    6, true);
+        coalesce({2,9},     4,    4, true);
+        coalesce({4,9},     4,    4, false);
     }
 
     void
@@ -0,0 +1,195 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+// Test that header file is self-contained.
+#include <boost/beast/core/format.hpp>
+
+#include <boost/beast/core/buffers_to_string.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/core/flat_static_buffer.hpp>
+#include <boost/beast/core/multi_buffer.hpp>
+#include <boost/beast/core/static_string.hpp>
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace boost {
+namespace beast {
+
+class format_test : public beast::unit_test::suite
+{
+public:
+    template<class... Args>
+    std::string
+    str(Args const&... args)
+    {
+        flat_buffer b;
+        auto const n = format_to(b, args...);
+        BEAST_EXPECT(n == b.size());
+        return buffers_to_string(b.data());
+    }
+
+    void
+    testIntegers()
+    {
+        BEAST_EXPECT(str(0) == "0");
+        BEAST_EXPECT(str(7) == "7");
+        BEAST_EXPECT(str(-7) == "-7");
+        BEAST_EXPECT(str(1234567890u) == "1234567890");
+        BEAST_EXPECT(str(static_cast<short>(-32768)) == "-32768");
+        BEAST_EXPECT(str(static_cast<unsigned char>(255)) == "255");
+        BEAST_EXPECT(str(static_cast<signed char>(-128)) == "-128");
+        BEAST_EXPECT(str((std::numeric_limits<std::int64_t>::min)()) ==
+            "-9223372036854775808");
+        BEAST_EXPECT(str((std::numeric_limits<std::int64_t>::max)()) ==
+            "9223372036854775807");
+        BEAST_EXPECT(str((std::numeric_limits<std::uint64_t>::max)()) ==
+            "18446744073709551615");
+        BEAST_EXPECT(str(std::size_t{42}) == "42");
+    }
+
+    void
+    testStrings()
+    {
+        BEAST_EXPECT(str() == "");
+        BEAST_EXPECT(str("") == "");
+        BEAST_EXPECT(str("Hello") == "Hello");
+        BEAST_EXPECT(str(std::string("Hello")) == "Hello");
+        BEAST_EXPECT(str(string_view("Hello, world", 5)) == "Hello");
+        BEAST_EXPECT(str(static_string<8>("Hello")) == "Hello");
+        char const* p = "Hello";
+        BEAST_EXPECT(str(p) == "Hello");
+        BEAST_EXPECT(str('x') == "x");
+        BEAST_EXPECT(str(true, ' ', false) == "true false");
+    }
+
+    void
+    testFixedPoint()
+    {
+        BEAST_EXPECT(str(fixed_point(0)) == "0.00");
+        BEAST_EXPECT(str(fixed_point(1.5)) == "1.50");
+        BEAST_EXPECT(str(fixed_point(-1.5)) == "-1.50");
+        BEAST_EXPECT(str(fixed_point(3.14159, 3)) == "3.142");
+        BEAST_EXPECT(str(fixed_point(2.5, 0)) == "3");
+        BEAST_EXPECT(str(fixed_point(0.996, 2)) == "1.00");
+        BEAST_EXPECT(str(fixed_point(9.9999, 3)) == "10.000");
+        BEAST_EXPECT(str(fixed_point(0.05, 1)) == "0.1");
+        BEAST_EXPECT(str(fixed_point(0.001, 1)) == "0.0");
+        BEAST_EXPECT(str(fixed_point(-0.001, 1)) == "0.0");
+        BEAST_EXPECT(str(fixed_point(-0.0)) == "0.00");
+        BEAST_EXPECT(str(fixed_point(123456789.125, 9)) ==
+            "123456789.125000000");
+        BEAST_EXPECT(str(fixed_point(1.0, 20)) == "1.000000000");
+        BEAST_EXPECT(str(fixed_point(1e18, 1)) ==
+            "1000000000000000000.0");
+        BEAST_EXPECT(str(fixed_point(1e20, 2)) == "1.00e+20");
+        BEAST_EXPECT(str(fixed_point(-1e300, 3)) == "-1.000e+300");
+        BEAST_EXPECT(str(fixed_point(1e19, 0)) == "1e+19");
+        BEAST_EXPECT(str(fixed_point(
+            12345678901234567890.0, 3)) == "1.235e+19");
+        BEAST_EXPECT(str(fixed_point(9.9999e20, 2)) == "1.00e+21");
+        BEAST_EXPECT(str(fixed_point(-2.5e100, 9)) ==
+            "-2.500000000e+100");
+        BEAST_EXPECT(str(fixed_point(
+            (std::numeric_limits<double>::max)(), 9)) ==
+                "1.797693135e+308");
+        {
+            // matches printf in the "C" locale
+            char buf[32];
+            double v = 1.0e19;
+            for(int i = 0; i < 250; ++i, v *= 13.7)
+            {
+                for(unsigned p = 0; p <= 9; p += 3)
+                {
+                    std::snprintf(buf, sizeof(buf),
+                        "%.*e", static_cast<int>(p), v);
+                    BEAST_EXPECTS(str(fixed_point(v, p)) == buf, buf);
+                }
+            }
+        }
+        BEAST_EXPECT(str(fixed_point(
+            std::numeric_limits<double>::infinity())) == "inf");
+        BEAST_EXPECT(str(fixed_point(
+            -std::numeric_limits<double>::infinity())) == "-inf");
+        BEAST_EXPECT(str(fixed_point(
+            std::numeric_limits<double>::quiet_NaN())) == "nan");
+    }
+
+    void
+    testDynamicBuffers()
+    {
+        // appends to existing content
+        {
+            flat_buffer b;
+            format_to(b, "Content-Length: ", 1234, "\r\n");
+            format_to(b, "Server: ", "Beast", "\r\n");
+            BEAST_EXPECT(buffers_to_string(b.data()) ==
+                "Content-Length: 1234\r\nServer: Beast\r\n");
+        }
+
+        // output spanning several buffers
+        {
+            multi_buffer b;
+            std::string const s(5000, '*');
+            for(int i = 0; i < 10; ++i)
+                format_to(b, s, i, fixed_point(i / 4.0));
+            std::string expected;
+            for(int i = 0; i < 10; ++i)
+                expected += s + std::to_string(i) +
+                    str(fixed_point(i / 4.0));
+            BEAST_EXPECT(buffers_to_string(b.data()) == expected);
+        }
+
+        // capacity is sufficient, so no allocation
+        {
+            flat_buffer b;
+            b.reserve(64);
+            auto const p = b.prepare(0).data();
+            format_to(b, "HTTP/1.1 ", 200, " OK\r\n");
+            BEAST_EXPECT(b.data().data() == p);
+            BEAST_EXPECT(buffers_to_string(b.data()) ==
+                "HTTP/1.1 200 OK\r\n");
+        }
+
+        // max_size
+        {
+            flat_static_buffer<8> b;
+            format_to(b, "1234");
+            try
+            {
+                format_to(b, "56", 789);
+                fail("missing exception", __FILE__, __LINE__);
+            }
+            catch(std::length_error const&)
+            {
+                pass();
+            }
+            BEAST_EXPECT(buffers_to_string(b.data()) == "1234");
+            format_to(b, "56", 78);
+            BEAST_EXPECT(buffers_to_string(b.data()) == "12345678");
+        }
+    }
+
+    void
+    run() override
+    {
+        testIntegers();
+        testStrings();
+        testFixedPoint();
+        testDynamicBuffers();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,core,format);
+
+} // beast
+} // boost
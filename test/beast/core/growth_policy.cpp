@@ -0,0 +1,126 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+// Test that header file is self-contained.
+#include <boost/beast/core/growth_policy.hpp>
+
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <limits>
+#include <memory>
+
+namespace boost {
+namespace beast {
+
+class growth_policy_test : public beast::unit_test::suite
+{
+public:
+    void
+    testGeometric()
+    {
+        geometric_growth g;
+        BEAST_EXPECT(g.grow(0, 10, 1000) == 10);
+        BEAST_EXPECT(g.grow(100, 10, 1000) == 200);
+        BEAST_EXPECT(g.grow(100, 150, 1000) == 250);
+    }
+
+    void
+    testPage()
+    {
+        page_growth g;
+        BEAST_EXPECT(g.grow(0, 1, 1000) == 4096);
+        BEAST_EXPECT(g.grow(0, 4096, 1000) == 4096);
+        BEAST_EXPECT(g.grow(0, 4097, 1000) == 8192);
+        BEAST_EXPECT(g.grow(3000, 1, 1000) == 8192);
+        g.page_size = 100;
+        BEAST_EXPECT(g.grow(0, 1, 1000) == 100);
+        BEAST_EXPECT(g.grow(60, 1, 1000) == 200);
+    }
+
+    void
+    testFixed()
+    {
+        fixed_growth g;
+        BEAST_EXPECT(g.grow(0, 1, 1000) == 1000);
+        BEAST_EXPECT(g.grow(500, 500, 1000) == 1000);
+        BEAST_EXPECT(g.grow(0, 1, g.limit) == g.limit);
+
+        // an unbounded maximum grows geometrically
+        auto const max =
+            (std::numeric_limits<std::size_t>::max)();
+        BEAST_EXPECT(g.grow(0, 10, max) == 10);
+        BEAST_EXPECT(g.grow(100, 10, max) == 200);
+        BEAST_EXPECT(g.grow(0, 10, g.limit + 1) == 10);
+        g.limit = 100;
+        BEAST_EXPECT(g.grow(0, 1, 100) == 100);
+        BEAST_EXPECT(g.grow(0, 1, 1000) == 1);
+
+        // with a buffer of the default maximum size
+        {
+            basic_flat_buffer<
+                std::allocator<char>, fixed_growth> b;
+            b.prepare(100);
+            BEAST_EXPECT(b.capacity() == 100);
+            b.commit(100);
+            b.prepare(1);
+            BEAST_EXPECT(b.capacity() == 200);
+        }
+
+        // with a bounded buffer
+        {
+            basic_flat_buffer<
+                std::allocator<char>, fixed_growth> b(5000);
+            b.prepare(100);
+            BEAST_EXPECT(b.capacity() == 5000);
+        }
+    }
+
+    void
+    testIdleShrink()
+    {
+        idle_shrink_growth<page_growth> g(2);
+        BEAST_EXPECT(g.grow(0, 1, 1000) == 4096);
+
+        // disabled for an empty buffer
+        BEAST_EXPECT(! g.on_consume(0));
+        BEAST_EXPECT(! g.on_consume(0));
+
+        g.on_commit(10);
+        BEAST_EXPECT(! g.on_consume(1000));
+        g.on_commit(10);
+        BEAST_EXPECT(g.on_consume(1000));
+
+        // a large use resets the count
+        g.on_commit(10);
+        BEAST_EXPECT(! g.on_consume(1000));
+        g.on_commit(500);
+        BEAST_EXPECT(! g.on_consume(1000));
+        g.on_commit(250);
+        BEAST_EXPECT(! g.on_consume(1000));
+        BEAST_EXPECT(g.on_consume(1000));
+
+        // disabled
+        g.idle_limit = 0;
+        BEAST_EXPECT(! g.on_consume(1000));
+    }
+
+    void
+    run() override
+    {
+        testGeometric();
+        testPage();
+        testFixed();
+        testIdleShrink();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,core,growth_policy);
+
+} // beast
+} // boost
@@ -0,0 +1,280 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+// Test that header file is self-contained.
+#include <boost/beast/core/metrics_policy.hpp>
+
+#include <boost/beast/core/basic_stream.hpp>
+#include <boost/beast/core/rate_policy.hpp>
+#include <boost/beast/core/tcp_stream.hpp>
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+#include <thread>
+#include <type_traits>
+
+namespace boost {
+namespace beast {
+
+BOOST_STATIC_ASSERT(std::is_same<tcp_stream, basic_stream<
+    net::ip::tcp, net::executor, unlimited_rate_policy,
+        null_metrics_policy>>::value);
+
+class metrics_policy_test : public beast::unit_test::suite
+{
+public:
+    using ms = std::chrono::milliseconds;
+    using tcp = net::ip::tcp;
+
+    template<class RatePolicy>
+    using stream_type = basic_stream<tcp,
+        net::io_context::executor_type,
+            RatePolicy, simple_metrics_policy>;
+
+    template<class Stream>
+    static
+    void
+    connect(net::io_context& ioc, Stream& s, tcp::socket& server)
+    {
+        tcp::acceptor a(ioc, tcp::endpoint(
+            net::ip::make_address("127.0.0.1"), 0));
+        s.socket().connect(a.local_endpoint());
+        a.accept(server);
+    }
+
+    void
+    testSync()
+    {
+        net::io_context ioc;
+        tcp::socket server(ioc);
+        stream_type<unlimited_rate_policy> s(ioc.get_executor());
+        connect(ioc, s, server);
+
+        char buf[8];
+        BEAST_EXPECT(s.write_some(net::buffer("Hello", 5)) == 5);
+        net::read(server, net::buffer(buf, 5));
+        net::write(server, net::buffer("Hi", 2));
+        BEAST_EXPECT(s.read_some(net::buffer(buf)) == 2);
+
+        auto const& m = s.metrics_policy().metrics();
+        BEAST_EXPECT(m.bytes_written == 5);
+        BEAST_EXPECT(m.writes == 1);
+        BEAST_EXPECT(m.bytes_read == 2);
+        BEAST_EXPECT(m.reads == 1);
+        BEAST_EXPECT(m.timeouts == 0);
+
+        // errors are counted as operations
+        server.close();
+        error_code ec;
+        s.read_some(net::buffer(buf), ec);
+        BEAST_EXPECT(ec == net::error::eof);
+        BEAST_EXPECT(m.bytes_read == 2);
+        BEAST_EXPECT(m.reads == 2);
+        try
+        {
+            s.read_some(net::buffer(buf));
+            fail("", __FILE__, __LINE__);
+        }
+        catch(system_error const& e)
+        {
+            BEAST_EXPECT(e.code() == net::error::eof);
+        }
+        BEAST_EXPECT(m.reads == 3);
+    }
+
+    void
+    testAsync()
+    {
+        net::io_context ioc;
+        tcp::socket server(ioc);
+        stream_type<unlimited_rate_policy> s(ioc.get_executor());
+        connect(ioc, s, server);
+        auto const& m = s.metrics_policy().metrics();
+
+        // handler time
+        {
+            char buf[8];
+            bool invoked = false;
+            net::write(server, net::buffer("abc", 3));
+            s.async_read_some(net::buffer(buf),
+                [&](error_code ec, std::size_t n)
+                {
+                    invoked = true;
+                    BEAST_EXPECTS(! ec, ec.message());
+                    BEAST_EXPECT(n == 3);
+                    std::this_thread::sleep_for(ms(20));
+                });
+            ioc.run();
+            BEAST_EXPECT(invoked);
+            BEAST_EXPECT(m.reads == 1);
+            BEAST_EXPECT(m.bytes_read == 3);
+            BEAST_EXPECT(m.handler_time >= ms(20));
+        }
+
+        // socket wait time
+        {
+            char buf[8];
+            bool invoked = false;
+            s.async_read_some(net::buffer(buf),
+                [&](error_code ec, std::size_t n)
+                {
+                    invoked = true;
+                    BEAST_EXPECTS(! ec, ec.message());
+                    BEAST_EXPECT(n == 1);
+                });
+            net::steady_timer t(ioc);
+            t.expires_after(ms(20));
+            t.async_wait(
+                [&](error_code)
+                {
+                    net::write(server, net::buffer("*", 1));
+                });
+            ioc.restart();
+            ioc.run();
+            BEAST_EXPECT(invoked);
+            BEAST_EXPECT(m.reads == 2);
+            BEAST_EXPECT(m.read_wait >= ms(20));
+        }
+
+        // write
+        {
+            bool invoked = false;
+            s.async_write_some(net::buffer("1234", 4),
+                [&](error_code ec, std::size_t n)
+                {
+                    invoked = true;
+                    BEAST_EXPECTS(! ec, ec.message());
+                    BEAST_EXPECT(n == 4);
+                });
+            ioc.restart();
+            ioc.run();
+            BEAST_EXPECT(invoked);
+            BEAST_EXPECT(m.writes == 1);
+            BEAST_EXPECT(m.bytes_written == 4);
+        }
+
+        // timeout
+        {
+            char buf[8];
+            bool invoked = false;
+            s.expires_after(ms(10));
+            s.async_read_some(net::buffer(buf),
+                [&](error_code ec, std::size_t)
+                {
+                    invoked = true;
+                    BEAST_EXPECTS(
+                        ec == error::timeout, ec.message());
+                });
+            ioc.restart();
+            ioc.run();
+            BEAST_EXPECT(invoked);
+            BEAST_EXPECT(m.timeouts == 1);
+        }
+    }
+
+    void
+    testRateWait()
+    {
+        net::io_context ioc;
+        tcp::socket server(ioc);
+        token_bucket_rate_policy policy(ms(20));
+        policy.write_limit(100, 1);
+        stream_type<token_bucket_rate_policy> s(
+            policy, ioc.get_executor());
+        connect(ioc, s, server);
+
+        // the burst is spent by the first write
+        std::size_t total = 0;
+        for(int i = 0; i < 2; ++i)
+        {
+            bool invoked = false;
+            s.async_write_some(net::buffer("*", 1),
+                [&](error_code ec, std::size_t n)
+                {
+                    invoked = true;
+                    BEAST_EXPECTS(! ec, ec.message());
+                    total += n;
+                });
+            ioc.restart();
+            ioc.run();
+            BEAST_EXPECT(invoked);
+        }
+        auto const& m = s.metrics_policy().metrics();
+        BEAST_EXPECT(total == 2);
+        BEAST_EXPECT(m.writes == 2);
+        BEAST_EXPECT(m.rate_wait >= ms(20));
+    }
+
+    void
+    testRegistry()
+    {
+        metrics_registry registry;
+        BEAST_EXPECT(registry.totals().bytes_read == 0);
+
+        net::io_context ioc;
+        tcp::socket server1(ioc);
+        tcp::socket server2(ioc);
+        stream_type<unlimited_rate_policy> s1(ioc.get_executor());
+        stream_type<unlimited_rate_policy> s2(ioc.get_executor());
+        connect(ioc, s1, server1);
+        connect(ioc, s2, server2);
+
+        char buf[8];
+        net::write(server1, net::buffer("abc", 3));
+        BEAST_EXPECT(s1.read_some(net::buffer(buf)) == 3);
+
+        // only counted after attach
+        s1.metrics_policy().attach(registry);
+        s2.metrics_policy().attach(registry);
+        net::write(server1, net::buffer("abcd", 4));
+        BEAST_EXPECT(s1.read_some(net::buffer(buf)) == 4);
+        net::write(server2, net::buffer("ab", 2));
+        BEAST_EXPECT(s2.read_some(net::buffer(buf)) == 2);
+        s2.write_some(net::buffer("x", 1));
+
+        auto const m = registry.totals();
+        BEAST_EXPECT(m.bytes_read == 6);
+        BEAST_EXPECT(m.reads == 2);
+        BEAST_EXPECT(m.bytes_written == 1);
+        BEAST_EXPECT(m.writes == 1);
+        BEAST_EXPECT(s1.metrics_policy().metrics().bytes_read == 7);
+
+        auto const text = registry.to_prometheus();
+        BEAST_EXPECT(text.find(
+            "# HELP beast_stream_read_bytes_total ") == 0);
+        BEAST_EXPECT(text.find(
+            "# TYPE beast_stream_read_bytes_total counter\n"
+            "beast_stream_read_bytes_total 6\n") !=
+                std::string::npos);
+        BEAST_EXPECT(text.find(
+            "\nbeast_stream_writes_total 1\n") !=
+                std::string::npos);
+        BEAST_EXPECT(text.find(
+            "\nbeast_stream_rate_limit_wait_seconds_total "
+            "0.000000000\n") != std::string::npos);
+        BEAST_EXPECT(registry.to_prometheus("app").find(
+            "\napp_timeouts_total 0\n") != std::string::npos);
+    }
+
+    void
+    run() override
+    {
+        testSync();
+        testAsync();
+        testRateWait();
+        testRegistry();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,core,metrics_policy);
+
+} // beast
+} // boost
@@ -0,0 +1,170 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+// Test that header file is self-contained.
+#include <boost/beast/core/mirrored_ring_buffer.hpp>
+
+#if BOOST_BEAST_USE_MIRRORED_RING_BUFFER
+
+#include "test_buffer.hpp"
+
+#include <boost/beast/core/buffers_to_string.hpp>
+#include <boost/beast/core/ostream.hpp>
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <string>
+#include <unistd.h>
+
+namespace boost {
+namespace beast {
+
+class mirrored_ring_buffer_test : public beast::unit_test::suite
+{
+public:
+    BOOST_STATIC_ASSERT(
+        is_mutable_dynamic_buffer<mirrored_ring_buffer>::value);
+
+    void
+    testDynamicBuffer()
+    {
+        mirrored_ring_buffer b(30);
+        BEAST_EXPECT(b.max_size() == 30);
+        test_dynamic_buffer(b);
+    }
+
+    void
+    testMembers()
+    {
+        // construction
+        {
+            mirrored_ring_buffer b;
+            BEAST_EXPECT(b.capacity() == 0);
+            BEAST_EXPECT(b.size() == 0);
+            BEAST_EXPECT(b.data().size() == 0);
+        }
+
+        // reserve, shrink_to_fit
+        {
+            mirrored_ring_buffer b;
+            b.reserve(1);
+            auto const page = b.capacity();
+            BEAST_EXPECT(page > 0);
+            b.reserve(page + 1);
+            BEAST_EXPECT(b.capacity() == 2 * page);
+            ostream(b) << "Hello";
+            b.shrink_to_fit();
+            BEAST_EXPECT(b.capacity() == page);
+            BEAST_EXPECT(buffers_to_string(b.data()) == "Hello");
+            b.consume(5);
+            b.shrink_to_fit();
+            BEAST_EXPECT(b.capacity() == 0);
+        }
+
+        // growth preserves the readable bytes
+        {
+            mirrored_ring_buffer b;
+            std::string s;
+            for(int i = 0; i < 10000; ++i)
+                s += std::to_string(i);
+            ostream(b) << s;
+            BEAST_EXPECT(b.capacity() >= s.size());
+            BEAST_EXPECT(buffers_to_string(b.data()) == s);
+        }
+    }
+
+    void
+    testWrap()
+    {
+        mirrored_ring_buffer b;
+        b.reserve(1);
+        auto const cap = b.capacity();
+        std::string s;
+        s.resize(cap / 2 + 100);
+        char c = 0;
+        // every region is one contiguous buffer,
+        // even when it wraps around the ring
+        for(int i = 0; i < 20; ++i)
+        {
+            for(auto& ch : s)
+                ch = c++;
+            auto const mb = b.prepare(s.size());
+            BEAST_EXPECT(mb.size() == s.size());
+            b.commit(net::buffer_copy(mb, net::buffer(s)));
+            BEAST_EXPECT(b.capacity() == cap);
+            auto const cb = b.data();
+            BEAST_EXPECT(cb.size() == s.size());
+            BEAST_EXPECT(std::string(
+                static_cast<char const*>(cb.data()),
+                cb.size()) == s);
+            b.consume(s.size());
+        }
+
+        // growth while the readable bytes wrap
+        {
+            b.clear();
+            std::string u(cap - 10, 'u');
+            b.commit(net::buffer_copy(
+                b.prepare(u.size()), net::buffer(u)));
+            b.consume(cap - 20);
+            std::string t(100, 'x');
+            b.commit(net::buffer_copy(
+                b.prepare(t.size()), net::buffer(t)));
+            BEAST_EXPECT(b.capacity() == cap);
+            auto const expected =
+                buffers_to_string(b.data());
+            BEAST_EXPECT(expected ==
+                std::string(10, 'u') + t);
+            b.prepare(cap);
+            BEAST_EXPECT(b.capacity() == 2 * cap);
+            BEAST_EXPECT(buffers_to_string(b.data()) == expected);
+        }
+    }
+
+    // The buffer does not keep a file descriptor open
+    void
+    testDescriptors()
+    {
+        auto const lowest =
+            []
+            {
+                // dup returns the lowest unused descriptor
+                auto const fd = ::dup(0);
+                if(fd != -1)
+                    ::close(fd);
+                return fd;
+            };
+        auto const fd = lowest();
+        if(! BEAST_EXPECT(fd != -1))
+            return;
+        {
+            mirrored_ring_buffer b1;
+            mirrored_ring_buffer b2;
+            b1.prepare(1);
+            b2.prepare(1);
+            b1.prepare(b1.capacity() + 1);
+            BEAST_EXPECT(lowest() == fd);
+        }
+        BEAST_EXPECT(lowest() == fd);
+    }
+
+    void
+    run() override
+    {
+        testDynamicBuffer();
+        testMembers();
+        testWrap();
+        testDescriptors();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,core,mirrored_ring_buffer);
+
+} // beast
+} // boost
+
+#endif
@@ -165,6 +165,8 @@ public:
         multi_buffer b(30);
         BEAST_EXPECT(b.max_size() == 30);
         test_dynamic_buffer(b);
+
+        test_dynamic_buffer(slab_multi_buffer(30));
     }
 
     void
@@ -49,6 +49,26 @@ public:
     {
         boost::ignore_unused(unlimited_rate_policy{});
         boost::ignore_unused(simple_rate_policy{});
+        boost::ignore_unused(token_bucket_rate_policy{});
+        boost::ignore_unused(shared_token_bucket_rate_policy{});
+
+        {
+            token_bucket_rate_policy p(
+                std::chrono::milliseconds(5));
+            BEAST_EXPECT(p.refill_interval() ==
+                std::chrono::milliseconds(5));
+            p.read_limit(1000);
+            p.write_limit(1000, 100);
+        }
+
+        {
+            shared_token_bucket_rate_policy p;
+            BEAST_EXPECT(p.refill_interval() ==
+                std::chrono::milliseconds(10));
+            auto p2 = p;
+            p2.read_limit(1000);
+            p2.write_limit(1000, 100);
+        }
 
         pass();
     }
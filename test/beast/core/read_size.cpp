@@ -33,6 +33,110 @@ public:
         pass();
     }
 
+    struct fake_socket
+    {
+        std::size_t available_ = 0;
+        int rcvbuf_ = 0;
+
+        std::size_t
+        available(error_code& ec) const
+        {
+            ec = {};
+            return available_;
+        }
+
+        void
+        get_option(
+            net::socket_base::receive_buffer_size& option,
+            error_code& ec) const
+        {
+            ec = {};
+            option = net::socket_base::receive_buffer_size(rcvbuf_);
+        }
+    };
+
+    void
+    testAdvisor()
+    {
+        // starts at the minimum
+        {
+            read_size_advisor a;
+            BEAST_EXPECT(a.size() == 512);
+            read_size_advisor a2(100, 1000);
+            BEAST_EXPECT(a2.size() == 100);
+        }
+
+        // grows while reads fill the space
+        {
+            read_size_advisor a(100, 1000);
+            a.feedback(100, 100);
+            BEAST_EXPECT(a.size() == 200);
+            a.feedback(200, 200);
+            BEAST_EXPECT(a.size() == 400);
+            a.feedback(400, 400);
+            BEAST_EXPECT(a.size() == 800);
+            a.feedback(800, 800);
+            BEAST_EXPECT(a.size() == 1000);
+        }
+
+        // follows the average when reads are short
+        {
+            read_size_advisor a(100, 1000);
+            a.feedback(1000, 400);
+            BEAST_EXPECT(a.size() == 800);
+            for(int i = 0; i < 20; ++i)
+                a.feedback(a.size(), 10);
+            BEAST_EXPECT(a.size() == 100);
+            a.feedback(100, 0);
+            BEAST_EXPECT(a.size() == 100);
+            a.reset();
+            BEAST_EXPECT(a.size() == 100);
+        }
+
+        // pending data and receive buffer
+        {
+            read_size_advisor a(100, 10000);
+            a.available(5000);
+            BEAST_EXPECT(a.size() == 5000);
+            a.feedback(5000, 5000);
+            BEAST_EXPECT(a.size() == 10000);
+            a.limit(2000);
+            BEAST_EXPECT(a.size() == 2000);
+            a.limit(10);
+            BEAST_EXPECT(a.size() == 100);
+        }
+        {
+            fake_socket sock;
+            sock.available_ = 3000;
+            sock.rcvbuf_ = 2048;
+            read_size_advisor a(100, 10000);
+            error_code ec;
+            a.update(sock, ec);
+            BEAST_EXPECT(! ec);
+            BEAST_EXPECT(a.size() == 2048);
+            a.feedback(a.size(), 1);
+            BEAST_EXPECT(a.size() == 100);
+        }
+
+        // read_size uses the advice as the minimum
+        {
+            flat_buffer b;
+            read_size_advisor a(100, 10000);
+            BEAST_EXPECT(read_size(b, 65536, a) == 100);
+            a.feedback(4000, 4000);
+            BEAST_EXPECT(read_size(b, 65536, a) == 8000);
+            BEAST_EXPECT(read_size(b, 1000, a) == 1000);
+            b.prepare(9000);
+            BEAST_EXPECT(read_size(b, 65536, a) == 9000);
+        }
+        {
+            flat_static_buffer<1024> b;
+            read_size_advisor a(100, 10000);
+            a.feedback(4000, 4000);
+            BEAST_EXPECT(read_size(b, 65536, a) == 1024);
+        }
+    }
+
     void
     run() override
     {
@@ -41,6 +145,7 @@ public:
         check<multi_buffer>();
         check<static_buffer<1024>>();
         check<net::streambuf>();
+        testAdvisor();
     }
 };
 
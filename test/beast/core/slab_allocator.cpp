@@ -0,0 +1,163 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+// Test that header file is self-contained.
+#include <boost/beast/core/slab_allocator.hpp>
+
+#include <boost/beast/core/buffer_size.hpp>
+#include <boost/beast/core/multi_buffer.hpp>
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <boost/config.hpp>
+#include <type_traits>
+#include <vector>
+
+namespace boost {
+namespace beast {
+
+BOOST_STATIC_ASSERT(std::is_same<
+    multi_buffer::allocator_type, std::allocator<char>>::value);
+
+BOOST_STATIC_ASSERT(std::is_same<
+    slab_multi_buffer::allocator_type, slab_allocator<char>>::value);
+
+class slab_allocator_test : public beast::unit_test::suite
+{
+public:
+    void
+    testAllocator()
+    {
+        slab_allocator<char> a;
+        slab_allocator<int> b(a);
+        BEAST_EXPECT(a == b);
+        BEAST_EXPECT(! (a != b));
+
+    #ifndef BOOST_NO_CXX11_THREAD_LOCAL
+        slab_allocator<char>::thread_shrink();
+        BEAST_EXPECT(slab_allocator<char>::thread_stats().cached == 0);
+
+        // a block of each size class is recycled
+        for(std::size_t n : {1, 1024, 1025, 4096, 16000, 65536})
+        {
+            slab_allocator<char>::thread_shrink();
+            auto const s0 = slab_allocator<char>::thread_stats();
+            auto const p = a.allocate(n);
+            a.deallocate(p, n);
+            auto const s1 = slab_allocator<char>::thread_stats();
+            BEAST_EXPECT(s1.cached > s0.cached);
+            auto const p1 = a.allocate(n);
+            BEAST_EXPECT(p1 == p);
+            auto const s2 = slab_allocator<char>::thread_stats();
+            BEAST_EXPECT(s2.hits == s1.hits + 1);
+            BEAST_EXPECT(s2.cached == s0.cached);
+            a.deallocate(p1, n);
+        }
+
+        // requests are rounded up to the size class
+        BEAST_EXPECT(slab_allocator<char>::good_size(1) == 1024);
+        BEAST_EXPECT(slab_allocator<char>::good_size(1025) == 4096);
+        BEAST_EXPECT(slab_allocator<char>::good_size(65536) == 65536);
+        BEAST_EXPECT(slab_allocator<char>::good_size(65537) == 65537);
+        BEAST_EXPECT(slab_allocator<int>::good_size(1) == 256);
+
+        // large blocks bypass the freelists
+        {
+            auto const s0 = slab_allocator<char>::thread_stats();
+            auto const p = a.allocate(65537);
+            a.deallocate(p, 65537);
+            auto const s1 = slab_allocator<char>::thread_stats();
+            BEAST_EXPECT(s1.hits == s0.hits);
+            BEAST_EXPECT(s1.misses == s0.misses);
+            BEAST_EXPECT(s1.cached == s0.cached);
+        }
+
+        // the freelists are bounded
+        {
+            std::vector<char*> v;
+            for(int i = 0; i < 1000; ++i)
+                v.push_back(a.allocate(4096));
+            for(auto p : v)
+                a.deallocate(p, 4096);
+            auto const s = slab_allocator<char>::thread_stats();
+            BEAST_EXPECT(s.cached < 1000 * 4096);
+        }
+    #endif
+    }
+
+    void
+    testMultiBuffer()
+    {
+    #ifndef BOOST_NO_CXX11_THREAD_LOCAL
+        {
+            slab_multi_buffer b;
+            b.prepare(100);
+            b.commit(100);
+        }
+        auto const s0 = slab_allocator<char>::thread_stats();
+        for(int i = 0; i < 100; ++i)
+        {
+            slab_multi_buffer b;
+            b.prepare(100);
+            b.commit(100);
+        }
+        auto const s1 = slab_allocator<char>::thread_stats();
+        BEAST_EXPECT(s1.hits == s0.hits + 100);
+        BEAST_EXPECT(s1.misses == s0.misses);
+    #endif
+
+        // elements fill their size class
+        {
+            slab_multi_buffer b;
+            b.prepare(100);
+            auto const c = b.capacity();
+            BEAST_EXPECT(c > 512 && c < 1024);
+            b.commit(100);
+            BEAST_EXPECT(b.capacity() == c);
+
+            // the slack is used before allocating again
+            b.prepare(c - 100);
+            BEAST_EXPECT(b.capacity() == c);
+            b.commit(c - 100);
+            BEAST_EXPECT(b.size() == c);
+
+            // a large element fills its class
+            b.prepare(4096);
+            BEAST_EXPECT(b.capacity() > c + 4096);
+            BEAST_EXPECT(b.capacity() <= c + 16384);
+            auto const n = b.capacity() - c;
+            BEAST_EXPECT(buffer_size(b.prepare(n)) == n);
+            BEAST_EXPECT(b.capacity() == c + n);
+        }
+
+        // the limit is respected
+        {
+            slab_multi_buffer b(600);
+            b.prepare(100);
+            BEAST_EXPECT(b.capacity() == 512);
+        }
+
+        // multi_buffer is unchanged
+        {
+            multi_buffer b;
+            b.prepare(100);
+            BEAST_EXPECT(b.capacity() == 512);
+        }
+    }
+
+    void
+    run() override
+    {
+        testAllocator();
+        testMultiBuffer();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,core,slab_allocator);
+
+} // beast
+} // boost
@@ -0,0 +1,375 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+// Test that header file is self-contained.
+#include <boost/beast/core/spsc_buffer.hpp>
+
+#include "test_buffer.hpp"
+
+#include <boost/beast/core/buffer_size.hpp>
+#include <boost/beast/core/buffers_to_string.hpp>
+#include <boost/beast/core/string.hpp>
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <boost/asio/bind_executor.hpp>
+#include <boost/asio/error.hpp>
+#include <boost/asio/io_context.hpp>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace boost {
+namespace beast {
+
+class spsc_buffer_test : public beast::unit_test::suite
+{
+public:
+    BOOST_STATIC_ASSERT(
+        is_mutable_dynamic_buffer<
+            spsc_buffer<13>>::value);
+
+    BOOST_STATIC_ASSERT(
+        is_mutable_dynamic_buffer<
+            spsc_buffer_base>::value);
+
+    void
+    testDynamicBuffer()
+    {
+        test_dynamic_buffer(spsc_buffer<13>{});
+    }
+
+    // An executor which can fail to post, as when out of memory
+    class failing_executor
+    {
+        net::io_context* ioc_;
+        bool* fail_;
+
+    public:
+        failing_executor(net::io_context& ioc, bool& fail)
+            : ioc_(&ioc)
+            , fail_(&fail)
+        {
+        }
+
+        net::io_context&
+        context() const noexcept
+        {
+            return *ioc_;
+        }
+
+        void
+        on_work_started() const noexcept
+        {
+            ioc_->get_executor().on_work_started();
+        }
+
+        void
+        on_work_finished() const noexcept
+        {
+            ioc_->get_executor().on_work_finished();
+        }
+
+        template<class F, class Alloc>
+        void
+        dispatch(F&& f, Alloc const& a) const
+        {
+            post(std::forward<F>(f), a);
+        }
+
+        template<class F, class Alloc>
+        void
+        post(F&& f, Alloc const& a) const
+        {
+            if(*fail_)
+                throw std::bad_alloc{};
+            ioc_->get_executor().post(std::forward<F>(f), a);
+        }
+
+        template<class F, class Alloc>
+        void
+        defer(F&& f, Alloc const& a) const
+        {
+            post(std::forward<F>(f), a);
+        }
+
+        friend
+        bool
+        operator==(
+            failing_executor const& lhs,
+            failing_executor const& rhs) noexcept
+        {
+            return lhs.ioc_ == rhs.ioc_;
+        }
+
+        friend
+        bool
+        operator!=(
+            failing_executor const& lhs,
+            failing_executor const& rhs) noexcept
+        {
+            return lhs.ioc_ != rhs.ioc_;
+        }
+    };
+
+    static
+    void
+    write(spsc_buffer_base& b, string_view s)
+    {
+        b.commit(net::buffer_copy(b.prepare(s.size()),
+            net::const_buffer(s.data(), s.size())));
+    }
+
+    void
+    testMembers()
+    {
+        // wraparound
+        {
+            spsc_buffer<8> b;
+            BEAST_EXPECT(b.max_size() == 8);
+            BEAST_EXPECT(b.base().capacity() == 8);
+            write(b, "12345");
+            b.consume(4);
+            write(b, "6789ab");
+            BEAST_EXPECT(b.size() == 7);
+            BEAST_EXPECT(buffers_to_string(b.data()) == "56789ab");
+            BEAST_EXPECT(buffers_to_string(b.cdata()) == "56789ab");
+            try
+            {
+                b.prepare(2);
+                fail("missing exception", __FILE__, __LINE__);
+            }
+            catch(std::length_error const&)
+            {
+                pass();
+            }
+            b.consume(100);
+            BEAST_EXPECT(b.size() == 0);
+            BEAST_EXPECT(buffer_size(b.data()) == 0);
+            write(b, "12345678");
+            BEAST_EXPECT(buffers_to_string(b.data()) == "12345678");
+        }
+
+        // commit more than prepared
+        {
+            spsc_buffer<8> b;
+            b.prepare(3);
+            b.commit(5);
+            BEAST_EXPECT(b.size() == 3);
+            b.commit(1);
+            BEAST_EXPECT(b.size() == 3);
+        }
+    }
+
+    void
+    testWait()
+    {
+        net::io_context ioc;
+
+        // completes immediately, but not inline
+        {
+            spsc_buffer<16> b;
+            write(b, "*");
+            bool invoked = false;
+            b.async_wait(net::bind_executor(ioc,
+                [&](error_code ec)
+                {
+                    BEAST_EXPECTS(! ec, ec.message());
+                    invoked = true;
+                }));
+            BEAST_EXPECT(! invoked);
+            ioc.run();
+            ioc.restart();
+            BEAST_EXPECT(invoked);
+        }
+
+        // completes on commit
+        {
+            spsc_buffer<16> b;
+            bool invoked = false;
+            b.async_wait(net::bind_executor(ioc,
+                [&](error_code ec)
+                {
+                    BEAST_EXPECTS(! ec, ec.message());
+                    invoked = true;
+                }));
+            BEAST_EXPECT(ioc.poll() == 0);
+            write(b, "*");
+            BEAST_EXPECT(! invoked);
+            ioc.run();
+            ioc.restart();
+            BEAST_EXPECT(invoked);
+        }
+
+        // close
+        {
+            spsc_buffer<16> b;
+            bool invoked = false;
+            b.async_wait(net::bind_executor(ioc,
+                [&](error_code ec)
+                {
+                    BEAST_EXPECTS(ec == net::error::eof, ec.message());
+                    invoked = true;
+                }));
+            b.close();
+            BEAST_EXPECT(b.is_closed());
+            ioc.run();
+            ioc.restart();
+            BEAST_EXPECT(invoked);
+        }
+
+        // cancel
+        {
+            spsc_buffer<16> b;
+            bool invoked = false;
+            b.async_wait(net::bind_executor(ioc,
+                [&](error_code ec)
+                {
+                    BEAST_EXPECTS(ec ==
+                        net::error::operation_aborted, ec.message());
+                    invoked = true;
+                }));
+            b.cancel();
+            ioc.run();
+            ioc.restart();
+            BEAST_EXPECT(invoked);
+        }
+
+        // failure to post the completion on commit
+        {
+            spsc_buffer<16> b;
+            bool bad = false;
+            bool invoked = false;
+            b.async_wait(net::bind_executor(
+                failing_executor(ioc, bad),
+                [&](error_code ec)
+                {
+                    BEAST_EXPECTS(! ec, ec.message());
+                    invoked = true;
+                }));
+            BEAST_EXPECT(ioc.poll() == 0);
+            bad = true;
+            try
+            {
+                write(b, "*");
+                fail("", __FILE__, __LINE__);
+            }
+            catch(std::bad_alloc const&)
+            {
+                pass();
+            }
+            // the bytes are committed, and the
+            // failed wait no longer keeps ioc busy
+            BEAST_EXPECT(b.size() == 1);
+            ioc.restart();
+            BEAST_EXPECT(ioc.run() == 0);
+            BEAST_EXPECT(! invoked);
+
+            // the next wait works
+            bad = false;
+            b.async_wait(net::bind_executor(
+                failing_executor(ioc, bad),
+                [&](error_code ec)
+                {
+                    BEAST_EXPECTS(! ec, ec.message());
+                    invoked = true;
+                }));
+            ioc.restart();
+            ioc.run();
+            ioc.restart();
+            BEAST_EXPECT(invoked);
+        }
+    }
+
+    // One thread writes a pattern, the other
+    // waits for it asynchronously and checks it.
+    void
+    testThreads()
+    {
+        std::size_t const total = 4 * 1024 * 1024;
+        auto const at =
+            [](std::size_t i)
+            {
+                return static_cast<char>((i * 7 + i / 251) & 0xff);
+            };
+        spsc_buffer<4096> b;
+        std::thread t(
+            [&]
+            {
+                char chunk[1000];
+                std::size_t i = 0;
+                while(i < total)
+                {
+                    auto const n = (std::min)((std::min)(
+                        sizeof(chunk), total - i),
+                        b.capacity() - b.size());
+                    if(n == 0)
+                    {
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    for(std::size_t j = 0; j < n; ++j)
+                        chunk[j] = at(i + j);
+                    b.commit(net::buffer_copy(
+                        b.prepare(n), net::buffer(chunk, n)));
+                    i += n;
+                }
+                b.close();
+            });
+
+        net::io_context ioc;
+        std::size_t i = 0;
+        std::size_t waits = 0;
+        bool ok = true;
+        error_code result;
+        std::function<void(error_code)> on_wait =
+            [&](error_code ec)
+            {
+                ++waits;
+                if(ec)
+                {
+                    result = ec;
+                    return;
+                }
+                for(auto const buf : b.data())
+                {
+                    auto const p = static_cast<
+                        char const*>(buf.data());
+                    for(std::size_t j = 0; j < buf.size(); ++j)
+                        if(p[j] != at(i + j))
+                            ok = false;
+                    i += buf.size();
+                    b.consume(buf.size());
+                }
+                b.async_wait(net::bind_executor(ioc, on_wait));
+            };
+        b.async_wait(net::bind_executor(ioc, on_wait));
+        ioc.run();
+        t.join();
+        BEAST_EXPECT(ok);
+        BEAST_EXPECT(i == total);
+        BEAST_EXPECT(result == net::error::eof);
+        BEAST_EXPECT(waits > 1);
+    }
+
+    void
+    run() override
+    {
+        testDynamicBuffer();
+        testMembers();
+        testWait();
+        testThreads();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,core,spsc_buffer);
+
+} // beast
+} // boost
@@ -0,0 +1,234 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+// Test that header file is self-contained.
+#include <boost/beast/core/timeout_wheel.hpp>
+
+#include <boost/beast/core/basic_stream.hpp>
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/write.hpp>
+#include <vector>
+
+namespace boost {
+namespace beast {
+
+class timeout_wheel_test : public beast::unit_test::suite
+{
+public:
+    using clock_type = std::chrono::steady_clock;
+    using ms = std::chrono::milliseconds;
+    using tcp = net::ip::tcp;
+
+    struct timed_entry : detail::timeout_entry
+    {
+        clock_type::time_point fired;
+        std::vector<int>* order = nullptr;
+        int id = 0;
+
+        timed_entry(std::vector<int>& v, int id_)
+            : order(&v)
+            , id(id_)
+        {
+            expire =
+                [](detail::timeout_entry& e)
+                {
+                    auto& self = static_cast<timed_entry&>(e);
+                    self.fired = clock_type::now();
+                    self.order->push_back(self.id);
+                };
+        }
+    };
+
+    void
+    testWheel()
+    {
+        // expires in order, never early, stops when empty
+        {
+            net::io_context ioc;
+            auto const wp = boost::make_shared<
+                detail::timeout_wheel_impl>(
+                    ioc.get_executor(), ms(5), 8);
+            auto& w = *wp;
+            std::vector<int> v;
+            timed_entry e1(v, 1);
+            timed_entry e2(v, 2);
+            timed_entry e3(v, 3);
+            timed_entry e4(v, 4);
+            auto const t0 = clock_type::now();
+            w.insert(e2, t0 + ms(30));
+            w.insert(e1, t0 + ms(10));
+            w.insert(e3, t0 - ms(10));
+            // beyond one revolution of the wheel
+            w.insert(e4, t0 + ms(100));
+            BEAST_EXPECT(w.size == 4);
+            ioc.run();
+            BEAST_EXPECT(w.size == 0);
+            BEAST_EXPECT((v == std::vector<int>{3, 1, 2, 4}));
+            BEAST_EXPECT(e1.fired >= t0 + ms(10));
+            BEAST_EXPECT(e2.fired >= t0 + ms(30));
+            BEAST_EXPECT(e4.fired >= t0 + ms(100));
+            BEAST_EXPECT(! e1.linked());
+        }
+
+        // removed entries do not expire
+        {
+            net::io_context ioc;
+            auto const wp = boost::make_shared<
+                detail::timeout_wheel_impl>(
+                    ioc.get_executor(), ms(5), 8);
+            auto& w = *wp;
+            std::vector<int> v;
+            timed_entry e1(v, 1);
+            timed_entry e2(v, 2);
+            auto const t0 = clock_type::now();
+            w.insert(e1, t0 + ms(10));
+            w.insert(e2, t0 + ms(10));
+            BEAST_EXPECT(w.remove(e1));
+            BEAST_EXPECT(! w.remove(e1));
+            {
+                timed_entry e3(v, 3);
+                w.insert(e3, t0 + ms(10));
+            }
+            BEAST_EXPECT(w.size == 1);
+            ioc.run();
+            BEAST_EXPECT((v == std::vector<int>{2}));
+            BEAST_EXPECT(! w.remove(e2));
+
+            // the wheel restarts after going idle
+            w.insert(e1, clock_type::now() + ms(10));
+            ioc.restart();
+            ioc.run();
+            BEAST_EXPECT((v == std::vector<int>{2, 1}));
+        }
+
+        // destroying the wheel drops pending entries
+        {
+            net::io_context ioc;
+            std::vector<int> v;
+            timed_entry e1(v, 1);
+            {
+                auto const wp = boost::make_shared<
+                    detail::timeout_wheel_impl>(
+                        ioc.get_executor(), ms(5), 8);
+                wp->insert(e1, clock_type::now() + ms(10));
+                BEAST_EXPECT(e1.linked());
+            }
+            BEAST_EXPECT(! e1.linked());
+            ioc.run();
+            BEAST_EXPECT(v.empty());
+        }
+
+        {
+            net::io_context ioc;
+            timeout_wheel w(ioc.get_executor(), ms(5));
+            BEAST_EXPECT(w.granularity() == ms(5));
+            BEAST_EXPECT(w.size() == 0);
+        }
+    }
+
+    void
+    testStream()
+    {
+        using stream_type = basic_stream<tcp,
+            net::io_context::executor_type>;
+
+        net::io_context ioc;
+        timeout_wheel wheel(ioc.get_executor(), ms(10));
+        tcp::acceptor a(ioc, tcp::endpoint(
+            net::ip::make_address("127.0.0.1"), 0));
+        tcp::socket server(ioc);
+        stream_type s(ioc.get_executor());
+        s.use_timeout_wheel(&wheel);
+        s.socket().connect(a.local_endpoint());
+        a.accept(server);
+
+        // completes before the timeout
+        {
+            char buf[1];
+            bool invoked = false;
+            net::write(server, net::buffer("*", 1));
+            s.expires_after(std::chrono::seconds(30));
+            s.async_read_some(net::buffer(buf),
+                [&](error_code ec, std::size_t n)
+                {
+                    invoked = true;
+                    BEAST_EXPECTS(! ec, ec.message());
+                    BEAST_EXPECT(n == 1);
+                });
+            BEAST_EXPECT(wheel.size() == 1);
+            ioc.run();
+            BEAST_EXPECT(invoked);
+            BEAST_EXPECT(wheel.size() == 0);
+        }
+
+        // times out
+        {
+            char buf[1];
+            bool invoked = false;
+            auto const t0 = clock_type::now();
+            s.expires_after(ms(30));
+            s.async_read_some(net::buffer(buf),
+                [&](error_code ec, std::size_t)
+                {
+                    invoked = true;
+                    BEAST_EXPECTS(
+                        ec == error::timeout, ec.message());
+                });
+            ioc.restart();
+            ioc.run();
+            BEAST_EXPECT(invoked);
+            BEAST_EXPECT(clock_type::now() >= t0 + ms(30));
+            BEAST_EXPECT(! s.socket().is_open());
+            BEAST_EXPECT(wheel.size() == 0);
+        }
+
+        // back to the stream's own timers
+        s.use_timeout_wheel(nullptr);
+
+        // the stream keeps the wheel alive
+        {
+            tcp::socket server2(ioc);
+            stream_type s2(ioc.get_executor());
+            {
+                timeout_wheel w(ioc.get_executor(), ms(10));
+                s2.use_timeout_wheel(&w);
+            }
+            s2.socket().connect(a.local_endpoint());
+            a.accept(server2);
+            char buf[1];
+            bool invoked = false;
+            s2.expires_after(ms(30));
+            s2.async_read_some(net::buffer(buf),
+                [&](error_code ec, std::size_t)
+                {
+                    invoked = true;
+                    BEAST_EXPECTS(
+                        ec == error::timeout, ec.message());
+                });
+            ioc.restart();
+            ioc.run();
+            BEAST_EXPECT(invoked);
+            BEAST_EXPECT(! s2.socket().is_open());
+        }
+    }
+
+    void
+    run() override
+    {
+        testWheel();
+        testStream();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,core,timeout_wheel);
+
+} // beast
+} // boost
@@ -0,0 +1,512 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+// Test that header file is self-contained.
+#include <boost/beast/_experimental/core/proxy_protocol_stream.hpp>
+
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <boost/beast/http/read.hpp>
+#include <boost/beast/http/string_body.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/write.hpp>
+#include <array>
+#include <string>
+
+namespace boost {
+namespace beast {
+
+class proxy_protocol_stream_test : public unit_test::suite
+{
+public:
+    using tcp = net::ip::tcp;
+    using socket_type = net::basic_stream_socket<
+        tcp, net::io_context::executor_type>;
+    using stream_type = proxy_protocol_stream<socket_type>;
+
+    static
+    std::size_t
+    parse(string_view s, detail::proxy_header& h, error_code& ec)
+    {
+        return detail::parse_proxy_header(
+            reinterpret_cast<unsigned char const*>(s.data()),
+            s.size(), h, ec);
+    }
+
+    // A version 2 header for 192.168.0.1:56324 -> 192.168.0.11:443
+    static
+    std::string
+    v2_inet(string_view tlvs = {})
+    {
+        std::string s("\r\n\r\n\0\r\nQUIT\n", 12);
+        s += '\x21';
+        s += '\x11';
+        auto const len = 12 + tlvs.size();
+        s += static_cast<char>(len >> 8);
+        s += static_cast<char>(len & 0xff);
+        s.append("\xc0\xa8\x00\x01" "\xc0\xa8\x00\x0b"
+            "\xdc\x04" "\x01\xbb", 12);
+        s.append(tlvs.data(), tlvs.size());
+        return s;
+    }
+
+    void
+    testParseV1()
+    {
+        auto const good =
+            [&](string_view s)
+            {
+                detail::proxy_header h;
+                error_code ec;
+                BEAST_EXPECTS(parse(s, h, ec) == s.size(), s);
+                BEAST_EXPECTS(! ec, ec.message());
+                BEAST_EXPECT(h.version == 1);
+                return h;
+            };
+
+        auto const bad =
+            [&](string_view s)
+            {
+                detail::proxy_header h;
+                error_code ec;
+                BEAST_EXPECTS(parse(s, h, ec) == 0, s);
+                BEAST_EXPECTS(ec == proxy_protocol_error::bad_header, s);
+            };
+
+        auto const more =
+            [&](string_view s)
+            {
+                detail::proxy_header h;
+                error_code ec;
+                BEAST_EXPECTS(parse(s, h, ec) == 0, s);
+                BEAST_EXPECTS(! ec, s);
+            };
+
+        {
+            auto const h = good(
+                "PROXY TCP4 192.168.0.1 192.168.0.11 56324 443\r\n");
+            BEAST_EXPECT(! h.local);
+            BEAST_EXPECT(h.source == tcp::endpoint(
+                net::ip::make_address("192.168.0.1"), 56324));
+            BEAST_EXPECT(h.destination == tcp::endpoint(
+                net::ip::make_address("192.168.0.11"), 443));
+        }
+        {
+            auto const h = good(
+                "PROXY TCP6 2001:db8::1 ::1 65535 0\r\n");
+            BEAST_EXPECT(! h.local);
+            BEAST_EXPECT(h.source == tcp::endpoint(
+                net::ip::make_address("2001:db8::1"), 65535));
+            BEAST_EXPECT(h.destination.port() == 0);
+        }
+        BEAST_EXPECT(good("PROXY UNKNOWN\r\n").local);
+        BEAST_EXPECT(good(
+            "PROXY UNKNOWN ffff:f...f:ffff 1 2 3 4\r\n").local);
+
+        // only the header is used
+        {
+            detail::proxy_header h;
+            error_code ec;
+            string_view const s =
+                "PROXY TCP4 1.2.3.4 5.6.7.8 1 2\r\nGET / HTTP/1.1\r\n";
+            BEAST_EXPECT(parse(s, h, ec) == 32);
+            BEAST_EXPECTS(! ec, ec.message());
+        }
+
+        more("P");
+        more("PROXY");
+        more("PROXY TCP4 192.168.0.1 192.168.0.11 56324 443\r");
+        bad("PROXI ");
+        bad("GET / HTTP/1.1\r\n");
+        bad(std::string("PROXY ") + std::string(101, 'x'));
+        bad("PROXY TCP4 192.168.0.1 192.168.0.11 56324\r\n");
+        bad("PROXY TCP4 192.168.0.1 192.168.0.11 56324 443 1\r\n");
+        bad("PROXY TCP4  192.168.0.1 192.168.0.11 56324 443\r\n");
+        bad("PROXY TCP4 192.168.0.1 192.168.0.11 65536 443\r\n");
+        bad("PROXY TCP4 192.168.0.1 192.168.0.11 -1 443\r\n");
+        bad("PROXY TCP4 ::1 192.168.0.11 56324 443\r\n");
+        bad("PROXY TCP6 192.168.0.1 ::1 56324 443\r\n");
+        bad("PROXY UDP4 192.168.0.1 192.168.0.11 56324 443\r\n");
+    }
+
+    void
+    testParseV2()
+    {
+        // inet, with TLVs
+        {
+            std::string const tlvs(
+                "\x01\x00\x02" "h2"
+                "\x05\x00\x03" "abc", 11);
+            auto const s = v2_inet(tlvs);
+            detail::proxy_header h;
+            error_code ec;
+            BEAST_EXPECT(parse(s, h, ec) == s.size());
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(h.version == 2);
+            BEAST_EXPECT(! h.local);
+            BEAST_EXPECT(h.source == tcp::endpoint(
+                net::ip::make_address("192.168.0.1"), 56324));
+            BEAST_EXPECT(h.destination == tcp::endpoint(
+                net::ip::make_address("192.168.0.11"), 443));
+            BEAST_EXPECT(*detail::find_proxy_tlv(h.tlvs, 1) == "h2");
+            BEAST_EXPECT(*detail::find_proxy_tlv(h.tlvs, 5) == "abc");
+            BEAST_EXPECT(! detail::find_proxy_tlv(h.tlvs, 2));
+
+            // every prefix needs more
+            for(std::size_t i = 0; i < s.size(); ++i)
+            {
+                BEAST_EXPECT(parse(s.substr(0, i), h, ec) == 0);
+                BEAST_EXPECTS(! ec, ec.message());
+            }
+        }
+
+        // inet6
+        {
+            std::string s("\r\n\r\n\0\r\nQUIT\n\x21\x21\x00\x24", 16);
+            s.append(15, '\0');
+            s += '\x01';
+            s += '\xfe';
+            s += '\x80';
+            s.append(14, '\0');
+            s.append("\x00\x50" "\x00\x51", 4);
+            detail::proxy_header h;
+            error_code ec;
+            BEAST_EXPECT(parse(s, h, ec) == s.size());
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(! h.local);
+            BEAST_EXPECT(h.source == tcp::endpoint(
+                net::ip::make_address("::1"), 80));
+            BEAST_EXPECT(h.destination == tcp::endpoint(
+                net::ip::make_address("fe80::"), 81));
+        }
+
+        // LOCAL command, the addresses are ignored
+        {
+            auto s = v2_inet();
+            s[12] = '\x20';
+            detail::proxy_header h;
+            error_code ec;
+            BEAST_EXPECT(parse(s, h, ec) == s.size());
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(h.local);
+        }
+
+        // UNSPEC, no addresses
+        {
+            std::string const s(
+                "\r\n\r\n\0\r\nQUIT\n\x21\x00\x00\x00", 16);
+            detail::proxy_header h;
+            error_code ec;
+            BEAST_EXPECT(parse(s, h, ec) == s.size());
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(h.local);
+        }
+
+        auto const bad =
+            [&](std::string const& s)
+            {
+                detail::proxy_header h;
+                error_code ec;
+                BEAST_EXPECT(parse(s, h, ec) == 0);
+                BEAST_EXPECT(ec == proxy_protocol_error::bad_header);
+            };
+
+        // bad signature
+        {
+            auto s = v2_inet();
+            s[11] = 'X';
+            bad(s);
+        }
+
+        // bad version, bad command
+        {
+            auto s = v2_inet();
+            s[12] = '\x11';
+            bad(s);
+            s[12] = '\x22';
+            bad(s);
+        }
+
+        // bad family
+        {
+            auto s = v2_inet();
+            s[13] = '\x41';
+            bad(s);
+        }
+
+        // addresses do not fit
+        {
+            std::string const s(
+                "\r\n\r\n\0\r\nQUIT\n\x21\x11\x00\x04"
+                "\x01\x02\x03\x04", 20);
+            bad(s);
+        }
+
+        // TLV does not fit
+        bad(v2_inet(string_view("\x01\x00\x03" "h2", 5)));
+        bad(v2_inet(string_view("\x01\x00", 2)));
+    }
+
+    void
+    testMoveFront()
+    {
+        char buf[10] = {'0','1','2','3','4','5','6','7','8','9'};
+        std::array<net::mutable_buffer, 3> bs;
+        bs[0] = net::mutable_buffer(buf, 3);
+        bs[1] = net::mutable_buffer(buf + 3, 3);
+        bs[2] = net::mutable_buffer(buf + 6, 4);
+        buffers_suffix<std::array<net::mutable_buffer, 3>> rest(bs);
+        rest.consume(4);
+        BEAST_EXPECT(detail::buffer_move_front(bs, rest) == 6);
+        BEAST_EXPECT(std::string(buf, 6) == "456789");
+    }
+
+    // Make a connected pair of sockets
+    static
+    void
+    connect(net::io_context& ioc, stream_type& s1, socket_type& s2)
+    {
+        tcp::acceptor a(ioc, tcp::endpoint(
+            net::ip::make_address("127.0.0.1"), 0));
+        s2.connect(a.local_endpoint());
+        a.accept(s1.next_layer());
+    }
+
+    void
+    testRead()
+    {
+        net::io_context ioc;
+        string_view const v1 =
+            "PROXY TCP4 192.168.0.1 192.168.0.11 56324 443\r\n";
+
+        // header and data in one read
+        {
+            stream_type s1(ioc.get_executor());
+            socket_type s2(ioc.get_executor());
+            connect(ioc, s1, s2);
+            net::write(s2, net::buffer(
+                v1.to_string() + "Hello, world!"));
+            BEAST_EXPECT(! s1.is_header_done());
+            BEAST_EXPECT(s1.version() == 0);
+            char buf[100];
+            auto const n = s1.read_some(net::buffer(buf));
+            BEAST_EXPECT(string_view(buf, n) == "Hello, world!");
+            BEAST_EXPECT(s1.is_header_done());
+            BEAST_EXPECT(s1.version() == 1);
+            BEAST_EXPECT(! s1.is_local());
+            BEAST_EXPECT(s1.source() == tcp::endpoint(
+                net::ip::make_address("192.168.0.1"), 56324));
+            BEAST_EXPECT(s1.destination() == tcp::endpoint(
+                net::ip::make_address("192.168.0.11"), 443));
+
+            // later reads go straight to the next layer
+            net::write(s2, net::buffer("*", 1));
+            BEAST_EXPECT(s1.read_some(net::buffer(buf)) == 1);
+            BEAST_EXPECT(buf[0] == '*');
+        }
+
+        // header spans the caller's buffers
+        {
+            stream_type s1(ioc.get_executor());
+            socket_type s2(ioc.get_executor());
+            connect(ioc, s1, s2);
+            net::write(s2, net::buffer(
+                v2_inet(string_view("\x02\x00\x03" "foo", 6)) + "body"));
+            char buf[40];
+            std::array<net::mutable_buffer, 2> bs;
+            bs[0] = net::mutable_buffer(buf, 10);
+            bs[1] = net::mutable_buffer(buf + 10, 30);
+            std::string got;
+            while(got.size() < 4)
+            {
+                auto const n = s1.read_some(bs);
+                got.append(buf, n);
+            }
+            BEAST_EXPECT(got == "body");
+            BEAST_EXPECT(s1.version() == 2);
+            BEAST_EXPECT(*s1.tlv(2) == "foo");
+            BEAST_EXPECT(! s1.tlv(1));
+        }
+
+        // header larger than the caller's buffer
+        {
+            stream_type s1(ioc.get_executor());
+            socket_type s2(ioc.get_executor());
+            connect(ioc, s1, s2);
+            net::write(s2, net::buffer(
+                v1.to_string() + "Hello, world!"));
+            std::string got;
+            char buf[5];
+            while(got.size() < 13)
+            {
+                auto const n = s1.read_some(net::buffer(buf));
+                got.append(buf, n);
+            }
+            BEAST_EXPECT(got == "Hello, world!");
+            BEAST_EXPECT(! s1.is_local());
+        }
+
+        // bad header
+        {
+            stream_type s1(ioc.get_executor());
+            socket_type s2(ioc.get_executor());
+            connect(ioc, s1, s2);
+            net::write(s2, net::buffer("GET / HTTP/1.1\r\n", 16));
+            char buf[100];
+            error_code ec;
+            s1.read_some(net::buffer(buf), ec);
+            BEAST_EXPECT(ec == proxy_protocol_error::bad_header);
+        }
+
+        // eof before the end of the header
+        {
+            stream_type s1(ioc.get_executor());
+            socket_type s2(ioc.get_executor());
+            connect(ioc, s1, s2);
+            net::write(s2, net::buffer("PROXY TCP4", 10));
+            s2.close();
+            char buf[100];
+            error_code ec;
+            s1.read_some(net::buffer(buf), ec);
+            BEAST_EXPECT(ec == net::error::eof);
+            BEAST_EXPECT(! s1.is_header_done());
+        }
+
+        // http::read through the stream
+        {
+            stream_type s1(ioc.get_executor());
+            socket_type s2(ioc.get_executor());
+            connect(ioc, s1, s2);
+            net::write(s2, net::buffer(v1.to_string() +
+                "GET / HTTP/1.1\r\nHost: www.example.com\r\n\r\n"));
+            flat_buffer b;
+            http::request<http::string_body> req;
+            http::read(s1, b, req);
+            BEAST_EXPECT(req.target() == "/");
+            BEAST_EXPECT(s1.source().port() == 56324);
+        }
+    }
+
+    void
+    testAsyncRead()
+    {
+        net::io_context ioc;
+
+        {
+            stream_type s1(ioc.get_executor());
+            socket_type s2(ioc.get_executor());
+            connect(ioc, s1, s2);
+            net::write(s2, net::buffer(v2_inet() + "Hello"));
+            char buf[100];
+            bool invoked = false;
+            s1.async_read_some(net::buffer(buf),
+                [&](error_code ec, std::size_t n)
+                {
+                    invoked = true;
+                    BEAST_EXPECTS(! ec, ec.message());
+                    BEAST_EXPECT(string_view(buf, n) == "Hello");
+                });
+            BEAST_EXPECT(! invoked);
+            ioc.run();
+            BEAST_EXPECT(invoked);
+            BEAST_EXPECT(s1.version() == 2);
+            BEAST_EXPECT(s1.source().port() == 56324);
+        }
+
+        // header alone, then data
+        {
+            stream_type s1(ioc.get_executor());
+            socket_type s2(ioc.get_executor());
+            connect(ioc, s1, s2);
+            net::write(s2, net::buffer(v2_inet()));
+            char buf[100];
+            std::size_t got = 0;
+            s1.async_read_some(net::buffer(buf),
+                [&](error_code ec, std::size_t n)
+                {
+                    BEAST_EXPECTS(! ec, ec.message());
+                    got = n;
+                });
+            ioc.restart();
+            ioc.poll();
+            BEAST_EXPECT(s1.is_header_done());
+            BEAST_EXPECT(got == 0);
+            net::write(s2, net::buffer("Hello", 5));
+            ioc.run();
+            BEAST_EXPECT(got == 5);
+        }
+
+        // small buffer
+        {
+            stream_type s1(ioc.get_executor());
+            socket_type s2(ioc.get_executor());
+            connect(ioc, s1, s2);
+            net::write(s2, net::buffer(v2_inet() + "Hello"));
+            char buf[4];
+            bool invoked = false;
+            s1.async_read_some(net::buffer(buf),
+                [&](error_code ec, std::size_t n)
+                {
+                    invoked = true;
+                    BEAST_EXPECTS(! ec, ec.message());
+                    BEAST_EXPECT(string_view(buf, n) == "Hell");
+                });
+            ioc.restart();
+            ioc.run();
+            BEAST_EXPECT(invoked);
+        }
+
+        // bad header
+        {
+            stream_type s1(ioc.get_executor());
+            socket_type s2(ioc.get_executor());
+            connect(ioc, s1, s2);
+            net::write(s2, net::buffer("\r\n\r\nX", 5));
+            char buf[100];
+            bool invoked = false;
+            s1.async_read_some(net::buffer(buf),
+                [&](error_code ec, std::size_t n)
+                {
+                    invoked = true;
+                    BEAST_EXPECT(ec == proxy_protocol_error::bad_header);
+                    BEAST_EXPECT(n == 0);
+                });
+            ioc.restart();
+            ioc.run();
+            BEAST_EXPECT(invoked);
+        }
+    }
+
+    void
+    testError()
+    {
+        error_code const ec = proxy_protocol_error::bad_header;
+        BEAST_EXPECT(std::string(ec.category().name()) ==
+            "boost.beast.proxy_protocol");
+        BEAST_EXPECT(! ec.message().empty());
+        BEAST_EXPECT(ec != error::timeout);
+        BEAST_EXPECT(ec != condition::timeout);
+    }
+
+    void
+    run() override
+    {
+        testError();
+        testParseV1();
+        testParseV2();
+        testMoveFront();
+        testRead();
+        testAsyncRead();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,experimental,proxy_protocol_stream);
+
+} // beast
+} // boost
@@ -12,4 +12,369 @@
 // Test that header file is self-contained.
 #include <boost/beast/_experimental/core/ssl_stream.hpp>
 
+#include "example/common/server_certificate.hpp"
+
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+#include <openssl/evp.h>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace boost {
+namespace beast {
+
+class ssl_stream_test : public beast::unit_test::suite
+{
+public:
+    using tcp = net::ip::tcp;
+    using socket_type = net::basic_stream_socket<
+        tcp, net::io_context::executor_type>;
+    using stream_type = ssl_stream<socket_type>;
+    using batch_stream_type = ssl_stream<socket_type, true>;
+
+    BOOST_STATIC_ASSERT(std::is_same<
+        stream_type::next_layer_type, socket_type>::value);
+    BOOST_STATIC_ASSERT(std::is_same<
+        batch_stream_type::next_layer_type, socket_type>::value);
+
+    // The streams copy the settings of
+    // the contexts when they are constructed.
+    struct contexts
+    {
+        net::ssl::context sctx{net::ssl::context::tls_server};
+        net::ssl::context cctx{net::ssl::context::tls_client};
+
+        contexts(
+            char const* ciphers,
+            bool tls13,
+            std::uint8_t fragment = 0)
+        {
+            load_server_certificate(sctx);
+            if(fragment)
+                SSL_CTX_set_tlsext_max_fragment_length(
+                    cctx.native_handle(), fragment);
+            if(tls13)
+            {
+                SSL_CTX_set_min_proto_version(
+                    sctx.native_handle(), TLS1_3_VERSION);
+            }
+            else
+            {
+                SSL_CTX_set_max_proto_version(
+                    sctx.native_handle(), TLS1_2_VERSION);
+                SSL_CTX_set_cipher_list(
+                    sctx.native_handle(), ciphers);
+            }
+        }
+    };
+
+    template<class Stream>
+    struct basic_connection : contexts
+    {
+        Stream server;
+        Stream client;
+
+        basic_connection(
+            net::io_context& ioc,
+            char const* ciphers,
+            bool tls13,
+            std::uint8_t fragment = 0)
+            : contexts(ciphers, tls13, fragment)
+            , server(ioc.get_executor(), sctx)
+            , client(ioc.get_executor(), cctx)
+        {
+            tcp::acceptor a(ioc, tcp::endpoint(
+                net::ip::make_address("127.0.0.1"), 0));
+            client.next_layer().connect(a.local_endpoint());
+            a.accept(server.next_layer());
+            error_code ec1;
+            error_code ec2;
+            server.async_handshake(Stream::server,
+                [&ec1](error_code ec)
+                {
+                    ec1 = ec;
+                });
+            client.async_handshake(Stream::client,
+                [&ec2](error_code ec)
+                {
+                    ec2 = ec;
+                });
+            ioc.run();
+            ioc.restart();
+            if(ec1 || ec2)
+                throw system_error{ec1 ? ec1 : ec2};
+        }
+    };
+
+    using connection = basic_connection<stream_type>;
+
+    // Seal one application data record as the kernel would
+    static
+    std::string
+    seal(detail::ktls_crypto const& c, std::string const& s)
+    {
+        unsigned char nonce[12];
+        std::memcpy(nonce, c.salt, 4);
+        std::memcpy(nonce + 4, c.iv, 8);
+        unsigned char aad[13];
+        std::memcpy(aad, c.rec_seq, 8);
+        aad[8] = 23;
+        aad[9] = 3;
+        aad[10] = 3;
+        aad[11] = static_cast<unsigned char>(s.size() >> 8);
+        aad[12] = static_cast<unsigned char>(s.size());
+
+        std::string out(5 + 8 + s.size() + 16, '\0');
+        auto p = reinterpret_cast<unsigned char*>(&out[0]);
+        auto const n = 8 + s.size() + 16;
+        p[0] = 23;
+        p[1] = 3;
+        p[2] = 3;
+        p[3] = static_cast<unsigned char>(n >> 8);
+        p[4] = static_cast<unsigned char>(n);
+        std::memcpy(p + 5, c.iv, 8);
+
+        auto const ctx = EVP_CIPHER_CTX_new();
+        int len = 0;
+        EVP_EncryptInit_ex(ctx, c.key_size == 16 ?
+            EVP_aes_128_gcm() : EVP_aes_256_gcm(),
+            nullptr, c.key, nonce);
+        EVP_EncryptUpdate(ctx, nullptr, &len, aad, sizeof(aad));
+        EVP_EncryptUpdate(ctx, p + 13, &len,
+            reinterpret_cast<unsigned char const*>(s.data()),
+            static_cast<int>(s.size()));
+        EVP_EncryptFinal_ex(ctx, p + 13 + len, &len);
+        EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_GET_TAG,
+            16, p + 13 + s.size());
+        EVP_CIPHER_CTX_free(ctx);
+        return out;
+    }
+
+    template<class Stream>
+    static
+    std::string
+    read_string(Stream& s, std::size_t n)
+    {
+        std::string out(n, '\0');
+        net::read(s, net::buffer(&out[0], n));
+        return out;
+    }
+
+    void
+    testCrypto(char const* ciphers, std::size_t key_size)
+    {
+        // Records sealed with the derived state
+        // are accepted by the peer, in both roles.
+        net::io_context ioc;
+        connection c(ioc, ciphers, false);
+        for(auto p : {&c.server, &c.client})
+        {
+            auto& from = *p;
+            auto& to = p == &c.server ? c.client : c.server;
+            detail::ktls_crypto k;
+            error_code ec;
+            detail::ktls_write_crypto(from.native_handle(), k, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(k.key_size == key_size);
+            std::string const s = "Hello, world!";
+            net::write(from.next_layer(),
+                net::buffer(seal(k, s)));
+            BEAST_EXPECT(read_string(to, s.size()) == s);
+        }
+    }
+
+    void
+    testSend()
+    {
+        net::io_context ioc;
+        connection c(ioc, "ECDHE-RSA-AES128-GCM-SHA256", false);
+        error_code ec;
+        c.server.enable_ktls_send(ec);
+        if(ec)
+        {
+            // no kernel support, nothing changes
+            BEAST_EXPECTS(ec ==
+                net::error::operation_not_supported, ec.message());
+            BEAST_EXPECT(! c.server.is_ktls_send());
+        }
+        else
+        {
+            BEAST_EXPECT(c.server.is_ktls_send());
+        }
+        std::string const s(100000, '*');
+        net::write(c.server, net::buffer(s));
+        BEAST_EXPECT(read_string(c.client, s.size()) == s);
+        net::write(c.client, net::buffer(s));
+        BEAST_EXPECT(read_string(c.server, s.size()) == s);
+
+        c.server.async_shutdown(
+            [&](error_code ec)
+            {
+                BEAST_EXPECTS(! ec, ec.message());
+            });
+        c.client.async_shutdown(
+            [&](error_code ec)
+            {
+                BEAST_EXPECTS(! ec, ec.message());
+            });
+        ioc.run();
+    }
+
+    void
+    testUnsupported()
+    {
+        net::io_context ioc;
+        connection c(ioc, nullptr, true);
+        error_code ec;
+        c.server.enable_ktls_send(ec);
+        BEAST_EXPECT(ec == net::error::operation_not_supported);
+        BEAST_EXPECT(! c.server.is_ktls_send());
+        std::string const s = "Hello, world!";
+        net::write(c.server, net::buffer(s));
+        BEAST_EXPECT(read_string(c.client, s.size()) == s);
+    }
+
+    void
+    testFragment()
+    {
+        // Flattening stops at the negotiated
+        // maximum fragment length.
+        net::io_context ioc;
+        connection c(ioc, "ECDHE-RSA-AES128-GCM-SHA256",
+            false, TLSEXT_max_fragment_length_512);
+        std::string const s0(100, 'h');
+        std::string const s1(4000, 'b');
+        std::array<net::const_buffer, 2> bs;
+        bs[0] = net::buffer(s0);
+        bs[1] = net::buffer(s1);
+        error_code ec;
+        auto const n = c.server.write_some(bs, ec);
+        BEAST_EXPECTS(! ec, ec.message());
+        BEAST_EXPECT(n == 512);
+        BEAST_EXPECT(read_string(c.client, n) ==
+            s0 + s1.substr(0, n - s0.size()));
+
+    }
+
+    void
+    testBatch()
+    {
+        net::io_context ioc;
+        basic_connection<batch_stream_type> c(
+            ioc, "ECDHE-RSA-AES128-GCM-SHA256", false);
+        c.server.write_batch_bytes(64 * 1024);
+        BEAST_EXPECT(c.server.write_batch_bytes() == 64 * 1024);
+        std::string s(1000000, '\0');
+        for(std::size_t i = 0; i < s.size(); ++i)
+            s[i] = static_cast<char>(i % 251);
+
+        // synchronous
+        {
+            std::string got;
+            std::thread t(
+                [&]
+                {
+                    got = read_string(c.client, s.size());
+                });
+            net::write(c.server, net::buffer(s));
+            t.join();
+            BEAST_EXPECT(got == s);
+        }
+
+        // fits in one record
+        {
+            std::string const small = "Hello, world!";
+            net::write(c.server, net::buffer(small));
+            BEAST_EXPECT(read_string(c.client, small.size()) == small);
+        }
+
+        // asynchronous
+        {
+            std::string got(s.size(), '\0');
+            std::size_t written = 0;
+            net::async_write(c.server, net::buffer(s),
+                [&](error_code ec, std::size_t n)
+                {
+                    BEAST_EXPECTS(! ec, ec.message());
+                    written = n;
+                });
+            net::async_read(c.client, net::buffer(&got[0], got.size()),
+                [&](error_code ec, std::size_t)
+                {
+                    BEAST_EXPECTS(! ec, ec.message());
+                });
+            ioc.run();
+            BEAST_EXPECT(written == s.size());
+            BEAST_EXPECT(got == s);
+        }
+
+        // with a read in progress
+        {
+            std::string got(s.size(), '\0');
+            std::string const reply = "reply";
+            std::string echo(reply.size(), '\0');
+            std::size_t written = 0;
+            std::size_t read = 0;
+            ioc.restart();
+            net::async_read(c.server,
+                net::buffer(&echo[0], echo.size()),
+                [&](error_code ec, std::size_t n)
+                {
+                    BEAST_EXPECTS(! ec, ec.message());
+                    read = n;
+                });
+            net::async_write(c.server, net::buffer(s),
+                [&](error_code ec, std::size_t n)
+                {
+                    BEAST_EXPECTS(! ec, ec.message());
+                    written = n;
+                });
+            net::async_read(c.client, net::buffer(&got[0], got.size()),
+                [&](error_code ec, std::size_t)
+                {
+                    BEAST_EXPECTS(! ec, ec.message());
+                    net::async_write(c.client, net::buffer(reply),
+                        [&](error_code ec, std::size_t)
+                        {
+                            BEAST_EXPECTS(! ec, ec.message());
+                        });
+                });
+            ioc.run();
+            BEAST_EXPECT(written == s.size());
+            BEAST_EXPECT(got == s);
+            BEAST_EXPECT(read == reply.size());
+            BEAST_EXPECT(echo == reply);
+        }
+
+        // back to one write per record
+        c.server.write_batch_bytes(0);
+        net::write(c.server, net::buffer(s.data(), 100000));
+        BEAST_EXPECT(read_string(c.client, 100000) ==
+            s.substr(0, 100000));
+    }
+
+    void
+    run() override
+    {
+        testCrypto("ECDHE-RSA-AES128-GCM-SHA256", 16);
+        testCrypto("ECDHE-RSA-AES256-GCM-SHA384", 32);
+        testSend();
+        testUnsupported();
+        testFragment();
+        testBatch();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,experimental,ssl_stream);
+
+} // beast
+} // boost
+
 #endif
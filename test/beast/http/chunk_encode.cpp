@@ -18,6 +18,8 @@
 #include <boost/beast/test/fuzz.hpp>
 #include <boost/beast/_experimental/unit_test/suite.hpp>
 #include <boost/optional.hpp>
+#include <array>
+#include <limits>
 #include <random>
 
 namespace boost {
@@ -36,6 +38,28 @@ public:
     BOOST_STATIC_ASSERT(
         ! detail::is_chunk_extensions<not_chunk_extensions>::value);
 
+    BOOST_STATIC_ASSERT(
+        buffer_sequence_max_length<chunk_header>::value == 3);
+
+    BOOST_STATIC_ASSERT(buffer_sequence_max_length<
+        chunk_body<net::const_buffer>>::value == 5);
+
+    BOOST_STATIC_ASSERT(buffer_sequence_max_length<
+        chunk_body<std::array<net::const_buffer, 2>>>::value == 6);
+
+    BOOST_STATIC_ASSERT(
+        buffer_sequence_max_length<chunk_crlf>::value == 1);
+
+    BOOST_STATIC_ASSERT(
+        buffer_sequence_max_length<chunk_last<>>::value == 2);
+
+    BOOST_STATIC_ASSERT(buffer_sequence_max_length<
+        chunk_last<std::array<net::const_buffer, 2>>>::value == 3);
+
+    BOOST_STATIC_ASSERT(buffer_sequence_max_length<
+        chunk_last<fields>>::value ==
+            (std::numeric_limits<std::size_t>::max)());
+
     template<class T, class... Args>
     void
     check(string_view match, Args&&... args)
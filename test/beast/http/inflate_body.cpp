@@ -0,0 +1,384 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+// Test that header file is self-contained.
+#include <boost/beast/http/inflate_body.hpp>
+
+#include <boost/beast/http/buffer_body.hpp>
+#include <boost/beast/http/parser.hpp>
+#include <boost/beast/http/string_body.hpp>
+#include <boost/beast/zlib/deflate_stream.hpp>
+#include <boost/beast/zlib/detail/checksum.hpp>
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <random>
+#include <string>
+
+namespace boost {
+namespace beast {
+namespace http {
+
+BOOST_STATIC_ASSERT(is_body<inflate_body<string_body>>::value);
+BOOST_STATIC_ASSERT(is_body_reader<inflate_body<string_body>>::value);
+BOOST_STATIC_ASSERT(! is_body_writer<inflate_body<string_body>>::value);
+
+class inflate_body_test : public beast::unit_test::suite
+{
+public:
+    static
+    std::string
+    corpus(std::size_t n)
+    {
+        static std::string const alphabet{
+            "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz"
+        };
+        std::string s;
+        s.reserve(n + 5);
+        std::mt19937 g;
+        std::uniform_int_distribution<std::size_t> d0{
+            0, alphabet.size() - 1};
+        std::uniform_int_distribution<std::size_t> d1{
+            1, 5};
+        while(s.size() < n)
+        {
+            auto const rep = d1(g);
+            auto const ch = alphabet[d0(g)];
+            s.insert(s.end(), rep, ch);
+        }
+        s.resize(n);
+        return s;
+    }
+
+    static
+    std::string
+    compress(string_view s)
+    {
+        zlib::deflate_stream zo;
+        std::string out;
+        out.resize(zo.upper_bound(s.size()));
+        zlib::z_params zs;
+        zs.next_in = s.data();
+        zs.avail_in = s.size();
+        zs.next_out = &out[0];
+        zs.avail_out = out.size();
+        error_code ec;
+        zo.write(zs, zlib::Flush::finish, ec);
+        out.resize(zs.total_out);
+        return out;
+    }
+
+    static
+    std::string
+    request(string_view body,
+        string_view coding = "deflate")
+    {
+        std::string s = "POST / HTTP/1.1\r\n";
+        if(! coding.empty())
+            s += "Content-Encoding: " + std::string(coding) + "\r\n";
+        return s +
+            "Content-Length: " + std::to_string(body.size()) + "\r\n"
+            "\r\n" + std::string(body);
+    }
+
+    static
+    void
+    append_le32(std::string& s, std::uint32_t v)
+    {
+        for(int i = 0; i < 4; ++i)
+            s.push_back(static_cast<char>((v >> (8 * i)) & 0xff));
+    }
+
+    // gzip with every optional header field
+    static
+    std::string
+    gzip(string_view s)
+    {
+        std::string z(
+            "\x1f\x8b\x08\x1e\x00\x00\x00\x00\x00\xff", 10);
+        z.append("\x03\x00" "abc", 5);    // FEXTRA
+        z.append("name.txt", 9);        // FNAME
+        z.append("comment", 8);         // FCOMMENT
+        auto const hcrc = zlib::detail::crc32(0, z.data(), z.size());
+        z.push_back(static_cast<char>(hcrc & 0xff));
+        z.push_back(static_cast<char>((hcrc >> 8) & 0xff));
+        z += compress(s);
+        append_le32(z, zlib::detail::crc32(0, s.data(), s.size()));
+        append_le32(z, static_cast<std::uint32_t>(s.size()));
+        return z;
+    }
+
+    // feed the message to the parser in pieces of `step` octets
+    template<class Parser>
+    void
+    put(Parser& p, string_view s,
+        std::size_t step, error_code& ec)
+    {
+        std::size_t used = 0;
+        std::size_t avail = 0;
+        while(! p.is_done())
+        {
+            avail = (std::min)(avail + step, s.size() - used);
+            auto const n = p.put(net::const_buffer(
+                s.data() + used, avail), ec);
+            if(ec == error::need_more)
+            {
+                ec = {};
+                BEAST_EXPECT(used + avail < s.size());
+                continue;
+            }
+            if(ec)
+                return;
+            used += n;
+            avail -= n;
+        }
+    }
+
+    void
+    testInflate()
+    {
+        auto const s = corpus(100000);
+        auto const m = request(compress(s));
+        for(std::size_t step : {1, 7, 512, 100000})
+        {
+            request_parser<inflate_body<string_body>> p;
+            error_code ec;
+            put(p, m, step, ec);
+            if(! BEAST_EXPECTS(! ec, ec.message()))
+                continue;
+            BEAST_EXPECT(p.get().body().body() == s);
+        }
+    }
+
+    void
+    testChecksum()
+    {
+        using zlib::detail::adler32;
+        using zlib::detail::crc32;
+        BEAST_EXPECT(crc32(0, "123456789", 9) == 0xcbf43926);
+        BEAST_EXPECT(crc32(crc32(0, "1234", 4), "56789", 5) == 0xcbf43926);
+        BEAST_EXPECT(adler32(1, "Wikipedia", 9) == 0x11e60398);
+        BEAST_EXPECT(adler32(adler32(1, "Wiki", 4), "pedia", 5) == 0x11e60398);
+        std::string const big(100000, '\xff');
+        std::uint32_t a = 1;
+        for(auto c : big)
+            a = adler32(a, &c, 1);
+        BEAST_EXPECT(adler32(1, big.data(), big.size()) == a);
+    }
+
+    void
+    testFormats()
+    {
+        string_view const hello =
+            "Hello, world! Hello, world! Hello, world!\n";
+
+        // from Python's gzip module, with FNAME
+        string_view const gz(
+            "\x1f\x8b\x08\x08\x00\x00\x00\x00\x02\xff\x68\x65\x6c\x6c"
+            "\x6f\x2e\x74\x78\x74\x00\xf3\x48\xcd\xc9\xc9\xd7\x51\x28"
+            "\xcf\x2f\xca\x49\x51\x54\xf0\xc0\xcd\xe3\x02\x00\xb8\x9f"
+            "\xf2\x67\x2a\x00\x00\x00", 48);
+
+        // from Python's zlib module
+        string_view const zl(
+            "\x78\x9c\xf3\x48\xcd\xc9\xc9\xd7\x51\x28\xcf\x2f\xca\x49"
+            "\x51\x54\xf0\xc0\xcd\xe3\x02\x00\x32\xcb\x0d\xe6", 26);
+
+        auto const check =
+            [&](std::string const& m, string_view expected)
+            {
+                for(std::size_t step : {1, 3, 4096})
+                {
+                    request_parser<inflate_body<string_body>> p;
+                    error_code ec;
+                    put(p, m, step, ec);
+                    if(! BEAST_EXPECTS(! ec, ec.message()))
+                        continue;
+                    BEAST_EXPECT(p.get().body().body() == expected);
+                }
+            };
+
+        check(request(gz, "gzip"), hello);
+        check(request(gz, "x-gzip"), hello);
+        check(request(gz, "GZIP"), hello);
+        check(request(zl, "deflate"), hello);
+        check(request(compress(hello), "deflate"), hello);
+        check(request(compress(hello), ""), hello);
+
+        auto const s = corpus(100000);
+        check(request(gzip(s), "gzip"), s);
+    }
+
+    void
+    testInnerBuffer()
+    {
+        // The inner reader takes a few octets at a time
+        auto const s = corpus(50000);
+        for(auto const& m : {
+            request(compress(s), "deflate"),
+            request(gzip(s), "gzip")})
+        {
+            request_parser<inflate_body<buffer_body>> p;
+            std::string out;
+            char buf[100];
+            error_code ec;
+            auto used = p.put(net::const_buffer(
+                m.data(), m.size()), ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(p.is_header_done());
+            while(! p.is_done())
+            {
+                auto& b = p.get().body().body();
+                b.data = buf;
+                b.size = sizeof(buf);
+                // at most 1000 octets of input each time
+                auto const n = (std::min<std::size_t>)(
+                    1000, m.size() - used);
+                used += p.put(net::const_buffer(
+                    m.data() + used, n), ec);
+                out.append(buf, sizeof(buf) - b.size);
+                if(ec == error::need_buffer)
+                    ec = {};
+                if(! BEAST_EXPECTS(! ec, ec.message()))
+                    break;
+            }
+            BEAST_EXPECT(used == m.size());
+            BEAST_EXPECT(out == s);
+        }
+    }
+
+    void
+    testLimit()
+    {
+        auto const s = corpus(100000);
+        auto const m = request(compress(s));
+
+        // default request limit
+        {
+            auto const s1 = corpus(2 * 1024 * 1024);
+            request_parser<inflate_body<string_body>> p;
+            p.body_limit(2 * 1024 * 1024);
+            error_code ec;
+            put(p, request(compress(s1)), 4096, ec);
+            BEAST_EXPECTS(ec == error::body_limit, ec.message());
+        }
+
+        // limit exceeded
+        {
+            request_parser<inflate_body<string_body>> p;
+            p.get().body().body_limit(s.size() - 1);
+            error_code ec;
+            put(p, m, 4096, ec);
+            BEAST_EXPECTS(ec == error::body_limit, ec.message());
+        }
+
+        // exact limit
+        {
+            request_parser<inflate_body<string_body>> p;
+            p.get().body().body_limit(s.size());
+            error_code ec;
+            put(p, m, 4096, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(p.get().body().body() == s);
+        }
+    }
+
+    void
+    testErrors()
+    {
+        // truncated deflate stream
+        {
+            auto const s = corpus(1000);
+            auto z = compress(s);
+            z.resize(z.size() / 2);
+            request_parser<inflate_body<string_body>> p;
+            error_code ec;
+            put(p, request(z), 4096, ec);
+            BEAST_EXPECTS(ec == error::partial_message, ec.message());
+        }
+
+        // invalid deflate stream
+        {
+            request_parser<inflate_body<string_body>> p;
+            error_code ec;
+            put(p, request("\xff\xff\xff\xff"), 4096, ec);
+            BEAST_EXPECT(ec);
+        }
+
+        auto const fail =
+            [&](std::string const& m, error_code expected)
+            {
+                for(std::size_t step : {1, 4096})
+                {
+                    request_parser<inflate_body<string_body>> p;
+                    error_code ec;
+                    put(p, m, step, ec);
+                    BEAST_EXPECTS(ec == expected, ec.message());
+                }
+            };
+
+        auto const s = corpus(1000);
+        auto const gz = gzip(s);
+
+        // unsupported content coding
+        fail(request(compress(s), "br"), error::bad_value);
+
+        // bad gzip header
+        {
+            auto z = gz;
+            z[0] = 0;
+            fail(request(z, "gzip"), zlib::error::invalid_header);
+            z = gz;
+            z[3] = '\x3e'; // reserved flag
+            fail(request(z, "gzip"), zlib::error::invalid_header);
+            z = gz;
+            z[12] = 'x';    // covered by FHCRC
+            fail(request(z, "gzip"), zlib::error::invalid_header);
+        }
+
+        // zlib header with a preset dictionary
+        fail(request(std::string("\x78\xbb\x00\x00", 4), "deflate"),
+            zlib::error::invalid_header);
+
+        // bad trailer
+        {
+            auto z = gz;
+            z[z.size() - 8] ^= 1;   // crc
+            fail(request(z, "gzip"), zlib::error::invalid_checksum);
+            z = gz;
+            z[z.size() - 1] ^= 1;   // size
+            fail(request(z, "gzip"), zlib::error::invalid_checksum);
+            std::string zl = "\x78\x9c" + compress(s) + "abcd";
+            fail(request(zl, "deflate"), zlib::error::invalid_checksum);
+        }
+
+        // data after the end of the stream
+        fail(request(gz + "x", "gzip"), zlib::error::trailing_data);
+        fail(request(compress(s) + "x", ""), zlib::error::trailing_data);
+
+        // truncated trailer
+        fail(request(gz.substr(0, gz.size() - 3), "gzip"),
+            error::partial_message);
+    }
+
+    void
+    run() override
+    {
+        testChecksum();
+        testInflate();
+        testFormats();
+        testInnerBuffer();
+        testLimit();
+        testErrors();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,http,inflate_body);
+
+} // http
+} // beast
+} // boost
@@ -424,6 +424,67 @@ public:
         BEAST_EXPECTS(! ec, ec.message());
     }
 
+    void
+    testAdvisor()
+    {
+        std::string const body(100000, '*');
+        std::string const s =
+            "HTTP/1.1 200 OK\r\n"
+            "Content-Length: 100000\r\n"
+            "\r\n" + body;
+        read_size_advisor advisor;
+        BEAST_EXPECT(advisor.size() == 512);
+
+        // the advisor learns from a message
+        {
+            test::stream ts{ioc_, s};
+            flat_buffer b;
+            response_parser<string_body> p;
+            while(! p.is_done())
+                read_some(ts, b, p, advisor);
+            BEAST_EXPECT(p.get().body() == body);
+            BEAST_EXPECT(advisor.size() > 512);
+        }
+
+        // and sizes the first read of the next message
+        {
+            auto const n = advisor.size();
+            test::stream ts{ioc_, s};
+            flat_buffer b;
+            response_parser<string_body> p;
+            error_code ec;
+            BEAST_EXPECT(read_some(ts, b, p, advisor, ec) == n);
+            BEAST_EXPECTS(! ec, ec.message());
+        }
+
+        // without an advisor, the history is lost
+        {
+            test::stream ts{ioc_, s};
+            flat_buffer b;
+            response_parser<string_body> p;
+            BEAST_EXPECT(read_some(ts, b, p) == 512);
+        }
+
+        // asynchronous
+        {
+            auto const n = advisor.size();
+            test::stream ts{ioc_, s};
+            flat_buffer b;
+            response_parser<string_body> p;
+            bool invoked = false;
+            async_read_some(ts, b, p, advisor,
+                [&](error_code ec, std::size_t bytes_transferred)
+                {
+                    invoked = true;
+                    BEAST_EXPECTS(! ec, ec.message());
+                    BEAST_EXPECT(bytes_transferred == n);
+                });
+            ioc_.run();
+            ioc_.restart();
+            BEAST_EXPECT(invoked);
+        }
+    }
+
     //--------------------------------------------------------------------------
 
     template<class Parser, class Pred>
@@ -550,6 +611,7 @@ public:
 
         testIoService();
         testRegression430();
+        testAdvisor();
         testReadGrind();
         testAsioHandlerInvoke();
     }
@@ -0,0 +1,275 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+// Test that header file is self-contained.
+#include <boost/beast/http/small_string_body.hpp>
+
+#include <boost/beast/core/buffers_to_string.hpp>
+#include <boost/beast/http/parser.hpp>
+#include <boost/beast/http/serializer.hpp>
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <string>
+#include <utility>
+
+namespace boost {
+namespace beast {
+namespace http {
+
+BOOST_STATIC_ASSERT(is_body<small_string_body<16>>::value);
+BOOST_STATIC_ASSERT(is_body_writer<small_string_body<16>>::value);
+BOOST_STATIC_ASSERT(is_body_reader<small_string_body<16>>::value);
+
+class small_string_body_test : public beast::unit_test::suite
+{
+public:
+    // Counts heap allocations
+    template<class T>
+    struct counting_allocator
+    {
+        using value_type = T;
+
+        std::size_t* count;
+
+        explicit
+        counting_allocator(std::size_t* count_) noexcept
+            : count(count_)
+        {
+        }
+
+        template<class U>
+        counting_allocator(counting_allocator<U> const& other) noexcept
+            : count(other.count)
+        {
+        }
+
+        T*
+        allocate(std::size_t n)
+        {
+            ++*count;
+            return std::allocator<T>{}.allocate(n);
+        }
+
+        void
+        deallocate(T* p, std::size_t n) noexcept
+        {
+            std::allocator<T>{}.deallocate(p, n);
+        }
+
+        template<class U>
+        friend
+        bool
+        operator==(
+            counting_allocator const& lhs,
+            counting_allocator<U> const& rhs) noexcept
+        {
+            return lhs.count == rhs.count;
+        }
+
+        template<class U>
+        friend
+        bool
+        operator!=(
+            counting_allocator const& lhs,
+            counting_allocator<U> const& rhs) noexcept
+        {
+            return lhs.count != rhs.count;
+        }
+    };
+
+    using body_type = small_string_body<8>;
+    using value_type = body_type::value_type;
+
+    static
+    std::string
+    str(value_type const& v)
+    {
+        return std::string(v.data(), v.size());
+    }
+
+    struct visit
+    {
+        std::string& s;
+
+        template<class ConstBufferSequence>
+        void
+        operator()(error_code&, ConstBufferSequence const& buffers)
+        {
+            s.append(buffers_to_string(buffers));
+        }
+    };
+
+    void
+    testValueType()
+    {
+        // inline
+        {
+            value_type v;
+            BEAST_EXPECT(v.empty());
+            BEAST_EXPECT(v.capacity() == 8);
+            BEAST_EXPECT(value_type::inline_capacity() == 8);
+            v = "OK";
+            BEAST_EXPECT(str(v) == "OK");
+            BEAST_EXPECT(! v.is_heap());
+            v.append("123456");
+            BEAST_EXPECT(str(v) == "OK123456");
+            BEAST_EXPECT(! v.is_heap());
+            BEAST_EXPECT(string_view(v) == "OK123456");
+        }
+
+        // heap spill and shrink
+        {
+            value_type v("12345678");
+            v.append("9");
+            BEAST_EXPECT(v.is_heap());
+            BEAST_EXPECT(v.capacity() >= 16);
+            BEAST_EXPECT(str(v) == "123456789");
+            v.resize(3);
+            v.shrink_to_fit();
+            BEAST_EXPECT(! v.is_heap());
+            BEAST_EXPECT(str(v) == "123");
+            v.clear();
+            BEAST_EXPECT(v.empty());
+        }
+
+        // append to self
+        {
+            value_type v("abcdef");
+            v.append(v);
+            BEAST_EXPECT(str(v) == "abcdefabcdef");
+            v.append(v);
+            BEAST_EXPECT(str(v) == "abcdefabcdefabcdefabcdef");
+            // a part of the characters, while growing
+            v.append(string_view(v.data() + 20, 4));
+            BEAST_EXPECT(str(v) == "abcdefabcdefabcdefabcdefcdef");
+        }
+
+        // move and copy
+        {
+            value_type v1("abc");
+            value_type v2(std::move(v1));
+            BEAST_EXPECT(str(v2) == "abc");
+            BEAST_EXPECT(v1.empty());
+            value_type v3(std::string(100, '*'));
+            auto const p = v3.data();
+            value_type v4(std::move(v3));
+            BEAST_EXPECT(v4.data() == p);
+            BEAST_EXPECT(v3.empty());
+            BEAST_EXPECT(! v3.is_heap());
+            value_type v5(v4);
+            BEAST_EXPECT(str(v5) == std::string(100, '*'));
+            BEAST_EXPECT(v5.data() != p);
+            v5 = v2;
+            BEAST_EXPECT(str(v5) == "abc");
+            v2 = std::move(v4);
+            BEAST_EXPECT(v2.data() == p);
+            BEAST_EXPECT(v4.empty());
+            auto const& self = v2;
+            v2 = self;
+            BEAST_EXPECT(str(v2) == std::string(100, '*'));
+        }
+
+        // allocations
+        {
+            using alloc_type = counting_allocator<char>;
+            using value_type_ = small_string_body<
+                16, alloc_type>::value_type;
+            std::size_t count = 0;
+            value_type_ v{alloc_type{&count}};
+            v = "{}";
+            v.append("0123456789abcd");
+            BEAST_EXPECT(count == 0);
+            v.append("!");
+            BEAST_EXPECT(count == 1);
+            BEAST_EXPECT(v.get_allocator() == alloc_type{&count});
+        }
+    }
+
+    void
+    testParse()
+    {
+        // small body, no allocation for the payload
+        {
+            response_parser<body_type> p;
+            p.eager(true);
+            error_code ec;
+            string_view s =
+                "HTTP/1.1 200 OK\r\n"
+                "Content-Length: 2\r\n"
+                "\r\n"
+                "{}";
+            p.put(net::buffer(s.data(), s.size()), ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(p.is_done());
+            BEAST_EXPECT(str(p.get().body()) == "{}");
+            BEAST_EXPECT(! p.get().body().is_heap());
+        }
+
+        // large chunked body
+        {
+            response_parser<body_type> p;
+            p.eager(true);
+            error_code ec;
+            string_view s =
+                "HTTP/1.1 200 OK\r\n"
+                "Transfer-Encoding: chunked\r\n"
+                "\r\n"
+                "5\r\n"
+                "Hello\r\n"
+                "8\r\n"
+                ", world!\r\n"
+                "0\r\n"
+                "\r\n";
+            p.put(net::buffer(s.data(), s.size()), ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(p.is_done());
+            BEAST_EXPECT(str(p.get().body()) == "Hello, world!");
+            BEAST_EXPECT(p.get().body().is_heap());
+        }
+    }
+
+    void
+    testSerialize()
+    {
+        response<body_type> res{status::ok, 11};
+        res.body() = "OK";
+        res.prepare_payload();
+        BEAST_EXPECT(res[field::content_length] == "2");
+        std::string s;
+        serializer<false, body_type> sr(res);
+        error_code ec;
+        while(! sr.is_done())
+        {
+            std::string part;
+            sr.next(ec, visit{part});
+            if(! BEAST_EXPECTS(! ec, ec.message()))
+                return;
+            sr.consume(part.size());
+            s += part;
+        }
+        BEAST_EXPECT(s ==
+            "HTTP/1.1 200 OK\r\n"
+            "Content-Length: 2\r\n"
+            "\r\n"
+            "OK");
+    }
+
+    void
+    run() override
+    {
+        testValueType();
+        testParse();
+        testSerialize();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,http,small_string_body);
+
+} // http
+} // beast
+} // boost
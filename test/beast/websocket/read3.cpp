@@ -16,6 +16,8 @@
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/strand.hpp>
 #include <boost/asio/write.hpp>
+#include <array>
+#include <string>
 
 namespace boost {
 namespace beast {
@@ -597,6 +599,67 @@ public:
         }
     }
 
+    // a compressed message is inflated
+    // into a sequence of buffers
+    void
+    testDeflateBuffers()
+    {
+        permessage_deflate pmd;
+        pmd.client_enable = true;
+        pmd.server_enable = true;
+
+        std::string const s(5000, '*');
+        auto const check =
+            [&](bool async)
+            {
+                net::io_context ioc;
+                stream<test::stream> wsc{ioc};
+                stream<test::stream> wss{ioc};
+                wsc.set_option(pmd);
+                wss.set_option(pmd);
+                wsc.next_layer().connect(wss.next_layer());
+                wsc.async_handshake(
+                    "localhost", "/", [](error_code){});
+                wss.async_accept([](error_code){});
+                ioc.run();
+                ioc.restart();
+                wsc.write(net::buffer(s));
+                char b1[7];
+                char b2[100];
+                char b3[8000];
+                std::array<net::mutable_buffer, 3> const bs{{
+                    net::buffer(b1), net::buffer(b2), net::buffer(b3)}};
+                std::string got;
+                do
+                {
+                    error_code ec;
+                    std::size_t n = 0;
+                    if(async)
+                    {
+                        wss.async_read_some(bs,
+                            [&](error_code ec_, std::size_t n_)
+                            {
+                                ec = ec_;
+                                n = n_;
+                            });
+                        ioc.run();
+                        ioc.restart();
+                    }
+                    else
+                    {
+                        n = wss.read_some(bs, ec);
+                    }
+                    if(! BEAST_EXPECTS(! ec, ec.message()))
+                        return;
+                    got += buffers_to_string(buffers_prefix(n, bs));
+                }
+                while(! wss.is_message_done());
+                BEAST_EXPECT(got == s);
+            };
+        check(false);
+        check(true);
+    }
+
     void
     testMoveOnly()
     {
@@ -643,6 +706,7 @@ public:
         testIssue954();
         testIssueBF1();
         testIssueBF2();
+        testDeflateBuffers();
         testMoveOnly();
         testAsioHandlerInvoke();
     }
@@ -12,8 +12,10 @@
 
 #include <boost/beast/core/string.hpp>
 #include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <boost/asio/buffer.hpp>
 #include <cstdint>
 #include <random>
+#include <vector>
 
 #include "zlib-1.2.11/zlib.h"
 
@@ -302,6 +304,146 @@ public:
         doMatrix(corpus1(1024), &self::doDeflate1_beast);
     }
 
+    // Compress each message with a sync flush, as
+    // the permessage-deflate websocket extension does
+    void
+    doMessages(
+        std::size_t threshold,
+        int memLevel,
+        bool takeover)
+    {
+        auto const corpus = corpus1(4096);
+        deflate_stream ds;
+        ds.reset(6, 15, memLevel, Strategy::normal);
+        ds.fixed_threshold(threshold);
+        std::string in;
+        std::string stream;
+        for(std::size_t i = 0; i < 64; ++i)
+        {
+            auto const msg = corpus.substr(
+                (i * 97) % 2048, 16 + (i * 31) % 1500);
+            if(! takeover)
+                ds.reset();
+            std::string out;
+            out.resize(ds.upper_bound(msg.size()) + 6);
+            z_params zs;
+            zs.next_in = msg.data();
+            zs.avail_in = msg.size();
+            zs.next_out = &out[0];
+            zs.avail_out = out.size();
+            error_code ec;
+            ds.write(zs, Flush::sync, ec);
+            if(! BEAST_EXPECTS(! ec, ec.message()))
+                return;
+            BEAST_EXPECT(zs.avail_in == 0);
+            out.resize(zs.total_out);
+            if(takeover)
+            {
+                in.append(msg);
+                stream.append(out);
+            }
+            else
+            {
+                BEAST_EXPECT(decompress(out) == msg);
+            }
+        }
+        if(takeover)
+            BEAST_EXPECT(decompress(stream) == in);
+    }
+
+    void
+    testMessages()
+    {
+        for(std::size_t threshold : {0, 64, 1024, 65536})
+        {
+            for(int memLevel : {1, 4, 8, 9})
+            {
+                doMessages(threshold, memLevel, true);
+                doMessages(threshold, memLevel, false);
+            }
+        }
+    }
+
+    // Split a string into a sequence of buffers
+    template<class Buffer, class String>
+    static
+    std::vector<Buffer>
+    split(String& s, std::size_t n)
+    {
+        std::vector<Buffer> v;
+        for(std::size_t i = 0; i < s.size(); i += n)
+            v.emplace_back(&s[i], (std::min)(n, s.size() - i));
+        return v;
+    }
+
+    void
+    testBuffers()
+    {
+        auto const check = corpus1(10000);
+        for(std::size_t in_size : {1, 5, 100, 10000})
+        {
+            for(std::size_t out_size : {1, 7, 300})
+            {
+                deflate_stream ds;
+                std::string out;
+                out.resize(ds.upper_bound(check.size()) + 6);
+                auto const in = split<
+                    net::const_buffer>(check, in_size);
+                auto const bs = split<
+                    net::mutable_buffer>(out, out_size);
+                std::size_t total_in;
+                std::size_t total_out;
+                error_code ec;
+                ds.write(in, bs, total_in, total_out,
+                    Flush::sync, ec);
+                if(! BEAST_EXPECTS(! ec, ec.message()))
+                    continue;
+                BEAST_EXPECT(total_in == check.size());
+                out.resize(total_out);
+                BEAST_EXPECT(decompress(out) == check);
+            }
+        }
+
+        // output too small
+        {
+            deflate_stream ds;
+            std::string out;
+            out.resize(ds.upper_bound(check.size()) + 6);
+            auto const in = split<
+                net::const_buffer>(check, 100);
+            std::size_t total_in;
+            std::size_t total_out;
+            error_code ec;
+            ds.write(in, net::mutable_buffer(&out[0], 10),
+                total_in, total_out, Flush::sync, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            BEAST_EXPECT(total_out == 10);
+            std::size_t n = total_out;
+            auto const tail = check.substr(total_in);
+            auto const rest = split<
+                net::const_buffer>(tail, 100);
+            ds.write(rest, net::mutable_buffer(&out[n], out.size() - n),
+                total_in, total_out, Flush::sync, ec);
+            BEAST_EXPECTS(! ec, ec.message());
+            out.resize(n + total_out);
+            BEAST_EXPECT(decompress(out) == check);
+        }
+
+        // empty output
+        {
+            deflate_stream ds;
+            std::size_t total_in;
+            std::size_t total_out;
+            error_code ec;
+            ds.write(net::const_buffer(check.data(), check.size()),
+                net::mutable_buffer{}, total_in, total_out,
+                    Flush::sync, ec);
+            BEAST_EXPECT(ec == error::need_buffers);
+            BEAST_EXPECT(total_in == 0);
+            BEAST_EXPECT(total_out == 0);
+        }
+    }
+
     void
     run() override
     {
@@ -310,6 +452,8 @@ public:
             sizeof(deflate_stream) << std::endl;
 
         testDeflate();
+        testMessages();
+        testBuffers();
     }
 };
 
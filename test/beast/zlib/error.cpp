@@ -56,6 +56,10 @@ public:
         check("boost.beast.zlib", error::over_subscribed_length);
         check("boost.beast.zlib", error::incomplete_length_set);
 
+        check("boost.beast.zlib", error::invalid_header);
+        check("boost.beast.zlib", error::invalid_checksum);
+        check("boost.beast.zlib", error::trailing_data);
+
         check("boost.beast.zlib", error::general);
     }
 };
@@ -12,8 +12,10 @@
 
 #include <boost/beast/core/string.hpp>
 #include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <boost/asio/buffer.hpp>
 #include <chrono>
 #include <random>
+#include <vector>
 
 #include "zlib-1.2.11/zlib.h"
 
@@ -362,6 +364,51 @@ public:
 #endif
     }
 
+    // Split a string into a sequence of buffers
+    template<class Buffer, class String>
+    static
+    std::vector<Buffer>
+    split(String& s, std::size_t n)
+    {
+        std::vector<Buffer> v;
+        for(std::size_t i = 0; i < s.size(); i += n)
+            v.emplace_back(&s[i], (std::min)(n, s.size() - i));
+        return v;
+    }
+
+    void
+    testBuffers()
+    {
+        auto const check = corpus1(10000);
+        auto const z = compress(check, 6, 15, 8, Z_DEFAULT_STRATEGY);
+        for(std::size_t in_size : {1, 5, 100, 10000})
+        {
+            for(std::size_t out_size : {1, 7, 300, 10000})
+            {
+                inflate_stream is;
+                std::string out;
+                // one extra byte so the trailing
+                // flush marker is consumed
+                out.resize(check.size() + 1);
+                auto const in = split<
+                    net::const_buffer>(z, in_size);
+                auto const bs = split<
+                    net::mutable_buffer>(out, out_size);
+                std::size_t total_in;
+                std::size_t total_out;
+                error_code ec;
+                is.write(in, bs, total_in, total_out,
+                    Flush::sync, ec);
+                if(! BEAST_EXPECTS(! ec, ec.message()))
+                    continue;
+                BEAST_EXPECT(total_in == z.size());
+                BEAST_EXPECT(total_out == check.size());
+                out.resize(total_out);
+                BEAST_EXPECT(out == check);
+            }
+        }
+    }
+
     void
     run() override
     {
@@ -369,6 +416,7 @@ public:
             "sizeof(inflate_stream) == " <<
             sizeof(inflate_stream) << std::endl;
         testInflate();
+        testBuffers();
     }
 };
 
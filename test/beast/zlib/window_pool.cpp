@@ -0,0 +1,183 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+// Test that header file is self-contained.
+#include <boost/beast/zlib/window_pool.hpp>
+
+#include <boost/beast/zlib/deflate_stream.hpp>
+#include <boost/beast/zlib/inflate_stream.hpp>
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <string>
+
+namespace boost {
+namespace beast {
+namespace zlib {
+
+class window_pool_test : public unit_test::suite
+{
+public:
+    void
+    testPool()
+    {
+        // recycle a block of the same size
+        {
+            window_pool pool;
+            auto const p = pool.allocate(1000);
+            pool.deallocate(p, 1000);
+            BEAST_EXPECT(pool.size() == 1000);
+            auto const p1 = pool.allocate(2000);
+            BEAST_EXPECT(p1 != p);
+            BEAST_EXPECT(pool.size() == 1000);
+            auto const p2 = pool.allocate(1000);
+            BEAST_EXPECT(p2 == p);
+            BEAST_EXPECT(pool.size() == 0);
+            pool.deallocate(p1, 2000);
+            pool.deallocate(p2, 1000);
+            BEAST_EXPECT(pool.size() == 3000);
+            pool.shrink();
+            BEAST_EXPECT(pool.size() == 0);
+            BEAST_EXPECT(pool.capacity() ==
+                window_pool::default_capacity);
+        }
+
+        // capacity
+        {
+            window_pool pool(1500);
+            auto const p1 = pool.allocate(1000);
+            auto const p2 = pool.allocate(1000);
+            pool.deallocate(p1, 1000);
+            pool.deallocate(p2, 1000);
+            BEAST_EXPECT(pool.size() == 1000);
+            pool.capacity(500);
+            BEAST_EXPECT(pool.size() == 0);
+            BEAST_EXPECT(pool.capacity() == 500);
+        }
+
+        // this thread
+        {
+        #ifndef BOOST_NO_CXX11_THREAD_LOCAL
+            auto const pool = window_pool::this_thread();
+            BEAST_EXPECT(pool != nullptr);
+            BEAST_EXPECT(pool == window_pool::this_thread());
+
+            // nothing is cached until the capacity is raised
+            BEAST_EXPECT(pool->capacity() == 0);
+            auto const p = pool->allocate(1000);
+            pool->deallocate(p, 1000);
+            BEAST_EXPECT(pool->size() == 0);
+
+            pool->capacity(1000);
+            auto const p1 = pool->allocate(1000);
+            pool->deallocate(p1, 1000);
+            BEAST_EXPECT(pool->size() == 1000);
+            pool->capacity(0);
+            BEAST_EXPECT(pool->size() == 0);
+        #endif
+        }
+    }
+
+    static
+    std::string
+    deflate(deflate_stream& zo, std::string const& s)
+    {
+        std::string out;
+        out.resize(zo.upper_bound(s.size()));
+        z_params zs;
+        zs.next_in = s.data();
+        zs.avail_in = s.size();
+        zs.next_out = &out[0];
+        zs.avail_out = out.size();
+        error_code ec;
+        zo.write(zs, Flush::finish, ec);
+        out.resize(zs.total_out);
+        return out;
+    }
+
+    static
+    std::string
+    inflate(inflate_stream& zi, std::string const& s)
+    {
+        std::string out;
+        out.resize(64 * 1024);
+        z_params zs;
+        zs.next_in = s.data();
+        zs.avail_in = s.size();
+        zs.next_out = &out[0];
+        zs.avail_out = out.size();
+        error_code ec;
+        zi.write(zs, Flush::sync, ec);
+        out.resize(zs.total_out);
+        return out;
+    }
+
+    void
+    testStreams()
+    {
+        std::string s;
+        for(int i = 0; i < 1000; ++i)
+            s += std::to_string(i);
+
+        window_pool pool;
+        std::string z;
+        {
+            deflate_stream zo(pool);
+            z = deflate(zo, s);
+            BEAST_EXPECT(pool.size() == 0);
+        }
+        auto const n = pool.size();
+        BEAST_EXPECT(n > 0);
+        {
+            // the block is taken from the pool
+            deflate_stream zo(pool);
+            BEAST_EXPECT(deflate(zo, s) == z);
+            BEAST_EXPECT(pool.size() == 0);
+            zo.clear();
+            BEAST_EXPECT(pool.size() == n);
+        }
+        BEAST_EXPECT(pool.size() == n);
+        {
+            inflate_stream zi(pool);
+            BEAST_EXPECT(inflate(zi, z) == s);
+            BEAST_EXPECT(pool.size() == n);
+            zi.clear();
+            BEAST_EXPECT(pool.size() > n);
+        }
+        {
+            inflate_stream zi(pool);
+            BEAST_EXPECT(inflate(zi, z) == s);
+            BEAST_EXPECT(pool.size() == n);
+        }
+
+    #ifndef BOOST_NO_CXX11_THREAD_LOCAL
+        // default constructed streams cache nothing
+        {
+            {
+                deflate_stream zo;
+                BEAST_EXPECT(deflate(zo, s) == z);
+                inflate_stream zi;
+                BEAST_EXPECT(inflate(zi, z) == s);
+            }
+            BEAST_EXPECT(window_pool::this_thread()->size() == 0);
+        }
+    #endif
+    }
+
+    void
+    run() override
+    {
+        testPool();
+        testStreams();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,zlib,window_pool);
+
+} // zlib
+} // beast
+} // boost
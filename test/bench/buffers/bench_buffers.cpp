@@ -7,234 +7,749 @@
 // Official repository: https://github.com/boostorg/beast
 //
 
+#include <boost/beast/core/buffers_adaptor.hpp>
 #include <boost/beast/core/buffers_range.hpp>
+#include <boost/beast/core/dynamic_buffer_ref.hpp>
 #include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/core/flat_static_buffer.hpp>
+#include <boost/beast/core/mirrored_ring_buffer.hpp>
 #include <boost/beast/core/multi_buffer.hpp>
-#include <boost/beast/core/read_size.hpp>
+#include <boost/beast/core/spsc_buffer.hpp>
+#include <boost/beast/core/static_buffer.hpp>
 #include <boost/beast/core/string.hpp>
+#include <boost/beast/version.hpp>
 #include <boost/beast/_experimental/unit_test/suite.hpp>
 #include <boost/asio/streambuf.hpp>
+#include <boost/optional.hpp>
 #include <algorithm>
+#include <array>
 #include <chrono>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <iomanip>
-#include <utility>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <random>
+#include <string>
 #include <vector>
 
+//------------------------------------------------------------------------------
+
 namespace boost {
 namespace beast {
 
+/*  Buffer benchmark matrix
+
+    Each DynamicBuffer in core/ is driven through traces of prepare,
+    commit and consume calls which resemble real protocol traffic.
+    For every pair of buffer and trace, the benchmark reports the
+    throughput, the number of allocations, and the latency of each
+    kind of operation as percentiles and as a histogram.
+
+    The results are printed as a table, and written as JSON to the
+    file named by the environment variable BEAST_BENCH_BUFFERS_JSON,
+    or to the log when the variable is not set.
+*/
 class buffers_test : public beast::unit_test::suite
 {
 public:
-    using size_type = std::uint64_t;
+    using clock_type = std::chrono::steady_clock;
+
+    // Upper limit on the size of the buffers with fixed storage,
+    // every trace must fit.
+    static std::size_t constexpr limit = 256 * 1024;
+
+    // Number of replays used to measure throughput
+    static std::size_t constexpr repeat = 5;
+
+    //--------------------------------------------------------------------------
+    //
+    // Traces
+    //
+    //--------------------------------------------------------------------------
+
+    enum kind
+    {
+        prepare_op,
+        commit_op,
+        data_op,
+        consume_op,
+        kinds
+    };
+
+    static
+    char const*
+    kind_name(int k)
+    {
+        static char const* const names[] = {
+            "prepare", "commit", "data", "consume" };
+        return names[k];
+    }
+
+    // One call on the buffer. A prepare writes `fill`
+    // bytes into the returned sequence, as a read would.
+    struct op
+    {
+        kind k;
+        std::size_t n;
+        std::size_t fill;
+    };
+
+    struct trace
+    {
+        std::string name;
+        std::vector<op> ops;
+        std::size_t bytes = 0;      // total bytes committed
+        std::size_t peak = 0;       // largest size() + prepare(n)
+    };
+
+    /*  Model bytes arriving from a socket and parsed in units
 
-    class timer
+        The stream is the concatenation of `units`. Each read
+        prepares `read_size` bytes and commits what the socket
+        delivers, between `min_chunk` and `max_chunk` bytes.
+        After each read the complete units are inspected with
+        data() and removed with consume().
+    */
+    static
+    trace
+    make_trace(
+        char const* name,
+        std::vector<std::size_t> const& units,
+        std::size_t read_size,
+        std::size_t min_chunk,
+        std::size_t max_chunk)
     {
-        using clock_type =
-            std::chrono::system_clock;
+        std::mt19937 g;
+        std::uniform_int_distribution<std::size_t> d{min_chunk, max_chunk};
+        std::size_t total = 0;
+        for(auto n : units)
+            total += n;
+        trace t;
+        t.name = name;
+        std::size_t size = 0;
+        auto it = units.begin();
+        while(t.bytes < total)
+        {
+            auto const n = (std::min)({
+                read_size, d(g), total - t.bytes});
+            t.ops.push_back({prepare_op, read_size, n});
+            t.ops.push_back({commit_op, n, 0});
+            t.peak = (std::max)(t.peak, size + read_size);
+            size += n;
+            t.bytes += n;
+            while(it != units.end() && *it <= size)
+            {
+                t.ops.push_back({data_op, 0, 0});
+                t.ops.push_back({consume_op, *it, 0});
+                size -= *it;
+                ++it;
+            }
+        }
+        return t;
+    }
+
+    // Pipelined requests on a keep-alive connection. Most
+    // are header-only, some carry a small body.
+    static
+    trace
+    make_http_keepalive()
+    {
+        std::mt19937 g;
+        std::uniform_int_distribution<std::size_t> header{150, 900};
+        std::uniform_int_distribution<std::size_t> body{1, 4096};
+        std::vector<std::size_t> units;
+        for(int i = 0; i < 20000; ++i)
+        {
+            units.push_back(header(g));
+            if(g() % 8 == 0)
+                units.push_back(body(g));
+        }
+        return make_trace("http_keepalive", units, 4096, 64, 4096);
+    }
+
+    // A stream of mostly small websocket frames. The frame
+    // header and the payload are consumed separately.
+    static
+    trace
+    make_websocket_stream()
+    {
+        std::mt19937 g;
+        std::uniform_int_distribution<std::size_t> small{16, 125};
+        std::uniform_int_distribution<std::size_t> large{126, 4096};
+        std::vector<std::size_t> units;
+        for(int i = 0; i < 50000; ++i)
+        {
+            auto const n = g() % 4 == 0 ? large(g) : small(g);
+            units.push_back(n < 126 ? 2 : 4);
+            units.push_back(n);
+        }
+        return make_trace("websocket_stream", units, 1536, 1, 1460);
+    }
+
+    // One request with a 16MB body, read in large
+    // chunks and handed to the body in 8KB pieces.
+    static
+    trace
+    make_large_upload()
+    {
+        std::size_t constexpr body = 16 * 1024 * 1024;
+        std::size_t constexpr piece = 8192;
+        std::vector<std::size_t> units;
+        units.push_back(600);
+        for(std::size_t n = 0; n < body; n += piece)
+            units.push_back((std::min)(piece, body - n));
+        return make_trace("large_upload", units, 65536, 1460, 65536);
+    }
+
+    //--------------------------------------------------------------------------
+    //
+    // Buffers under test
+    //
+    //--------------------------------------------------------------------------
+
+    struct alloc_counts
+    {
+        std::size_t count = 0;
+        std::size_t bytes = 0;
+    };
+
+    static alloc_counts counts_;
 
-        clock_type::time_point when_;
+    // Counts the allocations of the buffers which take an allocator.
+    // The other buffers use fixed storage and never allocate, except
+    // mirrored_ring_buffer which maps its pages directly.
+    template<class T>
+    struct counting_allocator
+    {
+        using value_type = T;
+
+        counting_allocator() = default;
+
+        template<class U>
+        counting_allocator(counting_allocator<U> const&) noexcept
+        {
+        }
+
+        T*
+        allocate(std::size_t n)
+        {
+            ++counts_.count;
+            counts_.bytes += n * sizeof(T);
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+
+        void
+        deallocate(T* p, std::size_t) noexcept
+        {
+            ::operator delete(p);
+        }
+
+        friend
+        bool
+        operator==(counting_allocator const&,
+            counting_allocator const&) noexcept
+        {
+            return true;
+        }
+
+        friend
+        bool
+        operator!=(counting_allocator const&,
+            counting_allocator const&) noexcept
+        {
+            return false;
+        }
+    };
+
+    using allocator_type = counting_allocator<char>;
+    using flat_buffer_type = basic_flat_buffer<allocator_type>;
+    using multi_buffer_type = basic_multi_buffer<allocator_type>;
+    using streambuf_type = net::basic_streambuf<allocator_type>;
+
+    // A buffer which owns its storage
+    template<class DynamicBuffer>
+    struct owning
+    {
+        DynamicBuffer b;
+
+        typename DynamicBuffer::mutable_buffers_type
+        prepare(std::size_t n)
+        {
+            return b.prepare(n);
+        }
+
+        void
+        commit(std::size_t n)
+        {
+            b.commit(n);
+        }
+
+        typename DynamicBuffer::const_buffers_type
+        data() const
+        {
+            return b.data();
+        }
+
+        void
+        consume(std::size_t n)
+        {
+            b.consume(n);
+        }
+    };
+
+    // A dynamic_buffer_ref to a flat_buffer
+    struct referencing
+    {
+        flat_buffer_type storage;
+        dynamic_buffer_ref_wrapper<flat_buffer_type> b{storage};
+
+        flat_buffer_type::mutable_buffers_type
+        prepare(std::size_t n)
+        {
+            return b.prepare(n);
+        }
+
+        void
+        commit(std::size_t n)
+        {
+            b.commit(n);
+        }
+
+        flat_buffer_type::const_buffers_type
+        data() const
+        {
+            return b.data();
+        }
+
+        void
+        consume(std::size_t n)
+        {
+            b.consume(n);
+        }
+    };
+
+    // A buffers_adaptor over caller-provided storage made of
+    // several pieces. The adaptor never reuses consumed space,
+    // so it is recreated when empty, and the readable bytes are
+    // moved to the front when the storage runs out, the way a
+    // caller using it for reads would have to.
+    class adapting
+    {
+        static std::size_t constexpr pieces = 4;
+        static std::size_t constexpr piece = limit / pieces;
+
+        using sequence = std::array<net::mutable_buffer, pieces>;
+
+        std::unique_ptr<char[]> mem_{new char[limit]};
+        std::unique_ptr<char[]> tmp_{new char[limit]};
+        boost::optional<buffers_adaptor<sequence>> b_;
+        std::size_t used_ = 0;
+
+        sequence
+        storage()
+        {
+            sequence s;
+            for(std::size_t i = 0; i < pieces; ++i)
+                s[i] = net::mutable_buffer(mem_.get() + i * piece, piece);
+            return s;
+        }
+
+        void
+        reset()
+        {
+            b_.emplace(storage());
+            used_ = 0;
+        }
 
     public:
-        using duration =
-            clock_type::duration;
+        using adaptor_type = buffers_adaptor<sequence>;
+
+        adapting()
+        {
+            reset();
+        }
+
+        adaptor_type::mutable_buffers_type
+        prepare(std::size_t n)
+        {
+            if(used_ + n > limit)
+            {
+                auto const size = net::buffer_copy(
+                    net::buffer(tmp_.get(), limit), b_->data());
+                reset();
+                b_->commit(net::buffer_copy(b_->prepare(size),
+                    net::buffer(tmp_.get(), size)));
+                used_ = size;
+            }
+            return b_->prepare(n);
+        }
+
+        void
+        commit(std::size_t n)
+        {
+            b_->commit(n);
+            used_ += n;
+        }
 
-        timer()
-            : when_(clock_type::now())
+        adaptor_type::const_buffers_type
+        data() const
         {
+            return b_->data();
         }
 
-        duration
-        elapsed() const
+        void
+        consume(std::size_t n)
         {
-            return clock_type::now() - when_;
+            b_->consume(n);
+            if(b_->size() == 0)
+                reset();
         }
     };
 
-    inline
-    size_type
-    throughput(std::chrono::duration<
-        double> const& elapsed, size_type items)
+    //--------------------------------------------------------------------------
+    //
+    // Measurement
+    //
+    //--------------------------------------------------------------------------
+
+    struct stats
     {
-        using namespace std::chrono;
-        return static_cast<size_type>(
-            1 / (elapsed/items).count());
-    }
+        std::size_t count = 0;
+        double mean = 0;
+        std::uint64_t p50 = 0;
+        std::uint64_t p99 = 0;
+        std::uint64_t max = 0;
+
+        // Element i counts latencies in [2^i, 2^(i+1)) ns,
+        // element 0 also counts zero.
+        std::vector<std::size_t> histogram;
+    };
+
+    struct result
+    {
+        std::string buffer;
+        std::string trace;
+        double mbps = 0;
+        std::size_t cold_allocs = 0;
+        std::size_t cold_bytes = 0;
+        std::size_t warm_allocs = 0;
+        std::size_t warm_bytes = 0;
+        stats ops[kinds];
+    };
+
+    std::vector<trace> traces_;
+    std::vector<result> results_;
+    std::uint64_t clock_overhead_ = 0;
+    std::size_t sink_ = 0;
 
     template<class MutableBufferSequence>
     static
-    std::size_t
-    fill(MutableBufferSequence const& buffers)
+    void
+    fill(MutableBufferSequence const& buffers, std::size_t n)
     {
-        std::size_t n = 0;
         for(auto b : beast::buffers_range_ref(buffers))
         {
-            std::fill(
-                static_cast<char*>(b.data()),
-                static_cast<char*>(b.data()) +
-                    b.size(), '\0');
-            n += b.size();
+            if(n == 0)
+                break;
+            auto const k = (std::min)(n, b.size());
+            std::memset(b.data(), 'x', k);
+            n -= k;
         }
+    }
+
+    // Touch each buffer without reading every byte,
+    // so the cost of the sequence itself dominates.
+    template<class ConstBufferSequence>
+    static
+    std::size_t
+    walk(ConstBufferSequence const& buffers)
+    {
+        std::size_t n = 0;
+        for(auto b : beast::buffers_range_ref(buffers))
+            if(b.size() > 0)
+                n += b.size() + static_cast<
+                    unsigned char>(*static_cast<char const*>(b.data()));
         return n;
     }
 
-    template<class DynamicBuffer>
-    size_type
-    do_prepares(std::size_t repeat,
-        std::size_t count, std::size_t size)
+    template<class Buffer>
+    void
+    replay(Buffer& b, trace const& t)
     {
-        timer t;
-        size_type total = 0;
-        for(auto i = repeat; i--;)
+        for(auto const& o : t.ops)
         {
-            DynamicBuffer b;
-            for(auto j = count; j--;)
+            switch(o.k)
             {
-                auto const n = fill(b.prepare(size));
-                b.commit(n);
-                total += n;
+            case prepare_op: fill(b.prepare(o.n), o.fill); break;
+            case commit_op: b.commit(o.n); break;
+            case data_op: sink_ += walk(b.data()); break;
+            case consume_op: b.consume(o.n); break;
+            default: break;
             }
         }
-        return throughput(t.elapsed(), total);
     }
 
-    template<class DynamicBuffer>
-    size_type
-    do_hints(std::size_t repeat,
-        std::size_t count, std::size_t size)
+    static
+    std::uint64_t
+    since(clock_type::time_point t0)
+    {
+        return static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                clock_type::now() - t0).count());
+    }
+
+    // Replay with each operation timed individually. The
+    // fill and the memory it touches are not timed.
+    template<class Buffer>
+    void
+    replay_timed(Buffer& b, trace const& t,
+        std::vector<std::uint64_t> (&v)[kinds])
     {
-        timer t;
-        size_type total = 0;
-        for(auto i = repeat; i--;)
+        for(auto const& o : t.ops)
         {
-            DynamicBuffer b;
-            for(auto j = count; j--;)
+            auto const t0 = clock_type::now();
+            switch(o.k)
+            {
+            case prepare_op:
             {
-                for(auto remain = size; remain;)
-                {
-                    auto const n = fill(b.prepare(
-                        read_size(b, remain)));
-                    b.commit(n);
-                    remain -= n;
-                    total += n;
-                }
+                auto const mb = b.prepare(o.n);
+                v[prepare_op].push_back(since(t0));
+                fill(mb, o.fill);
+                break;
+            }
+            case commit_op:
+                b.commit(o.n);
+                v[commit_op].push_back(since(t0));
+                break;
+            case data_op:
+                sink_ += walk(b.data());
+                v[data_op].push_back(since(t0));
+                break;
+            case consume_op:
+                b.consume(o.n);
+                v[consume_op].push_back(since(t0));
+                break;
+            default:
+                break;
             }
         }
-        return throughput(t.elapsed(), total);
     }
 
-    template<class DynamicBuffer>
-    size_type
-    do_random(std::size_t repeat,
-        std::size_t count, std::size_t size)
+    static
+    stats
+    make_stats(std::vector<std::uint64_t>& v)
     {
-        timer t;
-        size_type total = 0;
-        for(auto i = repeat; i--;)
+        stats s;
+        s.count = v.size();
+        if(v.empty())
+            return s;
+        std::uint64_t sum = 0;
+        for(auto ns : v)
         {
-            DynamicBuffer b;
-            for(auto j = count; j--;)
-            {
-                auto const n = fill(b.prepare(
-                    1 + (rand()%(2*size))));
-                b.commit(n);
-                total += n;
-            }
+            sum += ns;
+            std::size_t i = 0;
+            while((ns >> (i + 1)) > 0)
+                ++i;
+            if(s.histogram.size() <= i)
+                s.histogram.resize(i + 1);
+            ++s.histogram[i];
+        }
+        s.mean = static_cast<double>(sum) / v.size();
+        std::sort(v.begin(), v.end());
+        s.p50 = v[v.size() / 2];
+        s.p99 = v[v.size() * 99 / 100];
+        s.max = v.back();
+        return s;
+    }
+
+    template<class Buffer>
+    void
+    do_matrix(string_view name)
+    {
+        for(auto const& t : traces_)
+        {
+            result r;
+            r.buffer = std::string(name);
+            r.trace = t.name;
+
+            std::unique_ptr<Buffer> b(new Buffer);
+
+            // first replay, from an empty buffer
+            auto c0 = counts_;
+            replay(*b, t);
+            r.cold_allocs = counts_.count - c0.count;
+            r.cold_bytes = counts_.bytes - c0.bytes;
+
+            // second replay, with the buffer grown
+            c0 = counts_;
+            replay(*b, t);
+            r.warm_allocs = counts_.count - c0.count;
+            r.warm_bytes = counts_.bytes - c0.bytes;
+
+            auto const t0 = clock_type::now();
+            for(auto i = repeat; i--;)
+                replay(*b, t);
+            std::chrono::duration<double> const elapsed =
+                clock_type::now() - t0;
+            r.mbps = static_cast<double>(t.bytes) * repeat /
+                (1024 * 1024) / elapsed.count();
+
+            std::vector<std::uint64_t> v[kinds];
+            for(auto& e : v)
+                e.reserve(t.ops.size());
+            replay_timed(*b, t, v);
+            for(int k = 0; k < kinds; ++k)
+                r.ops[k] = make_stats(v[k]);
+
+            log <<
+                std::left << std::setw(22) << r.buffer <<
+                std::left << std::setw(18) << r.trace <<
+                std::right << std::fixed << std::setprecision(1) <<
+                std::setw(10) << r.mbps << " MB/s" <<
+                std::setw(8) << r.cold_allocs <<
+                std::setw(8) << r.warm_allocs <<
+                std::setw(8) << r.ops[prepare_op].p50 <<
+                std::setw(8) << r.ops[prepare_op].p99 <<
+                std::setw(8) << r.ops[consume_op].p50 <<
+                std::setw(8) << r.ops[consume_op].p99 <<
+                std::defaultfloat << std::endl;
+            results_.emplace_back(std::move(r));
         }
-        return throughput(t.elapsed(), total);
     }
 
+    void
+    measure_clock()
+    {
+        std::uint64_t best = (std::numeric_limits<std::uint64_t>::max)();
+        for(int i = 0; i < 1000; ++i)
+            best = (std::min)(best, since(clock_type::now()));
+        clock_overhead_ = best;
+    }
+
+    //--------------------------------------------------------------------------
+    //
+    // Output
+    //
+    //--------------------------------------------------------------------------
+
     static
-    inline
     void
-    do_trials_1(bool)
+    write_json(std::ostream& os, stats const& s)
     {
+        os <<
+            "{\"count\":" << s.count <<
+            ",\"mean_ns\":" << s.mean <<
+            ",\"p50_ns\":" << s.p50 <<
+            ",\"p99_ns\":" << s.p99 <<
+            ",\"max_ns\":" << s.max <<
+            ",\"histogram_log2_ns\":[";
+        for(std::size_t i = 0; i < s.histogram.size(); ++i)
+            os << (i > 0 ? "," : "") << s.histogram[i];
+        os << "]}";
     }
 
-    template<class F0, class... FN>
     void
-    do_trials_1(bool print, F0&& f, FN... fn)
+    write_json(std::ostream& os) const
     {
-        timer t;
-        using namespace std::chrono;
-        static size_type constexpr den = 1024 * 1024;
-        if(print)
+        os << std::fixed << std::setprecision(1) <<
+            "{\n"
+            "\"benchmark\":\"buffers\",\n"
+            "\"version\":" << BOOST_BEAST_VERSION << ",\n"
+            "\"repeat\":" << repeat << ",\n"
+            "\"clock_overhead_ns\":" << clock_overhead_ << ",\n"
+            "\"traces\":[\n";
+        for(std::size_t i = 0; i < traces_.size(); ++i)
         {
-            log << std::right << std::setw(10) <<
-                ((f() + (den / 2)) / den) << " MB/s";
-            log.flush();
+            auto const& t = traces_[i];
+            os <<
+                "{\"name\":\"" << t.name << "\"" <<
+                ",\"bytes\":" << t.bytes <<
+                ",\"ops\":" << t.ops.size() <<
+                ",\"peak\":" << t.peak << "}" <<
+                (i + 1 < traces_.size() ? ",\n" : "\n");
         }
-        else
+        os << "],\n\"results\":[\n";
+        for(std::size_t i = 0; i < results_.size(); ++i)
         {
-            f();
-        }
-        do_trials_1(print, fn...);
-    }
-
-    template<class F0, class... FN>
-    void
-    do_trials(string_view name,
-        std::size_t trials, F0&& f0, FN... fn)
-    {
-        using namespace std::chrono;
-        // warm-up
-        do_trials_1(false, f0, fn...);
-        do_trials_1(false, f0, fn...);
-        while(trials--)
-        {
-            timer t;
-            log << std::left << std::setw(24) << name << ":";
-            log.flush();
-            do_trials_1(true, f0, fn...);
-            log << "   " <<
-                duration_cast<milliseconds>(t.elapsed()).count() << "ms";
-            log << std::endl;
+            auto const& r = results_[i];
+            os <<
+                "{\"buffer\":\"" << r.buffer << "\"" <<
+                ",\"trace\":\"" << r.trace << "\"" <<
+                ",\"mb_per_s\":" << r.mbps <<
+                ",\"allocations\":{" <<
+                    "\"cold\":" << r.cold_allocs <<
+                    ",\"cold_bytes\":" << r.cold_bytes <<
+                    ",\"warm\":" << r.warm_allocs <<
+                    ",\"warm_bytes\":" << r.warm_bytes << "}" <<
+                ",\"ops\":{";
+            for(int k = 0; k < kinds; ++k)
+            {
+                os << (k > 0 ? "," : "") <<
+                    "\"" << kind_name(k) << "\":";
+                write_json(os, r.ops[k]);
+            }
+            os << "}}" << (i + 1 < results_.size() ? ",\n" : "\n");
         }
+        os << "]\n}\n" << std::defaultfloat;
     }
 
     void
     run() override
     {
-        static std::size_t constexpr trials = 1;
-        static std::size_t constexpr repeat = 250;
-        std::vector<std::pair<std::size_t, std::size_t>> params;
-        params.emplace_back(1024, 1024);
-        params.emplace_back(512, 4096);
-        params.emplace_back(256, 32768);
-        log << std::endl;
-        for(auto const& param : params)
-        {
-            auto const count = param.first;
-            auto const size = param.second;
-            auto const s = std::string("count=") + std::to_string(count) +
-                ", size=" + std::to_string(size);
-            log << std::left << std::setw(24) << s << " " <<
-                std::right << std::setw(15) << "prepare" <<
-                std::right << std::setw(15) << "with hint" <<
-                std::right << std::setw(15) << "random" <<
-                std::endl;
-            do_trials("multi_buffer", trials,
-                 [&](){ return do_prepares<multi_buffer>(repeat, count, size); }
-                ,[&](){ return do_hints   <multi_buffer>(repeat, count, size); }
-                ,[&](){ return do_random  <multi_buffer>(repeat, count, size); }
-            );
-            do_trials("flat_buffer", trials,
-                 [&](){ return do_prepares<flat_buffer>(repeat, count, size); }
-                ,[&](){ return do_hints   <flat_buffer>(repeat, count, size); }
-                ,[&](){ return do_random  <flat_buffer>(repeat, count, size); }
-            );
-            do_trials("net::streambuf", trials,
-                 [&](){ return do_prepares<net::streambuf>(repeat, count, size); }
-                ,[&](){ return do_hints   <net::streambuf>(repeat, count, size); }
-                ,[&](){ return do_random  <net::streambuf>(repeat, count, size); }
-            );
+        traces_.push_back(make_http_keepalive());
+        traces_.push_back(make_websocket_stream());
+        traces_.push_back(make_large_upload());
+        for(auto const& t : traces_)
+            BEAST_EXPECT(t.peak <= limit);
+        measure_clock();
+
+        log << std::endl <<
+            std::left << std::setw(22) << "buffer" <<
+            std::left << std::setw(18) << "trace" <<
+            std::right << std::setw(15) << "throughput" <<
+            std::setw(8) << "allocs" <<
+            std::setw(8) << "warm" <<
+            std::setw(16) << "prepare p50/99" <<
+            std::setw(16) << "consume p50/99" <<
+            std::endl;
+
+        do_matrix<owning<flat_buffer_type>>("flat_buffer");
+        do_matrix<owning<multi_buffer_type>>("multi_buffer");
+        do_matrix<owning<static_buffer<limit>>>("static_buffer");
+        do_matrix<owning<flat_static_buffer<limit>>>("flat_static_buffer");
+        do_matrix<adapting>("buffers_adaptor");
+        do_matrix<referencing>("dynamic_buffer_ref");
+#if BOOST_BEAST_USE_MIRRORED_RING_BUFFER
+        do_matrix<owning<mirrored_ring_buffer>>("mirrored_ring_buffer");
+#endif
+        do_matrix<owning<spsc_buffer<limit>>>("spsc_buffer");
+        do_matrix<owning<streambuf_type>>("net::streambuf");
+
+        if(auto const path = std::getenv("BEAST_BENCH_BUFFERS_JSON"))
+        {
+            std::ofstream os(path);
+            write_json(os);
+            BEAST_EXPECT(os.good());
+        }
+        else
+        {
             log << std::endl;
+            write_json(log);
         }
+        log << std::endl;
+        BEAST_EXPECT(sink_ > 0);
         pass();
     }
 };
 
+buffers_test::alloc_counts buffers_test::counts_;
+std::size_t constexpr buffers_test::limit;
+std::size_t constexpr buffers_test::repeat;
+
 BEAST_DEFINE_TESTSUITE(beast,benchmarks,buffers);
 
 } // beast
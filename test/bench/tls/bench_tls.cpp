@@ -0,0 +1,261 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#if BOOST_BEAST_USE_OPENSSL
+
+#include <boost/beast/_experimental/core/ssl_stream.hpp>
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/read.hpp>
+#include "example/common/server_certificate.hpp"
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <string>
+#include <thread>
+#include <time.h>
+
+namespace boost {
+namespace beast {
+
+/*  TLS bulk transfer benchmark
+
+    A server ssl_stream sends a large body over loopback to a client
+    reading on another thread, in chunks of one megabyte. Like
+    http::write, it calls write_some until each chunk is sent. Each combination
+    of protocol, write batch size and synchronous or asynchronous
+    writing reports the throughput, the CPU time of the writing
+    thread, and the number of writes made on the socket.
+*/
+class tls_test : public beast::unit_test::suite
+{
+public:
+    using clock_type = std::chrono::steady_clock;
+    using tcp = net::ip::tcp;
+    using plain_socket = net::basic_stream_socket<
+        tcp, net::io_context::executor_type>;
+
+    // Total bytes sent for each result
+    static std::size_t constexpr total = 128 * 1024 * 1024;
+
+    // Bytes passed to each write
+    static std::size_t constexpr chunk = 1024 * 1024;
+
+    // A socket which counts the writes made on it
+    class counted_socket : public plain_socket
+    {
+    public:
+        std::size_t writes = 0;
+
+        explicit
+        counted_socket(net::io_context::executor_type const& ex)
+            : plain_socket(ex)
+        {
+        }
+
+        template<class ConstBufferSequence>
+        std::size_t
+        write_some(ConstBufferSequence const& buffers)
+        {
+            ++writes;
+            return plain_socket::write_some(buffers);
+        }
+
+        template<class ConstBufferSequence>
+        std::size_t
+        write_some(
+            ConstBufferSequence const& buffers,
+            error_code& ec)
+        {
+            ++writes;
+            return plain_socket::write_some(buffers, ec);
+        }
+
+        template<class ConstBufferSequence, class WriteHandler>
+        auto
+        async_write_some(
+            ConstBufferSequence const& buffers,
+            WriteHandler&& handler) ->
+            decltype(std::declval<plain_socket&>().async_write_some(
+                buffers, std::forward<WriteHandler>(handler)))
+        {
+            ++writes;
+            return plain_socket::async_write_some(
+                buffers, std::forward<WriteHandler>(handler));
+        }
+    };
+
+    using stream_type = ssl_stream<counted_socket, true>;
+
+    struct result
+    {
+        double mbps;
+        double cpu_ms;
+        std::size_t writes;
+    };
+
+    static
+    double
+    thread_cpu_ms()
+    {
+#ifdef CLOCK_THREAD_CPUTIME_ID
+        timespec ts;
+        ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+        return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+#else
+        return 0;
+#endif
+    }
+
+    result
+    transfer(bool tls13, std::size_t batch, bool async)
+    {
+        net::ssl::context sctx{net::ssl::context::tls_server};
+        net::ssl::context cctx{net::ssl::context::tls_client};
+        load_server_certificate(sctx);
+        if(tls13)
+        {
+            SSL_CTX_set_min_proto_version(
+                sctx.native_handle(), TLS1_3_VERSION);
+        }
+        else
+        {
+            SSL_CTX_set_max_proto_version(
+                sctx.native_handle(), TLS1_2_VERSION);
+            SSL_CTX_set_cipher_list(sctx.native_handle(),
+                "ECDHE-RSA-AES128-GCM-SHA256");
+        }
+
+        net::io_context ioc;
+        stream_type server(ioc.get_executor(), sctx);
+        stream_type client(ioc.get_executor(), cctx);
+        tcp::acceptor a(ioc, tcp::endpoint(
+            net::ip::make_address("127.0.0.1"), 0));
+        client.next_layer().connect(a.local_endpoint());
+        a.accept(server.next_layer());
+        server.next_layer().set_option(
+            net::socket_base::send_buffer_size(4 * 1024 * 1024));
+        client.next_layer().set_option(
+            net::socket_base::receive_buffer_size(4 * 1024 * 1024));
+        server.async_handshake(stream_type::server,
+            [&](error_code ec)
+            {
+                BEAST_EXPECTS(! ec, ec.message());
+            });
+        client.async_handshake(stream_type::client,
+            [&](error_code ec)
+            {
+                BEAST_EXPECTS(! ec, ec.message());
+            });
+        ioc.run();
+        ioc.restart();
+        server.write_batch_bytes(batch);
+        server.next_layer().writes = 0;
+
+        std::string const body(chunk, '*');
+        std::size_t received = 0;
+        std::thread t(
+            [&]
+            {
+                std::string buf(64 * 1024, '\0');
+                error_code ec;
+                while(received < total)
+                {
+                    auto const n = client.read_some(
+                        net::buffer(&buf[0], buf.size()), ec);
+                    if(ec)
+                        break;
+                    received += n;
+                }
+            });
+
+        auto const t0 = clock_type::now();
+        auto const c0 = thread_cpu_ms();
+        if(async)
+        {
+            std::size_t sent = 0;
+            std::function<void(error_code, std::size_t)> on_write =
+                [&](error_code ec, std::size_t n)
+                {
+                    BEAST_EXPECTS(! ec, ec.message());
+                    sent += n;
+                    if(! ec && sent < total)
+                        server.async_write_some(net::buffer(
+                            body.data() + sent % chunk,
+                            chunk - sent % chunk), on_write);
+                };
+            server.async_write_some(net::buffer(body), on_write);
+            ioc.run();
+        }
+        else
+        {
+            for(std::size_t sent = 0; sent < total;)
+                sent += server.write_some(net::buffer(
+                    body.data() + sent % chunk,
+                    chunk - sent % chunk));
+        }
+        auto const cpu = thread_cpu_ms() - c0;
+        t.join();
+        std::chrono::duration<double> const elapsed =
+            clock_type::now() - t0;
+        BEAST_EXPECT(received == total);
+
+        result r;
+        r.mbps = static_cast<double>(total) /
+            (1024 * 1024) / elapsed.count();
+        r.cpu_ms = cpu;
+        r.writes = server.next_layer().writes;
+        return r;
+    }
+
+    void
+    run() override
+    {
+        log << std::endl <<
+            std::left << std::setw(10) << "protocol" <<
+            std::left << std::setw(8) << "mode" <<
+            std::right << std::setw(10) << "batch" <<
+            std::setw(15) << "throughput" <<
+            std::setw(12) << "cpu ms" <<
+            std::setw(10) << "writes" <<
+            std::setw(14) << "bytes/write" <<
+            std::endl;
+        for(auto tls13 : {false, true})
+        for(auto async : {false, true})
+        for(std::size_t batch : {0, 64 * 1024, 256 * 1024})
+        {
+            auto const r = transfer(tls13, batch, async);
+            log <<
+                std::left << std::setw(10) <<
+                    (tls13 ? "TLS1.3" : "TLS1.2") <<
+                std::left << std::setw(8) <<
+                    (async ? "async" : "sync") <<
+                std::right << std::setw(10) << batch <<
+                std::fixed << std::setprecision(1) <<
+                std::setw(10) << r.mbps << " MB/s" <<
+                std::setw(12) << r.cpu_ms <<
+                std::setw(10) << r.writes <<
+                std::setw(14) << total / (r.writes ? r.writes : 1) <<
+                std::defaultfloat << std::endl;
+        }
+        pass();
+    }
+};
+
+std::size_t constexpr tls_test::total;
+std::size_t constexpr tls_test::chunk;
+
+BEAST_DEFINE_TESTSUITE(beast,benchmarks,tls);
+
+} // beast
+} // boost
+
+#endif
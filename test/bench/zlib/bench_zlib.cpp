@@ -0,0 +1,492 @@
+//
+// Copyright (c) 2016-2019 Vinnie Falco (vinnie dot falco at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/boostorg/beast
+//
+
+#include <boost/beast/core/string.hpp>
+#include <boost/beast/zlib/deflate_stream.hpp>
+#include <boost/beast/zlib/inflate_stream.hpp>
+#include <boost/beast/test/throughput.hpp>
+#include <boost/beast/_experimental/unit_test/suite.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "zlib-1.2.11/zlib.h"
+
+namespace boost {
+namespace beast {
+namespace zlib {
+
+/*  Compare Beast's zlib port against the vendored zlib.
+
+    Each corpus is compressed at every level and window size
+    by both implementations, then decompressed again by both.
+    The report shows the throughput in MB/s of uncompressed
+    data and the compression ratio side by side.
+
+    A corpus is a list of messages. Corpora with a single
+    message are compressed as one stream with Flush::finish.
+    Corpora with many small messages are compressed the way
+    permessage-deflate does it: one stream for the whole log,
+    with a Flush::sync after each message.
+
+    The corpora are generated, so the results are repeatable
+    without shipping sample files.
+*/
+class zlib_test : public beast::unit_test::suite
+{
+public:
+    using messages = std::vector<std::string>;
+
+    struct corpus
+    {
+        char const* name;
+        messages m;
+        std::size_t size;
+    };
+
+    struct result
+    {
+        double mbps = 0;
+        std::size_t size = 0;
+    };
+
+    // Number of timed runs, the best one is reported
+    static std::size_t constexpr trials = 3;
+
+    // Size of the bulk corpora
+    static std::size_t constexpr corpus_size = 512 * 1024;
+
+    //--------------------------------------------------------------------------
+
+    static
+    std::string const&
+    word(std::mt19937& g)
+    {
+        static std::vector<std::string> const v = []
+        {
+            std::vector<std::string> v;
+            std::mt19937 g;
+            std::uniform_int_distribution<std::size_t> d0{2, 10};
+            std::uniform_int_distribution<int> d1{'a', 'z'};
+            for(std::size_t i = 0; i < 2000; ++i)
+            {
+                std::string s;
+                s.resize(d0(g));
+                for(auto& c : s)
+                    c = static_cast<char>(d1(g));
+                v.emplace_back(std::move(s));
+            }
+            return v;
+        }();
+        // Approximate the skewed word frequencies of natural text
+        std::uniform_real_distribution<double> d{0, 1};
+        auto const x = d(g);
+        return v[static_cast<std::size_t>(
+            x * x * x * (v.size() - 1))];
+    }
+
+    // Prose with a skewed vocabulary
+    static
+    std::string
+    make_text(std::size_t n)
+    {
+        std::mt19937 g;
+        std::uniform_int_distribution<std::size_t> d{0, 15};
+        std::string s;
+        s.reserve(n + 16);
+        bool cap = true;
+        while(s.size() < n)
+        {
+            auto w = word(g);
+            if(cap)
+                w[0] = static_cast<char>(w[0] - 'a' + 'A');
+            s.append(w);
+            auto const r = d(g);
+            cap = r < 2;
+            if(r == 0)
+                s.append(".\n");
+            else if(r == 1)
+                s.append(". ");
+            else if(r == 2)
+                s.append(", ");
+            else
+                s.push_back(' ');
+        }
+        s.resize(n);
+        return s;
+    }
+
+    static
+    std::string
+    make_record(std::mt19937& g, std::size_t id)
+    {
+        std::uniform_int_distribution<int> d0{0, 100000};
+        std::uniform_int_distribution<int> d1{0, 1};
+        std::stringstream ss;
+        ss <<
+            "{\"id\":" << id <<
+            ",\"user\":\"" << word(g) << "_" << word(g) << "\""
+            ",\"score\":" << d0(g) <<
+            ",\"active\":" << (d1(g) ? "true" : "false") <<
+            ",\"tags\":[\"" << word(g) << "\",\"" << word(g) << "\"]"
+            ",\"text\":\"" << word(g) << " " << word(g) <<
+                " " << word(g) << "\"}";
+        return ss.str();
+    }
+
+    // An array of JSON objects
+    static
+    std::string
+    make_json(std::size_t n)
+    {
+        std::mt19937 g;
+        std::string s = "[";
+        s.reserve(n + 256);
+        for(std::size_t id = 0; s.size() < n; ++id)
+        {
+            if(id > 0)
+                s.append(",\n");
+            s.append(make_record(g, id));
+        }
+        s.resize(n);
+        return s;
+    }
+
+    // Nested markup with attributes and text
+    static
+    std::string
+    make_html(std::size_t n)
+    {
+        static char const* const tags[] = {
+            "div", "p", "span", "a", "li", "td", "em" };
+        std::mt19937 g;
+        std::uniform_int_distribution<std::size_t> d0{
+            0, sizeof(tags) / sizeof(tags[0]) - 1};
+        std::uniform_int_distribution<std::size_t> d1{1, 8};
+        std::string s = "<!DOCTYPE html>\n<html><body>\n";
+        s.reserve(n + 256);
+        while(s.size() < n)
+        {
+            auto const tag = tags[d0(g)];
+            s.append("<").append(tag).append(" class=\"")
+                .append(word(g)).append("\">");
+            for(auto i = d1(g); i--;)
+                s.append(word(g)).push_back(' ');
+            s.append("</").append(tag).append(">\n");
+        }
+        s.resize(n);
+        return s;
+    }
+
+    // Runs of characters from a limited alphabet
+    static
+    std::string
+    make_repeat(std::size_t n)
+    {
+        static std::string const alphabet{
+            "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz"
+        };
+        std::mt19937 g;
+        std::uniform_int_distribution<std::size_t> d0{
+            0, alphabet.size() - 1};
+        std::uniform_int_distribution<std::size_t> d1{1, 5};
+        std::string s;
+        s.reserve(n + 5);
+        while(s.size() < n)
+            s.insert(s.end(), d1(g), alphabet[d0(g)]);
+        s.resize(n);
+        return s;
+    }
+
+    // Incompressible data
+    static
+    std::string
+    make_binary(std::size_t n)
+    {
+        std::mt19937 g;
+        std::uniform_int_distribution<int> d{0, 255};
+        std::string s;
+        s.resize(n);
+        for(auto& c : s)
+            c = static_cast<char>(d(g));
+        return s;
+    }
+
+    // Small JSON messages as seen on a WebSocket
+    static
+    messages
+    make_wslog(std::size_t n)
+    {
+        std::mt19937 g;
+        messages v;
+        std::size_t size = 0;
+        for(std::size_t id = 0; size < n; ++id)
+        {
+            v.emplace_back(
+                "{\"type\":\"message\",\"channel\":\"" +
+                word(g) + "\",\"body\":" + make_record(g, id) + "}");
+            size += v.back().size();
+        }
+        return v;
+    }
+
+    static
+    corpus
+    make_corpus(char const* name, messages m)
+    {
+        corpus c;
+        c.name = name;
+        c.size = 0;
+        for(auto const& s : m)
+            c.size += s.size();
+        c.m = std::move(m);
+        return c;
+    }
+
+    //--------------------------------------------------------------------------
+
+    static
+    double
+    mbps(test::timer::duration elapsed, std::size_t bytes)
+    {
+        return bytes / std::chrono::duration<
+            double>(elapsed).count() / 1e6;
+    }
+
+    static
+    std::size_t
+    total(messages const& v)
+    {
+        std::size_t n = 0;
+        for(auto const& s : v)
+            n += s.size();
+        return n;
+    }
+
+    messages
+    deflateBeast(
+        messages const& in, int level, int wbits)
+    {
+        deflate_stream ds;
+        ds.reset(level, wbits, 8, Strategy::normal);
+        auto const flush = in.size() > 1 ?
+            Flush::sync : Flush::finish;
+        messages out;
+        out.reserve(in.size());
+        for(auto const& s : in)
+        {
+            std::string z;
+            z.resize(ds.upper_bound(s.size()) + 16);
+            z_params zs;
+            zs.next_in = s.data();
+            zs.avail_in = s.size();
+            zs.next_out = &z[0];
+            zs.avail_out = z.size();
+            error_code ec;
+            ds.write(zs, flush, ec);
+            BEAST_EXPECTS(! ec || ec == error::end_of_stream,
+                ec.message());
+            z.resize(zs.total_out);
+            out.emplace_back(std::move(z));
+        }
+        return out;
+    }
+
+    messages
+    deflateZLib(
+        messages const& in, int level, int wbits)
+    {
+        z_stream zs;
+        std::memset(&zs, 0, sizeof(zs));
+        if(deflateInit2(&zs, level, Z_DEFLATED,
+                -wbits, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+            throw std::logic_error("deflateInit2 failed");
+        auto const flush = in.size() > 1 ?
+            Z_SYNC_FLUSH : Z_FINISH;
+        messages out;
+        out.reserve(in.size());
+        for(auto const& s : in)
+        {
+            std::string z;
+            z.resize(deflateBound(&zs,
+                static_cast<uLong>(s.size())) + 16);
+            auto const total_out = zs.total_out;
+            zs.next_in = (Bytef*)s.data();
+            zs.avail_in = static_cast<uInt>(s.size());
+            zs.next_out = (Bytef*)&z[0];
+            zs.avail_out = static_cast<uInt>(z.size());
+            auto const result = deflate(&zs, flush);
+            BEAST_EXPECT(result == Z_OK || result == Z_STREAM_END);
+            z.resize(zs.total_out - total_out);
+            out.emplace_back(std::move(z));
+        }
+        deflateEnd(&zs);
+        return out;
+    }
+
+    messages
+    inflateBeast(
+        messages const& in, messages const& ref, int wbits)
+    {
+        inflate_stream is;
+        is.reset(wbits);
+        messages out;
+        out.reserve(in.size());
+        for(std::size_t i = 0; i < in.size(); ++i)
+        {
+            std::string s;
+            s.resize(ref[i].size() + 1);
+            z_params zs;
+            zs.next_in = in[i].data();
+            zs.avail_in = in[i].size();
+            zs.next_out = &s[0];
+            zs.avail_out = s.size();
+            error_code ec;
+            is.write(zs, Flush::sync, ec);
+            BEAST_EXPECTS(! ec || ec == error::end_of_stream,
+                ec.message());
+            s.resize(zs.total_out);
+            out.emplace_back(std::move(s));
+        }
+        return out;
+    }
+
+    messages
+    inflateZLib(
+        messages const& in, messages const& ref, int wbits)
+    {
+        z_stream zs;
+        std::memset(&zs, 0, sizeof(zs));
+        if(inflateInit2(&zs, -wbits) != Z_OK)
+            throw std::logic_error("inflateInit2 failed");
+        messages out;
+        out.reserve(in.size());
+        for(std::size_t i = 0; i < in.size(); ++i)
+        {
+            std::string s;
+            s.resize(ref[i].size() + 1);
+            auto const total_out = zs.total_out;
+            zs.next_in = (Bytef*)in[i].data();
+            zs.avail_in = static_cast<uInt>(in[i].size());
+            zs.next_out = (Bytef*)&s[0];
+            zs.avail_out = static_cast<uInt>(s.size());
+            auto const result = inflate(&zs, Z_SYNC_FLUSH);
+            BEAST_EXPECT(result == Z_OK || result == Z_STREAM_END);
+            s.resize(zs.total_out - total_out);
+            out.emplace_back(std::move(s));
+        }
+        inflateEnd(&zs);
+        return out;
+    }
+
+    // Run f several times and keep the best throughput
+    template<class F>
+    result
+    measure(std::size_t bytes, F const& f)
+    {
+        result r;
+        for(std::size_t i = 0; i < trials; ++i)
+        {
+            test::timer t;
+            auto const out = f();
+            r.mbps = (std::max)(r.mbps, mbps(t.elapsed(), bytes));
+            r.size = total(out);
+        }
+        return r;
+    }
+
+    void
+    doCorpus(corpus const& c)
+    {
+        log <<
+            c.name << ", " << c.m.size() << " message(s), " <<
+                c.size << " bytes\n" <<
+            std::setw(5)  << "level" <<
+            std::setw(6)  << "wbits" <<
+            std::setw(14) << "deflate" <<
+            std::setw(14) << "zlib" <<
+            std::setw(9)  << "ratio" <<
+            std::setw(9)  << "zlib" <<
+            std::setw(14) << "inflate" <<
+            std::setw(14) << "zlib" <<
+            std::endl;
+        log << std::fixed;
+        for(int level = 0; level <= 9; ++level)
+        {
+            for(int wbits = 9; wbits <= 15; ++wbits)
+            {
+                messages z;
+                auto const d1 = measure(c.size,
+                    [&]
+                    {
+                        z = deflateBeast(c.m, level, wbits);
+                        return z;
+                    });
+                auto const d2 = measure(c.size,
+                    [&]
+                    {
+                        return deflateZLib(c.m, level, wbits);
+                    });
+                messages out;
+                auto const i1 = measure(c.size,
+                    [&]
+                    {
+                        out = inflateBeast(z, c.m, wbits);
+                        return out;
+                    });
+                BEAST_EXPECT(out == c.m);
+                auto const i2 = measure(c.size,
+                    [&]
+                    {
+                        out = inflateZLib(z, c.m, wbits);
+                        return out;
+                    });
+                BEAST_EXPECT(out == c.m);
+                log <<
+                    std::setw(5) << level <<
+                    std::setw(6) << wbits <<
+                    std::setprecision(1) <<
+                    std::setw(9) << d1.mbps << " MB/s" <<
+                    std::setw(9) << d2.mbps << " MB/s" <<
+                    std::setprecision(3) <<
+                    std::setw(9) << double(c.size) / d1.size <<
+                    std::setw(9) << double(c.size) / d2.size <<
+                    std::setprecision(1) <<
+                    std::setw(9) << i1.mbps << " MB/s" <<
+                    std::setw(9) << i2.mbps << " MB/s" <<
+                    std::endl;
+            }
+        }
+        log << std::defaultfloat << std::endl;
+    }
+
+    void
+    run() override
+    {
+        doCorpus(make_corpus("text",   {make_text(corpus_size)}));
+        doCorpus(make_corpus("json",   {make_json(corpus_size)}));
+        doCorpus(make_corpus("html",   {make_html(corpus_size)}));
+        doCorpus(make_corpus("repeat", {make_repeat(corpus_size)}));
+        doCorpus(make_corpus("binary", {make_binary(corpus_size)}));
+        doCorpus(make_corpus("wslog",  make_wslog(corpus_size)));
+        pass();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(beast,benchmarks,zlib);
+
+} // zlib
+} // beast
+} // boost